@@ -0,0 +1,225 @@
+/* Copyright Airship and Contributors */
+
+#import <XCTest/XCTest.h>
+#import <malloc/malloc.h>
+#import <Airship/UAAutomationEngine+Internal.h>
+#import <Airship/UAAutomationStore+Internal.h>
+#import <Airship/UASchedule+Internal.h>
+#import <Airship/UAScheduleInfo+Internal.h>
+#import <Airship/UAActionScheduleInfo.h>
+#import <Airship/UAScheduleTrigger.h>
+
+// Number of schedules seeded into the store
+#define kUAAutomationEngineBenchmarkScheduleCount 500
+
+// Number of events replayed per measurement
+#define kUAAutomationEngineBenchmarkEventCount 1000
+
+// Number of distinct custom event and screen names, controls the trigger fan-out per event
+#define kUAAutomationEngineBenchmarkNameCount 20
+
+// Allocation logging hook used by malloc stack logging. Not in a public header.
+typedef void (UAMallocLogger)(uint32_t type, uintptr_t arg1, uintptr_t arg2, uintptr_t arg3, uintptr_t result, uint32_t numHotFramesToSkip);
+extern UAMallocLogger *malloc_logger;
+
+// Matches MALLOC_LOG_TYPE_ALLOCATE in libmalloc
+#define kUAMallocLogTypeAllocate 2
+
+static uint64_t allocationCount;
+
+static void UAAutomationEngineBenchmarkCountAllocation(uint32_t type, uintptr_t arg1, uintptr_t arg2, uintptr_t arg3, uintptr_t result, uint32_t numHotFramesToSkip) {
+    if (type & kUAMallocLogTypeAllocate) {
+        __atomic_fetch_add(&allocationCount, 1, __ATOMIC_RELAXED);
+    }
+}
+
+@interface UAAutomationEngineBenchmarkDelegate : NSObject <UAAutomationEngineDelegate>
+@end
+
+@implementation UAAutomationEngineBenchmarkDelegate
+
+- (UAScheduleInfo *)createScheduleInfoWithBuilder:(UAScheduleInfoBuilder *)builder {
+    return [[UAActionScheduleInfo alloc] initWithBuilder:builder];
+}
+
+- (void)prepareSchedule:(UASchedule *)schedule completionHandler:(void (^)(UAAutomationSchedulePrepareResult))completionHandler {
+    // Triggered schedules go back to idle, so the benchmark only measures trigger evaluation
+    completionHandler(UAAutomationSchedulePrepareResultSkip);
+}
+
+- (UAAutomationScheduleReadyResult)isScheduleReadyToExecute:(UASchedule *)schedule {
+    return UAAutomationScheduleReadyResultNotReady;
+}
+
+- (void)executeSchedule:(UASchedule *)schedule completionHandler:(void (^)(void))completionHandler {
+    completionHandler();
+}
+
+@end
+
+/**
+ * Headless automation engine benchmark. Seeds a store with schedules, replays a synthetic stream of
+ * custom events, screen views and foregrounds through the triggers, and attaches the engine metrics
+ * report with the allocations per event as JSON so regressions can be gated.
+ */
+@interface UAAutomationEngineBenchmarkTest : XCTestCase
+@property (nonatomic, strong) UAAutomationStore *automationStore;
+@property (nonatomic, strong) UAAutomationEngine *automationEngine;
+@property (nonatomic, strong) UAAutomationEngineBenchmarkDelegate *engineDelegate;
+@end
+
+@implementation UAAutomationEngineBenchmarkTest
+
+- (void)tearDown {
+    [self.automationStore deleteAllSchedules];
+    [self.automationStore waitForIdle];
+    [self.automationStore shutDown];
+
+    [super tearDown];
+}
+
+#pragma mark -
+#pragma mark Benchmarks
+
+- (void)testInMemoryStorePerformance {
+    [self setUpEngineInMemory:YES];
+    [self measureEventStream];
+}
+
+- (void)testSQLiteStorePerformance {
+    [self setUpEngineInMemory:NO];
+    [self measureEventStream];
+}
+
+- (void)testEventsAreEvaluated {
+    [self setUpEngineInMemory:YES];
+
+    NSDictionary *report = [self replayEventStream];
+
+    XCTAssertEqualObjects(report[UAAutomationEngineMetricsEventsKey], @(kUAAutomationEngineBenchmarkEventCount));
+    XCTAssertGreaterThan([report[UAAutomationEngineMetricsTriggersEvaluatedKey] unsignedIntegerValue], 0);
+    XCTAssertGreaterThan([report[UAAutomationEngineMetricsSchedulesTriggeredKey] unsignedIntegerValue], 0);
+}
+
+#pragma mark -
+#pragma mark Helpers
+
+- (void)setUpEngineInMemory:(BOOL)inMemory {
+    NSString *storeName = [NSString stringWithFormat:@"UAAutomationEngineBenchmark-%@.sqlite", [NSUUID UUID].UUIDString];
+    self.automationStore = [UAAutomationStore automationStoreWithStoreName:storeName
+                                                             scheduleLimit:kUAAutomationEngineBenchmarkScheduleCount
+                                                                  inMemory:inMemory
+                                                                      date:[[UADate alloc] init]];
+
+    self.engineDelegate = [[UAAutomationEngineBenchmarkDelegate alloc] init];
+    self.automationEngine = [UAAutomationEngine automationEngineWithAutomationStore:self.automationStore
+                                                                    appStateTracker:[UAAppStateTracker shared]
+                                                                     timerScheduler:[UATimerScheduler timerScheduler]
+                                                                 notificationCenter:[[NSNotificationCenter alloc] init]
+                                                                         dispatcher:[UADispatcher mainDispatcher]
+                                                                        application:[UIApplication sharedApplication]
+                                                                               date:[[UADate alloc] init]];
+    self.automationEngine.delegate = self.engineDelegate;
+
+    [self seedSchedules];
+}
+
+- (void)seedSchedules {
+    NSMutableArray<UASchedule *> *schedules = [NSMutableArray arrayWithCapacity:kUAAutomationEngineBenchmarkScheduleCount];
+
+    for (NSUInteger i = 0; i < kUAAutomationEngineBenchmarkScheduleCount; i++) {
+        NSString *name = [self nameWithIndex:i];
+
+        UAJSONPredicate *predicate = [UAJSONPredicate andPredicateWithSubpredicates:@[
+            [UAJSONPredicate predicateWithJSONMatcher:[UAJSONMatcher matcherWithValueMatcher:[UAJSONValueMatcher matcherWhereStringEquals:name]
+                                                                                      scope:@[@"event_name"]]],
+            [UAJSONPredicate predicateWithJSONMatcher:[UAJSONMatcher matcherWithValueMatcher:[UAJSONValueMatcher matcherWhereNumberAtLeast:@(i % 100)]
+                                                                                      scope:@[@"event_value"]]]
+        ]];
+
+        UAActionScheduleInfo *info = [UAActionScheduleInfo scheduleInfoWithBuilderBlock:^(UAActionScheduleInfoBuilder *builder) {
+            builder.actions = @{ @"test_action": @"test_value" };
+            builder.limit = 1000;
+            builder.priority = i % 5;
+            builder.triggers = @[[UAScheduleTrigger customEventTriggerWithPredicate:predicate count:(i % 10) + 1],
+                                 [UAScheduleTrigger screenTriggerForScreenName:name count:(i % 5) + 1],
+                                 [UAScheduleTrigger foregroundTriggerWithCount:(i % 20) + 1]];
+        }];
+
+        [schedules addObject:[UASchedule scheduleWithIdentifier:[NSUUID UUID].UUIDString info:info metadata:@{}]];
+    }
+
+    XCTestExpectation *saved = [self expectationWithDescription:@"schedules saved"];
+    [self.automationStore saveSchedules:schedules completionHandler:^(BOOL success) {
+        XCTAssertTrue(success);
+        [saved fulfill];
+    }];
+
+    [self waitForExpectationsWithTimeout:30 handler:nil];
+}
+
+- (void)measureEventStream {
+    NSMutableArray<NSDictionary *> *reports = [NSMutableArray array];
+
+    [self measureBlock:^{
+        [reports addObject:[self replayEventStream]];
+    }];
+
+    NSData *json = [NSJSONSerialization dataWithJSONObject:reports options:NSJSONWritingPrettyPrinted error:nil];
+    XCTAttachment *attachment = [XCTAttachment attachmentWithData:json uniformTypeIdentifier:@"public.json"];
+    attachment.name = [NSString stringWithFormat:@"%@.json", self.name];
+    attachment.lifetime = XCTAttachmentLifetimeKeepAlways;
+    [self addAttachment:attachment];
+}
+
+/**
+ * Replays the event stream and waits for every event to be evaluated.
+ *
+ * @return The engine metrics report, with the allocations made per event.
+ */
+- (NSDictionary *)replayEventStream {
+    self.automationEngine.metrics = [UAAutomationEngineMetrics metrics];
+
+    // The hook is process wide, so allocations made by other threads while the stream runs are counted too
+    __atomic_store_n(&allocationCount, 0, __ATOMIC_RELAXED);
+    malloc_logger = UAAutomationEngineBenchmarkCountAllocation;
+
+    for (NSUInteger i = 0; i < kUAAutomationEngineBenchmarkEventCount; i++) {
+        switch (i % 10) {
+            case 0:
+                [self.automationEngine updateTriggersWithType:UAScheduleTriggerAppForeground argument:nil incrementAmount:1.0];
+                break;
+            case 1:
+            case 2:
+            case 3:
+                [self.automationEngine updateTriggersWithType:UAScheduleTriggerScreen argument:[self nameWithIndex:i] incrementAmount:1.0];
+                break;
+            default:
+                [self.automationEngine updateTriggersWithType:UAScheduleTriggerCustomEventCount
+                                                     argument:[self customEventPayloadWithIndex:i]
+                                              incrementAmount:1.0];
+                break;
+        }
+    }
+
+    [self.automationStore waitForIdle];
+
+    malloc_logger = NULL;
+    uint64_t allocations = __atomic_load_n(&allocationCount, __ATOMIC_RELAXED);
+
+    NSMutableDictionary *report = [[self.automationEngine metricsReport] mutableCopy];
+    report[@"allocations_per_event"] = @((double)allocations / kUAAutomationEngineBenchmarkEventCount);
+    return report;
+}
+
+- (NSString *)nameWithIndex:(NSUInteger)index {
+    return [NSString stringWithFormat:@"name_%lu", (unsigned long)(index % kUAAutomationEngineBenchmarkNameCount)];
+}
+
+- (NSDictionary *)customEventPayloadWithIndex:(NSUInteger)index {
+    return @{ @"event_name": [self nameWithIndex:index],
+              @"event_value": @(index % 100),
+              @"properties": @{ @"sku": [NSString stringWithFormat:@"SKU-%05lu", (unsigned long)index], @"category": @"travel" } };
+}
+
+@end
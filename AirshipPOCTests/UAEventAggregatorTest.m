@@ -0,0 +1,321 @@
+/* Copyright Airship and Contributors */
+
+#import <XCTest/XCTest.h>
+#import <Airship/UAEventAggregator+Internal.h>
+#import <Airship/UAEvent+Internal.h>
+#import <Airship/UACustomEvent.h>
+#import <Airship/UAScreenTrackingEvent+Internal.h>
+#import <Airship/UAAnalytics+Internal.h>
+#import <Airship/UAEventManager+Internal.h>
+#import <Airship/UARuntimeConfig+Internal.h>
+#import <Airship/UAPreferenceDataStore+Internal.h>
+#import <Airship/UAAppStateTracker.h>
+#import "UATestDate.h"
+#import "UATestDispatcher.h"
+
+// Aggregation window used by the tests
+#define kUAEventAggregatorTestWindow 60
+
+static NSString * const UAEventAggregatorTestSessionID = @"session";
+
+/**
+ * Event manager that records the added events instead of storing them.
+ */
+@interface UAEventAggregatorTestEventManager : UAEventManager
+@property (nonatomic, strong) NSMutableArray<UAEvent *> *events;
+@end
+
+@implementation UAEventAggregatorTestEventManager
+
+- (instancetype)init {
+    self = [super init];
+
+    if (self) {
+        self.events = [NSMutableArray array];
+    }
+
+    return self;
+}
+
+- (void)addEvent:(UAEvent *)event sessionID:(NSString *)sessionID {
+    [self.events addObject:event];
+}
+
+- (void)setUploadsEnabled:(BOOL)uploadsEnabled {
+}
+
+- (void)deleteAllEvents {
+}
+
+- (void)scheduleUpload {
+}
+
+- (void)cancelUpload {
+}
+
+@end
+
+/**
+ * Tests event aggregation against a test date and dispatcher.
+ */
+@interface UAEventAggregatorTest : XCTestCase
+@property (nonatomic, strong) UATestDate *testDate;
+@property (nonatomic, strong) UATestDispatcher *dispatcher;
+@property (nonatomic, strong) NSMutableArray<UACustomEvent *> *emittedEvents;
+@property (nonatomic, strong) NSMutableArray<NSString *> *emittedSessionIDs;
+@end
+
+@implementation UAEventAggregatorTest
+
+- (void)setUp {
+    [super setUp];
+
+    self.testDate = [[UATestDate alloc] initWithAbsoluteTime:[NSDate dateWithTimeIntervalSince1970:1000]];
+    self.dispatcher = [UATestDispatcher testDispatcher];
+    self.emittedEvents = [NSMutableArray array];
+    self.emittedSessionIDs = [NSMutableArray array];
+}
+
+#pragma mark -
+#pragma mark Tests
+
+- (void)testWindow {
+    UAEventAggregator *aggregator = [self aggregatorWithEventNames:@[@"purchase"] maxEntries:UAEventAggregatorDefaultMaxEntries];
+
+    XCTAssertTrue([aggregator aggregateEvent:[self eventWithName:@"purchase" value:@10 time:100] sessionID:UAEventAggregatorTestSessionID]);
+    XCTAssertTrue([aggregator aggregateEvent:[self eventWithName:@"purchase" value:@20 time:105] sessionID:UAEventAggregatorTestSessionID]);
+    XCTAssertTrue([aggregator aggregateEvent:[self eventWithName:@"purchase" value:nil time:103] sessionID:UAEventAggregatorTestSessionID]);
+
+    [self advanceTime:kUAEventAggregatorTestWindow - 1];
+    XCTAssertEqual(self.emittedEvents.count, 0);
+
+    [self advanceTime:1];
+    XCTAssertEqual(self.emittedEvents.count, 1);
+    [self assertEvent:self.emittedEvents[0] name:@"purchase" count:3 value:@30 firstTime:100 lastTime:105];
+    XCTAssertEqualObjects(self.emittedSessionIDs[0], UAEventAggregatorTestSessionID);
+}
+
+- (void)testWindowsEndSeparately {
+    UAEventAggregator *aggregator = [self aggregatorWithEventNames:@[@"purchase", @"browse"] maxEntries:UAEventAggregatorDefaultMaxEntries];
+
+    [aggregator aggregateEvent:[self eventWithName:@"purchase" value:@1 time:100] sessionID:UAEventAggregatorTestSessionID];
+    [self advanceTime:30];
+    [aggregator aggregateEvent:[self eventWithName:@"browse" value:@2 time:130] sessionID:UAEventAggregatorTestSessionID];
+
+    [self advanceTime:30];
+    XCTAssertEqual(self.emittedEvents.count, 1);
+    [self assertEvent:self.emittedEvents[0] name:@"purchase" count:1 value:@1 firstTime:100 lastTime:100];
+
+    // A new purchase aggregate starts its own window
+    [aggregator aggregateEvent:[self eventWithName:@"purchase" value:@3 time:160] sessionID:UAEventAggregatorTestSessionID];
+
+    [self advanceTime:30];
+    XCTAssertEqual(self.emittedEvents.count, 2);
+    [self assertEvent:self.emittedEvents[1] name:@"browse" count:1 value:@2 firstTime:130 lastTime:130];
+
+    [self advanceTime:30];
+    XCTAssertEqual(self.emittedEvents.count, 3);
+    [self assertEvent:self.emittedEvents[2] name:@"purchase" count:1 value:@3 firstTime:160 lastTime:160];
+}
+
+- (void)testEvictionAtMaxEntries {
+    UAEventAggregator *aggregator = [self aggregatorWithEventNames:@[@"a", @"b", @"c"] maxEntries:2];
+
+    [aggregator aggregateEvent:[self eventWithName:@"a" value:@1 time:100] sessionID:UAEventAggregatorTestSessionID];
+    [self advanceTime:1];
+    [aggregator aggregateEvent:[self eventWithName:@"b" value:@2 time:101] sessionID:UAEventAggregatorTestSessionID];
+    [self advanceTime:1];
+    [aggregator aggregateEvent:[self eventWithName:@"b" value:@2 time:102] sessionID:UAEventAggregatorTestSessionID];
+    XCTAssertEqual(self.emittedEvents.count, 0);
+
+    // The aggregate whose window ends first is evicted
+    [aggregator aggregateEvent:[self eventWithName:@"c" value:@3 time:103] sessionID:UAEventAggregatorTestSessionID];
+    XCTAssertEqual(self.emittedEvents.count, 1);
+    [self assertEvent:self.emittedEvents[0] name:@"a" count:1 value:@1 firstTime:100 lastTime:100];
+
+    [aggregator flush];
+    XCTAssertEqual(self.emittedEvents.count, 3);
+    XCTAssertEqualObjects([self emittedNames], ([NSSet setWithObjects:@"a", @"b", @"c", nil]));
+}
+
+- (void)testSessionSplit {
+    UAEventAggregator *aggregator = [self aggregatorWithEventNames:@[@"purchase"] maxEntries:UAEventAggregatorDefaultMaxEntries];
+
+    [aggregator aggregateEvent:[self eventWithName:@"purchase" value:@1 time:100] sessionID:@"first"];
+    [aggregator aggregateEvent:[self eventWithName:@"purchase" value:@1 time:101] sessionID:@"first"];
+    [aggregator aggregateEvent:[self eventWithName:@"purchase" value:@5 time:102] sessionID:@"second"];
+
+    XCTAssertEqual(self.emittedEvents.count, 1);
+    [self assertEvent:self.emittedEvents[0] name:@"purchase" count:2 value:@2 firstTime:100 lastTime:101];
+    XCTAssertEqualObjects(self.emittedSessionIDs[0], @"first");
+
+    [aggregator flush];
+    XCTAssertEqual(self.emittedEvents.count, 2);
+    [self assertEvent:self.emittedEvents[1] name:@"purchase" count:1 value:@5 firstTime:102 lastTime:102];
+    XCTAssertEqualObjects(self.emittedSessionIDs[1], @"second");
+}
+
+- (void)testValueSumSplitsBeforeOverflow {
+    UAEventAggregator *aggregator = [self aggregatorWithEventNames:@[@"purchase"] maxEntries:UAEventAggregatorDefaultMaxEntries];
+
+    [aggregator aggregateEvent:[self eventWithName:@"purchase" value:@(INT32_MAX - 1) time:100] sessionID:UAEventAggregatorTestSessionID];
+    [aggregator aggregateEvent:[self eventWithName:@"purchase" value:@1 time:101] sessionID:UAEventAggregatorTestSessionID];
+    XCTAssertEqual(self.emittedEvents.count, 0);
+
+    [aggregator aggregateEvent:[self eventWithName:@"purchase" value:@1 time:102] sessionID:UAEventAggregatorTestSessionID];
+    XCTAssertEqual(self.emittedEvents.count, 1);
+    [self assertEvent:self.emittedEvents[0] name:@"purchase" count:2 value:@(INT32_MAX) firstTime:100 lastTime:101];
+    XCTAssertTrue(self.emittedEvents[0].isValid);
+
+    // Negative sums split at the other end of the range
+    [aggregator aggregateEvent:[self eventWithName:@"purchase" value:@((int64_t)INT32_MIN - 1) time:103] sessionID:UAEventAggregatorTestSessionID];
+    XCTAssertEqual(self.emittedEvents.count, 1);
+    [aggregator aggregateEvent:[self eventWithName:@"purchase" value:@(-1) time:104] sessionID:UAEventAggregatorTestSessionID];
+    XCTAssertEqual(self.emittedEvents.count, 2);
+    [self assertEvent:self.emittedEvents[1] name:@"purchase" count:2 value:@(INT32_MIN) firstTime:102 lastTime:103];
+    XCTAssertTrue(self.emittedEvents[1].isValid);
+
+    [aggregator flush];
+    XCTAssertEqual(self.emittedEvents.count, 3);
+    [self assertEvent:self.emittedEvents[2] name:@"purchase" count:1 value:@(-1) firstTime:104 lastTime:104];
+}
+
+- (void)testScreenTracking {
+    UAEventAggregator *aggregator = [self aggregatorWithEventNames:@[kUAScreenTrackingEventType] maxEntries:UAEventAggregatorDefaultMaxEntries];
+
+    XCTAssertTrue([aggregator aggregateEvent:[self screenEventWithScreen:@"home" startTime:100 stopTime:102] sessionID:UAEventAggregatorTestSessionID]);
+    XCTAssertTrue([aggregator aggregateEvent:[self screenEventWithScreen:@"home" startTime:110 stopTime:113] sessionID:UAEventAggregatorTestSessionID]);
+    XCTAssertTrue([aggregator aggregateEvent:[self screenEventWithScreen:@"trips" startTime:120 stopTime:121] sessionID:UAEventAggregatorTestSessionID]);
+
+    // Custom events are only aggregated by name
+    XCTAssertFalse([aggregator aggregateEvent:[self eventWithName:@"purchase" value:@1 time:100] sessionID:UAEventAggregatorTestSessionID]);
+
+    [aggregator flush];
+    XCTAssertEqual(self.emittedEvents.count, 2);
+
+    for (UACustomEvent *event in self.emittedEvents) {
+        XCTAssertEqualObjects(event.eventName, kUAScreenTrackingEventType);
+        if ([event.properties[UAEventAggregatorScreenKey] isEqualToString:@"home"]) {
+            XCTAssertEqualObjects(event.properties[UAEventAggregatorCountKey], @2);
+            XCTAssertEqualObjects(event.eventValue, [NSDecimalNumber decimalNumberWithString:@"5"]);
+        } else {
+            XCTAssertEqualObjects(event.properties[UAEventAggregatorScreenKey], @"trips");
+            XCTAssertEqualObjects(event.properties[UAEventAggregatorCountKey], @1);
+            XCTAssertEqualObjects(event.eventValue, [NSDecimalNumber decimalNumberWithString:@"1"]);
+        }
+    }
+}
+
+- (void)testEventsNotAggregated {
+    UAEventAggregator *aggregator = [self aggregatorWithEventNames:@[@"purchase"] maxEntries:UAEventAggregatorDefaultMaxEntries];
+
+    XCTAssertFalse([aggregator aggregateEvent:[self eventWithName:@"browse" value:@1 time:100] sessionID:UAEventAggregatorTestSessionID]);
+
+    UACustomEvent *transaction = [self eventWithName:@"purchase" value:@1 time:100];
+    transaction.transactionID = @"transaction";
+    XCTAssertFalse([aggregator aggregateEvent:transaction sessionID:UAEventAggregatorTestSessionID]);
+
+    [aggregator flush];
+    XCTAssertEqual(self.emittedEvents.count, 0);
+}
+
+- (void)testRemoveAllAggregates {
+    UAEventAggregator *aggregator = [self aggregatorWithEventNames:@[@"purchase"] maxEntries:UAEventAggregatorDefaultMaxEntries];
+
+    [aggregator aggregateEvent:[self eventWithName:@"purchase" value:@1 time:100] sessionID:UAEventAggregatorTestSessionID];
+    [aggregator removeAllAggregates];
+
+    [self advanceTime:kUAEventAggregatorTestWindow];
+    [aggregator flush];
+    XCTAssertEqual(self.emittedEvents.count, 0);
+}
+
+- (void)testAnalyticsFlushesOnBackground {
+    UAConfig *config = [UAConfig config];
+    config.aggregatedEventNames = @[@"purchase"];
+
+    UAPreferenceDataStore *dataStore = [UAPreferenceDataStore preferenceDataStoreWithKeyPrefix:[NSUUID UUID].UUIDString];
+    UAEventAggregatorTestEventManager *eventManager = [[UAEventAggregatorTestEventManager alloc] init];
+    NSNotificationCenter *notificationCenter = [[NSNotificationCenter alloc] init];
+    UAChannel *channel = nil;
+
+    UAAnalytics *analytics = [UAAnalytics analyticsWithConfig:[[UARuntimeConfig alloc] initWithConfig:config]
+                                                    dataStore:dataStore
+                                                      channel:channel
+                                                 eventManager:eventManager
+                                           notificationCenter:notificationCenter
+                                                         date:self.testDate
+                                                   dispatcher:self.dispatcher];
+
+    [analytics addEvent:[UACustomEvent eventWithName:@"purchase" value:@10]];
+    [analytics addEvent:[UACustomEvent eventWithName:@"purchase" value:@5]];
+    XCTAssertEqual(eventManager.events.count, 0);
+
+    [notificationCenter postNotificationName:UAApplicationDidEnterBackgroundNotification object:nil];
+
+    // The aggregate is added before the background event
+    XCTAssertEqual(eventManager.events.count, 2);
+    UACustomEvent *aggregate = (UACustomEvent *)eventManager.events[0];
+    XCTAssertEqualObjects(aggregate.eventName, @"purchase");
+    XCTAssertEqualObjects(aggregate.eventValue, [NSDecimalNumber decimalNumberWithString:@"15"]);
+    XCTAssertEqualObjects(aggregate.properties[UAEventAggregatorCountKey], @2);
+    XCTAssertEqualObjects(eventManager.events[1].eventType, @"app_background");
+
+    [dataStore removeAll];
+}
+
+#pragma mark -
+#pragma mark Helpers
+
+- (UAEventAggregator *)aggregatorWithEventNames:(NSArray<NSString *> *)eventNames maxEntries:(NSUInteger)maxEntries {
+    return [UAEventAggregator aggregatorWithEventNames:eventNames
+                                                window:kUAEventAggregatorTestWindow
+                                            maxEntries:maxEntries
+                                                  date:self.testDate
+                                            dispatcher:self.dispatcher
+                                          eventHandler:^(UAEvent *event, NSString *sessionID) {
+        [self.emittedEvents addObject:(UACustomEvent *)event];
+        [self.emittedSessionIDs addObject:sessionID];
+    }];
+}
+
+- (void)advanceTime:(NSTimeInterval)time {
+    self.testDate.offset += time;
+    [self.dispatcher advanceTime:time];
+}
+
+- (UACustomEvent *)eventWithName:(NSString *)name value:(nullable NSNumber *)value time:(NSTimeInterval)time {
+    UACustomEvent *event = [UACustomEvent eventWithName:name value:value];
+    event.time = [NSString stringWithFormat:@"%f", time];
+    return event;
+}
+
+- (UAScreenTrackingEvent *)screenEventWithScreen:(NSString *)screen startTime:(NSTimeInterval)startTime stopTime:(NSTimeInterval)stopTime {
+    UAScreenTrackingEvent *event = [UAScreenTrackingEvent eventWithScreen:screen startTime:startTime];
+    event.stopTime = stopTime;
+    event.time = [NSString stringWithFormat:@"%f", stopTime];
+    return event;
+}
+
+- (NSSet<NSString *> *)emittedNames {
+    NSMutableSet<NSString *> *names = [NSMutableSet set];
+    for (UACustomEvent *event in self.emittedEvents) {
+        [names addObject:event.eventName];
+    }
+    return names;
+}
+
+- (void)assertEvent:(UACustomEvent *)event
+               name:(NSString *)name
+              count:(NSUInteger)count
+              value:(NSNumber *)value
+          firstTime:(NSTimeInterval)firstTime
+           lastTime:(NSTimeInterval)lastTime {
+    XCTAssertEqualObjects(event.eventName, name);
+    XCTAssertEqualObjects(event.properties[UAEventAggregatorCountKey], @(count));
+    XCTAssertEqual([event.eventValue compare:value], NSOrderedSame, @"Expected value %@, got %@", value, event.eventValue);
+    XCTAssertEqualWithAccuracy([event.properties[UAEventAggregatorFirstTimeKey] doubleValue], firstTime, 0.001);
+    XCTAssertEqualWithAccuracy([event.properties[UAEventAggregatorLastTimeKey] doubleValue], lastTime, 0.001);
+}
+
+@end
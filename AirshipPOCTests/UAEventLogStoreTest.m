@@ -0,0 +1,258 @@
+/* Copyright Airship and Contributors */
+
+#import <XCTest/XCTest.h>
+#import <Airship/UAEventLogStore+Internal.h>
+#import <Airship/UACustomEvent.h>
+
+// Large enough to hold every event the tests save in one segment
+#define kUAEventLogStoreTestLargeSegmentSize (64 * 1024)
+
+// Smaller than any record, so each event gets a segment of its own
+#define kUAEventLogStoreTestSmallSegmentSize 1
+
+// Max upload batch size in bytes
+#define kUAEventLogStoreTestMaxBatchSize (500 * 1024)
+
+static NSString * const UAEventLogStoreTestSessionID = @"session";
+
+/**
+ * Tests the event log recovering from torn and corrupt records, and keeping its read cursor across
+ * reopens, by reopening the log directory after changing the segment files.
+ */
+@interface UAEventLogStoreTest : XCTestCase
+@property (nonatomic, strong) NSURL *directoryURL;
+@property (nonatomic, assign) NSUInteger segmentSize;
+@property (nonatomic, strong) UAEventLogStore *store;
+@end
+
+@implementation UAEventLogStoreTest
+
+- (void)setUp {
+    [super setUp];
+
+    NSString *name = [NSString stringWithFormat:@"Events-%@.log", [NSUUID UUID].UUIDString];
+    self.directoryURL = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:name]];
+}
+
+- (void)tearDown {
+    self.store = nil;
+    [[NSFileManager defaultManager] removeItemAtURL:self.directoryURL error:nil];
+    [super tearDown];
+}
+
+#pragma mark -
+#pragma mark Tests
+
+- (void)testTornRecordIsTruncated {
+    [self openWithSegmentSize:kUAEventLogStoreTestLargeSegmentSize];
+    NSArray<NSString *> *eventIDs = [self saveEvents:3];
+
+    // A record header claiming more bytes than follow it
+    [self reopenAfterChangingStore:^{
+        NSMutableData *garbage = [NSMutableData dataWithLength:20];
+        memset(garbage.mutableBytes, 0xFF, garbage.length);
+        [self appendData:garbage toSegmentURL:[self segmentURLs].lastObject];
+    }];
+
+    XCTAssertEqualObjects([self fetchEventIDs], eventIDs);
+
+    // Records appended after the truncation are readable
+    NSArray<NSString *> *moreEventIDs = [self saveEvents:1];
+    XCTAssertEqualObjects([self fetchEventIDs], [eventIDs arrayByAddingObjectsFromArray:moreEventIDs]);
+
+    [self reopenAfterChangingStore:nil];
+    XCTAssertEqualObjects([self fetchEventIDs], [eventIDs arrayByAddingObjectsFromArray:moreEventIDs]);
+}
+
+- (void)testRecordFailingCRCIsTruncated {
+    [self openWithSegmentSize:kUAEventLogStoreTestLargeSegmentSize];
+    NSArray<NSString *> *eventIDs = [self saveEvents:3];
+
+    // Flips the last byte of the last record's payload
+    [self reopenAfterChangingStore:^{
+        NSURL *segmentURL = [self segmentURLs].lastObject;
+        [self flipByteAtOffset:[self sizeOfSegmentURL:segmentURL] - 1 ofSegmentURL:segmentURL];
+    }];
+
+    XCTAssertEqualObjects([self fetchEventIDs], [eventIDs subarrayWithRange:NSMakeRange(0, 2)]);
+
+    NSArray<NSString *> *moreEventIDs = [self saveEvents:1];
+    [self reopenAfterChangingStore:nil];
+    XCTAssertEqualObjects([self fetchEventIDs], [[eventIDs subarrayWithRange:NSMakeRange(0, 2)] arrayByAddingObjectsFromArray:moreEventIDs]);
+}
+
+- (void)testCursorPersistsAcrossReopen {
+    [self openWithSegmentSize:kUAEventLogStoreTestLargeSegmentSize];
+    NSArray<NSString *> *eventIDs = [self saveEvents:5];
+
+    XCTAssertEqualObjects([self fetchEventIDs], eventIDs);
+    [self.store deleteEventsWithIDs:[eventIDs subarrayWithRange:NSMakeRange(0, 2)]];
+
+    [self reopenAfterChangingStore:nil];
+    XCTAssertEqualObjects([self fetchEventIDs], [eventIDs subarrayWithRange:NSMakeRange(2, 3)]);
+}
+
+- (void)testCursorPersistsAcrossSegments {
+    [self openWithSegmentSize:kUAEventLogStoreTestSmallSegmentSize];
+    NSArray<NSString *> *eventIDs = [self saveEvents:4];
+    XCTAssertEqual([self segmentURLs].count, 4);
+
+    XCTAssertEqualObjects([self fetchEventIDs], eventIDs);
+    [self.store deleteEventsWithIDs:[eventIDs subarrayWithRange:NSMakeRange(0, 3)]];
+
+    // Fully read segments are dropped
+    [self reopenAfterChangingStore:nil];
+    XCTAssertEqual([self segmentURLs].count, 1);
+    XCTAssertEqualObjects([self fetchEventIDs], [eventIDs subarrayWithRange:NSMakeRange(3, 1)]);
+}
+
+- (void)testOutOfOrderDelete {
+    [self openWithSegmentSize:kUAEventLogStoreTestLargeSegmentSize];
+    NSArray<NSString *> *eventIDs = [self saveEvents:4];
+    XCTAssertEqualObjects([self fetchEventIDs], eventIDs);
+
+    // The cursor can't move past the first event until it is deleted
+    [self.store deleteEventsWithIDs:@[eventIDs[1], eventIDs[2]]];
+    [self reopenAfterChangingStore:nil];
+    XCTAssertEqualObjects([self fetchEventIDs], eventIDs);
+
+    [self.store deleteEventsWithIDs:@[eventIDs[2]]];
+    [self.store deleteEventsWithIDs:@[eventIDs[0]]];
+    [self.store deleteEventsWithIDs:@[eventIDs[1]]];
+
+    [self reopenAfterChangingStore:nil];
+    XCTAssertEqualObjects([self fetchEventIDs], [eventIDs subarrayWithRange:NSMakeRange(3, 1)]);
+}
+
+- (void)testTrimDropsWholeSegments {
+    [self openWithSegmentSize:kUAEventLogStoreTestSmallSegmentSize];
+    NSArray<NSString *> *eventIDs = [self saveEvents:4];
+
+    // Room for two and a half events, so the two oldest segments are dropped
+    uint64_t segmentSize = [self sizeOfSegmentURL:[self segmentURLs].firstObject];
+    [self.store trimEventsToStoreSize:(NSUInteger)(segmentSize * 5 / 2)];
+
+    XCTAssertEqualObjects([self fetchEventIDs], [eventIDs subarrayWithRange:NSMakeRange(2, 2)]);
+    XCTAssertEqual([self segmentURLs].count, 2);
+
+    [self reopenAfterChangingStore:nil];
+    XCTAssertEqualObjects([self fetchEventIDs], [eventIDs subarrayWithRange:NSMakeRange(2, 2)]);
+}
+
+- (void)testTrimRollsLastSegment {
+    [self openWithSegmentSize:kUAEventLogStoreTestLargeSegmentSize];
+    [self saveEvents:3];
+
+    // Every event is in the segment being written, so a new segment is started to drop it
+    [self.store trimEventsToStoreSize:1];
+    XCTAssertEqualObjects([self fetchEventIDs], @[]);
+    XCTAssertEqual([self segmentURLs].count, 1);
+
+    NSArray<NSString *> *moreEventIDs = [self saveEvents:2];
+    XCTAssertEqualObjects([self fetchEventIDs], moreEventIDs);
+
+    [self reopenAfterChangingStore:nil];
+    XCTAssertEqualObjects([self fetchEventIDs], moreEventIDs);
+}
+
+- (void)testCorruptSegmentIsSkipped {
+    [self openWithSegmentSize:kUAEventLogStoreTestSmallSegmentSize];
+    NSArray<NSString *> *eventIDs = [self saveEvents:3];
+
+    // Only the last segment is checked on open, so the corrupt record is found while reading
+    [self reopenAfterChangingStore:^{
+        NSURL *segmentURL = [self segmentURLs].firstObject;
+        [self flipByteAtOffset:[self sizeOfSegmentURL:segmentURL] - 1 ofSegmentURL:segmentURL];
+    }];
+
+    XCTAssertEqualObjects([self fetchEventIDs], [eventIDs subarrayWithRange:NSMakeRange(1, 2)]);
+
+    [self.store deleteEventsWithIDs:@[eventIDs[1]]];
+    [self reopenAfterChangingStore:nil];
+    XCTAssertEqualObjects([self fetchEventIDs], [eventIDs subarrayWithRange:NSMakeRange(2, 1)]);
+}
+
+#pragma mark -
+#pragma mark Helpers
+
+- (void)openWithSegmentSize:(NSUInteger)segmentSize {
+    self.segmentSize = segmentSize;
+    self.store = [UAEventLogStore eventLogStoreWithDirectoryURL:self.directoryURL segmentSize:segmentSize];
+}
+
+/**
+ * Waits for the store's pending work, closes it, optionally changes the segment files, then opens the
+ * directory again.
+ */
+- (void)reopenAfterChangingStore:(nullable void (^)(void))block {
+    [self fetchEventIDs];
+    self.store = nil;
+
+    if (block) {
+        block();
+    }
+
+    [self openWithSegmentSize:self.segmentSize];
+}
+
+/**
+ * Saves events and waits for them to be written.
+ *
+ * @return The event IDs, in the order they were saved.
+ */
+- (NSArray<NSString *> *)saveEvents:(NSUInteger)count {
+    NSMutableArray<NSString *> *eventIDs = [NSMutableArray arrayWithCapacity:count];
+    for (NSUInteger i = 0; i < count; i++) {
+        UACustomEvent *event = [UACustomEvent eventWithName:@"log" value:@(i)];
+        [self.store saveEvent:event sessionID:UAEventLogStoreTestSessionID];
+        [eventIDs addObject:event.eventID];
+    }
+
+    [self fetchEventIDs];
+    return eventIDs;
+}
+
+- (NSArray<NSString *> *)fetchEventIDs {
+    NSMutableArray<NSString *> *eventIDs = [NSMutableArray array];
+    XCTestExpectation *fetched = [self expectationWithDescription:@"fetched"];
+    [self.store fetchEventsWithMaxBatchSize:kUAEventLogStoreTestMaxBatchSize completionHandler:^(NSArray<id<UAEventStoreEvent>> *events) {
+        for (id<UAEventStoreEvent> event in events) {
+            XCTAssertNotNil(event.uploadFragment);
+            [eventIDs addObject:event.identifier];
+        }
+        [fetched fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:10 handler:nil];
+
+    return eventIDs;
+}
+
+- (NSArray<NSURL *> *)segmentURLs {
+    NSArray<NSURL *> *contents = [[NSFileManager defaultManager] contentsOfDirectoryAtURL:self.directoryURL
+                                                               includingPropertiesForKeys:nil
+                                                                                  options:0
+                                                                                    error:nil];
+
+    NSPredicate *predicate = [NSPredicate predicateWithFormat:@"pathExtension == 'segment'"];
+    NSSortDescriptor *sortDescriptor = [NSSortDescriptor sortDescriptorWithKey:@"lastPathComponent" ascending:YES];
+    return [[contents filteredArrayUsingPredicate:predicate] sortedArrayUsingDescriptors:@[sortDescriptor]];
+}
+
+- (uint64_t)sizeOfSegmentURL:(NSURL *)segmentURL {
+    return [[NSFileManager defaultManager] attributesOfItemAtPath:segmentURL.path error:nil].fileSize;
+}
+
+- (void)appendData:(NSData *)data toSegmentURL:(NSURL *)segmentURL {
+    NSFileHandle *handle = [NSFileHandle fileHandleForWritingToURL:segmentURL error:nil];
+    [handle seekToEndOfFile];
+    [handle writeData:data];
+    [handle closeFile];
+}
+
+- (void)flipByteAtOffset:(uint64_t)offset ofSegmentURL:(NSURL *)segmentURL {
+    NSMutableData *data = [NSMutableData dataWithContentsOfURL:segmentURL];
+    ((uint8_t *)data.mutableBytes)[offset] ^= 0xFF;
+    [data writeToURL:segmentURL atomically:YES];
+}
+
+@end
@@ -0,0 +1,179 @@
+/* Copyright Airship and Contributors */
+
+#import <XCTest/XCTest.h>
+#import <Airship/UAEventStore+Internal.h>
+#import <Airship/UAEventLogStore+Internal.h>
+#import <Airship/UACustomEvent.h>
+
+// Number of events saved and drained per measurement
+#define kUAEventStoreBenchmarkEventCount 1000
+
+// Max upload batch size in bytes
+#define kUAEventStoreBenchmarkMaxBatchSize (500 * 1024)
+
+static NSString * const UAEventStoreBenchmarkSessionID = @"benchmark";
+
+/**
+ * Times the Core Data event store and the event log saving a burst of events, then draining them the
+ * way the event manager does: fetch a batch, delete it, repeat until empty.
+ */
+@interface UAEventStoreBenchmarkTest : XCTestCase
+@property (nonatomic, strong) UAEventStore *eventStore;
+@property (nonatomic, strong) NSURL *logDirectoryURL;
+@end
+
+@implementation UAEventStoreBenchmarkTest
+
+- (void)setUp {
+    [super setUp];
+
+    NSString *name = [NSUUID UUID].UUIDString;
+    self.eventStore = [UAEventStore eventStoreWithStoreName:[NSString stringWithFormat:@"Events-%@.sqlite", name]];
+    self.logDirectoryURL = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:[NSString stringWithFormat:@"Events-%@.log", name]]];
+}
+
+- (void)tearDown {
+    [[NSFileManager defaultManager] removeItemAtURL:self.logDirectoryURL error:nil];
+
+    // Destroys the scratch Core Data store
+    XCTestExpectation *destroyed = [self expectationWithDescription:@"store destroyed"];
+    [self.eventStore drainEventsWithBlock:^NSUInteger(NSArray<UAEventData *> *events) {
+        return events.count;
+    } completionHandler:^{
+        [destroyed fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:10 handler:nil];
+
+    [super tearDown];
+}
+
+#pragma mark -
+#pragma mark Tests
+
+- (void)testDrainKeepsUndrainedEvents {
+    UAEventStore *eventStore = self.eventStore;
+    for (NSUInteger i = 0; i < 3; i++) {
+        [eventStore saveEvent:[UACustomEvent eventWithName:@"drain" value:@(i)] sessionID:UAEventStoreBenchmarkSessionID];
+    }
+
+    XCTestExpectation *drained = [self expectationWithDescription:@"drained"];
+    [eventStore drainEventsWithBlock:^NSUInteger(NSArray<UAEventData *> *events) {
+        XCTAssertEqual(events.count, 3);
+        return 1;
+    } completionHandler:^{
+        [drained fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:10 handler:nil];
+
+    XCTestExpectation *fetched = [self expectationWithDescription:@"fetched"];
+    [eventStore fetchEventsWithMaxBatchSize:kUAEventStoreBenchmarkMaxBatchSize completionHandler:^(NSArray<id<UAEventStoreEvent>> *events) {
+        XCTAssertEqual(events.count, 2);
+        [fetched fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:10 handler:nil];
+}
+
+#pragma mark -
+#pragma mark Benchmarks
+
+- (void)testCoreDataStoreSavePerformance {
+    [self measureSaveWithStore:self.eventStore];
+}
+
+- (void)testEventLogStoreSavePerformance {
+    UAEventLogStore *eventLogStore = [UAEventLogStore eventLogStoreWithDirectoryURL:self.logDirectoryURL
+                                                                        segmentSize:UAEventLogStoreDefaultSegmentSize];
+    [self measureSaveWithStore:eventLogStore];
+}
+
+- (void)testCoreDataStoreDrainPerformance {
+    [self measureDrainWithStore:self.eventStore];
+}
+
+- (void)testEventLogStoreDrainPerformance {
+    UAEventLogStore *eventLogStore = [UAEventLogStore eventLogStoreWithDirectoryURL:self.logDirectoryURL
+                                                                        segmentSize:UAEventLogStoreDefaultSegmentSize];
+    [self measureDrainWithStore:eventLogStore];
+}
+
+#pragma mark -
+#pragma mark Helpers
+
+- (void)measureSaveWithStore:(id<UAEventStoreProtocol>)store {
+    [self measureMetrics:[[self class] defaultPerformanceMetrics] automaticallyStartMeasuring:NO forBlock:^{
+        [store deleteAllEvents];
+        [self waitForStore:store];
+
+        // Saves are asynchronous, so the time runs until a fetch queued behind them returns
+        [self startMeasuring];
+        [self saveEventsToStore:store];
+        [self waitForStore:store];
+        [self stopMeasuring];
+    }];
+}
+
+- (void)measureDrainWithStore:(id<UAEventStoreProtocol>)store {
+    [self measureMetrics:[[self class] defaultPerformanceMetrics] automaticallyStartMeasuring:NO forBlock:^{
+        [store deleteAllEvents];
+        [self saveEventsToStore:store];
+        [self waitForStore:store];
+
+        [self startMeasuring];
+        NSUInteger batches = [self drainStore:store];
+        [self stopMeasuring];
+
+        XCTAssertGreaterThan(batches, 0);
+    }];
+}
+
+- (void)saveEventsToStore:(id<UAEventStoreProtocol>)store {
+    for (NSUInteger i = 0; i < kUAEventStoreBenchmarkEventCount; i++) {
+        [store saveEvent:[UACustomEvent eventWithName:@"benchmark" value:@(i)] sessionID:UAEventStoreBenchmarkSessionID];
+    }
+}
+
+- (void)waitForStore:(id<UAEventStoreProtocol>)store {
+    XCTestExpectation *fetched = [self expectationWithDescription:@"fetched"];
+    [store fetchEventsWithMaxBatchSize:kUAEventStoreBenchmarkMaxBatchSize completionHandler:^(NSArray<id<UAEventStoreEvent>> *events) {
+        [fetched fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:30 handler:nil];
+}
+
+/**
+ * Fetches and deletes batches until the store is empty.
+ *
+ * @return The number of batches.
+ */
+- (NSUInteger)drainStore:(id<UAEventStoreProtocol>)store {
+    NSUInteger batches = 0;
+
+    // A store that never empties would otherwise loop forever
+    while (batches <= kUAEventStoreBenchmarkEventCount) {
+        __block NSArray<id<UAEventStoreEvent>> *batch;
+        XCTestExpectation *fetched = [self expectationWithDescription:@"fetched"];
+        [store fetchEventsWithMaxBatchSize:kUAEventStoreBenchmarkMaxBatchSize completionHandler:^(NSArray<id<UAEventStoreEvent>> *events) {
+            batch = events;
+            [fetched fulfill];
+        }];
+        [self waitForExpectationsWithTimeout:30 handler:nil];
+
+        if (!batch.count) {
+            break;
+        }
+
+        NSMutableArray<NSString *> *eventIDs = [NSMutableArray arrayWithCapacity:batch.count];
+        for (id<UAEventStoreEvent> event in batch) {
+            if (event.identifier) {
+                [eventIDs addObject:event.identifier];
+            }
+        }
+
+        [store deleteEventsWithIDs:eventIDs];
+        batches++;
+    }
+
+    return batches;
+}
+
+@end
@@ -0,0 +1,242 @@
+/* Copyright Airship and Contributors */
+
+#import <XCTest/XCTest.h>
+#import <zlib.h>
+#import <Airship/UAGzipWriter+Internal.h>
+
+// Number of events in a full upload batch
+#define kUAGzipWriterTestBatchSize 500
+
+// Number of registration payloads compressed per measurement
+#define kUAGzipWriterTestRegistrationCount 200
+
+@interface UAGzipWriterTest : XCTestCase
+@property (nonatomic, copy) NSArray<NSData *> *eventFragments;
+@property (nonatomic, copy) NSData *registrationPayload;
+@end
+
+@implementation UAGzipWriterTest
+
+- (void)setUp {
+    [super setUp];
+
+    NSMutableArray<NSData *> *fragments = [NSMutableArray array];
+    for (NSUInteger i = 0; i < kUAGzipWriterTestBatchSize; i++) {
+        [fragments addObject:[NSJSONSerialization dataWithJSONObject:[self eventWithIndex:i] options:0 error:nil]];
+    }
+    self.eventFragments = fragments;
+
+    self.registrationPayload = [NSJSONSerialization dataWithJSONObject:[self registrationPayloadObject] options:0 error:nil];
+}
+
+#pragma mark -
+#pragma mark Tests
+
+- (void)testGzipDataRoundTrip {
+    NSData *compressed = [UAGzipWriter gzipData:self.registrationPayload];
+
+    XCTAssertNotNil(compressed);
+    XCTAssertEqualObjects([self gunzip:compressed], self.registrationPayload);
+}
+
+- (void)testStreamingMatchesBody {
+    UAGzipWriter *writer = [UAGzipWriter writerWithExpectedLength:[self eventBatchBody].length];
+    [self writeEventBatch:writer];
+    NSData *compressed = [writer finish];
+
+    XCTAssertNotNil(compressed);
+    XCTAssertEqualObjects([self gunzip:compressed], [self eventBatchBody]);
+}
+
+- (void)testOutgrowsExpectedLength {
+    // Random bytes do not compress, so the output outgrows a buffer sized for a tiny payload
+    NSMutableData *data = [NSMutableData dataWithLength:256 * 1024];
+    arc4random_buf(data.mutableBytes, data.length);
+
+    UAGzipWriter *writer = [UAGzipWriter writerWithExpectedLength:16];
+    XCTAssertTrue([writer appendData:data]);
+    NSData *compressed = [writer finish];
+
+    XCTAssertEqualObjects([self gunzip:compressed], data);
+}
+
+- (void)testPooledWritersAreReset {
+    for (NSUInteger i = 0; i < 5; i++) {
+        NSData *compressed = [UAGzipWriter gzipData:self.registrationPayload];
+        XCTAssertEqualObjects([self gunzip:compressed], self.registrationPayload);
+    }
+}
+
+- (void)testFinishWithoutDataReturnsNil {
+    UAGzipWriter *writer = [UAGzipWriter writer];
+
+    XCTAssertNil([writer finish]);
+    XCTAssertFalse([writer appendData:self.registrationPayload]);
+}
+
+#pragma mark -
+#pragma mark Benchmarks
+
+- (void)testEventBatchPerformance {
+    NSUInteger expectedLength = [self eventBatchBody].length;
+
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < 10; i++) {
+            UAGzipWriter *writer = [UAGzipWriter writerWithExpectedLength:expectedLength];
+            [self writeEventBatch:writer];
+            [writer finish];
+        }
+    }];
+}
+
+- (void)testEventBatchUnpooledPerformance {
+    // Baseline: a fresh deflate stream per request over the fully built body
+    NSData *body = [self eventBatchBody];
+
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < 10; i++) {
+            [self unpooledGzip:body];
+        }
+    }];
+}
+
+- (void)testRegistrationPayloadPerformance {
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < kUAGzipWriterTestRegistrationCount; i++) {
+            [UAGzipWriter gzipData:self.registrationPayload];
+        }
+    }];
+}
+
+- (void)testRegistrationPayloadUnpooledPerformance {
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < kUAGzipWriterTestRegistrationCount; i++) {
+            [self unpooledGzip:self.registrationPayload];
+        }
+    }];
+}
+
+#pragma mark -
+#pragma mark Helpers
+
+- (NSDictionary *)eventWithIndex:(NSUInteger)index {
+    return @{
+        @"type": index % 3 ? @"enhanced_custom_event" : @"screen_tracking",
+        @"event_id": [NSUUID UUID].UUIDString,
+        @"time": [NSString stringWithFormat:@"%f", [[NSDate date] timeIntervalSince1970] + index],
+        @"data": @{
+            @"session_id": @"9F2E7F4C-5A4B-4E55-9B0C-1B3A2F6B8C11",
+            @"event_name": [NSString stringWithFormat:@"purchase_%lu", (unsigned long)(index % 10)],
+            @"event_value": @(index * 100),
+            @"properties": @{ @"sku": [NSString stringWithFormat:@"SKU-%05lu", (unsigned long)index], @"category": @"travel" },
+            @"screen": @"home",
+            @"previous_screen": @"trips",
+            @"duration": @"12.500",
+        }
+    };
+}
+
+- (NSDictionary *)registrationPayloadObject {
+    NSMutableArray *tags = [NSMutableArray array];
+    for (NSUInteger i = 0; i < 50; i++) {
+        [tags addObject:[NSString stringWithFormat:@"tag-%lu", (unsigned long)i]];
+    }
+
+    return @{
+        @"channel": @{
+            @"device_type": @"ios",
+            @"opt_in": @YES,
+            @"background": @YES,
+            @"push_address": @"5f0e7a3c1d2b4a6e8f9c0b1a2d3e4f5a6b7c8d9e0f1a2b3c4d5e6f7a8b9c0d1e",
+            @"set_tags": @YES,
+            @"tags": tags,
+            @"timezone": @"America/Chicago",
+            @"locale_language": @"en",
+            @"locale_country": @"US",
+            @"app_version": @"1.0",
+            @"sdk_version": @"13.3.0",
+            @"device_model": @"iPhone12,1",
+            @"carrier": @"Carrier",
+            @"ios": @{ @"badge": @0, @"quiet_time": @{ @"start": @"22:00", @"end": @"07:00" }, @"tz": @"America/Chicago" }
+        },
+        @"identity_hints": @{ @"user_id": @"user-1234" }
+    };
+}
+
+- (void)writeEventBatch:(id<UARequestBodyWriter>)writer {
+    [writer appendBytes:"[" length:1];
+    for (NSUInteger i = 0; i < self.eventFragments.count; i++) {
+        if (i > 0) {
+            [writer appendBytes:"," length:1];
+        }
+        [writer appendData:self.eventFragments[i]];
+    }
+    [writer appendBytes:"]" length:1];
+}
+
+- (NSData *)eventBatchBody {
+    NSMutableData *body = [NSMutableData data];
+    [body appendBytes:"[" length:1];
+    for (NSUInteger i = 0; i < self.eventFragments.count; i++) {
+        if (i > 0) {
+            [body appendBytes:"," length:1];
+        }
+        [body appendData:self.eventFragments[i]];
+    }
+    [body appendBytes:"]" length:1];
+    return body;
+}
+
+- (NSData *)unpooledGzip:(NSData *)data {
+    z_stream stream = {0};
+    deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY);
+
+    NSMutableData *compressed = [NSMutableData dataWithLength:16384];
+    stream.next_in = (Bytef *)data.bytes;
+    stream.avail_in = (uInt)data.length;
+
+    do {
+        if (stream.total_out >= compressed.length) {
+            [compressed increaseLengthBy:16384];
+        }
+        stream.next_out = (Bytef *)compressed.mutableBytes + stream.total_out;
+        stream.avail_out = (uInt)(compressed.length - stream.total_out);
+        deflate(&stream, Z_FINISH);
+    } while (stream.avail_out == 0);
+
+    compressed.length = stream.total_out;
+    deflateEnd(&stream);
+    return compressed;
+}
+
+- (NSData *)gunzip:(NSData *)data {
+    z_stream stream = {0};
+    if (inflateInit2(&stream, 15 + 16) != Z_OK) {
+        return nil;
+    }
+
+    NSMutableData *inflated = [NSMutableData dataWithLength:data.length * 4 + 1024];
+    stream.next_in = (Bytef *)data.bytes;
+    stream.avail_in = (uInt)data.length;
+
+    int status;
+    do {
+        if (stream.total_out >= inflated.length) {
+            inflated.length = inflated.length * 2;
+        }
+        stream.next_out = (Bytef *)inflated.mutableBytes + stream.total_out;
+        stream.avail_out = (uInt)(inflated.length - stream.total_out);
+        status = inflate(&stream, Z_NO_FLUSH);
+    } while (status == Z_OK);
+
+    inflateEnd(&stream);
+
+    if (status != Z_STREAM_END) {
+        return nil;
+    }
+
+    inflated.length = stream.total_out;
+    return inflated;
+}
+
+@end
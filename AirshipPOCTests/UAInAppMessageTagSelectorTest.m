@@ -0,0 +1,152 @@
+/* Copyright Airship and Contributors */
+
+#import <XCTest/XCTest.h>
+#import <Airship/UAInAppMessageTagSelector+Internal.h>
+#import <Airship/UATagGroups.h>
+
+// Number of generated selectors in the differential corpus
+#define kUAInAppMessageTagSelectorTestSelectorCount 300
+
+// Number of generated tag sets each selector is applied to
+#define kUAInAppMessageTagSelectorTestTagSetCount 50
+
+/**
+ * Differential tests of the compiled tag selector programs against the tree evaluator.
+ */
+@interface UAInAppMessageTagSelectorTest : XCTestCase
+@property (nonatomic, assign) unsigned int seed;
+@end
+
+@implementation UAInAppMessageTagSelectorTest
+
+- (void)setUp {
+    [super setUp];
+
+    // Fixed seed so a failure can be reproduced
+    self.seed = 20200108;
+}
+
+#pragma mark -
+#pragma mark Tests
+
+- (void)testApplyResults {
+    UAInAppMessageTagSelector *selector = [UAInAppMessageTagSelector and:@[[UAInAppMessageTagSelector tag:@"vip"],
+                                                                           [UAInAppMessageTagSelector not:[UAInAppMessageTagSelector tag:@"churned" group:@"lifecycle"]]]];
+
+    UATagGroups *tagGroups = [UATagGroups tagGroupsWithTags:@{ @"lifecycle": @[@"churned"] }];
+
+    XCTAssertTrue([selector apply:@[@"vip"] tagGroups:nil]);
+    XCTAssertFalse([selector apply:@[@"vip"] tagGroups:tagGroups]);
+    XCTAssertFalse([selector apply:@[@"new"] tagGroups:nil]);
+    XCTAssertFalse([selector apply:@[] tagGroups:nil]);
+}
+
+- (void)testGeneratedSelectorsMatchTreeEvaluator {
+    NSMutableArray<NSArray<NSString *> *> *tagSets = [NSMutableArray arrayWithObject:@[]];
+    NSMutableArray<UATagGroups *> *tagGroupSets = [NSMutableArray arrayWithObject:[UATagGroups tagGroupsWithTags:@{}]];
+    for (NSUInteger i = 0; i < kUAInAppMessageTagSelectorTestTagSetCount; i++) {
+        [tagSets addObject:[self randomTags]];
+        [tagGroupSets addObject:[self randomTagGroups]];
+    }
+
+    for (NSUInteger i = 0; i < kUAInAppMessageTagSelectorTestSelectorCount; i++) {
+        UAInAppMessageTagSelector *selector = [self randomSelectorWithDepth:3];
+
+        for (NSUInteger j = 0; j < tagSets.count; j++) {
+            [self assertSelector:selector matchesTreeWithTags:tagSets[j] tagGroups:tagGroupSets[j]];
+            [self assertSelector:selector matchesTreeWithTags:tagSets[j] tagGroups:nil];
+        }
+    }
+}
+
+- (void)testTagsInternedAfterCompileMatchTreeEvaluator {
+    NSString *tag = [NSUUID UUID].UUIDString;
+    UAInAppMessageTagSelector *selector = [UAInAppMessageTagSelector or:@[[UAInAppMessageTagSelector tag:@"vip"],
+                                                                          [UAInAppMessageTagSelector not:[UAInAppMessageTagSelector tag:tag]]]];
+
+    // Compiles the program before the later selectors intern more tags
+    [self assertSelector:selector matchesTreeWithTags:@[@"vip"] tagGroups:nil];
+
+    for (NSUInteger i = 0; i < 100; i++) {
+        NSString *otherTag = [NSUUID UUID].UUIDString;
+        [[UAInAppMessageTagSelector tag:otherTag] apply:@[otherTag] tagGroups:nil];
+    }
+
+    [self assertSelector:selector matchesTreeWithTags:@[tag] tagGroups:nil];
+    [self assertSelector:selector matchesTreeWithTags:@[tag, @"vip"] tagGroups:nil];
+    [self assertSelector:selector matchesTreeWithTags:@[@"new"] tagGroups:nil];
+}
+
+- (void)testJSONRoundTripMatchesTreeEvaluator {
+    for (NSUInteger i = 0; i < 50; i++) {
+        UAInAppMessageTagSelector *selector = [self randomSelectorWithDepth:3];
+
+        NSError *error;
+        UAInAppMessageTagSelector *parsed = [UAInAppMessageTagSelector selectorWithJSON:[selector toJSON] error:&error];
+        XCTAssertNotNil(parsed, @"Invalid selector %@: %@", [selector toJSON], error);
+
+        NSArray<NSString *> *tags = [self randomTags];
+        UATagGroups *tagGroups = [self randomTagGroups];
+        XCTAssertEqual([parsed apply:tags tagGroups:tagGroups], [selector applyTree:tags tagGroups:tagGroups]);
+    }
+}
+
+#pragma mark -
+#pragma mark Helpers
+
+- (void)assertSelector:(UAInAppMessageTagSelector *)selector matchesTreeWithTags:(NSArray<NSString *> *)tags tagGroups:(UATagGroups *)tagGroups {
+    XCTAssertEqual([selector apply:tags tagGroups:tagGroups], [selector applyTree:tags tagGroups:tagGroups],
+                   @"Selector %@ disagrees with the tree evaluator for tags %@ and tag groups %@", [selector toJSON], tags, tagGroups.tags);
+}
+
+- (NSUInteger)randomBelow:(NSUInteger)bound {
+    return (NSUInteger)rand_r(&_seed) % bound;
+}
+
+- (NSString *)randomTag {
+    return [NSString stringWithFormat:@"tag-%lu", (unsigned long)[self randomBelow:12]];
+}
+
+- (NSString *)randomGroup {
+    return [NSString stringWithFormat:@"group-%lu", (unsigned long)[self randomBelow:3]];
+}
+
+- (NSArray<NSString *> *)randomTags {
+    NSMutableArray<NSString *> *tags = [NSMutableArray array];
+    NSUInteger count = [self randomBelow:8];
+    for (NSUInteger i = 0; i < count; i++) {
+        [tags addObject:[self randomTag]];
+    }
+    return tags;
+}
+
+- (UATagGroups *)randomTagGroups {
+    NSMutableDictionary<NSString *, NSArray<NSString *> *> *tags = [NSMutableDictionary dictionary];
+    NSUInteger count = [self randomBelow:4];
+    for (NSUInteger i = 0; i < count; i++) {
+        tags[[self randomGroup]] = [self randomTags];
+    }
+    return [UATagGroups tagGroupsWithTags:tags];
+}
+
+- (UAInAppMessageTagSelector *)randomSelectorWithDepth:(NSUInteger)depth {
+    switch ([self randomBelow:depth ? 5 : 2]) {
+        case 0:
+            return [UAInAppMessageTagSelector tag:[self randomTag]];
+        case 1:
+            return [UAInAppMessageTagSelector tag:[self randomTag] group:[self randomGroup]];
+        case 2:
+            return [UAInAppMessageTagSelector not:[self randomSelectorWithDepth:depth - 1]];
+        default: {
+            NSMutableArray<UAInAppMessageTagSelector *> *selectors = [NSMutableArray array];
+            NSUInteger count = [self randomBelow:3] + 1;
+            for (NSUInteger i = 0; i < count; i++) {
+                [selectors addObject:[self randomSelectorWithDepth:depth - 1]];
+            }
+
+            return [self randomBelow:2] ? [UAInAppMessageTagSelector and:selectors] : [UAInAppMessageTagSelector or:selectors];
+        }
+    }
+}
+
+@end
@@ -0,0 +1,231 @@
+/* Copyright Airship and Contributors */
+
+#import <XCTest/XCTest.h>
+#import <Airship/UAJSONPredicate+Internal.h>
+
+// Number of generated predicates in the differential corpus
+#define kUAJSONPredicateTestGeneratedPredicateCount 300
+
+// Number of generated objects each predicate is evaluated against
+#define kUAJSONPredicateTestGeneratedObjectCount 100
+
+/**
+ * Differential tests of the compiled predicate programs against the tree evaluator.
+ */
+@interface UAJSONPredicateTest : XCTestCase
+@property (nonatomic, assign) unsigned int seed;
+@end
+
+@implementation UAJSONPredicateTest
+
+- (void)setUp {
+    [super setUp];
+
+    // Fixed seed so a failure can be reproduced
+    self.seed = 20200108;
+}
+
+#pragma mark -
+#pragma mark Tests
+
+- (void)testCorpusMatchesTreeEvaluator {
+    NSArray *objects = [self objectCorpus];
+
+    for (NSDictionary *json in [self predicateCorpus]) {
+        [self assertProgramMatchesTreeForPredicateJSON:json objects:objects];
+    }
+}
+
+- (void)testGeneratedPredicatesMatchTreeEvaluator {
+    NSMutableArray *objects = [NSMutableArray arrayWithArray:[self objectCorpus]];
+    for (NSUInteger i = 0; i < kUAJSONPredicateTestGeneratedObjectCount; i++) {
+        [objects addObject:[self randomObject]];
+    }
+
+    for (NSUInteger i = 0; i < kUAJSONPredicateTestGeneratedPredicateCount; i++) {
+        [self assertProgramMatchesTreeForPredicateJSON:[self randomPredicateWithDepth:3] objects:objects];
+    }
+}
+
+- (void)testCorpusResults {
+    UAJSONPredicate *predicate = [self predicateWithJSON:@{ @"and": @[ @{ @"key": @"name", @"value": @{ @"equals": @"purchase" }, @"ignore_case": @YES },
+                                                                       @{ @"key": @"value", @"value": @{ @"at_least": @10, @"at_most": @100 } } ] }];
+
+    XCTAssertTrue([predicate evaluateObject:@{ @"name": @"PURCHASE", @"value": @50 }]);
+    XCTAssertFalse([predicate evaluateObject:@{ @"name": @"purchase", @"value": @500 }]);
+    XCTAssertFalse([predicate evaluateObject:@{ @"name": @"browse", @"value": @50 }]);
+    XCTAssertFalse([predicate evaluateObject:nil]);
+
+    predicate = [self predicateWithJSON:@{ @"not": @[ @{ @"key": @"tags", @"value": @{ @"array_contains": @{ @"value": @{ @"equals": @"vip" } } } } ] }];
+
+    XCTAssertFalse([predicate evaluateObject:@{ @"tags": @[@"new", @"vip"] }]);
+    XCTAssertTrue([predicate evaluateObject:@{ @"tags": @[@"new"] }]);
+}
+
+#pragma mark -
+#pragma mark Helpers
+
+- (void)assertProgramMatchesTreeForPredicateJSON:(NSDictionary *)json objects:(NSArray *)objects {
+    UAJSONPredicate *predicate = [self predicateWithJSON:json];
+    if (!predicate) {
+        return;
+    }
+
+    for (id object in objects) {
+        id value = [object isEqual:[NSNull null]] ? nil : object;
+        XCTAssertEqual([predicate evaluateObject:value], [predicate evaluateTreeWithObject:value],
+                       @"Predicate %@ disagrees with the tree evaluator for object %@", json, value);
+    }
+}
+
+- (UAJSONPredicate *)predicateWithJSON:(NSDictionary *)json {
+    NSError *error;
+    UAJSONPredicate *predicate = [UAJSONPredicate predicateWithJSON:json error:&error];
+    XCTAssertNotNil(predicate, @"Invalid predicate %@: %@", json, error);
+    return predicate;
+}
+
+- (NSArray<NSDictionary *> *)predicateCorpus {
+    return @[
+        @{ @"value": @{ @"equals": @"purchase" } },
+        @{ @"value": @{ @"equals": @"Purchase" }, @"ignore_case": @YES },
+        @{ @"key": @"name", @"value": @{ @"equals": @"purchase" } },
+        @{ @"key": @"name", @"value": @{ @"equals": @"PURCHASE" }, @"ignore_case": @YES },
+        @{ @"key": @"value", @"value": @{ @"equals": @10 } },
+        @{ @"key": @"value", @"value": @{ @"at_least": @10 } },
+        @{ @"key": @"value", @"value": @{ @"at_most": @10.5 } },
+        @{ @"key": @"value", @"value": @{ @"at_least": @1, @"at_most": @100 } },
+        @{ @"key": @"flag", @"value": @{ @"equals": @YES } },
+        @{ @"key": @"name", @"value": @{ @"is_present": @YES } },
+        @{ @"key": @"missing", @"value": @{ @"is_present": @NO } },
+        @{ @"key": @"version", @"value": @{ @"version_matches": @"[1.0, 2.0)" } },
+        @{ @"key": @"version", @"value": @{ @"version": @"1.+" } },
+        @{ @"key": @"tags", @"value": @{ @"array_contains": @{ @"value": @{ @"equals": @"vip" } } } },
+        @{ @"key": @"tags", @"value": @{ @"array_contains": @{ @"value": @{ @"equals": @"new" } }, @"index": @0 } },
+        @{ @"key": @"inner", @"scope": @[@"nested"], @"value": @{ @"equals": @"deep" } },
+        @{ @"key": @"value", @"scope": @[@"nested", @"deeper"], @"value": @{ @"at_least": @0 } },
+        @{ @"key": @"properties", @"value": @{ @"equals": @{ @"sku": @"SKU-1", @"category": @"travel" } } },
+        @{ @"and": @[ @{ @"key": @"name", @"value": @{ @"equals": @"purchase" } },
+                      @{ @"key": @"value", @"value": @{ @"at_least": @10 } } ] },
+        @{ @"or": @[ @{ @"key": @"name", @"value": @{ @"equals": @"purchase" } },
+                     @{ @"key": @"name", @"value": @{ @"equals": @"browse" } },
+                     @{ @"key": @"flag", @"value": @{ @"equals": @YES } } ] },
+        @{ @"not": @[ @{ @"key": @"name", @"value": @{ @"is_present": @YES } } ] },
+        @{ @"and": @[ @{ @"or": @[ @{ @"key": @"value", @"value": @{ @"at_most": @0 } },
+                                   @{ @"not": @[ @{ @"key": @"tags", @"value": @{ @"array_contains": @{ @"value": @{ @"equals": @"vip" } } } } ] } ] },
+                      @{ @"not": @[ @{ @"and": @[ @{ @"key": @"flag", @"value": @{ @"equals": @NO } },
+                                                  @{ @"key": @"version", @"value": @{ @"version_matches": @"2.+" } } ] } ] } ] },
+    ];
+}
+
+- (NSArray *)objectCorpus {
+    return @[
+        [NSNull null],
+        @"purchase",
+        @"PURCHASE",
+        @10,
+        @YES,
+        @[],
+        @{},
+        @{ @"name": @"purchase", @"value": @10, @"flag": @YES, @"version": @"1.5.0", @"tags": @[@"new", @"vip"] },
+        @{ @"name": @"Purchase", @"value": @10.5, @"flag": @NO, @"version": @"2.0.0", @"tags": @[@"vip"] },
+        @{ @"name": @"browse", @"value": @-1, @"version": @"0.9", @"tags": @[] },
+        @{ @"name": [NSNull null], @"value": @"10", @"flag": @1, @"tags": @"vip" },
+        @{ @"name": @10, @"value": @[@10], @"tags": @[@[@"vip"], @{ @"vip": @YES }] },
+        @{ @"nested": @{ @"inner": @"deep", @"deeper": @{ @"value": @5 } } },
+        @{ @"nested": @{ @"inner": @"DEEP", @"deeper": @"value" } },
+        @{ @"nested": @"inner" },
+        @{ @"properties": @{ @"sku": @"SKU-1", @"category": @"travel" } },
+        @{ @"properties": @{ @"sku": @"SKU-1" } },
+    ];
+}
+
+- (NSUInteger)randomBelow:(NSUInteger)bound {
+    return (NSUInteger)rand_r(&_seed) % bound;
+}
+
+- (id)randomElement:(NSArray *)array {
+    return array[[self randomBelow:array.count]];
+}
+
+- (NSDictionary *)randomPredicateWithDepth:(NSUInteger)depth {
+    NSUInteger choice = [self randomBelow:depth ? 6 : 3];
+
+    if (choice >= 3) {
+        NSUInteger count = choice == 5 ? 1 : [self randomBelow:3] + 1;
+        NSMutableArray *subpredicates = [NSMutableArray array];
+        for (NSUInteger i = 0; i < count; i++) {
+            [subpredicates addObject:[self randomPredicateWithDepth:depth - 1]];
+        }
+
+        NSString *type = choice == 3 ? @"and" : choice == 4 ? @"or" : @"not";
+        return @{ type: subpredicates };
+    }
+
+    NSMutableDictionary *matcher = [NSMutableDictionary dictionary];
+    matcher[@"key"] = [self randomElement:@[@"name", @"value", @"flag", @"version", @"tags", @"missing"]];
+    if (![self randomBelow:4]) {
+        matcher[@"scope"] = @[@"nested"];
+    }
+    if (![self randomBelow:3]) {
+        matcher[@"ignore_case"] = @YES;
+    }
+    matcher[@"value"] = [self randomValueMatcherWithDepth:depth];
+    return matcher;
+}
+
+- (NSDictionary *)randomValueMatcherWithDepth:(NSUInteger)depth {
+    switch ([self randomBelow:depth ? 7 : 6]) {
+        case 0:
+            return @{ @"equals": [self randomScalar] };
+        case 1:
+            return @{ @"at_least": @((NSInteger)[self randomBelow:20] - 5) };
+        case 2:
+            return @{ @"at_most": @((NSInteger)[self randomBelow:20] - 5) };
+        case 3:
+            return @{ @"at_least": @([self randomBelow:5]), @"at_most": @([self randomBelow:10] + 5) };
+        case 4:
+            return @{ @"is_present": @([self randomBelow:2] == 0) };
+        case 5:
+            return @{ @"version_matches": [self randomElement:@[@"1.+", @"[1.0, 2.0)", @"2.0.0", @"[0.1,)"]] };
+        default: {
+            NSMutableDictionary *arrayContains = [NSMutableDictionary dictionary];
+            arrayContains[@"array_contains"] = [self randomPredicateWithDepth:0];
+            if ([self randomBelow:2]) {
+                arrayContains[@"index"] = @([self randomBelow:3]);
+            }
+            return arrayContains;
+        }
+    }
+}
+
+- (id)randomScalar {
+    return [self randomElement:@[@"purchase", @"PURCHASE", @"browse", @"vip", @"1.5.0", @0, @5, @10, @10.5, @YES, @NO]];
+}
+
+- (id)randomObject {
+    NSMutableDictionary *object = [NSMutableDictionary dictionary];
+    for (NSString *key in @[@"name", @"value", @"flag", @"version", @"tags"]) {
+        switch ([self randomBelow:5]) {
+            case 0:
+                break;
+            case 1:
+                object[key] = [NSNull null];
+                break;
+            case 2:
+                object[key] = @[[self randomScalar], [self randomScalar]];
+                break;
+            default:
+                object[key] = [self randomScalar];
+                break;
+        }
+    }
+
+    if ([self randomBelow:2]) {
+        object[@"nested"] = @{ [self randomElement:@[@"name", @"value", @"tags"]]: [self randomScalar] };
+    }
+
+    return object;
+}
+
+@end
@@ -0,0 +1,179 @@
+/* Copyright Airship and Contributors */
+
+#import <XCTest/XCTest.h>
+#import <Airship/UAMetrics+Internal.h>
+#import <Airship/UAMetricsSnapshot.h>
+
+/**
+ * Exporter that records the snapshots and ended spans it receives.
+ */
+@interface UAMetricsTestExporter : NSObject <UAMetricsExporter>
+@property (nonatomic, strong) NSMutableArray<UAMetricsSnapshot *> *snapshots;
+@property (nonatomic, copy, nullable) void (^spanBlock)(NSString *name, NSTimeInterval duration);
+@end
+
+@implementation UAMetricsTestExporter
+
+- (instancetype)init {
+    self = [super init];
+
+    if (self) {
+        self.snapshots = [NSMutableArray array];
+    }
+
+    return self;
+}
+
+- (void)exportMetrics:(UAMetricsSnapshot *)snapshot {
+    [self.snapshots addObject:snapshot];
+}
+
+- (void)spanNamed:(NSString *)name didEndWithDuration:(NSTimeInterval)duration {
+    if (self.spanBlock) {
+        self.spanBlock(name, duration);
+    }
+}
+
+@end
+
+/**
+ * Tests recording and exporting metrics through the shared instance. The host app may record metrics while
+ * the tests run, so only metrics the app does not use are checked.
+ */
+@interface UAMetricsTest : XCTestCase
+@property (nonatomic, strong) UAMetricsTestExporter *exporter;
+@end
+
+@implementation UAMetricsTest
+
+- (void)setUp {
+    [super setUp];
+
+    self.exporter = [[UAMetricsTestExporter alloc] init];
+    [UAMetrics shared].exporter = self.exporter;
+    [UAMetrics shared].enabled = YES;
+}
+
+- (void)tearDown {
+    [UAMetrics shared].enabled = NO;
+    [UAMetrics shared].exporter = nil;
+    [super tearDown];
+}
+
+#pragma mark -
+#pragma mark Tests
+
+- (void)testBucketBoundaries {
+    // Bucket i holds durations up to 2^i microseconds
+    uint64_t durations[] = { 0, 1000, 1999, 2000, 3000, 4000, 5000, 8000 };
+    for (NSUInteger i = 0; i < sizeof(durations) / sizeof(durations[0]); i++) {
+        UAMetricsAddToHistogram(UAMetricsHistogramInAppPrepareData, durations[i]);
+    }
+
+    // Everything above 2^23 microseconds lands in the last bucket
+    UAMetricsAddToHistogram(UAMetricsHistogramInAppPrepareData, (1ULL << 24) * NSEC_PER_USEC);
+    UAMetricsAddToHistogram(UAMetricsHistogramInAppPrepareData, 100 * NSEC_PER_SEC);
+
+    UAMetricsHistogramSnapshot *histogram = [self exportMetrics].histograms[[UAMetrics nameForHistogram:UAMetricsHistogramInAppPrepareData]];
+
+    NSMutableArray<NSNumber *> *expected = [NSMutableArray array];
+    for (NSUInteger i = 0; i < histogram.bucketCounts.count; i++) {
+        [expected addObject:@0];
+    }
+    expected[0] = @3;
+    expected[1] = @1;
+    expected[2] = @2;
+    expected[3] = @2;
+    expected[histogram.bucketCounts.count - 1] = @2;
+
+    XCTAssertEqual(histogram.bucketCounts.count, 25);
+    XCTAssertEqualObjects(histogram.bucketCounts, expected);
+    XCTAssertEqual(histogram.count, 10);
+    XCTAssertEqualWithAccuracy(histogram.max, 100, 0.000001);
+    XCTAssertEqualWithAccuracy(histogram.sum, (24999.0 + (1 << 24) * 1000.0) / NSEC_PER_SEC + 100, 0.000001);
+}
+
+- (void)testExportsDeltas {
+    NSString *counterName = [UAMetrics nameForCounter:UAMetricsCounterSchedulesTriggered];
+    NSString *histogramName = [UAMetrics nameForHistogram:UAMetricsHistogramInAppPrepareAssets];
+
+    UAMetricsIncrement(UAMetricsCounterSchedulesTriggered, 2);
+    UAMetricsRecordDuration(UAMetricsHistogramInAppPrepareAssets, 0.5);
+
+    UAMetricsSnapshot *first = [self exportMetrics];
+    XCTAssertEqualObjects(first.counters[counterName], @2);
+    XCTAssertEqual(first.histograms[histogramName].count, 1);
+
+    // Nothing recorded since the last export
+    UAMetricsSnapshot *second = [self exportMetrics];
+    XCTAssertNil(second.counters[counterName]);
+    XCTAssertNil(second.histograms[histogramName]);
+    XCTAssertEqualObjects(second.startDate, first.endDate);
+
+    UAMetricsIncrement(UAMetricsCounterSchedulesTriggered, 1);
+    UAMetricsRecordDuration(UAMetricsHistogramInAppPrepareAssets, 0.25);
+
+    UAMetricsSnapshot *third = [self exportMetrics];
+    XCTAssertEqualObjects(third.counters[counterName], @1);
+
+    UAMetricsHistogramSnapshot *histogram = third.histograms[histogramName];
+    XCTAssertEqual(histogram.count, 1);
+    XCTAssertEqualWithAccuracy(histogram.sum, 0.25, 0.000001);
+    XCTAssertEqualWithAccuracy(histogram.max, 0.25, 0.000001);
+}
+
+- (void)testDisabledRecordsNothing {
+    [UAMetrics shared].enabled = NO;
+    XCTAssertFalse(UAMetricsIsRecording());
+
+    UAMetricsSpan span = UAMetricsSpanBegin(UAMetricsHistogramInAppPrepareAudience);
+    XCTAssertEqual(span.start, 0);
+
+    // Nothing is exported while disabled
+    [[UAMetrics shared] exportMetrics];
+    XCTAssertEqual(self.exporter.snapshots.count, 0);
+
+    // A span started while disabled is ignored when it ends after enabling
+    [UAMetrics shared].enabled = YES;
+    UAMetricsSpanEnd(span);
+
+    UAMetricsSnapshot *snapshot = [self exportMetrics];
+    XCTAssertNil(snapshot.histograms[[UAMetrics nameForHistogram:UAMetricsHistogramInAppPrepareAudience]]);
+
+    // Disabling discards anything not yet exported
+    UAMetricsIncrement(UAMetricsCounterSchedulesTriggered, 1);
+    [UAMetrics shared].enabled = NO;
+    [UAMetrics shared].enabled = YES;
+
+    XCTAssertNil([self exportMetrics].counters[[UAMetrics nameForCounter:UAMetricsCounterSchedulesTriggered]]);
+}
+
+- (void)testSpanExport {
+    NSString *histogramName = [UAMetrics nameForHistogram:UAMetricsHistogramInAppPrepareAdapter];
+
+    // Spans are exported off the thread that ended them
+    XCTestExpectation *exported = [self expectationWithDescription:@"span exported"];
+    self.exporter.spanBlock = ^(NSString *name, NSTimeInterval duration) {
+        if ([name isEqualToString:histogramName]) {
+            XCTAssertGreaterThanOrEqual(duration, 0);
+            [exported fulfill];
+        }
+    };
+
+    UAMetricsSpanEnd(UAMetricsSpanBegin(UAMetricsHistogramInAppPrepareAdapter));
+    [self waitForExpectationsWithTimeout:10 handler:nil];
+
+    XCTAssertEqual([self exportMetrics].histograms[histogramName].count, 1);
+}
+
+#pragma mark -
+#pragma mark Helpers
+
+- (UAMetricsSnapshot *)exportMetrics {
+    NSUInteger count = self.exporter.snapshots.count;
+    [[UAMetrics shared] exportMetrics];
+    XCTAssertEqual(self.exporter.snapshots.count, count + 1);
+    return self.exporter.snapshots.lastObject;
+}
+
+@end
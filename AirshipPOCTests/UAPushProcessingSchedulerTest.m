@@ -0,0 +1,204 @@
+/* Copyright Airship and Contributors */
+
+#import <XCTest/XCTest.h>
+#import <Airship/UAPushProcessingScheduler+Internal.h>
+#import "UATestDispatcher.h"
+
+// Deadline used by the tests that do not run out of time
+#define kUAPushProcessingSchedulerTestTimeBudget 10
+
+@interface UAPushProcessingSchedulerTest : XCTestCase
+@property (nonatomic, strong) UATestDispatcher *dispatcher;
+@property (nonatomic, strong) NSMutableArray<NSString *> *events;
+@end
+
+@implementation UAPushProcessingSchedulerTest
+
+- (void)setUp {
+    [super setUp];
+
+    self.dispatcher = [UATestDispatcher testDispatcher];
+    self.events = [NSMutableArray array];
+}
+
+#pragma mark -
+#pragma mark Tests
+
+- (void)testSynchronousCompletion {
+    UAPushProcessingScheduler *scheduler = [self schedulerWithTimeBudget:kUAPushProcessingSchedulerTestTimeBudget];
+    [self addTaskWithName:@"high" priority:UAPushableComponentPriorityHigh expectedTime:0 result:UIBackgroundFetchResultNoData toScheduler:scheduler];
+    [self addTaskWithName:@"normal" priority:UAPushableComponentPriorityNormal expectedTime:1 result:UIBackgroundFetchResultNewData toScheduler:scheduler];
+
+    __block NSNumber *fetchResult;
+    [scheduler runWithCompletionHandler:^(UIBackgroundFetchResult result) {
+        fetchResult = @(result);
+        [self.events addObject:@"completion"];
+    }];
+
+    // Every task finished while starting, so no deadline is needed
+    XCTAssertEqualObjects(fetchResult, @(UIBackgroundFetchResultNewData));
+    XCTAssertEqualObjects(self.events, (@[@"high", @"normal", @"completion"]));
+    XCTAssertNotNil(scheduler.taskTimings[@"high"]);
+    XCTAssertNotNil(scheduler.taskTimings[@"normal"]);
+}
+
+- (void)testTasksRunInPriorityOrder {
+    UAPushProcessingScheduler *scheduler = [self schedulerWithTimeBudget:kUAPushProcessingSchedulerTestTimeBudget];
+    [self addTaskWithName:@"normal" priority:UAPushableComponentPriorityNormal expectedTime:0 result:UIBackgroundFetchResultNoData toScheduler:scheduler];
+    [self addTaskWithName:@"low" priority:UAPushableComponentPriorityLow expectedTime:0 result:UIBackgroundFetchResultNoData toScheduler:scheduler];
+    [self addTaskWithName:@"high" priority:UAPushableComponentPriorityHigh expectedTime:0 result:UIBackgroundFetchResultNoData toScheduler:scheduler];
+
+    [scheduler runWithCompletionHandler:^(UIBackgroundFetchResult result) {
+        [self.events addObject:@"completion"];
+    }];
+
+    XCTAssertEqualObjects(self.events, (@[@"high", @"normal", @"low", @"completion"]));
+}
+
+- (void)testDeferral {
+    UAPushProcessingScheduler *scheduler = [self schedulerWithTimeBudget:5];
+    [self addTaskWithName:@"slow" priority:UAPushableComponentPriorityNormal expectedTime:10 result:UIBackgroundFetchResultNewData toScheduler:scheduler];
+    [self addTaskWithName:@"fast" priority:UAPushableComponentPriorityNormal expectedTime:1 result:UIBackgroundFetchResultNoData toScheduler:scheduler];
+
+    __block NSNumber *fetchResult;
+    [scheduler runWithCompletionHandler:^(UIBackgroundFetchResult result) {
+        fetchResult = @(result);
+        [self.events addObject:@"completion"];
+    }];
+
+    // The slow task starts after the completion handler and its result is dropped
+    XCTAssertEqualObjects(self.events, (@[@"fast", @"completion", @"slow"]));
+    XCTAssertEqualObjects(fetchResult, @(UIBackgroundFetchResultNoData));
+}
+
+- (void)testHighPriorityIsNeverDeferred {
+    UAPushProcessingScheduler *scheduler = [self schedulerWithTimeBudget:5];
+    [self addTaskWithName:@"high" priority:UAPushableComponentPriorityHigh expectedTime:10 result:UIBackgroundFetchResultNoData toScheduler:scheduler];
+
+    [scheduler runWithCompletionHandler:^(UIBackgroundFetchResult result) {
+        [self.events addObject:@"completion"];
+    }];
+
+    XCTAssertEqualObjects(self.events, (@[@"high", @"completion"]));
+}
+
+- (void)testNoExpectedTimeIsNeverDeferred {
+    // No budget left, as when the app has less background time than the deadline margin
+    UAPushProcessingScheduler *scheduler = [self schedulerWithTimeBudget:0];
+    [self addTaskWithName:@"instant" priority:UAPushableComponentPriorityNormal expectedTime:0 result:UIBackgroundFetchResultNewData toScheduler:scheduler];
+    [self addTaskWithName:@"slow" priority:UAPushableComponentPriorityNormal expectedTime:1 result:UIBackgroundFetchResultNoData toScheduler:scheduler];
+
+    __block NSNumber *fetchResult;
+    [scheduler runWithCompletionHandler:^(UIBackgroundFetchResult result) {
+        fetchResult = @(result);
+        [self.events addObject:@"completion"];
+    }];
+
+    XCTAssertEqualObjects(self.events, (@[@"instant", @"completion", @"slow"]));
+    XCTAssertEqualObjects(fetchResult, @(UIBackgroundFetchResultNewData));
+}
+
+- (void)testDeadlineCutoff {
+    UAPushProcessingScheduler *scheduler = [self schedulerWithTimeBudget:kUAPushProcessingSchedulerTestTimeBudget];
+    [self addTaskWithName:@"finished" priority:UAPushableComponentPriorityNormal expectedTime:1 result:UIBackgroundFetchResultFailed toScheduler:scheduler];
+
+    __block void (^pendingCompletionHandler)(UIBackgroundFetchResult);
+    [scheduler addTaskWithName:@"pending" priority:UAPushableComponentPriorityNormal expectedTime:1 task:^(void (^completionHandler)(UIBackgroundFetchResult)) {
+        pendingCompletionHandler = completionHandler;
+    }];
+
+    __block NSUInteger calls = 0;
+    __block NSNumber *fetchResult;
+    [scheduler runWithCompletionHandler:^(UIBackgroundFetchResult result) {
+        calls++;
+        fetchResult = @(result);
+    }];
+
+    XCTAssertEqual(calls, 0);
+
+    [self.dispatcher advanceTime:kUAPushProcessingSchedulerTestTimeBudget - 1];
+    XCTAssertEqual(calls, 0);
+
+    [self.dispatcher advanceTime:1];
+    XCTAssertEqual(calls, 1);
+    XCTAssertEqualObjects(fetchResult, @(UIBackgroundFetchResultFailed));
+
+    // A result after the deadline is dropped
+    pendingCompletionHandler(UIBackgroundFetchResultNewData);
+    XCTAssertEqual(calls, 1);
+    XCTAssertEqualObjects(fetchResult, @(UIBackgroundFetchResultFailed));
+    XCTAssertNotNil(scheduler.taskTimings[@"pending"]);
+}
+
+- (void)testDeadlineWaitsOnHighPriority {
+    UAPushProcessingScheduler *scheduler = [self schedulerWithTimeBudget:0];
+
+    __block void (^highCompletionHandler)(UIBackgroundFetchResult);
+    [scheduler addTaskWithName:@"high" priority:UAPushableComponentPriorityHigh expectedTime:1 task:^(void (^completionHandler)(UIBackgroundFetchResult)) {
+        highCompletionHandler = completionHandler;
+    }];
+
+    __block void (^normalCompletionHandler)(UIBackgroundFetchResult);
+    [scheduler addTaskWithName:@"normal" priority:UAPushableComponentPriorityNormal expectedTime:0 task:^(void (^completionHandler)(UIBackgroundFetchResult)) {
+        normalCompletionHandler = completionHandler;
+    }];
+
+    __block NSUInteger calls = 0;
+    __block NSNumber *fetchResult;
+    [scheduler runWithCompletionHandler:^(UIBackgroundFetchResult result) {
+        calls++;
+        fetchResult = @(result);
+    }];
+
+    [self.dispatcher advanceTime:0];
+    XCTAssertEqual(calls, 0);
+
+    // Past the deadline, the normal priority task is no longer waited on
+    highCompletionHandler(UIBackgroundFetchResultNewData);
+    XCTAssertEqual(calls, 1);
+    XCTAssertEqualObjects(fetchResult, @(UIBackgroundFetchResultNewData));
+
+    normalCompletionHandler(UIBackgroundFetchResultFailed);
+    XCTAssertEqual(calls, 1);
+}
+
+- (void)testLowPriorityIsNotWaitedOn {
+    UAPushProcessingScheduler *scheduler = [self schedulerWithTimeBudget:kUAPushProcessingSchedulerTestTimeBudget];
+    [self addTaskWithName:@"normal" priority:UAPushableComponentPriorityNormal expectedTime:1 result:UIBackgroundFetchResultNoData toScheduler:scheduler];
+
+    __block BOOL lowStarted = NO;
+    [scheduler addTaskWithName:@"low" priority:UAPushableComponentPriorityLow expectedTime:1 task:^(void (^completionHandler)(UIBackgroundFetchResult)) {
+        lowStarted = YES;
+    }];
+
+    __block NSUInteger calls = 0;
+    [scheduler runWithCompletionHandler:^(UIBackgroundFetchResult result) {
+        calls++;
+    }];
+
+    XCTAssertTrue(lowStarted);
+    XCTAssertEqual(calls, 1);
+}
+
+#pragma mark -
+#pragma mark Helpers
+
+- (UAPushProcessingScheduler *)schedulerWithTimeBudget:(NSTimeInterval)timeBudget {
+    return [UAPushProcessingScheduler schedulerWithTimeBudget:timeBudget dispatcher:self.dispatcher];
+}
+
+/**
+ * Adds a task that records its name and finishes synchronously.
+ */
+- (void)addTaskWithName:(NSString *)name
+               priority:(UAPushableComponentPriority)priority
+           expectedTime:(NSTimeInterval)expectedTime
+                 result:(UIBackgroundFetchResult)result
+            toScheduler:(UAPushProcessingScheduler *)scheduler {
+    [scheduler addTaskWithName:name priority:priority expectedTime:expectedTime task:^(void (^completionHandler)(UIBackgroundFetchResult)) {
+        [self.events addObject:name];
+        completionHandler(result);
+    }];
+}
+
+@end
@@ -0,0 +1,311 @@
+/* Copyright Airship and Contributors */
+
+#import <XCTest/XCTest.h>
+#import <Airship/UARemoteDataAPIClient+Internal.h>
+#import <Airship/UARuntimeConfig+Internal.h>
+#import <Airship/UAConfig.h>
+
+static NSString * const UARemoteDataAPIClientTestHost = @"remote-data.test";
+static NSString * const UARemoteDataAPIClientTestLastModified = @"Wed, 08 Jan 2020 10:00:00 GMT";
+
+static NSMutableArray<NSDictionary *> *queuedResponses;
+static NSMutableArray<NSURLRequest *> *receivedRequests;
+
+/**
+ * Local stand-in for the remote data server. Answers each request with the next queued response
+ * and records the request.
+ */
+@interface UARemoteDataAPIClientTestServer : NSURLProtocol
+@end
+
+@implementation UARemoteDataAPIClientTestServer
+
++ (void)reset {
+    @synchronized (self) {
+        queuedResponses = [NSMutableArray array];
+        receivedRequests = [NSMutableArray array];
+    }
+}
+
++ (void)respondWithStatus:(NSInteger)status headers:(NSDictionary<NSString *, NSString *> *)headers body:(nullable id)body {
+    NSMutableDictionary *response = [NSMutableDictionary dictionary];
+    response[@"status"] = @(status);
+    response[@"headers"] = headers;
+    [response setValue:body ? [NSJSONSerialization dataWithJSONObject:body options:0 error:nil] : nil forKey:@"body"];
+
+    @synchronized (self) {
+        [queuedResponses addObject:response];
+    }
+}
+
++ (NSArray<NSURLRequest *> *)requests {
+    @synchronized (self) {
+        return [receivedRequests copy];
+    }
+}
+
++ (BOOL)canInitWithRequest:(NSURLRequest *)request {
+    return [request.URL.host isEqualToString:UARemoteDataAPIClientTestHost];
+}
+
++ (NSURLRequest *)canonicalRequestForRequest:(NSURLRequest *)request {
+    return request;
+}
+
+- (void)startLoading {
+    NSDictionary *response;
+    @synchronized ([UARemoteDataAPIClientTestServer class]) {
+        [receivedRequests addObject:self.request];
+        if (queuedResponses.count) {
+            response = queuedResponses.firstObject;
+            [queuedResponses removeObjectAtIndex:0];
+        }
+    }
+
+    if (!response) {
+        [self.client URLProtocol:self didFailWithError:[NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorCannotConnectToHost userInfo:nil]];
+        return;
+    }
+
+    NSHTTPURLResponse *httpResponse = [[NSHTTPURLResponse alloc] initWithURL:self.request.URL
+                                                                  statusCode:[response[@"status"] integerValue]
+                                                                 HTTPVersion:@"HTTP/1.1"
+                                                                headerFields:response[@"headers"]];
+
+    [self.client URLProtocol:self didReceiveResponse:httpResponse cacheStoragePolicy:NSURLCacheStorageNotAllowed];
+    if (response[@"body"]) {
+        [self.client URLProtocol:self didLoadData:response[@"body"]];
+    }
+    [self.client URLProtocolDidFinishLoading:self];
+}
+
+- (void)stopLoading {
+}
+
+@end
+
+/**
+ * Tests the remote data delta protocol against the stand-in server.
+ */
+@interface UARemoteDataAPIClientTest : XCTestCase
+@property (nonatomic, strong) UAPreferenceDataStore *dataStore;
+@property (nonatomic, strong) UARemoteDataAPIClient *client;
+@end
+
+@implementation UARemoteDataAPIClientTest
+
+- (void)setUp {
+    [super setUp];
+
+    [UARemoteDataAPIClientTestServer reset];
+
+    UAConfig *config = [UAConfig config];
+    config.developmentAppKey = @"0123456789abcdefghijkl";
+    config.developmentAppSecret = @"0123456789abcdefghijkl";
+    config.inProduction = NO;
+    config.remoteDataAPIURL = [NSString stringWithFormat:@"https://%@", UARemoteDataAPIClientTestHost];
+    UARuntimeConfig *runtimeConfig = [[UARuntimeConfig alloc] initWithConfig:config];
+
+    NSURLSessionConfiguration *sessionConfiguration = [NSURLSessionConfiguration ephemeralSessionConfiguration];
+    sessionConfiguration.protocolClasses = @[[UARemoteDataAPIClientTestServer class]];
+    NSURLSession *session = [NSURLSession sessionWithConfiguration:sessionConfiguration];
+
+    self.dataStore = [UAPreferenceDataStore preferenceDataStoreWithKeyPrefix:[NSUUID UUID].UUIDString];
+    self.client = [UARemoteDataAPIClient clientWithConfig:runtimeConfig
+                                                dataStore:self.dataStore
+                                                  session:[UARequestSession sessionWithConfig:runtimeConfig NSURLSession:session]];
+}
+
+- (void)tearDown {
+    [self.dataStore removeAll];
+    [super tearDown];
+}
+
+#pragma mark -
+#pragma mark Tests
+
+- (void)testFullResponseSendsNoVersions {
+    [self respondWithFullDocument];
+
+    NSDictionary *result = [self fetch];
+
+    XCTAssertEqualObjects(result[@"status"], @200);
+    XCTAssertEqual([result[@"remoteData"] count], 3);
+    XCTAssertNil(result[@"unchangedTypes"]);
+
+    NSURLRequest *request = [UARemoteDataAPIClientTestServer requests].firstObject;
+    XCTAssertNil([request valueForHTTPHeaderField:@"X-UA-Remote-Data-Versions"]);
+    XCTAssertNil([request valueForHTTPHeaderField:@"If-Modified-Since"]);
+}
+
+- (void)testDeltaResponse {
+    [self respondWithFullDocument];
+    [self fetch];
+
+    [UARemoteDataAPIClientTestServer respondWithStatus:200
+                                               headers:@{ @"Last-Modified": UARemoteDataAPIClientTestLastModified }
+                                                  body:@{ @"delta": @YES,
+                                                          @"payloads": @[[self payloadWithType:@"b" value:@"b2"]],
+                                                          @"removed_types": @[@"c"],
+                                                          @"versions": @{ @"a": @"1", @"b": @"2" } }];
+
+    NSDictionary *result = [self fetch];
+
+    XCTAssertEqualObjects(result[@"status"], @200);
+    XCTAssertEqual([result[@"remoteData"] count], 1);
+    XCTAssertEqualObjects(result[@"unchangedTypes"], [NSSet setWithObject:@"a"]);
+
+    // The versions of the last response are sent back with its Last-Modified
+    NSURLRequest *request = [UARemoteDataAPIClientTestServer requests].lastObject;
+    XCTAssertEqualObjects([request valueForHTTPHeaderField:@"X-UA-Remote-Data-Versions"], @"{\"a\":\"1\",\"b\":\"1\",\"c\":\"1\"}");
+    XCTAssertEqualObjects([request valueForHTTPHeaderField:@"If-Modified-Since"], UARemoteDataAPIClientTestLastModified);
+}
+
+- (void)testDeltaUpdatesVersions {
+    [self respondWithFullDocument];
+    [self fetch];
+
+    [UARemoteDataAPIClientTestServer respondWithStatus:200
+                                               headers:@{ @"Last-Modified": UARemoteDataAPIClientTestLastModified }
+                                                  body:@{ @"delta": @YES,
+                                                          @"payloads": @[[self payloadWithType:@"b" value:@"b2"]],
+                                                          @"removed_types": @[@"c"],
+                                                          @"versions": @{ @"a": @"1", @"b": @"2" } }];
+    [self fetch];
+
+    [UARemoteDataAPIClientTestServer respondWithStatus:304 headers:@{} body:nil];
+    NSDictionary *result = [self fetch];
+
+    XCTAssertEqualObjects(result[@"status"], @304);
+    XCTAssertNil(result[@"remoteData"]);
+
+    NSURLRequest *request = [UARemoteDataAPIClientTestServer requests].lastObject;
+    XCTAssertEqualObjects([request valueForHTTPHeaderField:@"X-UA-Remote-Data-Versions"], @"{\"a\":\"1\",\"b\":\"2\"}");
+}
+
+- (void)testVersionedTypeWithoutPayloadsIsNotSent {
+    // A versioned type with no payloads is never cached, so it can't be kept by a delta
+    [UARemoteDataAPIClientTestServer respondWithStatus:200
+                                               headers:@{ @"Last-Modified": UARemoteDataAPIClientTestLastModified }
+                                                  body:@{ @"payloads": @[[self payloadWithType:@"a" value:@"a1"]],
+                                                          @"versions": @{ @"a": @"1", @"empty": @"1" } }];
+    [self fetch];
+
+    [UARemoteDataAPIClientTestServer respondWithStatus:200
+                                               headers:@{ @"Last-Modified": UARemoteDataAPIClientTestLastModified }
+                                                  body:@{ @"delta": @YES,
+                                                          @"payloads": @[],
+                                                          @"versions": @{ @"a": @"1", @"empty": @"1" } }];
+    NSDictionary *result = [self fetch];
+
+    XCTAssertEqualObjects(result[@"unchangedTypes"], [NSSet setWithObject:@"a"]);
+
+    NSURLRequest *request = [UARemoteDataAPIClientTestServer requests].lastObject;
+    XCTAssertEqualObjects([request valueForHTTPHeaderField:@"X-UA-Remote-Data-Versions"], @"{\"a\":\"1\"}");
+
+    // The versions kept after a delta are the unchanged types and the types in its payloads
+    [UARemoteDataAPIClientTestServer respondWithStatus:304 headers:@{} body:nil];
+    [self fetch];
+
+    request = [UARemoteDataAPIClientTestServer requests].lastObject;
+    XCTAssertEqualObjects([request valueForHTTPHeaderField:@"X-UA-Remote-Data-Versions"], @"{\"a\":\"1\"}");
+}
+
+- (void)testServerWithoutDeltaSupport {
+    [self respondWithFullDocument];
+    [self fetch];
+
+    // Versions are sent, but the server replies with the full document
+    [UARemoteDataAPIClientTestServer respondWithStatus:200
+                                               headers:@{ @"Last-Modified": UARemoteDataAPIClientTestLastModified }
+                                                  body:@{ @"payloads": @[[self payloadWithType:@"a" value:@"a2"]] }];
+
+    NSDictionary *result = [self fetch];
+
+    XCTAssertEqualObjects(result[@"status"], @200);
+    XCTAssertEqual([result[@"remoteData"] count], 1);
+    XCTAssertNil(result[@"unchangedTypes"]);
+
+    // Without versions in the response, the next request can't ask for a delta
+    [UARemoteDataAPIClientTestServer respondWithStatus:304 headers:@{} body:nil];
+    [self fetch];
+
+    NSURLRequest *request = [UARemoteDataAPIClientTestServer requests].lastObject;
+    XCTAssertNil([request valueForHTTPHeaderField:@"X-UA-Remote-Data-Versions"]);
+}
+
+- (void)testDeltaWithoutSentVersionsFails {
+    [UARemoteDataAPIClientTestServer respondWithStatus:200
+                                               headers:@{ @"Last-Modified": UARemoteDataAPIClientTestLastModified }
+                                                  body:@{ @"delta": @YES,
+                                                          @"payloads": @[[self payloadWithType:@"a" value:@"a1"]],
+                                                          @"versions": @{ @"a": @"1" } }];
+
+    XCTAssertNil([self fetch]);
+
+    // The next refresh is a full fetch
+    [UARemoteDataAPIClientTestServer respondWithStatus:304 headers:@{} body:nil];
+    [self fetch];
+
+    NSURLRequest *request = [UARemoteDataAPIClientTestServer requests].lastObject;
+    XCTAssertNil([request valueForHTTPHeaderField:@"X-UA-Remote-Data-Versions"]);
+    XCTAssertNil([request valueForHTTPHeaderField:@"If-Modified-Since"]);
+}
+
+- (void)testClearLastModifiedTimeClearsVersions {
+    [self respondWithFullDocument];
+    [self fetch];
+
+    [self.client clearLastModifiedTime];
+
+    [self respondWithFullDocument];
+    NSDictionary *result = [self fetch];
+
+    XCTAssertNil(result[@"unchangedTypes"]);
+
+    NSURLRequest *request = [UARemoteDataAPIClientTestServer requests].lastObject;
+    XCTAssertNil([request valueForHTTPHeaderField:@"X-UA-Remote-Data-Versions"]);
+    XCTAssertNil([request valueForHTTPHeaderField:@"If-Modified-Since"]);
+}
+
+#pragma mark -
+#pragma mark Helpers
+
+- (NSDictionary *)payloadWithType:(NSString *)type value:(NSString *)value {
+    return @{ @"type": type, @"timestamp": @"2020-01-08T10:00:00", @"data": @{ @"value": value } };
+}
+
+- (void)respondWithFullDocument {
+    [UARemoteDataAPIClientTestServer respondWithStatus:200
+                                               headers:@{ @"Last-Modified": UARemoteDataAPIClientTestLastModified }
+                                                  body:@{ @"payloads": @[[self payloadWithType:@"a" value:@"a1"],
+                                                                         [self payloadWithType:@"b" value:@"b1"],
+                                                                         [self payloadWithType:@"c" value:@"c1"]],
+                                                          @"versions": @{ @"a": @"1", @"b": @"1", @"c": @"1" } }];
+}
+
+/**
+ * Fetches remote data and waits for the result.
+ *
+ * @return The status code, remote data and unchanged types, or `nil` if the fetch failed.
+ */
+- (nullable NSDictionary *)fetch {
+    __block NSDictionary *result;
+    XCTestExpectation *fetched = [self expectationWithDescription:@"fetched"];
+
+    [self.client fetchRemoteData:^(NSUInteger statusCode, NSArray<NSDictionary *> *remoteData, NSSet<NSString *> *unchangedTypes) {
+        NSMutableDictionary *success = [NSMutableDictionary dictionary];
+        success[@"status"] = @(statusCode);
+        [success setValue:remoteData forKey:@"remoteData"];
+        [success setValue:unchangedTypes forKey:@"unchangedTypes"];
+        result = success;
+        [fetched fulfill];
+    } onFailure:^{
+        [fetched fulfill];
+    }];
+
+    [self waitForExpectationsWithTimeout:10 handler:nil];
+    return result;
+}
+
+@end
@@ -0,0 +1,199 @@
+/* Copyright Airship and Contributors */
+
+#import <XCTest/XCTest.h>
+#import <Airship/UARemoteDataManager+Internal.h>
+#import <Airship/UARuntimeConfig+Internal.h>
+#import <Airship/UAConfig.h>
+#import "UATestDispatcher.h"
+
+/**
+ * API client that answers each fetch with the next queued result, or fails when none is queued.
+ */
+@interface UARemoteDataManagerTestAPIClient : UARemoteDataAPIClient
+@property (nonatomic, strong) NSMutableArray<NSDictionary *> *results;
+@property (nonatomic, assign) NSUInteger clearLastModifiedTimeCount;
+@end
+
+@implementation UARemoteDataManagerTestAPIClient
+
+- (UADisposable *)fetchRemoteData:(UARemoteDataRefreshSuccessBlock)successBlock
+                        onFailure:(UARemoteDataRefreshFailureBlock)failureBlock {
+    NSDictionary *result = self.results.firstObject;
+    if (!result) {
+        failureBlock();
+    } else {
+        [self.results removeObjectAtIndex:0];
+        successBlock(200, result[@"remoteData"], result[@"unchangedTypes"]);
+    }
+
+    return [UADisposable disposableWithBlock:^{}];
+}
+
+- (void)clearLastModifiedTime {
+    self.clearLastModifiedTimeCount++;
+}
+
+@end
+
+/**
+ * Tests applying remote data deltas and notifying subscribers.
+ */
+@interface UARemoteDataManagerTest : XCTestCase
+@property (nonatomic, strong) UAPreferenceDataStore *dataStore;
+@property (nonatomic, strong) UARemoteDataStore *remoteDataStore;
+@property (nonatomic, strong) UARemoteDataManagerTestAPIClient *client;
+@property (nonatomic, strong) UARemoteDataManager *remoteDataManager;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, NSMutableArray<NSArray<NSString *> *> *> *published;
+@property (nonatomic, strong) NSMutableArray<UADisposable *> *subscriptions;
+@end
+
+@implementation UARemoteDataManagerTest
+
+- (void)setUp {
+    [super setUp];
+
+    UAConfig *config = [UAConfig config];
+    config.developmentAppKey = @"0123456789abcdefghijkl";
+    config.developmentAppSecret = @"0123456789abcdefghijkl";
+    config.inProduction = NO;
+    UARuntimeConfig *runtimeConfig = [[UARuntimeConfig alloc] initWithConfig:config];
+
+    NSString *name = [NSUUID UUID].UUIDString;
+    self.dataStore = [UAPreferenceDataStore preferenceDataStoreWithKeyPrefix:name];
+    self.remoteDataStore = [UARemoteDataStore storeWithName:[NSString stringWithFormat:@"RemoteData-%@.sqlite", name] inMemory:YES];
+    self.client = [[UARemoteDataManagerTestAPIClient alloc] initWithConfig:runtimeConfig session:[UARequestSession sessionWithConfig:runtimeConfig]];
+    self.client.results = [NSMutableArray array];
+
+    // The refresh on init fails, since no result is queued
+    self.remoteDataManager = [UARemoteDataManager remoteDataManagerWithConfig:runtimeConfig
+                                                                    dataStore:self.dataStore
+                                                              remoteDataStore:self.remoteDataStore
+                                                          remoteDataAPIClient:self.client
+                                                           notificationCenter:[[NSNotificationCenter alloc] init]
+                                                                   dispatcher:[UATestDispatcher testDispatcher]];
+
+    self.published = [NSMutableDictionary dictionary];
+    self.subscriptions = [NSMutableArray array];
+}
+
+- (void)tearDown {
+    for (UADisposable *subscription in self.subscriptions) {
+        [subscription dispose];
+    }
+
+    [self.remoteDataStore shutDown];
+    [self.remoteDataStore waitForIdle];
+    [self.dataStore removeAll];
+    [super tearDown];
+}
+
+#pragma mark -
+#pragma mark Tests
+
+- (void)testDeltaOnlyNotifiesChangedSubscribers {
+    [self subscribeWithName:@"a" types:@[@"a"]];
+    [self subscribeWithName:@"b" types:@[@"b"]];
+    [self subscribeWithName:@"ba" types:@[@"b", @"a"]];
+
+    XCTAssertTrue([self refreshWithPayloads:@[[self payloadWithType:@"a" value:@"a1"], [self payloadWithType:@"b" value:@"b1"]] unchangedTypes:nil]);
+    XCTAssertEqualObjects(self.published[@"a"], (@[@[@"a1"]]));
+    XCTAssertEqualObjects(self.published[@"b"], (@[@[@"b1"]]));
+    XCTAssertEqualObjects(self.published[@"ba"], (@[@[@"b1", @"a1"]]));
+
+    XCTAssertTrue([self refreshWithPayloads:@[[self payloadWithType:@"b" value:@"b2"]] unchangedTypes:@[@"a"]]);
+
+    // The stored hash of the unchanged type matches the hash published with the full response
+    XCTAssertEqualObjects(self.published[@"a"], (@[@[@"a1"]]));
+    XCTAssertEqualObjects(self.published[@"b"], (@[@[@"b1"], @[@"b2"]]));
+
+    // The unchanged type is loaded from the store for a subscriber that also has a changed type
+    XCTAssertEqualObjects(self.published[@"ba"], (@[@[@"b1", @"a1"], @[@"b2", @"a1"]]));
+}
+
+- (void)testUnchangedTypeThenChanged {
+    [self subscribeWithName:@"a" types:@[@"a"]];
+
+    XCTAssertTrue([self refreshWithPayloads:@[[self payloadWithType:@"a" value:@"a1"], [self payloadWithType:@"b" value:@"b1"]] unchangedTypes:nil]);
+    XCTAssertTrue([self refreshWithPayloads:@[[self payloadWithType:@"b" value:@"b2"]] unchangedTypes:@[@"a"]]);
+    XCTAssertTrue([self refreshWithPayloads:@[[self payloadWithType:@"a" value:@"a2"]] unchangedTypes:@[@"b"]]);
+
+    XCTAssertEqualObjects(self.published[@"a"], (@[@[@"a1"], @[@"a2"]]));
+}
+
+- (void)testDeltaWithMissingTypeFallsBackToFullRefresh {
+    [self subscribeWithName:@"a" types:@[@"a"]];
+    XCTAssertTrue([self refreshWithPayloads:@[[self payloadWithType:@"a" value:@"a1"]] unchangedTypes:nil]);
+    NSUInteger clearCount = self.client.clearLastModifiedTimeCount;
+
+    XCTAssertFalse([self refreshWithPayloads:@[[self payloadWithType:@"b" value:@"b1"]] unchangedTypes:@[@"a", @"missing"]]);
+
+    // The last modified time is cleared, so the next refresh is a full fetch
+    XCTAssertEqual(self.client.clearLastModifiedTimeCount, clearCount + 1);
+    XCTAssertEqualObjects(self.published[@"a"], (@[@[@"a1"]]));
+
+    // Nothing of the failed delta was stored
+    [self subscribeWithName:@"ab" types:@[@"a", @"b"]];
+    XCTAssertEqualObjects(self.published[@"ab"], (@[@[@"a1"]]));
+}
+
+- (void)testSubscriberAfterDelta {
+    XCTAssertTrue([self refreshWithPayloads:@[[self payloadWithType:@"a" value:@"a1"], [self payloadWithType:@"b" value:@"b1"]] unchangedTypes:nil]);
+    XCTAssertTrue([self refreshWithPayloads:@[[self payloadWithType:@"b" value:@"b2"]] unchangedTypes:@[@"a"]]);
+
+    [self subscribeWithName:@"ab" types:@[@"a", @"b"]];
+    XCTAssertEqualObjects(self.published[@"ab"], (@[@[@"a1", @"b2"]]));
+}
+
+#pragma mark -
+#pragma mark Helpers
+
+- (NSDictionary *)payloadWithType:(NSString *)type value:(NSString *)value {
+    return @{ @"type": type, @"timestamp": @"2020-01-08T10:00:00", @"data": @{ @"value": value } };
+}
+
+/**
+ * Subscribes and records the data values of each publish under the name, then waits for the
+ * subscriber to be notified of the cached payloads.
+ */
+- (void)subscribeWithName:(NSString *)name types:(NSArray<NSString *> *)types {
+    self.published[name] = [NSMutableArray array];
+
+    UADisposable *subscription = [self.remoteDataManager subscribeWithTypes:types block:^(NSArray<UARemoteDataPayload *> *payloads) {
+        NSMutableArray<NSString *> *values = [NSMutableArray array];
+        for (UARemoteDataPayload *payload in payloads) {
+            [values addObject:payload.data[@"value"]];
+        }
+
+        @synchronized (self.published) {
+            [self.published[name] addObject:values];
+        }
+    }];
+
+    [self.subscriptions addObject:subscription];
+    [self.remoteDataStore waitForIdle];
+}
+
+/**
+ * Refreshes with a full response, or a delta if unchanged types are given, and waits for the subscribers
+ * to be notified.
+ *
+ * @return The refresh result.
+ */
+- (BOOL)refreshWithPayloads:(NSArray<NSDictionary *> *)payloads unchangedTypes:(nullable NSArray<NSString *> *)unchangedTypes {
+    NSMutableDictionary *result = [NSMutableDictionary dictionary];
+    result[@"remoteData"] = payloads;
+    [result setValue:unchangedTypes ? [NSSet setWithArray:unchangedTypes] : nil forKey:@"unchangedTypes"];
+    [self.client.results addObject:result];
+
+    __block BOOL refreshed = NO;
+    XCTestExpectation *completed = [self expectationWithDescription:@"refreshed"];
+    [self.remoteDataManager refreshWithCompletionHandler:^(BOOL success) {
+        refreshed = success;
+        [completed fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:10 handler:nil];
+
+    return refreshed;
+}
+
+@end
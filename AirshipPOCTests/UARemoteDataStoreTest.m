@@ -0,0 +1,121 @@
+/* Copyright Airship and Contributors */
+
+#import <XCTest/XCTest.h>
+#import <Airship/UARemoteDataStore+Internal.h>
+#import <Airship/UARemoteDataStorePayload+Internal.h>
+#import <Airship/UARemoteDataPayload+Internal.h>
+
+/**
+ * Tests applying remote data deltas to the store.
+ */
+@interface UARemoteDataStoreTest : XCTestCase
+@property (nonatomic, strong) UARemoteDataStore *remoteDataStore;
+@end
+
+@implementation UARemoteDataStoreTest
+
+- (void)setUp {
+    [super setUp];
+
+    NSString *storeName = [NSString stringWithFormat:@"RemoteData-%@.sqlite", [NSUUID UUID].UUIDString];
+    self.remoteDataStore = [UARemoteDataStore storeWithName:storeName inMemory:YES];
+}
+
+- (void)tearDown {
+    [self.remoteDataStore shutDown];
+    [self.remoteDataStore waitForIdle];
+    [super tearDown];
+}
+
+#pragma mark -
+#pragma mark Tests
+
+- (void)testDeltaKeepsUnchangedTypes {
+    UARemoteDataPayload *a1 = [self payloadWithType:@"a" value:@"a1"];
+    XCTAssertTrue([self overwriteWithPayloads:@[a1, [self payloadWithType:@"b" value:@"b1"], [self payloadWithType:@"c" value:@"c1"]]]);
+
+    NSDictionary *contentHashes = [self applyDelta:@[[self payloadWithType:@"b" value:@"b2"]] unchangedTypes:@[@"a"]];
+
+    // The stored hash of an unchanged type matches the hash of its payloads
+    XCTAssertEqualObjects(contentHashes, @{ @"a": [UARemoteDataPayload contentHashForPayloads:@[a1]] });
+
+    // Types that are neither changed nor unchanged are removed
+    XCTAssertEqualObjects([self storedValuesByType], (@{ @"a": @[@"a1"], @"b": @[@"b2"] }));
+}
+
+- (void)testDeltaWithMissingUnchangedTypeRollsBack {
+    XCTAssertTrue([self overwriteWithPayloads:@[[self payloadWithType:@"a" value:@"a1"], [self payloadWithType:@"b" value:@"b1"]]]);
+
+    NSDictionary *contentHashes = [self applyDelta:@[[self payloadWithType:@"b" value:@"b2"]] unchangedTypes:@[@"a", @"missing"]];
+
+    XCTAssertNil(contentHashes);
+    XCTAssertEqualObjects([self storedValuesByType], (@{ @"a": @[@"a1"], @"b": @[@"b1"] }));
+}
+
+- (void)testDeltaWithoutUnchangedTypes {
+    XCTAssertTrue([self overwriteWithPayloads:@[[self payloadWithType:@"a" value:@"a1"]]]);
+
+    NSDictionary *contentHashes = [self applyDelta:@[[self payloadWithType:@"b" value:@"b1"]] unchangedTypes:@[]];
+
+    XCTAssertEqualObjects(contentHashes, @{});
+    XCTAssertEqualObjects([self storedValuesByType], (@{ @"b": @[@"b1"] }));
+}
+
+#pragma mark -
+#pragma mark Helpers
+
+- (UARemoteDataPayload *)payloadWithType:(NSString *)type value:(NSString *)value {
+    return [[UARemoteDataPayload alloc] initWithType:type
+                                           timestamp:[NSDate dateWithTimeIntervalSince1970:1000]
+                                                data:@{ @"value": value }
+                                            metadata:@{ @"language": @"en" }];
+}
+
+- (BOOL)overwriteWithPayloads:(NSArray<UARemoteDataPayload *> *)payloads {
+    __block BOOL result = NO;
+    XCTestExpectation *synced = [self expectationWithDescription:@"synced"];
+    [self.remoteDataStore overwriteCachedRemoteDataWithResponse:payloads completionHandler:^(BOOL success) {
+        result = success;
+        [synced fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:10 handler:nil];
+
+    return result;
+}
+
+- (nullable NSDictionary<NSString *, NSString *> *)applyDelta:(NSArray<UARemoteDataPayload *> *)payloads
+                                               unchangedTypes:(NSArray<NSString *> *)unchangedTypes {
+    __block NSDictionary<NSString *, NSString *> *result;
+    XCTestExpectation *applied = [self expectationWithDescription:@"applied"];
+    [self.remoteDataStore applyRemoteDataDelta:payloads
+                                unchangedTypes:[NSSet setWithArray:unchangedTypes]
+                             completionHandler:^(NSDictionary<NSString *, NSString *> *contentHashes) {
+        result = contentHashes;
+        [applied fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:10 handler:nil];
+
+    return result;
+}
+
+/**
+ * The stored data values, keyed by type.
+ */
+- (NSDictionary<NSString *, NSArray<NSString *> *> *)storedValuesByType {
+    NSMutableDictionary<NSString *, NSMutableArray<NSString *> *> *valuesByType = [NSMutableDictionary dictionary];
+    XCTestExpectation *fetched = [self expectationWithDescription:@"fetched"];
+    [self.remoteDataStore fetchRemoteDataFromCacheWithPredicate:nil completionHandler:^(NSArray<UARemoteDataStorePayload *> *payloads) {
+        for (UARemoteDataStorePayload *payload in payloads) {
+            if (!valuesByType[payload.type]) {
+                valuesByType[payload.type] = [NSMutableArray array];
+            }
+            [valuesByType[payload.type] addObject:payload.data[@"value"]];
+        }
+        [fetched fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:10 handler:nil];
+
+    return valuesByType;
+}
+
+@end
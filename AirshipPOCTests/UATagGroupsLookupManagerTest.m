@@ -0,0 +1,322 @@
+/* Copyright Airship and Contributors */
+
+#import <XCTest/XCTest.h>
+#import <Airship/UATagGroupsLookupManager+Internal.h>
+#import <Airship/UATagGroupsLookupResponseCache+Internal.h>
+#import <Airship/UATagGroupsLookupResponse+Internal.h>
+#import <Airship/UATagGroupsLookupAPIClient+Internal.h>
+#import <Airship/UAPreferenceDataStore+Internal.h>
+#import <Airship/UARuntimeConfig+Internal.h>
+#import <Airship/UAConfig.h>
+#import <Airship/UATagGroups.h>
+#import "UATestDate.h"
+
+// Data store keys older SDK versions archived the cache under
+#define kUATagGroupsLookupManagerTestCachedResponseKey @"com.urbanairship.tag_groups.CACHED_RESPONSE"
+#define kUATagGroupsLookupManagerTestCachedRequestTagGroupsKey @"com.urbanairship.tag_groups.CACHED_REQUEST_TAG_GROUPS"
+#define kUATagGroupsLookupManagerTestCacheRefreshDateKey @"com.urbanairship.tag_groups.CACHE_REFRESH_DATE"
+
+// Number of callers looking up the same tag groups at once
+#define kUATagGroupsLookupManagerTestConcurrentCallers 5
+
+// Cache max age in seconds
+#define kUATagGroupsLookupManagerTestMaxAgeTime 60
+
+// Cache stale read time in seconds
+#define kUATagGroupsLookupManagerTestStaleReadTime 600
+
+/**
+ * API client that holds each lookup until the test responds to it.
+ */
+@interface UATagGroupsLookupManagerTestAPIClient : UATagGroupsLookupAPIClient
+@property (nonatomic, strong) NSMutableArray<UATagGroups *> *requestedTagGroups;
+@property (nonatomic, strong) NSMutableArray<void (^)(UATagGroupsLookupResponse *)> *completionHandlers;
+@end
+
+@implementation UATagGroupsLookupManagerTestAPIClient
+
+- (void)lookupTagGroupsWithChannelID:(NSString *)channelID
+                  requestedTagGroups:(UATagGroups *)requestedTagGroups
+                      cachedResponse:(UATagGroupsLookupResponse *)cachedResponse
+                   completionHandler:(void (^)(UATagGroupsLookupResponse *))completionHandler {
+    [self.requestedTagGroups addObject:requestedTagGroups];
+    [self.completionHandlers addObject:completionHandler];
+}
+
+/**
+ * Completes the oldest pending lookup.
+ */
+- (void)respondWithTagGroups:(UATagGroups *)tagGroups {
+    void (^completionHandler)(UATagGroupsLookupResponse *) = self.completionHandlers.firstObject;
+    [self.completionHandlers removeObjectAtIndex:0];
+    completionHandler([UATagGroupsLookupResponse responseWithTagGroups:tagGroups status:200 lastModifiedTimestamp:@"last"]);
+}
+
+@end
+
+/**
+ * Channel with a fixed identifier and channel tag registration disabled.
+ */
+@interface UATagGroupsLookupManagerTestChannel : UAChannel
+@end
+
+@implementation UATagGroupsLookupManagerTestChannel
+
+- (NSString *)identifier {
+    return @"channel";
+}
+
+- (BOOL)isChannelTagRegistrationEnabled {
+    return NO;
+}
+
+@end
+
+/**
+ * Tag groups history without any local mutations.
+ */
+@interface UATagGroupsLookupManagerTestHistory : NSObject <UATagGroupsHistory>
+@end
+
+@implementation UATagGroupsLookupManagerTestHistory
+
+@synthesize maxSentMutationAge;
+
+- (UATagGroups *)applyHistory:(UATagGroups *)tagGroups maxAge:(NSTimeInterval)maxAge {
+    return tagGroups;
+}
+
+@end
+
+/**
+ * Tests coalescing concurrent lookups into a single refresh, serving stale reads while revalidating and
+ * migrating the cache out of the data store.
+ */
+@interface UATagGroupsLookupManagerTest : XCTestCase <UATagGroupsLookupManagerDelegate>
+@property (nonatomic, strong) UAPreferenceDataStore *dataStore;
+@property (nonatomic, strong) NSURL *cacheFileURL;
+@property (nonatomic, strong) UATestDate *testDate;
+@property (nonatomic, strong) UATagGroupsLookupManagerTestAPIClient *client;
+@property (nonatomic, strong) UATagGroupsLookupManagerTestChannel *channel;
+@property (nonatomic, strong) UATagGroupsLookupManagerTestHistory *history;
+@property (nonatomic, strong) UATagGroupsLookupManager *lookupManager;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, UATagGroups *> *results;
+@end
+
+@implementation UATagGroupsLookupManagerTest
+
+- (void)setUp {
+    [super setUp];
+
+    UAConfig *config = [UAConfig config];
+    config.developmentAppKey = @"0123456789abcdefghijkl";
+    config.developmentAppSecret = @"0123456789abcdefghijkl";
+    config.inProduction = NO;
+    UARuntimeConfig *runtimeConfig = [[UARuntimeConfig alloc] initWithConfig:config];
+
+    NSString *name = [NSUUID UUID].UUIDString;
+    self.dataStore = [UAPreferenceDataStore preferenceDataStoreWithKeyPrefix:name];
+    self.cacheFileURL = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:[NSString stringWithFormat:@"TagGroups-%@.plist", name]]];
+    self.testDate = [[UATestDate alloc] initWithAbsoluteTime:[NSDate dateWithTimeIntervalSince1970:1000000]];
+
+    self.client = [UATagGroupsLookupManagerTestAPIClient clientWithConfig:runtimeConfig session:[UARequestSession sessionWithConfig:runtimeConfig]];
+    self.client.requestedTagGroups = [NSMutableArray array];
+    self.client.completionHandlers = [NSMutableArray array];
+
+    self.channel = [[UATagGroupsLookupManagerTestChannel alloc] initWithDataStore:self.dataStore];
+    self.history = [[UATagGroupsLookupManagerTestHistory alloc] init];
+    self.results = [NSMutableDictionary dictionary];
+}
+
+- (void)tearDown {
+    [[NSFileManager defaultManager] removeItemAtURL:self.cacheFileURL error:nil];
+    [self.dataStore removeAll];
+    [super tearDown];
+}
+
+#pragma mark -
+#pragma mark Tests
+
+- (void)testConcurrentCallersShareOneLookup {
+    [self createLookupManager];
+
+    for (NSUInteger i = 0; i < kUATagGroupsLookupManagerTestConcurrentCallers; i++) {
+        [self getTagGroupsWithName:[NSString stringWithFormat:@"%lu", (unsigned long)i] tags:@{ @"group": @[@"a"] }];
+    }
+
+    XCTAssertEqual(self.client.requestedTagGroups.count, 1);
+    XCTAssertEqual(self.results.count, 0);
+
+    [self.client respondWithTagGroups:[UATagGroups tagGroupsWithTags:@{ @"group": @[@"a", @"b"] }]];
+
+    XCTAssertEqual(self.client.requestedTagGroups.count, 1);
+    XCTAssertEqual(self.results.count, kUATagGroupsLookupManagerTestConcurrentCallers);
+    for (NSString *name in self.results) {
+        XCTAssertEqualObjects(self.results[name], [UATagGroups tagGroupsWithTags:@{ @"group": @[@"a"] }]);
+    }
+}
+
+- (void)testJoinsRefreshInFlightAndFoldsIntoPendingRefresh {
+    [self createLookupManager];
+
+    [self getTagGroupsWithName:@"ab" tags:@{ @"group": @[@"a", @"b"] }];
+
+    // Covered by the refresh in flight
+    [self getTagGroupsWithName:@"a" tags:@{ @"group": @[@"a"] }];
+
+    // Not covered, so both are folded into one follow up refresh
+    [self getTagGroupsWithName:@"c" tags:@{ @"group": @[@"c"] }];
+    [self getTagGroupsWithName:@"d" tags:@{ @"other": @[@"d"] }];
+
+    XCTAssertEqualObjects(self.client.requestedTagGroups, @[[UATagGroups tagGroupsWithTags:@{ @"group": @[@"a", @"b"] }]]);
+
+    [self.client respondWithTagGroups:[UATagGroups tagGroupsWithTags:@{ @"group": @[@"a", @"b"] }]];
+
+    XCTAssertEqualObjects(self.results[@"ab"], [UATagGroups tagGroupsWithTags:@{ @"group": @[@"a", @"b"] }]);
+    XCTAssertEqualObjects(self.results[@"a"], [UATagGroups tagGroupsWithTags:@{ @"group": @[@"a"] }]);
+    XCTAssertNil(self.results[@"c"]);
+    XCTAssertNil(self.results[@"d"]);
+
+    // The pending refresh starts as soon as the first one finishes
+    XCTAssertEqual(self.client.requestedTagGroups.count, 2);
+    XCTAssertEqualObjects(self.client.requestedTagGroups[1], ([UATagGroups tagGroupsWithTags:@{ @"group": @[@"c"], @"other": @[@"d"] }]));
+
+    [self.client respondWithTagGroups:[UATagGroups tagGroupsWithTags:@{ @"group": @[@"c"], @"other": @[@"d"] }]];
+
+    XCTAssertEqualObjects(self.results[@"c"], [UATagGroups tagGroupsWithTags:@{ @"group": @[@"c"] }]);
+    XCTAssertEqualObjects(self.results[@"d"], [UATagGroups tagGroupsWithTags:@{ @"other": @[@"d"] }]);
+    XCTAssertEqual(self.client.requestedTagGroups.count, 2);
+}
+
+- (void)testStaleReadWhileRefreshInFlight {
+    [self createLookupManager];
+
+    [self getTagGroupsWithName:@"first" tags:@{ @"group": @[@"a", @"b"] }];
+    [self.client respondWithTagGroups:[UATagGroups tagGroupsWithTags:@{ @"group": @[@"a"] }]];
+
+    // Past the max age but not yet stale, the cached response is served while the cache is refreshed
+    self.testDate.offset = kUATagGroupsLookupManagerTestMaxAgeTime * 2;
+    [self getTagGroupsWithName:@"revalidating" tags:@{ @"group": @[@"a", @"b"] }];
+    [self getTagGroupsWithName:@"joined" tags:@{ @"group": @[@"a", @"b"] }];
+
+    XCTAssertEqualObjects(self.results[@"revalidating"], [UATagGroups tagGroupsWithTags:@{ @"group": @[@"a"] }]);
+    XCTAssertEqualObjects(self.results[@"joined"], [UATagGroups tagGroupsWithTags:@{ @"group": @[@"a"] }]);
+    XCTAssertEqual(self.client.requestedTagGroups.count, 2);
+    XCTAssertEqualObjects(self.client.requestedTagGroups[1], [UATagGroups tagGroupsWithTags:@{ @"group": @[@"a", @"b"] }]);
+
+    // The refreshed response is served from the cache without another lookup
+    [self.client respondWithTagGroups:[UATagGroups tagGroupsWithTags:@{ @"group": @[@"a", @"b"] }]];
+    [self getTagGroupsWithName:@"refreshed" tags:@{ @"group": @[@"a", @"b"] }];
+
+    XCTAssertEqualObjects(self.results[@"refreshed"], [UATagGroups tagGroupsWithTags:@{ @"group": @[@"a", @"b"] }]);
+    XCTAssertEqual(self.client.requestedTagGroups.count, 2);
+
+    // Once stale, callers wait for the refresh
+    self.testDate.offset += kUATagGroupsLookupManagerTestStaleReadTime;
+    [self getTagGroupsWithName:@"stale" tags:@{ @"group": @[@"a", @"b"] }];
+
+    XCTAssertNil(self.results[@"stale"]);
+    XCTAssertEqual(self.client.requestedTagGroups.count, 3);
+
+    [self.client respondWithTagGroups:[UATagGroups tagGroupsWithTags:@{ @"group": @[@"b"] }]];
+    XCTAssertEqualObjects(self.results[@"stale"], [UATagGroups tagGroupsWithTags:@{ @"group": @[@"b"] }]);
+}
+
+- (void)testStaleWhileRevalidateDisabled {
+    [self createLookupManager];
+    self.lookupManager.staleWhileRevalidate = NO;
+
+    [self getTagGroupsWithName:@"first" tags:@{ @"group": @[@"a"] }];
+    [self.client respondWithTagGroups:[UATagGroups tagGroupsWithTags:@{ @"group": @[@"a"] }]];
+
+    self.testDate.offset = kUATagGroupsLookupManagerTestMaxAgeTime * 2;
+    [self getTagGroupsWithName:@"refresh" tags:@{ @"group": @[@"a"] }];
+
+    XCTAssertNil(self.results[@"refresh"]);
+    XCTAssertEqual(self.client.requestedTagGroups.count, 2);
+}
+
+- (void)testMigratesDataStoreCache {
+    UATagGroups *requestedTagGroups = [UATagGroups tagGroupsWithTags:@{ @"group": @[@"a", @"b"] }];
+    UATagGroupsLookupResponse *response = [UATagGroupsLookupResponse responseWithTagGroups:[UATagGroups tagGroupsWithTags:@{ @"group": @[@"a"] }]
+                                                                                   status:200
+                                                                    lastModifiedTimestamp:@"last"];
+
+    [self.dataStore setObject:[NSKeyedArchiver archivedDataWithRootObject:response] forKey:kUATagGroupsLookupManagerTestCachedResponseKey];
+    [self.dataStore setObject:[NSKeyedArchiver archivedDataWithRootObject:requestedTagGroups] forKey:kUATagGroupsLookupManagerTestCachedRequestTagGroupsKey];
+    [self.dataStore setObject:[self.testDate now] forKey:kUATagGroupsLookupManagerTestCacheRefreshDateKey];
+
+    UATagGroupsLookupResponseCache *cache = [self createCache];
+    [self assertCache:cache containsResponse:response requestedTagGroups:requestedTagGroups];
+
+    // The archived cache is moved to a binary property list file
+    XCTAssertNil([self.dataStore objectForKey:kUATagGroupsLookupManagerTestCachedResponseKey]);
+    XCTAssertNil([self.dataStore objectForKey:kUATagGroupsLookupManagerTestCachedRequestTagGroupsKey]);
+    XCTAssertNil([self.dataStore objectForKey:kUATagGroupsLookupManagerTestCacheRefreshDateKey]);
+
+    NSPropertyListFormat format;
+    NSData *data = [NSData dataWithContentsOfURL:self.cacheFileURL];
+    XCTAssertNotNil([NSPropertyListSerialization propertyListWithData:data options:NSPropertyListImmutable format:&format error:nil]);
+    XCTAssertEqual(format, NSPropertyListBinaryFormat_v1_0);
+
+    // Loaded from the file from then on
+    [self assertCache:[self createCache] containsResponse:response requestedTagGroups:requestedTagGroups];
+
+    // The migrated response is served without a lookup
+    [self createLookupManager];
+    [self getTagGroupsWithName:@"migrated" tags:@{ @"group": @[@"a"] }];
+
+    XCTAssertEqualObjects(self.results[@"migrated"], [UATagGroups tagGroupsWithTags:@{ @"group": @[@"a"] }]);
+    XCTAssertEqual(self.client.requestedTagGroups.count, 0);
+}
+
+#pragma mark -
+#pragma mark UATagGroupsLookupManagerDelegate
+
+- (void)gatherTagGroupsWithCompletionHandler:(void (^)(UATagGroups *))completionHandler {
+    completionHandler([UATagGroups tagGroupsWithTags:@{}]);
+}
+
+#pragma mark -
+#pragma mark Helpers
+
+- (UATagGroupsLookupResponseCache *)createCache {
+    UATagGroupsLookupResponseCache *cache = [UATagGroupsLookupResponseCache cacheWithDataStore:self.dataStore
+                                                                                       fileURL:self.cacheFileURL
+                                                                                   currentTime:self.testDate];
+    cache.maxAgeTime = kUATagGroupsLookupManagerTestMaxAgeTime;
+    cache.staleReadTime = kUATagGroupsLookupManagerTestStaleReadTime;
+    return cache;
+}
+
+- (void)createLookupManager {
+    self.lookupManager = [UATagGroupsLookupManager lookupManagerWithAPIClient:self.client
+                                                                    dataStore:self.dataStore
+                                                                        cache:[self createCache]
+                                                             tagGroupsHistory:self.history
+                                                                      channel:self.channel
+                                                                  currentTime:self.testDate];
+    self.lookupManager.delegate = self;
+}
+
+/**
+ * Looks up the tag groups, recording the result under the name once the lookup completes.
+ */
+- (void)getTagGroupsWithName:(NSString *)name tags:(NSDictionary *)tags {
+    [self.lookupManager getTagGroups:[UATagGroups tagGroupsWithTags:tags] completionHandler:^(UATagGroups *tagGroups, NSError *error) {
+        XCTAssertNil(error);
+        self.results[name] = tagGroups;
+    }];
+}
+
+- (void)assertCache:(UATagGroupsLookupResponseCache *)cache
+   containsResponse:(UATagGroupsLookupResponse *)response
+ requestedTagGroups:(UATagGroups *)requestedTagGroups {
+    XCTAssertEqualObjects(cache.response.tagGroups, response.tagGroups);
+    XCTAssertEqual(cache.response.status, response.status);
+    XCTAssertEqualObjects(cache.response.lastModifiedTimestamp, response.lastModifiedTimestamp);
+    XCTAssertEqualObjects(cache.requestedTagGroups, requestedTagGroups);
+    XCTAssertEqualObjects(cache.refreshDate, [self.testDate now]);
+}
+
+@end
@@ -0,0 +1,32 @@
+/* Copyright Airship and Contributors */
+
+#import <Airship/UADate.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * Date whose current time is set by the test.
+ */
+@interface UATestDate : UADate
+
+/**
+ * The time reported by `now` before the offset is applied.
+ */
+@property (nonatomic, strong) NSDate *absoluteTime;
+
+/**
+ * The offset in seconds added to the absolute time.
+ */
+@property (nonatomic, assign) NSTimeInterval offset;
+
+/**
+ * Init method.
+ *
+ * @param absoluteTime The initial time.
+ * @return A test date.
+ */
+- (instancetype)initWithAbsoluteTime:(NSDate *)absoluteTime;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,21 @@
+/* Copyright Airship and Contributors */
+
+#import "UATestDate.h"
+
+@implementation UATestDate
+
+- (instancetype)initWithAbsoluteTime:(NSDate *)absoluteTime {
+    self = [super init];
+
+    if (self) {
+        self.absoluteTime = absoluteTime;
+    }
+
+    return self;
+}
+
+- (NSDate *)now {
+    return [self.absoluteTime dateByAddingTimeInterval:self.offset];
+}
+
+@end
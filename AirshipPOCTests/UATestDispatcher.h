@@ -0,0 +1,29 @@
+/* Copyright Airship and Contributors */
+
+#import <Airship/UADispatcher.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * Dispatcher that runs blocks immediately on the calling thread. Delayed blocks run when the
+ * dispatcher's clock is advanced past their time.
+ */
+@interface UATestDispatcher : UADispatcher
+
+/**
+ * Factory method.
+ *
+ * @return A test dispatcher.
+ */
++ (instancetype)testDispatcher;
+
+/**
+ * Advances the dispatcher's clock and runs the delayed blocks that became due, in time order.
+ *
+ * @param time The time in seconds.
+ */
+- (void)advanceTime:(NSTimeInterval)time;
+
+@end
+
+NS_ASSUME_NONNULL_END
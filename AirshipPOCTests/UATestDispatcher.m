@@ -0,0 +1,96 @@
+/* Copyright Airship and Contributors */
+
+#import "UATestDispatcher.h"
+#import <Airship/UADisposable.h>
+
+@interface UATestDispatcherScheduledBlock : NSObject
+@property (nonatomic, assign) NSTimeInterval time;
+@property (nonatomic, copy) void (^block)(void);
+@end
+
+@implementation UATestDispatcherScheduledBlock
+@end
+
+@interface UATestDispatcher ()
+@property (nonatomic, assign) NSTimeInterval currentTime;
+@property (nonatomic, strong) NSMutableArray<UATestDispatcherScheduledBlock *> *scheduledBlocks;
+@end
+
+@implementation UATestDispatcher
+
+- (instancetype)init {
+    self = [super init];
+
+    if (self) {
+        self.scheduledBlocks = [NSMutableArray array];
+    }
+
+    return self;
+}
+
++ (instancetype)testDispatcher {
+    return [[self alloc] init];
+}
+
+- (UADisposable *)dispatchAfter:(NSTimeInterval)delay block:(void (^)(void))block {
+    UATestDispatcherScheduledBlock *scheduledBlock = [[UATestDispatcherScheduledBlock alloc] init];
+    scheduledBlock.block = block;
+
+    @synchronized (self) {
+        scheduledBlock.time = self.currentTime + MAX(0, delay);
+        [self.scheduledBlocks addObject:scheduledBlock];
+    }
+
+    return [UADisposable disposableWithBlock:^{
+        @synchronized (self) {
+            [self.scheduledBlocks removeObject:scheduledBlock];
+        }
+    }];
+}
+
+- (void)dispatchAsync:(void (^)(void))block {
+    block();
+}
+
+- (void)dispatchSync:(void (^)(void))block {
+    block();
+}
+
+- (void)doSync:(void (^)(void))block {
+    block();
+}
+
+- (void)dispatchAsyncIfNecessary:(void (^)(void))block {
+    block();
+}
+
+- (void)advanceTime:(NSTimeInterval)time {
+    NSTimeInterval targetTime;
+    @synchronized (self) {
+        self.currentTime += time;
+        targetTime = self.currentTime;
+    }
+
+    // Blocks may schedule more blocks, so the earliest due block is taken one at a time
+    while (YES) {
+        UATestDispatcherScheduledBlock *next;
+
+        @synchronized (self) {
+            for (UATestDispatcherScheduledBlock *scheduledBlock in self.scheduledBlocks) {
+                if (scheduledBlock.time <= targetTime && (!next || scheduledBlock.time < next.time)) {
+                    next = scheduledBlock;
+                }
+            }
+
+            if (!next) {
+                return;
+            }
+
+            [self.scheduledBlocks removeObject:next];
+        }
+
+        next.block();
+    }
+}
+
+@end
@@ -1,5 +1,6 @@
 #if UA_USE_MODULE_IMPORT
 #import <AirshipCore/AirshipCore.h>
+#import <AirshipCore/UAMetrics+Internal.h>
 #else
 #import "NSJSONSerialization+UAAdditions.h"
 #import "NSOperationQueue+UAAdditions.h"
@@ -69,4 +70,5 @@
 #import "NSManagedObjectContext+UAAdditions.h"
 #import "UAActionPredicateProtocol.h"
 #import "UAJSONSerialization.h"
+#import "UAMetrics+Internal.h"
 #endif
@@ -6,6 +6,7 @@
 #import "UASchedule.h"
 #import "UAScheduleInfo.h"
 #import "UATimerScheduler+Internal.h"
+#import "UAAutomationEngineMetrics+Internal.h"
 #import "UAAirshipAutomationCoreImport.h"
 
 NS_ASSUME_NONNULL_BEGIN
@@ -135,6 +136,11 @@ typedef NS_ENUM(NSInteger, UAAutomationScheduleReadyResult) {
  */
 @property (nonatomic, strong) UAAutomationStore *automationStore;
 
+/**
+ * Metrics for trigger evaluation, recorded while set. Defaults to `nil`. Used for benchmarking.
+ */
+@property (nonatomic, strong, nullable) UAAutomationEngineMetrics *metrics;
+
 /**
  * Automation Engine constructor.
  *
@@ -210,6 +216,22 @@ typedef NS_ENUM(NSInteger, UAAutomationScheduleReadyResult) {
  */
 - (void)scheduleConditionsChanged;
 
+/**
+ * Updates the triggers of a type with an event. Used for benchmarking.
+ *
+ * @param triggerType The trigger type.
+ * @param argument The event argument the trigger predicates are evaluated against.
+ * @param amount The amount to increment the trigger progress by.
+ */
+- (void)updateTriggersWithType:(UAScheduleTriggerType)triggerType argument:(nullable id)argument incrementAmount:(double)amount;
+
+/**
+ * Returns the metrics report, including the store saves made since the metrics were set.
+ *
+ * @return The report, or `nil` if metrics are not set.
+ */
+- (nullable NSDictionary<NSString *, NSNumber *> *)metricsReport;
+
 /**
  * Cancels a schedule with the given identifier.
  *
@@ -255,6 +277,14 @@ typedef NS_ENUM(NSInteger, UAAutomationScheduleReadyResult) {
 - (void)getScheduleWithID:(NSString *)identifier
         completionHandler:(void (^)(UASchedule * _Nullable))completionHandler;
 
+/**
+ * Gets the progress of idle schedules toward their trigger goals.
+ *
+ * @param completionHandler The completion handler with the progress keyed by schedule identifier,
+ * from 0 to 1.
+ */
+- (void)getTriggerProgress:(void (^)(NSDictionary<NSString *, NSNumber *> *))completionHandler;
+
 /**
  * Gets all unended schedules.
  *
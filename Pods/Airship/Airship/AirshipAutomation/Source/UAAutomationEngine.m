@@ -11,6 +11,19 @@
 #import "UAScheduleEdits+Internal.h"
 #import "UAAirshipAutomationCoreImport.h"
 
+// Schedule handles kept for reuse across fetches
+static NSUInteger const UAAutomationEngineScheduleCacheLimit = 1000;
+
+// Keys for schedule values copied off the store's managed objects
+static NSString * const UAAutomationEngineTriggerTypeKey = @"type";
+static NSString * const UAAutomationEngineTriggerGoalKey = @"goal";
+static NSString * const UAAutomationEngineTriggerPredicateKey = @"predicate";
+static NSString * const UAAutomationEngineDelaySecondsKey = @"seconds";
+static NSString * const UAAutomationEngineDelayScreensKey = @"screens";
+static NSString * const UAAutomationEngineDelayRegionIDKey = @"region_id";
+static NSString * const UAAutomationEngineDelayAppStateKey = @"app_state";
+static NSString * const UAAutomationEngineDelayCancellationTriggersKey = @"cancellation_triggers";
+
 @interface UAAutomationStateCondition : NSObject
 
 @property (nonatomic, copy, nonnull) BOOL (^predicate)(void);
@@ -52,6 +65,10 @@
 @property (atomic, assign) BOOL paused;
 @property (nonatomic, readonly) BOOL isForegrounded;
 
+// Store saves when the metrics were set
+@property (atomic, assign) NSUInteger metricsSaveCount;
+@property (nonatomic, strong) NSCache<NSString *, UASchedule *> *scheduleCache;
+
 @end
 
 @implementation UAAutomationEngine
@@ -83,6 +100,8 @@
         self.activeTimers = [NSMutableArray array];
         self.stateConditions = [NSMutableDictionary dictionary];
         self.paused = NO;
+        self.scheduleCache = [[NSCache alloc] init];
+        self.scheduleCache.countLimit = UAAutomationEngineScheduleCacheLimit;
     }
 
     return self;
@@ -281,6 +300,7 @@
     }];
 
     [self.automationStore deleteSchedule:identifier];
+    [self.scheduleCache removeObjectForKey:identifier];
     [self cancelTimersWithIdentifiers:[NSSet setWithArray:@[identifier]]];
 }
 
@@ -299,6 +319,7 @@
     }];
 
     [self.automationStore deleteAllSchedules];
+    [self.scheduleCache removeAllObjects];
     [self cancelTimers];
 }
 
@@ -312,6 +333,7 @@
             UASchedule *schedule = [self scheduleFromData:scheduleData];
             [self notifyDelegateOnScheduleCancelled:schedule];
             [schedules addObject:schedule];
+            [self.scheduleCache removeObjectForKey:scheduleData.identifier];
         }
 
         if (completionHandler) {
@@ -345,17 +367,25 @@
     }];
 }
 
+- (void)getTriggerProgress:(void (^)(NSDictionary<NSString *, NSNumber *> *))completionHandler {
+    UA_WEAKIFY(self)
+    [self.automationStore getTriggerProgress:^(NSDictionary<NSString *, NSNumber *> *progress) {
+        UA_STRONGIFY(self)
+        [self.dispatcher dispatchAsync:^{
+            completionHandler(progress);
+        }];
+    }];
+}
+
 - (void)getSchedules:(void (^)(NSArray<UASchedule *> *))completionHandler {
     UA_WEAKIFY(self)
     [self.automationStore getSchedules:^(NSArray<UAScheduleData *> *schedulesData) {
         UA_STRONGIFY(self)
 
+        // Handles only decode what callers access
         NSMutableArray *schedules = [NSMutableArray array];
         for (UAScheduleData *scheduleData in schedulesData) {
-            UASchedule *schedule = [self scheduleFromData:scheduleData];
-            if (schedule) {
-                [schedules addObject:schedule];
-            }
+            [schedules addObject:[self scheduleHandleFromData:scheduleData]];
         }
 
         [self.dispatcher dispatchAsync:^{
@@ -369,12 +399,10 @@
     [self.automationStore getAllSchedules:^(NSArray<UAScheduleData *> *schedulesData) {
         UA_STRONGIFY(self)
 
+        // Handles only decode what callers access
         NSMutableArray *schedules = [NSMutableArray array];
         for (UAScheduleData *scheduleData in schedulesData) {
-            UASchedule *schedule = [self scheduleFromData:scheduleData];
-            if (schedule) {
-                [schedules addObject:schedule];
-            }
+            [schedules addObject:[self scheduleHandleFromData:scheduleData]];
         }
 
         [self.dispatcher dispatchAsync:^{
@@ -387,12 +415,10 @@
     UA_WEAKIFY(self)
     [self.automationStore getSchedules:group completionHandler:^(NSArray<UAScheduleData *> *schedulesData) {
         UA_STRONGIFY(self)
+        // Handles only decode what callers access
         NSMutableArray *schedules = [NSMutableArray array];
         for (UAScheduleData *scheduleData in schedulesData) {
-            UASchedule *schedule = [self scheduleFromData:scheduleData];
-            if (schedule) {
-                [schedules addObject:[self scheduleFromData:scheduleData]];
-            }
+            [schedules addObject:[self scheduleHandleFromData:scheduleData]];
         }
 
         [self.dispatcher dispatchAsync:^{
@@ -412,6 +438,7 @@
         UASchedule *schedule = nil;
         if (scheduleData) {
             [UAAutomationEngine applyEdits:edits toData:scheduleData];
+            [self.scheduleCache removeObjectForKey:identifier];
 
             BOOL overLimit = [scheduleData isOverLimit];
             BOOL isExpired = [scheduleData isExpired];
@@ -483,7 +510,7 @@
             }
 
             if ([finishDate compare:self.date.now] == NSOrderedAscending) {
-                [scheduleData.managedObjectContext deleteObject:scheduleData];
+                [self deleteScheduleData:scheduleData];
             }
         }
     }];
@@ -581,11 +608,13 @@
     UA_LDEBUG(@"Updating triggers with type: %ld", (long)triggerType);
 
     NSDate *start = self.date.now;
+    NSTimeInterval eventTime = [NSProcessInfo processInfo].systemUptime;
 
     UA_WEAKIFY(self)
     [self.automationStore getActiveTriggers:scheduleID type:triggerType completionHandler:^(NSArray<UAScheduleTriggerData *> *triggers) {
 
         UA_STRONGIFY(self)
+        NSTimeInterval evaluationStartTime = [NSProcessInfo processInfo].systemUptime;
 
         // Capture what schedules need to be cancelled and executed in sets so we do not double process any schedules
         NSMutableSet *schedulesToCancel = [NSMutableSet set];
@@ -634,6 +663,16 @@
 
         NSTimeInterval executionTime = -[start timeIntervalSinceDate:self.date.now];
         UA_LTRACE(@"Automation execution time: %f seconds, triggers: %ld, triggered schedules: %ld", executionTime, (unsigned long)triggers.count, (unsigned long)schedulesToExecute.count);
+
+        NSTimeInterval evaluationEndTime = [NSProcessInfo processInfo].systemUptime;
+        UAMetricsRecordDuration(UAMetricsHistogramTriggerEvaluation, evaluationEndTime - evaluationStartTime);
+        UAMetricsIncrement(UAMetricsCounterTriggersEvaluated, triggers.count);
+        UAMetricsIncrement(UAMetricsCounterSchedulesTriggered, schedulesToExecute.count);
+
+        [self.metrics recordEventWithLatency:evaluationEndTime - eventTime
+                              evaluationTime:evaluationEndTime - evaluationStartTime
+                                triggerCount:triggers.count
+                              triggeredCount:schedulesToExecute.count];
     }];
 }
 
@@ -641,6 +680,15 @@
     [self updateTriggersWithScheduleID:nil type:triggerType argument:argument incrementAmount:amount];
 }
 
+- (void)setMetrics:(UAAutomationEngineMetrics *)metrics {
+    _metrics = metrics;
+    self.metricsSaveCount = self.automationStore.saveCount;
+}
+
+- (nullable NSDictionary<NSString *, NSNumber *> *)metricsReport {
+    return [self.metrics reportWithStoreSaves:self.automationStore.saveCount - self.metricsSaveCount];
+}
+
 /**
  * Starts a timer for the schedule.
  *
@@ -1116,7 +1164,7 @@
                 switch (prepareResult) {
                     case UAAutomationSchedulePrepareResultCancel:
                         [self notifyDelegateOnScheduleCancelled:[self scheduleFromData:scheduleData]];
-                        [scheduleData.managedObjectContext deleteObject:scheduleData];
+                        [self deleteScheduleData:scheduleData];
                         break;
                     case UAAutomationSchedulePrepareResultContinue:
                         scheduleData.executionState = @(UAScheduleStateWaitingScheduleConditions);
@@ -1233,10 +1281,21 @@
 
     if ([scheduleData.editGracePeriod doubleValue] <= 0) {
         UA_LDEBUG(@"Deleting schedule: %@", scheduleData.identifier);
-        [scheduleData.managedObjectContext deleteObject:scheduleData];
+        [self deleteScheduleData:scheduleData];
     }
 }
 
+/**
+ * Deletes the schedule data and drops its cached handle, so a schedule saved later with the same
+ * identifier is not served the deleted schedule's decoded values. Must be called on the store's context.
+ *
+ * @param scheduleData The schedule data.
+ */
+- (void)deleteScheduleData:(UAScheduleData *)scheduleData {
+    [self.scheduleCache removeObjectForKey:scheduleData.identifier];
+    [scheduleData.managedObjectContext deleteObject:scheduleData];
+}
+
 - (void)scheduleFinishedExecuting:(UAScheduleData *)scheduleData {
     if (!scheduleData) {
         return;
@@ -1256,8 +1315,8 @@
     if ([scheduleData isOverLimit]) {
         // Over limit
         UA_LDEBUG(@"Limit reached for schedule %@", scheduleData.identifier);
-        [self finishSchedule:scheduleData];
         [self notifyDelegateOnScheduleLimitReached:[self scheduleFromData:scheduleData]];
+        [self finishSchedule:scheduleData];
     } else if ([scheduleData.interval doubleValue] > 0) {
         // Paused
         scheduleData.executionState = @(UAScheduleStatePaused);
@@ -1329,45 +1388,96 @@
 #pragma mark Converters
 
 - (nullable UASchedule *)scheduleFromData:(UAScheduleData *)scheduleData {
-    UAScheduleInfoBuilder *builder = [[UAScheduleInfoBuilder alloc] init];
-    builder.triggers = [UAAutomationEngine triggersFromData:scheduleData.triggers];
-    builder.delay = [UAAutomationEngine delayFromData:scheduleData.delay];
-    builder.group = scheduleData.group;
-    builder.data = scheduleData.data;
-    builder.start = scheduleData.start;
-    builder.end = scheduleData.end;
-    builder.priority = [scheduleData.priority integerValue];
-    builder.limit = [scheduleData.limit unsignedIntegerValue];
-    builder.interval = [scheduleData.interval doubleValue];
-    builder.editGracePeriod = [scheduleData.editGracePeriod doubleValue];
-
-    UASchedule *schedule;
-    UAScheduleInfo *info = [self.delegate createScheduleInfoWithBuilder:builder];
+    if (!scheduleData) {
+        return nil;
+    }
 
+    UASchedule *schedule = [self scheduleHandleFromData:scheduleData];
+
+    // Decodes the info, the result is kept on the cached handle
+    UAScheduleInfo *info = schedule.info;
     if (![info isValid]) {
         UA_LERR(@"Info is invalid: %@", info);
-        schedule = nil;
-    } else {
-        schedule = [UASchedule scheduleWithIdentifier:scheduleData.identifier
-                                                 info:info
-                                             metadata:[NSJSONSerialization objectWithString:scheduleData.metadata] ?: @{}];
+        UA_LERR(@"Failed to parse schedule data. Deleting %@", scheduleData.identifier);
+        [self deleteScheduleData:scheduleData];
+        return nil;
     }
 
-    if (!schedule) {
-        UA_LERR(@"Failed to parse schedule data. Deleting %@", scheduleData.identifier);
-        [scheduleData.managedObjectContext deleteObject:scheduleData];
+    return schedule;
+}
+
+/**
+ * Returns a schedule handle for the data. The handle only decodes the triggers, delay, metadata and info on first access,
+ * and is cached so the decoded values are reused until the schedule is edited or deleted.
+ *
+ * @param scheduleData The schedule data. Must be accessed on the store's context.
+ * @return The schedule handle.
+ */
+- (UASchedule *)scheduleHandleFromData:(UAScheduleData *)scheduleData {
+    UASchedule *cached = [self.scheduleCache objectForKey:scheduleData.identifier];
+    if (cached) {
+        return cached;
     }
 
+    // Copy the values off the managed object, the info can be decoded outside of the store's context
+    NSArray<NSDictionary *> *triggerValues = [UAAutomationEngine triggerValuesFromData:scheduleData.triggers];
+    NSDictionary *delayValues = [UAAutomationEngine delayValuesFromData:scheduleData.delay];
+    NSString *group = scheduleData.group;
+    NSString *data = scheduleData.data;
+    NSDate *start = scheduleData.start;
+    NSDate *end = scheduleData.end;
+    NSInteger priority = [scheduleData.priority integerValue];
+    NSUInteger limit = [scheduleData.limit unsignedIntegerValue];
+    NSTimeInterval interval = [scheduleData.interval doubleValue];
+    NSTimeInterval editGracePeriod = [scheduleData.editGracePeriod doubleValue];
+
+    UA_WEAKIFY(self)
+    UASchedule *schedule = [UASchedule scheduleWithIdentifier:scheduleData.identifier
+                                                        group:group
+                                                     priority:priority
+                                                 metadataJSON:scheduleData.metadata
+                                                    infoBlock:^UAScheduleInfo *{
+        UA_STRONGIFY(self)
+        UAScheduleInfoBuilder *builder = [[UAScheduleInfoBuilder alloc] init];
+        builder.triggers = [UAAutomationEngine triggersFromValues:triggerValues];
+        builder.delay = [UAAutomationEngine delayFromValues:delayValues];
+        builder.group = group;
+        builder.data = data;
+        builder.start = start;
+        builder.end = end;
+        builder.priority = priority;
+        builder.limit = limit;
+        builder.interval = interval;
+        builder.editGracePeriod = editGracePeriod;
+
+        return [self.delegate createScheduleInfoWithBuilder:builder];
+    }];
+
+    [self.scheduleCache setObject:schedule forKey:scheduleData.identifier];
     return schedule;
 }
 
-+ (NSArray<UAScheduleTrigger *> *)triggersFromData:(NSSet<UAScheduleTriggerData *> *)data {
-    NSMutableArray *triggers = [NSMutableArray array];
++ (NSArray<NSDictionary *> *)triggerValuesFromData:(NSSet<UAScheduleTriggerData *> *)data {
+    NSMutableArray *values = [NSMutableArray arrayWithCapacity:data.count];
 
     for (UAScheduleTriggerData *triggerData in data) {
-        UAScheduleTrigger *trigger = [UAScheduleTrigger triggerWithType:(UAScheduleTriggerType)[triggerData.type integerValue]
-                                                                   goal:triggerData.goal
-                                                              predicate:[UAAutomationEngine predicateFromData:triggerData.predicateData]];
+        NSMutableDictionary *triggerValues = [NSMutableDictionary dictionary];
+        [triggerValues setValue:triggerData.type forKey:UAAutomationEngineTriggerTypeKey];
+        [triggerValues setValue:triggerData.goal forKey:UAAutomationEngineTriggerGoalKey];
+        [triggerValues setValue:triggerData.predicateData forKey:UAAutomationEngineTriggerPredicateKey];
+        [values addObject:triggerValues];
+    }
+
+    return values;
+}
+
++ (NSArray<UAScheduleTrigger *> *)triggersFromValues:(NSArray<NSDictionary *> *)values {
+    NSMutableArray *triggers = [NSMutableArray array];
+
+    for (NSDictionary *triggerValues in values) {
+        UAScheduleTrigger *trigger = [UAScheduleTrigger triggerWithType:(UAScheduleTriggerType)[triggerValues[UAAutomationEngineTriggerTypeKey] integerValue]
+                                                                   goal:triggerValues[UAAutomationEngineTriggerGoalKey]
+                                                              predicate:[UAAutomationEngine predicateFromData:triggerValues[UAAutomationEngineTriggerPredicateKey]]];
 
         [triggers addObject:trigger];
     }
@@ -1375,21 +1485,34 @@
     return triggers;
 }
 
-
-+ (UAScheduleDelay *)delayFromData:(UAScheduleDelayData *)data {
++ (nullable NSDictionary *)delayValuesFromData:(UAScheduleDelayData *)data {
     if (!data) {
         return nil;
     }
 
+    NSMutableDictionary *delayValues = [NSMutableDictionary dictionary];
+    [delayValues setValue:data.seconds forKey:UAAutomationEngineDelaySecondsKey];
+    [delayValues setValue:data.screens forKey:UAAutomationEngineDelayScreensKey];
+    [delayValues setValue:data.regionID forKey:UAAutomationEngineDelayRegionIDKey];
+    [delayValues setValue:data.appState forKey:UAAutomationEngineDelayAppStateKey];
+    [delayValues setValue:[UAAutomationEngine triggerValuesFromData:data.cancellationTriggers] forKey:UAAutomationEngineDelayCancellationTriggersKey];
+    return delayValues;
+}
+
++ (UAScheduleDelay *)delayFromValues:(NSDictionary *)values {
+    if (!values) {
+        return nil;
+    }
+
     return [UAScheduleDelay delayWithBuilderBlock:^(UAScheduleDelayBuilder *builder) {
-        builder.seconds = [data.seconds doubleValue];
-        NSData *screenData = [data.screens dataUsingEncoding:NSUTF8StringEncoding];
+        builder.seconds = [values[UAAutomationEngineDelaySecondsKey] doubleValue];
+        NSData *screenData = [values[UAAutomationEngineDelayScreensKey] dataUsingEncoding:NSUTF8StringEncoding];
         if (screenData != nil) {
             builder.screens = [NSJSONSerialization JSONObjectWithData:screenData options:NSJSONReadingMutableContainers error:nil];
         }
-        builder.regionID = data.regionID;
-        builder.cancellationTriggers = [UAAutomationEngine triggersFromData:data.cancellationTriggers];
-        builder.appState = [data.appState integerValue];
+        builder.regionID = values[UAAutomationEngineDelayRegionIDKey];
+        builder.cancellationTriggers = [UAAutomationEngine triggersFromValues:values[UAAutomationEngineDelayCancellationTriggersKey]];
+        builder.appState = [values[UAAutomationEngineDelayAppStateKey] integerValue];
     }];
 }
 
@@ -1398,8 +1521,26 @@
         return nil;
     }
 
+    // Predicates compile on first evaluation, keep them so triggers are not parsed and compiled on every event
+    static NSCache<NSData *, UAJSONPredicate *> *predicateCache;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        predicateCache = [[NSCache alloc] init];
+        predicateCache.countLimit = UAAutomationEngineScheduleCacheLimit;
+    });
+
+    UAJSONPredicate *predicate = [predicateCache objectForKey:data];
+    if (predicate) {
+        return predicate;
+    }
+
     id json = [NSJSONSerialization JSONObjectWithData:data options:NSJSONReadingMutableContainers error:nil];
-    return [UAJSONPredicate predicateWithJSON:json error:nil];
+    predicate = [UAJSONPredicate predicateWithJSON:json error:nil];
+    if (predicate) {
+        [predicateCache setObject:predicate forKey:data];
+    }
+
+    return predicate;
 }
 
 + (void)applyEdits:(UAScheduleEdits *)edits toData:(UAScheduleData *)scheduleData {
@@ -0,0 +1,66 @@
+/* Copyright Airship and Contributors */
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * Metrics report keys.
+ */
+extern NSString * const UAAutomationEngineMetricsEventsKey;
+extern NSString * const UAAutomationEngineMetricsEventsPerSecondKey;
+extern NSString * const UAAutomationEngineMetricsTriggersEvaluatedKey;
+extern NSString * const UAAutomationEngineMetricsSchedulesTriggeredKey;
+extern NSString * const UAAutomationEngineMetricsEvaluationP50Key;
+extern NSString * const UAAutomationEngineMetricsEvaluationP99Key;
+extern NSString * const UAAutomationEngineMetricsLatencyP50Key;
+extern NSString * const UAAutomationEngineMetricsLatencyP99Key;
+extern NSString * const UAAutomationEngineMetricsStoreSavesKey;
+extern NSString * const UAAutomationEngineMetricsStoreSavesPerEventKey;
+
+/**
+ * Collects automation engine throughput and trigger evaluation timings, for benchmarking the
+ * engine under load. Only the most recent samples are kept for percentiles.
+ */
+@interface UAAutomationEngineMetrics : NSObject
+
+///---------------------------------------------------------------------------------------
+/// @name Automation Engine Metrics Internal Methods
+///---------------------------------------------------------------------------------------
+
+/**
+ * Factory method.
+ *
+ * @return A metrics instance.
+ */
++ (instancetype)metrics;
+
+/**
+ * Records an event that was run through the triggers.
+ *
+ * @param latency The time in seconds from the event to the end of its evaluation, including time spent queued.
+ * @param evaluationTime The time in seconds spent evaluating the triggers.
+ * @param triggerCount The number of triggers evaluated.
+ * @param triggeredCount The number of schedules that were triggered.
+ */
+- (void)recordEventWithLatency:(NSTimeInterval)latency
+                evaluationTime:(NSTimeInterval)evaluationTime
+                  triggerCount:(NSUInteger)triggerCount
+                triggeredCount:(NSUInteger)triggeredCount;
+
+/**
+ * Returns the metrics as a JSON serializable report. Times are in milliseconds.
+ *
+ * @param storeSaves The number of store saves made while the metrics were recorded.
+ * @return The report.
+ */
+- (NSDictionary<NSString *, NSNumber *> *)reportWithStoreSaves:(NSUInteger)storeSaves;
+
+/**
+ * Clears all recorded metrics.
+ */
+- (void)reset;
+
+@end
+
+NS_ASSUME_NONNULL_END
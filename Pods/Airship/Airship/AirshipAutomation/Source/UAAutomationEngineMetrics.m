@@ -0,0 +1,115 @@
+/* Copyright Airship and Contributors */
+
+#import "UAAutomationEngineMetrics+Internal.h"
+
+NSString * const UAAutomationEngineMetricsEventsKey = @"events";
+NSString * const UAAutomationEngineMetricsEventsPerSecondKey = @"events_per_second";
+NSString * const UAAutomationEngineMetricsTriggersEvaluatedKey = @"triggers_evaluated";
+NSString * const UAAutomationEngineMetricsSchedulesTriggeredKey = @"schedules_triggered";
+NSString * const UAAutomationEngineMetricsEvaluationP50Key = @"evaluation_p50_ms";
+NSString * const UAAutomationEngineMetricsEvaluationP99Key = @"evaluation_p99_ms";
+NSString * const UAAutomationEngineMetricsLatencyP50Key = @"latency_p50_ms";
+NSString * const UAAutomationEngineMetricsLatencyP99Key = @"latency_p99_ms";
+NSString * const UAAutomationEngineMetricsStoreSavesKey = @"store_saves";
+NSString * const UAAutomationEngineMetricsStoreSavesPerEventKey = @"store_saves_per_event";
+
+// Samples kept for percentiles, older samples are overwritten
+static const NSUInteger UAAutomationEngineMetricsMaxSamples = 10000;
+
+@interface UAAutomationEngineMetrics ()
+@property (nonatomic, assign) NSUInteger eventCount;
+@property (nonatomic, assign) NSUInteger triggerCount;
+@property (nonatomic, assign) NSUInteger triggeredCount;
+@property (nonatomic, assign) NSTimeInterval firstEventTime;
+@property (nonatomic, assign) NSTimeInterval lastEventTime;
+@property (nonatomic, strong) NSMutableArray<NSNumber *> *evaluationSamples;
+@property (nonatomic, strong) NSMutableArray<NSNumber *> *latencySamples;
+@end
+
+@implementation UAAutomationEngineMetrics
+
+- (instancetype)init {
+    self = [super init];
+
+    if (self) {
+        [self reset];
+    }
+
+    return self;
+}
+
++ (instancetype)metrics {
+    return [[self alloc] init];
+}
+
+- (void)recordEventWithLatency:(NSTimeInterval)latency
+                evaluationTime:(NSTimeInterval)evaluationTime
+                  triggerCount:(NSUInteger)triggerCount
+                triggeredCount:(NSUInteger)triggeredCount {
+    NSTimeInterval now = [NSProcessInfo processInfo].systemUptime;
+
+    @synchronized (self) {
+        if (!self.eventCount) {
+            // Throughput is measured from when the first event was sent
+            self.firstEventTime = now - latency;
+        }
+
+        self.lastEventTime = now;
+        self.triggerCount += triggerCount;
+        self.triggeredCount += triggeredCount;
+
+        NSUInteger index = self.eventCount % UAAutomationEngineMetricsMaxSamples;
+        if (index < self.evaluationSamples.count) {
+            self.evaluationSamples[index] = @(evaluationTime);
+            self.latencySamples[index] = @(latency);
+        } else {
+            [self.evaluationSamples addObject:@(evaluationTime)];
+            [self.latencySamples addObject:@(latency)];
+        }
+
+        self.eventCount++;
+    }
+}
+
+- (NSDictionary<NSString *, NSNumber *> *)reportWithStoreSaves:(NSUInteger)storeSaves {
+    @synchronized (self) {
+        NSTimeInterval duration = self.lastEventTime - self.firstEventTime;
+        NSArray<NSNumber *> *evaluations = [self.evaluationSamples sortedArrayUsingSelector:@selector(compare:)];
+        NSArray<NSNumber *> *latencies = [self.latencySamples sortedArrayUsingSelector:@selector(compare:)];
+
+        return @{ UAAutomationEngineMetricsEventsKey : @(self.eventCount),
+                  UAAutomationEngineMetricsEventsPerSecondKey : @(duration > 0 ? self.eventCount / duration : 0),
+                  UAAutomationEngineMetricsTriggersEvaluatedKey : @(self.triggerCount),
+                  UAAutomationEngineMetricsSchedulesTriggeredKey : @(self.triggeredCount),
+                  UAAutomationEngineMetricsEvaluationP50Key : @([self percentile:0.5 ofSortedSamples:evaluations] * 1000),
+                  UAAutomationEngineMetricsEvaluationP99Key : @([self percentile:0.99 ofSortedSamples:evaluations] * 1000),
+                  UAAutomationEngineMetricsLatencyP50Key : @([self percentile:0.5 ofSortedSamples:latencies] * 1000),
+                  UAAutomationEngineMetricsLatencyP99Key : @([self percentile:0.99 ofSortedSamples:latencies] * 1000),
+                  UAAutomationEngineMetricsStoreSavesKey : @(storeSaves),
+                  UAAutomationEngineMetricsStoreSavesPerEventKey : @(self.eventCount ? (double)storeSaves / self.eventCount : 0) };
+    }
+}
+
+- (void)reset {
+    @synchronized (self) {
+        self.eventCount = 0;
+        self.triggerCount = 0;
+        self.triggeredCount = 0;
+        self.firstEventTime = 0;
+        self.lastEventTime = 0;
+        self.evaluationSamples = [NSMutableArray array];
+        self.latencySamples = [NSMutableArray array];
+    }
+}
+
+- (NSTimeInterval)percentile:(double)percentile ofSortedSamples:(NSArray<NSNumber *> *)samples {
+    if (!samples.count) {
+        return 0;
+    }
+
+    // Nearest rank
+    NSUInteger rank = (NSUInteger)ceil(percentile * samples.count);
+    return [samples[MAX(rank, 1) - 1] doubleValue];
+}
+
+@end
@@ -2,6 +2,7 @@
 
 #import <Foundation/Foundation.h>
 #import "UAScheduleTrigger+Internal.h"
+#import "UAScheduleData+Internal.h"
 #import "UAAirshipAutomationCoreImport.h"
 
 NS_ASSUME_NONNULL_BEGIN
@@ -11,11 +12,55 @@ NS_ASSUME_NONNULL_BEGIN
 @class UAScheduleTriggerData;
 @class UARuntimeConfig;
 
+/**
+ * How durably a schedule state change is written to the store.
+ */
+typedef NS_ENUM(NSUInteger, UAScheduleStateDurability) {
+    /**
+     * Kept in memory and saved with the next coalesced save. Lost if the app exits first.
+     */
+    UAScheduleStateDurabilityDeferred = 0,
+
+    /**
+     * Appended to the state log and saved with the next coalesced save. Replayed after a crash.
+     */
+    UAScheduleStateDurabilityLogged = 1,
+
+    /**
+     * Saved right away, along with any pending changes.
+     */
+    UAScheduleStateDurabilityImmediate = 2,
+};
+
 /**
  * Manager class for the Automation CoreData store.
+ *
+ * Changes that only touch schedule state, like trigger progress and execution state, are not saved
+ * after every fetch. They are appended to a state log and saved together after the flush interval,
+ * when the app is backgrounded, or when any other change is saved. Logged changes that were not
+ * saved are replayed when the store is opened.
  */
 @interface UAAutomationStore : NSObject
 
+///---------------------------------------------------------------------------------------
+/// @name Automation Store Internal Properties
+///---------------------------------------------------------------------------------------
+
+/**
+ * The durability of trigger progress changes. Defaults to `UAScheduleStateDurabilityLogged`.
+ */
+@property (atomic, assign) UAScheduleStateDurability triggerProgressDurability;
+
+/**
+ * The delay in seconds before pending state changes are saved. Defaults to 5 seconds.
+ */
+@property (atomic, assign) NSTimeInterval flushInterval;
+
+/**
+ * The number of times the store has been saved. Used for benchmarking.
+ */
+@property (atomic, readonly) NSUInteger saveCount;
+
 ///---------------------------------------------------------------------------------------
 /// @name Automation Store Internal Methods
 ///---------------------------------------------------------------------------------------
@@ -146,6 +191,14 @@ NS_ASSUME_NONNULL_BEGIN
                      type:(UAScheduleTriggerType)type
         completionHandler:(void (^)(NSArray<UAScheduleTriggerData *> *triggers))completionHandler;
 
+/**
+ * Gets the progress of idle schedules toward their trigger goals.
+ *
+ * @param completionHandler Completion handler called back with the progress keyed by schedule identifier.
+ * Progress is the largest fraction of a goal reached by any of the schedule's triggers, from 0 to 1.
+ */
+- (void)getTriggerProgress:(void (^)(NSDictionary<NSString *, NSNumber *> *progress))completionHandler;
+
 /**
  * Gets the schedule count.
  *
@@ -153,6 +206,20 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (void)getScheduleCount:(void (^)(NSNumber *))completionHandler;
 
+/**
+ * Sets the durability of transitions into an execution state. Transitions into the executing and
+ * finished states default to `UAScheduleStateDurabilityImmediate`, all others to `UAScheduleStateDurabilityLogged`.
+ *
+ * @param durability The durability.
+ * @param state The execution state.
+ */
+- (void)setDurability:(UAScheduleStateDurability)durability forState:(UAScheduleState)state;
+
+/**
+ * Saves any pending state changes.
+ */
+- (void)flushChanges;
+
 /**
  * Waits for the store to become idle and then returns. Used by Unit Tests.
  */
@@ -9,8 +9,23 @@
 #import "UASchedule+Internal.h"
 #import "UAScheduleTrigger+Internal.h"
 #import "UAScheduleDataMigrator+Internal.h"
+#import "UAScheduleStateLog+Internal.h"
 #import "UAAirshipAutomationCoreImport.h"
 
+// Default delay before logged state changes are saved
+static const NSTimeInterval UAAutomationStoreDefaultFlushInterval = 5;
+
+// Logged records that force a save, bounds the replay after a crash
+static const NSUInteger UAAutomationStoreMaxLoggedRecords = 500;
+
+// State log record keys
+static NSString * const UAScheduleStateLogObjectKey = @"object";
+static NSString * const UAScheduleStateLogValuesKey = @"values";
+static NSString * const UAScheduleStateLogGenerationKey = @"generation";
+
+// Store metadata key for the last log generation included in a save
+static NSString * const UAAutomationStoreLogGenerationMetadataKey = @"com.urbanairship.automation.state_log_generation";
+
 @interface UAAutomationStore ()
 @property (nonatomic, strong) NSManagedObjectContext *managedContext;
 @property (nonatomic, copy) NSString *storeName;
@@ -18,6 +33,17 @@
 @property (nonatomic, assign) NSUInteger scheduleLimit;
 @property (nonatomic, assign) BOOL inMemory;
 @property (nonatomic, assign) BOOL finished;
+@property (nonatomic, strong) UADispatcher *dispatcher;
+@property (atomic, assign) NSUInteger saveCount;
+@property (nonatomic, strong, nullable) UAScheduleStateLog *stateLog;
+
+// Generation of the records currently appended to the state log, only accessed on the context's queue
+@property (nonatomic, assign) NSUInteger logGeneration;
+@property (nonatomic, strong) NSMutableDictionary<NSNumber *, NSNumber *> *stateDurabilities;
+
+// Last logged state values per object since the last save, only accessed on the context's queue
+@property (nonatomic, strong) NSMutableDictionary<NSManagedObjectID *, NSDictionary *> *loggedValues;
+@property (nonatomic, strong, nullable) UADisposable *flushDisposable;
 @end
 
 @implementation UAAutomationStore
@@ -31,6 +57,16 @@
         self.inMemory = inMemory;
         self.date = date;
         self.finished = NO;
+        self.dispatcher = [UADispatcher backgroundDispatcher];
+        self.loggedValues = [NSMutableDictionary dictionary];
+        self.flushInterval = UAAutomationStoreDefaultFlushInterval;
+        self.triggerProgressDurability = UAScheduleStateDurabilityLogged;
+
+        // Losing these transitions could execute a schedule again after a crash
+        self.stateDurabilities = [NSMutableDictionary dictionaryWithDictionary:@{
+            @(UAScheduleStateExecuting) : @(UAScheduleStateDurabilityImmediate),
+            @(UAScheduleStateFinished) : @(UAScheduleStateDurabilityImmediate)
+        }];
 
         NSBundle *bundle = [NSBundle bundleForClass:[self class]];
         NSURL *modelURL = [bundle URLForResource:@"UAAutomation" withExtension:@"momd"];
@@ -46,6 +82,7 @@
 
             UA_STRONGIFY(self);
             [self migrateData];
+            [self openStateLog];
         };
 
         if (inMemory) {
@@ -58,6 +95,11 @@
                                                  selector:@selector(protectedDataAvailable)
                                                      name:UIApplicationProtectedDataDidBecomeAvailable
                                                    object:nil];
+
+        [[NSNotificationCenter defaultCenter] addObserver:self
+                                                 selector:@selector(flushChanges)
+                                                     name:UIApplicationDidEnterBackgroundNotification
+                                                   object:nil];
     }
 
     return self;
@@ -82,6 +124,7 @@
 
             UA_STRONGIFY(self);
             [self migrateData];
+            [self openStateLog];
         }];
     }
 }
@@ -108,7 +151,7 @@
                                              newVersion:UAScheduleDataVersion];
         }
 
-        [self.managedContext safeSave];
+        [self saveChanges];
     }];
 }
 
@@ -140,7 +183,7 @@
 
         [self addScheduleDataFromSchedule:schedule];
 
-        completionHandler([self.managedContext safeSave]);
+        completionHandler([self saveChanges]);
     }];
 }
 
@@ -164,7 +207,7 @@
             [self addScheduleDataFromSchedule:schedule];
         }
         
-        completionHandler([self.managedContext safeSave]);
+        completionHandler([self saveChanges]);
     }];
 }
 
@@ -226,12 +269,40 @@
 
     scheduleID = scheduleID ? : @"*";
 
-    NSString *format = @"(schedule.identifier LIKE %@ AND type = %ld AND start <= %@) AND ((delay != nil AND schedule.executionState in %@) OR (delay == nil AND schedule.executionState == %d))";
+    NSPredicate *predicate = [NSPredicate predicateWithFormat:@"schedule.identifier LIKE %@ AND type = %ld AND start <= %@", scheduleID, type, self.date.now];
 
     NSArray *cancelTriggerState = @[@(UAScheduleStateTimeDelayed), @(UAScheduleStateWaitingScheduleConditions), @(UAScheduleStatePreparingSchedule)];
-    NSPredicate *predicate = [NSPredicate predicateWithFormat:format, scheduleID, type, self.date.now, cancelTriggerState, UAScheduleStateIdle];
+    NSPredicate *statePredicate = [NSPredicate predicateWithFormat:@"(delay != nil AND schedule.executionState in %@) OR (delay == nil AND schedule.executionState == %d)", cancelTriggerState, UAScheduleStateIdle];
+
+    [self fetchTriggersWithPredicate:predicate completionHandler:^(NSArray<UAScheduleTriggerData *> *triggers) {
+        // Schedule state may not be saved yet, so it is matched in memory instead of by the fetch
+        completionHandler([triggers filteredArrayUsingPredicate:statePredicate]);
+    }];
+}
+
+- (void)getTriggerProgress:(void (^)(NSDictionary<NSString *, NSNumber *> *))completionHandler {
+    // Cancellation triggers belong to a delay and do not count toward execution
+    NSPredicate *predicate = [NSPredicate predicateWithFormat:@"delay == nil"];
+    NSPredicate *statePredicate = [NSPredicate predicateWithFormat:@"schedule.executionState == %d", UAScheduleStateIdle];
+
+    [self fetchTriggersWithPredicate:predicate completionHandler:^(NSArray<UAScheduleTriggerData *> *triggers) {
+        NSMutableDictionary<NSString *, NSNumber *> *progress = [NSMutableDictionary dictionary];
 
-    [self fetchTriggersWithPredicate:predicate completionHandler:completionHandler];
+        for (UAScheduleTriggerData *trigger in [triggers filteredArrayUsingPredicate:statePredicate]) {
+            NSString *scheduleID = trigger.schedule.identifier;
+            double goal = [trigger.goal doubleValue];
+            if (!scheduleID || goal <= 0) {
+                continue;
+            }
+
+            double fraction = MIN([trigger.goalProgress doubleValue] / goal, 1);
+            if (fraction >= [progress[scheduleID] doubleValue]) {
+                progress[scheduleID] = @(fraction);
+            }
+        }
+
+        completionHandler(progress);
+    }];
 }
 
 - (void)getScheduleCount:(void (^)(NSNumber *))completionHandler {
@@ -264,6 +335,9 @@
                 [self.managedContext deleteObject:event];
             }
         } else {
+            // Batch deletes bypass the context, pending changes to the deleted rows would fail to save afterwards
+            [self saveChanges];
+
             NSBatchDeleteRequest *deleteRequest = [[NSBatchDeleteRequest alloc] initWithFetchRequest:request];
             [self.managedContext executeRequest:deleteRequest error:&error];
         }
@@ -273,7 +347,7 @@
             return;
         }
 
-        [self.managedContext safeSave];
+        [self saveChanges];
     }];
 }
 
@@ -296,7 +370,7 @@
             completionHandler(@[]);
         } else {
             completionHandler(result);
-            [self.managedContext safeSave];
+            [self commitChanges];
         }
     }];
 }
@@ -318,11 +392,263 @@
             completionHandler(@[]);
         } else {
             completionHandler(result);
-            [self.managedContext safeSave];
+            [self commitChanges];
+        }
+    }];
+}
+
+#pragma mark -
+#pragma mark State Changes
+
+- (void)setDurability:(UAScheduleStateDurability)durability forState:(UAScheduleState)state {
+    @synchronized (self.stateDurabilities) {
+        self.stateDurabilities[@(state)] = @(durability);
+    }
+}
+
+- (void)flushChanges {
+    [self safePerformBlock:^(BOOL isSafe) {
+        if (isSafe) {
+            [self saveChanges];
+        }
+    }];
+}
+
+/**
+ * The state attributes of an entity that may be logged instead of saved, in the order they are replayed.
+ * An execution state is replayed before its change date, since setting the state resets the date.
+ *
+ * @param entityName The entity name.
+ * @return The state attributes, or `nil` if the entity has none.
+ */
++ (nullable NSArray<NSString *> *)stateKeysForEntityName:(NSString *)entityName {
+    static NSDictionary<NSString *, NSArray<NSString *> *> *stateKeys;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        stateKeys = @{ @"UAScheduleData" : @[@"executionState", @"executionStateChangeDate", @"triggeredCount", @"delayedExecutionDate"],
+                       @"UAScheduleTriggerData" : @[@"goalProgress"] };
+    });
+
+    return stateKeys[entityName];
+}
+
+/**
+ * Opens the state log next to the SQLite store and replays any changes that were logged but not saved.
+ */
+- (void)openStateLog {
+    [self safePerformBlock:^(BOOL isSafe) {
+        if (!isSafe || self.inMemory || self.stateLog) {
+            return;
+        }
+
+        NSURL *storeURL = self.managedContext.persistentStoreCoordinator.persistentStores.firstObject.URL;
+        if (!storeURL) {
+            return;
+        }
+
+        self.stateLog = [UAScheduleStateLog logWithFileURL:[storeURL URLByAppendingPathExtension:@"log"]];
+
+        // Records from the saved generation or older are already in the store, even if the log was not truncated
+        NSPersistentStoreCoordinator *coordinator = self.managedContext.persistentStoreCoordinator;
+        NSPersistentStore *store = coordinator.persistentStores.firstObject;
+        NSUInteger savedGeneration = [[coordinator metadataForPersistentStore:store][UAAutomationStoreLogGenerationMetadataKey] unsignedIntegerValue];
+        self.logGeneration = savedGeneration + 1;
+
+        NSMutableArray<NSDictionary *> *records = [NSMutableArray array];
+        for (NSDictionary *record in [self.stateLog records]) {
+            // Records written before generations were tracked belong to the first one
+            NSUInteger generation = record[UAScheduleStateLogGenerationKey] ? [record[UAScheduleStateLogGenerationKey] unsignedIntegerValue] : 1;
+            if (generation > savedGeneration) {
+                [records addObject:record];
+            }
+        }
+
+        if (!records.count) {
+            [self.stateLog truncate];
+            return;
+        }
+
+        UA_LDEBUG(@"Replaying %lu logged schedule state changes", (unsigned long)records.count);
+
+        for (NSDictionary *record in records) {
+            NSURL *objectURI = [NSURL URLWithString:record[UAScheduleStateLogObjectKey]];
+            NSManagedObjectID *objectID = objectURI ? [coordinator managedObjectIDForURIRepresentation:objectURI] : nil;
+
+            // Objects deleted after the change was logged are skipped
+            NSManagedObject *object = objectID ? [self.managedContext existingObjectWithID:objectID error:nil] : nil;
+            if (object) {
+                [self applyStateValues:record[UAScheduleStateLogValuesKey] toObject:object];
+            }
+        }
+
+        [self saveChanges];
+    }];
+}
+
+/**
+ * Writes the changes made by a fetch completion handler. Changes that only touch schedule state are
+ * logged or kept in memory according to their durability and saved together later, any other change
+ * is saved right away. Must be called on the context's queue.
+ */
+- (void)commitChanges {
+    NSManagedObjectContext *context = self.managedContext;
+    if (!context.hasChanges) {
+        return;
+    }
+
+    if (!self.stateLog || context.insertedObjects.count || context.deletedObjects.count) {
+        [self saveChanges];
+        return;
+    }
+
+    NSMutableArray<NSDictionary *> *records = [NSMutableArray array];
+    NSMutableDictionary<NSManagedObjectID *, NSDictionary *> *recordedValues = [NSMutableDictionary dictionary];
+
+    for (NSManagedObject *object in context.updatedObjects) {
+        NSArray<NSString *> *stateKeys = [UAAutomationStore stateKeysForEntityName:object.entity.name];
+
+        // Edits are saved right away
+        if (!stateKeys || ![[NSSet setWithArray:stateKeys] isSupersetOfSet:[NSSet setWithArray:object.changedValues.allKeys]]) {
+            [self saveChanges];
+            return;
+        }
+
+        UAScheduleStateDurability durability = [self durabilityForObject:object];
+        if (durability == UAScheduleStateDurabilityImmediate) {
+            [self saveChanges];
+            return;
+        }
+
+        if (durability == UAScheduleStateDurabilityDeferred) {
+            continue;
+        }
+
+        NSDictionary *values = [self stateValuesForObject:object keys:stateKeys];
+        if (![self.loggedValues[object.objectID] isEqualToDictionary:values]) {
+            recordedValues[object.objectID] = values;
+            [records addObject:@{ UAScheduleStateLogObjectKey : object.objectID.URIRepresentation.absoluteString,
+                                  UAScheduleStateLogValuesKey : values,
+                                  UAScheduleStateLogGenerationKey : @(self.logGeneration) }];
         }
+    }
+
+    // Changes that can not be logged are only durable once saved
+    if (records.count && ![self.stateLog appendRecords:records]) {
+        [self saveChanges];
+        return;
+    }
+
+    [self.loggedValues addEntriesFromDictionary:recordedValues];
+
+    if (self.stateLog.recordCount >= UAAutomationStoreMaxLoggedRecords) {
+        [self saveChanges];
+        return;
+    }
+
+    [self scheduleFlush];
+}
+
+/**
+ * Saves the context and checkpoints the state log. The log generation is written to the store metadata
+ * in the same save, so records of that generation are never replayed once the save succeeds, even if
+ * truncating the log fails or does not happen. Must be called on the context's queue.
+ *
+ * @return `YES` if the context was saved, otherwise `NO`.
+ */
+- (BOOL)saveChanges {
+    [self.flushDisposable dispose];
+    self.flushDisposable = nil;
+
+    if (self.managedContext.hasChanges) {
+        NSPersistentStoreCoordinator *coordinator = self.managedContext.persistentStoreCoordinator;
+        NSPersistentStore *store = coordinator.persistentStores.firstObject;
+        if (self.stateLog && store) {
+            NSMutableDictionary *metadata = [[coordinator metadataForPersistentStore:store] mutableCopy];
+            metadata[UAAutomationStoreLogGenerationMetadataKey] = @(self.logGeneration);
+            [coordinator setMetadata:metadata forPersistentStore:store];
+        }
+
+        if (![self.managedContext safeSave]) {
+            return NO;
+        }
+
+        self.saveCount++;
+        self.logGeneration++;
+    }
+
+    [self.stateLog truncate];
+    [self.loggedValues removeAllObjects];
+    return YES;
+}
+
+/**
+ * Schedules a save of the pending changes, unless one is scheduled. Must be called on the context's queue.
+ */
+- (void)scheduleFlush {
+    if (self.flushDisposable) {
+        return;
+    }
+
+    UA_WEAKIFY(self)
+    self.flushDisposable = [self.dispatcher dispatchAfter:self.flushInterval block:^{
+        UA_STRONGIFY(self)
+        [self flushChanges];
     }];
 }
 
+- (UAScheduleStateDurability)durabilityForObject:(NSManagedObject *)object {
+    if ([object isKindOfClass:[UAScheduleTriggerData class]]) {
+        return self.triggerProgressDurability;
+    }
+
+    if ([object isKindOfClass:[UAScheduleData class]] && object.changedValues[@"executionState"]) {
+        NSNumber *durability;
+        @synchronized (self.stateDurabilities) {
+            durability = self.stateDurabilities[((UAScheduleData *)object).executionState];
+        }
+
+        if (durability) {
+            return [durability unsignedIntegerValue];
+        }
+    }
+
+    return UAScheduleStateDurabilityLogged;
+}
+
+- (NSDictionary *)stateValuesForObject:(NSManagedObject *)object keys:(NSArray<NSString *> *)keys {
+    NSMutableDictionary *values = [NSMutableDictionary dictionaryWithCapacity:keys.count];
+
+    for (NSString *key in keys) {
+        id value = [object valueForKey:key];
+        if ([value isKindOfClass:[NSDate class]]) {
+            value = @([value timeIntervalSince1970]);
+        }
+
+        values[key] = value ?: [NSNull null];
+    }
+
+    return values;
+}
+
+- (void)applyStateValues:(NSDictionary *)values toObject:(NSManagedObject *)object {
+    NSDictionary<NSString *, NSAttributeDescription *> *attributes = object.entity.attributesByName;
+
+    for (NSString *key in [UAAutomationStore stateKeysForEntityName:object.entity.name]) {
+        id value = values[key];
+        if (!value || !attributes[key]) {
+            continue;
+        }
+
+        if ([value isEqual:[NSNull null]]) {
+            value = nil;
+        } else if (attributes[key].attributeType == NSDateAttributeType) {
+            value = [NSDate dateWithTimeIntervalSince1970:[value doubleValue]];
+        }
+
+        [object setValue:value forKey:key];
+    }
+}
+
 #pragma mark -
 #pragma mark Converters
 
@@ -0,0 +1,27 @@
+/* Copyright Airship and Contributors */
+
+#import <UIKit/UIKit.h>
+
+@class UAInAppMessageImage;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * Image view that plays the frames of an animated in-app message image natively. Frames that were
+ * not predecoded are decoded one frame ahead off the main queue. Playback pauses while the view
+ * is not in a window.
+ */
+@interface UAInAppMessageAnimatedImageView : UIImageView
+
+///---------------------------------------------------------------------------------------
+/// @name Animated Image View Internal Properties
+///---------------------------------------------------------------------------------------
+
+/**
+ * The animated image. Setting it displays the first frame.
+ */
+@property (nonatomic, strong, nullable) UAInAppMessageImage *animatedImage;
+
+@end
+
+NS_ASSUME_NONNULL_END
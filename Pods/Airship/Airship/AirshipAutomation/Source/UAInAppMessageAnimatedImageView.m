@@ -0,0 +1,134 @@
+/* Copyright Airship and Contributors */
+
+#import "UAInAppMessageAnimatedImageView+Internal.h"
+#import "UAInAppMessageImage+Internal.h"
+#import "UAAirshipAutomationCoreImport.h"
+
+@interface UAInAppMessageAnimatedImageView ()
+@property (nonatomic, strong, nullable) CADisplayLink *displayLink;
+@property (nonatomic, strong) dispatch_queue_t decodeQueue;
+@property (nonatomic, assign) NSUInteger frameIndex;
+@property (nonatomic, assign) NSTimeInterval frameElapsed;
+@property (nonatomic, assign) CFTimeInterval lastTimestamp;
+@property (nonatomic, strong, nullable) UIImage *nextFrame;
+@property (nonatomic, assign) BOOL decoding;
+
+- (void)displayLinkDidFire:(CADisplayLink *)displayLink;
+@end
+
+/**
+ * Forwards display link callbacks without retaining the view, since a display link retains its target.
+ */
+@interface UAInAppMessageDisplayLinkProxy : NSObject
+@property (nonatomic, weak) UAInAppMessageAnimatedImageView *imageView;
+@end
+
+@implementation UAInAppMessageDisplayLinkProxy
+
+- (void)displayLinkDidFire:(CADisplayLink *)displayLink {
+    [self.imageView displayLinkDidFire:displayLink];
+}
+
+@end
+
+@implementation UAInAppMessageAnimatedImageView
+
+- (void)dealloc {
+    [_displayLink invalidate];
+}
+
+- (dispatch_queue_t)decodeQueue {
+    if (!_decodeQueue) {
+        _decodeQueue = dispatch_queue_create("com.urbanairship.in_app_message.frame_decode", DISPATCH_QUEUE_SERIAL);
+    }
+
+    return _decodeQueue;
+}
+
+- (void)setAnimatedImage:(UAInAppMessageImage *)animatedImage {
+    _animatedImage = animatedImage;
+
+    [self.displayLink invalidate];
+    self.displayLink = nil;
+    self.frameIndex = 0;
+    self.frameElapsed = 0;
+    self.nextFrame = nil;
+    self.decoding = NO;
+    self.image = animatedImage.image;
+
+    [self updateAnimation];
+}
+
+- (void)didMoveToWindow {
+    [super didMoveToWindow];
+    [self updateAnimation];
+}
+
+- (void)updateAnimation {
+    BOOL shouldAnimate = self.animatedImage.isAnimated && self.window;
+
+    if (shouldAnimate && !self.displayLink) {
+        UAInAppMessageDisplayLinkProxy *proxy = [[UAInAppMessageDisplayLinkProxy alloc] init];
+        proxy.imageView = self;
+
+        self.lastTimestamp = 0;
+        self.displayLink = [CADisplayLink displayLinkWithTarget:proxy selector:@selector(displayLinkDidFire:)];
+        [self.displayLink addToRunLoop:[NSRunLoop mainRunLoop] forMode:NSRunLoopCommonModes];
+        [self decodeNextFrame];
+    } else if (!shouldAnimate && self.displayLink) {
+        [self.displayLink invalidate];
+        self.displayLink = nil;
+    }
+}
+
+- (void)displayLinkDidFire:(CADisplayLink *)displayLink {
+    if (self.lastTimestamp) {
+        self.frameElapsed += displayLink.timestamp - self.lastTimestamp;
+    }
+    self.lastTimestamp = displayLink.timestamp;
+
+    NSTimeInterval frameDuration = [self.animatedImage.frameDurations[self.frameIndex] doubleValue];
+
+    // Hold the current frame until its time is up and the next frame is decoded
+    if (self.frameElapsed < frameDuration || !self.nextFrame) {
+        return;
+    }
+
+    // Drop the extra time after a long stall instead of racing through frames to catch up
+    self.frameElapsed = MIN(self.frameElapsed - frameDuration, frameDuration);
+    self.frameIndex = (self.frameIndex + 1) % self.animatedImage.frameCount;
+    self.image = self.nextFrame;
+    self.nextFrame = nil;
+
+    [self decodeNextFrame];
+}
+
+- (void)decodeNextFrame {
+    if (self.decoding) {
+        return;
+    }
+
+    self.decoding = YES;
+
+    UAInAppMessageImage *animatedImage = self.animatedImage;
+    NSUInteger index = (self.frameIndex + 1) % animatedImage.frameCount;
+
+    UA_WEAKIFY(self)
+    dispatch_async(self.decodeQueue, ^{
+        UIImage *frame = [animatedImage frameAtIndex:index];
+
+        dispatch_async(dispatch_get_main_queue(), ^{
+            UA_STRONGIFY(self)
+            if (self.animatedImage != animatedImage) {
+                return;
+            }
+
+            self.decoding = NO;
+
+            // Repeat the current frame if the next one can not be decoded
+            self.nextFrame = frame ?: self.image;
+        });
+    });
+}
+
+@end
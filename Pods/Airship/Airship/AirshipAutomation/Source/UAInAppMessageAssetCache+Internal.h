@@ -29,7 +29,8 @@ NS_ASSUME_NONNULL_BEGIN
  * Releases assets instance for this schedule id
  *
  * @param scheduleId The id of the schedule for which to release assets instance
- * @param wipeFromDisk Also remove all of the assets from disk
+ * @param wipeFromDisk Also release the schedule's references to its assets, making any asset not
+ * referenced by another schedule eligible for eviction
  */
 - (void)releaseAssets:(NSString *)scheduleId wipeFromDisk:(BOOL)wipeFromDisk;
 
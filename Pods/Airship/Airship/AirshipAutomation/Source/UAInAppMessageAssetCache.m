@@ -2,12 +2,15 @@
 
 #import "UAInAppMessageAssetCache+Internal.h"
 #import "UAInAppMessageAssets+Internal.h"
+#import "UAInAppMessageAssetStore+Internal.h"
 #import "UAAirshipAutomationCoreImport.h"
 
+static NSString * const UAInAppMessageAssetStoreDirectoryName = @"store";
 
 @interface UAInAppMessageAssetCache()
 
 @property (nonatomic, strong) NSURL *rootURL;
+@property (nonatomic, strong) UAInAppMessageAssetStore *store;
 @property (nonatomic, strong) NSMutableDictionary<NSString *, UAInAppMessageAssets *> *activeAssets;
 
 @end
@@ -23,9 +26,16 @@
     if (self) {
         self.rootURL = [self assetCacheRootURL];
         self.activeAssets = [NSMutableDictionary dictionary];
+
+        if (self.rootURL) {
+            [self removeLegacyScheduleDirectories];
+            self.store = [UAInAppMessageAssetStore storeWithDirectoryURL:[self.rootURL URLByAppendingPathComponent:UAInAppMessageAssetStoreDirectoryName]
+                                                                 maxSize:UAInAppMessageAssetStoreDefaultMaxSize
+                                                                 session:[NSURLSession sharedSession]];
+        }
     }
     
-    if (self.rootURL) {
+    if (self.store) {
         return self;
     } else {
         return nil;
@@ -35,7 +45,7 @@
 - (UAInAppMessageAssets *)assetsForScheduleId:(NSString *)scheduleId {
     @synchronized (self.activeAssets) {
         if (!self.activeAssets[scheduleId]) {
-            UAInAppMessageAssets *assets = [UAInAppMessageAssets assets:[self.rootURL URLByAppendingPathComponent:scheduleId]];
+            UAInAppMessageAssets *assets = [UAInAppMessageAssets assetsWithScheduleId:scheduleId store:self.store];
             self.activeAssets[scheduleId] = assets;
         }
         return self.activeAssets[scheduleId];
@@ -43,30 +53,20 @@
 }
 
 - (void)clearAllAssets {
-    // clear each of the assets instance
     @synchronized (self.activeAssets) {
-        [self.activeAssets enumerateKeysAndObjectsUsingBlock:^(id scheduleId, id assets, BOOL* stop) {
-            [(UAInAppMessageAssets *)assets clearAssets];
-        }];
-        
         // clear our dictionary of asset instances
         self.activeAssets = [NSMutableDictionary dictionary];
 
-        // remove the contents of the root cache directory
-        NSFileManager *fileManager = [NSFileManager defaultManager];
-        NSString *rootPath = [self.rootURL path];
-        NSArray *fileArray = [fileManager contentsOfDirectoryAtPath:rootPath error:nil];
-        for (NSString *filename in fileArray)  {
-            [fileManager removeItemAtPath:[rootPath stringByAppendingPathComponent:filename] error:NULL];
-        }
+        // remove every asset from the shared store
+        [self.store removeAllAssets];
     }
 }
 
 - (void)releaseAssets:(NSString *)scheduleId wipeFromDisk:(BOOL)wipeFromDisk {
     @synchronized (self.activeAssets) {
         if (wipeFromDisk) {
-            UAInAppMessageAssets *assets = [self assetsForScheduleId:scheduleId];
-            [assets clearAssets];
+            // Drops the schedule's references. Assets shared with other schedules stay on disk.
+            [self.store releaseAssetsForScheduleId:scheduleId];
         }
         [self.activeAssets removeObjectForKey:scheduleId];
     }
@@ -74,6 +74,18 @@
 
 #pragma mark -
 #pragma mark Utilities
+
+// Assets used to be stored in a directory per schedule
+- (void)removeLegacyScheduleDirectories {
+    NSFileManager *fileManager = [NSFileManager defaultManager];
+    NSString *rootPath = [self.rootURL path];
+    NSArray *fileArray = [fileManager contentsOfDirectoryAtPath:rootPath error:nil];
+    for (NSString *filename in fileArray)  {
+        if (![filename isEqualToString:UAInAppMessageAssetStoreDirectoryName]) {
+            [fileManager removeItemAtPath:[rootPath stringByAppendingPathComponent:filename] error:NULL];
+        }
+    }
+}
 - (NSURL *)assetCacheRootURL {
     NSFileManager *fileManager = [NSFileManager defaultManager];
     
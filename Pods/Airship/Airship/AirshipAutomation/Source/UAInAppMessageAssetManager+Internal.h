@@ -32,6 +32,16 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (void)onSchedule:(UASchedule *)schedule;
 
+/**
+ * Prefetches the assets for a schedule ahead of its trigger, regardless of the cache policy.
+ *
+ * The assets stay cached until the schedule finishes.
+ *
+ * @param schedule The schedule to prefetch
+ * @param completionHandler The completion handler called with the number of bytes downloaded.
+ */
+- (void)prefetchAssetsForSchedule:(UASchedule *)schedule completionHandler:(void (^)(unsigned long long bytes))completionHandler;
+
 /**
  * Called when message is being prepared.
  *
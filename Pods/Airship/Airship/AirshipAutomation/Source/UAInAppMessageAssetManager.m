@@ -2,8 +2,11 @@
 
 #import "UAInAppMessageAssetManager+Internal.h"
 #import "UAInAppMessageAssetCache+Internal.h"
+#import "UAInAppMessageAssets+Internal.h"
 #import "UAInAppMessageScheduleInfo.h"
 #import "UAInAppMessageDefaultPrepareAssetsDelegate.h"
+#import "UAInAppMessageUtils+Internal.h"
+#import "UAInAppMessageImage+Internal.h"
 #import "UAAirshipAutomationCoreImport.h"
 
 
@@ -72,6 +75,28 @@
     [self.queue addOperation:operation];
 }
 
+- (void)prefetchAssetsForSchedule:(UASchedule *)schedule completionHandler:(void (^)(unsigned long long))completionHandler {
+    UAAsyncOperation *operation = [UAAsyncOperation operationWithBlock:^(UAAsyncOperation *operation) {
+        // Prefetching reuses the delegate's prepare step, since it caches whatever display needs
+        if (!self.prepareAssetsDelegate || ![self.prepareAssetsDelegate respondsToSelector:@selector(onPrepare:assets:completionHandler:)]) {
+            completionHandler(0);
+            [operation finish];
+            return;
+        }
+
+        UAInAppMessageAssets *assets = [self.assetCache assetsForScheduleId:schedule.identifier];
+        UAInAppMessage *message = ((UAInAppMessageScheduleInfo *)schedule.info).message;
+
+        [self.prepareAssetsDelegate onPrepare:message assets:assets completionHandler:^(UAInAppMessagePrepareResult result) {
+            // Release the assets instance for this schedule but keep the assets
+            [self.assetCache releaseAssets:schedule.identifier wipeFromDisk:NO];
+            completionHandler(assets.fetchedBytes);
+            [operation finish];
+        }];
+    }];
+    [self.queue addOperation:operation];
+}
+
 - (void)onPrepare:(UASchedule *)schedule completionHandler:(void (^)(UAInAppMessagePrepareResult))completionHandler {
     UAAsyncOperation *operation = [UAAsyncOperation operationWithBlock:^(UAAsyncOperation *operation) {
         // Do nothing if delegate doesn't implement onPrepare method
@@ -89,13 +114,52 @@
         
         // Prepare the assets for this schedule
         [self.prepareAssetsDelegate onPrepare:message assets:assets completionHandler:^(UAInAppMessagePrepareResult result) {
-            completionHandler(result);
-            [operation finish];
+            if (result != UAInAppMessagePrepareResultSuccess) {
+                completionHandler(result);
+                [operation finish];
+                return;
+            }
+
+            [self decodeImageForMessage:message assets:assets completionHandler:^{
+                completionHandler(result);
+                [operation finish];
+            }];
         }];
     }];
     [self.queue addOperation:operation];
 }
 
+/**
+ * Decodes and downsamples the message's image into the in-memory image cache, so building
+ * the media view does not decode the image on the main queue.
+ *
+ * @param message The message.
+ * @param assets The message assets.
+ * @param completionHandler The completion handler.
+ */
+- (void)decodeImageForMessage:(UAInAppMessage *)message
+                       assets:(UAInAppMessageAssets *)assets
+            completionHandler:(void (^)(void))completionHandler {
+    UAInAppMessageMediaInfo *media = [UAInAppMessageUtils mediaInfoForMessage:message];
+    NSURL *mediaURL = media.url ? [NSURL URLWithString:media.url] : nil;
+
+    if (media.type != UAInAppMessageMediaInfoTypeImage || !mediaURL || ![assets isCached:mediaURL]) {
+        completionHandler();
+        return;
+    }
+
+    NSURL *cacheURL = [assets getCacheURL:mediaURL];
+    CGFloat maxPixelSize = [UAInAppMessageImage defaultMaxPixelSize];
+
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+        if (![UAInAppMessageImage imageWithContentsOfURL:cacheURL maxPixelSize:maxPixelSize]) {
+            UA_LDEBUG(@"Unable to decode image %@ for message %@", mediaURL, message.identifier);
+        }
+
+        completionHandler();
+    });
+}
+
 - (void)onDisplayFinished:(UASchedule *)schedule {
     UAAsyncOperation *operation = [UAAsyncOperation operationWithBlock:^(UAAsyncOperation *operation) {
         UAInAppMessage *message;
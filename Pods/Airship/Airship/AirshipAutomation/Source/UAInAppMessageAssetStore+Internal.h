@@ -0,0 +1,109 @@
+/* Copyright Airship and Contributors */
+
+#import <Foundation/Foundation.h>
+
+#import "UAInAppMessageAssetManager.h"
+
+@class UADispatcher;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * The default maximum size in bytes of unreferenced assets kept on disk.
+ */
+extern const NSUInteger UAInAppMessageAssetStoreDefaultMaxSize;
+
+/**
+ * Content-addressed store for in-app message assets shared across schedules.
+ *
+ * Assets are stored once per source URL and reference counted per schedule. Assets that are
+ * no longer referenced by any schedule are kept for reuse and evicted least recently used first
+ * once the store exceeds its maximum size. Referenced assets are never evicted.
+ */
+@interface UAInAppMessageAssetStore : NSObject
+
+///---------------------------------------------------------------------------------------
+/// @name Asset Store Internal Methods
+///---------------------------------------------------------------------------------------
+
+/**
+ * Factory method.
+ *
+ * @param directoryURL The directory in which to store assets.
+ * @param maxSize The maximum size in bytes of unreferenced assets kept on disk.
+ * @param session The URL session used to download assets.
+ * @return The asset store, or `nil` if the directory could not be created.
+ */
++ (nullable instancetype)storeWithDirectoryURL:(NSURL *)directoryURL
+                                       maxSize:(NSUInteger)maxSize
+                                       session:(NSURLSession *)session;
+
+/**
+ * Factory method. Used for testing.
+ *
+ * @param directoryURL The directory in which to store assets.
+ * @param maxSize The maximum size in bytes of unreferenced assets kept on disk.
+ * @param session The URL session used to download assets.
+ * @param dispatcher The dispatcher used to schedule manifest writes.
+ * @return The asset store, or `nil` if the directory could not be created.
+ */
++ (nullable instancetype)storeWithDirectoryURL:(NSURL *)directoryURL
+                                       maxSize:(NSUInteger)maxSize
+                                       session:(NSURLSession *)session
+                                    dispatcher:(UADispatcher *)dispatcher;
+
+/**
+ * Returns the file URL for an asset and records that the schedule references it.
+ *
+ * @param assetURL The URL from which the asset is fetched.
+ * @param scheduleId The schedule ID.
+ * @return The file URL, or `nil` if the store directory is unavailable.
+ */
+- (nullable NSURL *)fileURLForAssetURL:(NSURL *)assetURL scheduleId:(NSString *)scheduleId;
+
+/**
+ * Checks if an asset is stored, including files written directly to the asset's file URL.
+ * A stored asset is also recorded as referenced by the schedule.
+ *
+ * @param assetURL The URL from which the asset is fetched.
+ * @param scheduleId The schedule ID.
+ * @return `YES` if the asset is stored, otherwise `NO`.
+ */
+- (BOOL)isStored:(NSURL *)assetURL scheduleId:(NSString *)scheduleId;
+
+/**
+ * Downloads an asset into the store on behalf of a schedule. Concurrent fetches of the same
+ * asset share a single download.
+ *
+ * @param assetURL The URL from which the asset is fetched.
+ * @param scheduleId The schedule ID.
+ * @param completionHandler The completion handler.
+ */
+- (void)fetchAssetURL:(NSURL *)assetURL
+           scheduleId:(NSString *)scheduleId
+    completionHandler:(void (^)(UAInAppMessagePrepareResult result))completionHandler;
+
+/**
+ * Returns the size of a stored asset.
+ *
+ * @param assetURL The URL from which the asset is fetched.
+ * @return The size in bytes, or 0 if the asset is not stored.
+ */
+- (unsigned long long)sizeOfAssetURL:(NSURL *)assetURL;
+
+/**
+ * Releases every asset reference held by a schedule. Assets that are no longer referenced
+ * stay on disk until evicted.
+ *
+ * @param scheduleId The schedule ID.
+ */
+- (void)releaseAssetsForScheduleId:(NSString *)scheduleId;
+
+/**
+ * Removes all assets.
+ */
+- (void)removeAllAssets;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,462 @@
+/* Copyright Airship and Contributors */
+
+#import "UAInAppMessageAssetStore+Internal.h"
+#import "UAAirshipAutomationCoreImport.h"
+
+const NSUInteger UAInAppMessageAssetStoreDefaultMaxSize = 50 * 1024 * 1024;
+
+static NSString * const UAInAppMessageAssetStoreManifestFileName = @"manifest.plist";
+
+// Delay before a changed manifest is written, so bursts of retains share one write
+static const NSTimeInterval UAInAppMessageAssetStoreManifestWriteDelay = 1;
+
+static NSString * const UAInAppMessageAssetStoreSizeKey = @"size";
+static NSString * const UAInAppMessageAssetStoreLastAccessKey = @"last_access";
+static NSString * const UAInAppMessageAssetStoreSchedulesKey = @"schedules";
+
+/**
+ * Bookkeeping for a stored asset.
+ */
+@interface UAInAppMessageAssetStoreEntry : NSObject
+@property (nonatomic, assign) unsigned long long size;
+@property (nonatomic, strong) NSDate *lastAccess;
+@property (nonatomic, strong) NSMutableSet<NSString *> *scheduleIds;
+@property (nonatomic, assign) BOOL stored;
+@end
+
+@implementation UAInAppMessageAssetStoreEntry
+
+- (instancetype)init {
+    self = [super init];
+
+    if (self) {
+        self.lastAccess = [NSDate date];
+        self.scheduleIds = [NSMutableSet set];
+    }
+
+    return self;
+}
+
++ (instancetype)entryWithDictionary:(NSDictionary *)dictionary {
+    UAInAppMessageAssetStoreEntry *entry = [[self alloc] init];
+    entry.size = [dictionary[UAInAppMessageAssetStoreSizeKey] unsignedLongLongValue];
+    entry.lastAccess = dictionary[UAInAppMessageAssetStoreLastAccessKey] ?: [NSDate date];
+    [entry.scheduleIds addObjectsFromArray:dictionary[UAInAppMessageAssetStoreSchedulesKey] ?: @[]];
+    entry.stored = YES;
+    return entry;
+}
+
+- (NSDictionary *)dictionaryValue {
+    return @{ UAInAppMessageAssetStoreSizeKey : @(self.size),
+              UAInAppMessageAssetStoreLastAccessKey : self.lastAccess,
+              UAInAppMessageAssetStoreSchedulesKey : self.scheduleIds.allObjects };
+}
+
+@end
+
+@interface UAInAppMessageAssetStore ()
+@property (nonatomic, strong) NSURL *directoryURL;
+@property (nonatomic, assign) NSUInteger maxSize;
+@property (nonatomic, strong) NSURLSession *session;
+@property (nonatomic, strong) NSFileManager *fileManager;
+@property (nonatomic, strong) UADispatcher *dispatcher;
+@property (nonatomic, strong, nullable) UADisposable *scheduledManifestWrite;
+
+// Entries keyed by the SHA-256 hash of the asset URL, which is also the file name
+@property (nonatomic, strong) NSMutableDictionary<NSString *, UAInAppMessageAssetStoreEntry *> *entries;
+
+// Completion handlers of in-flight downloads, keyed by asset hash
+@property (nonatomic, strong) NSMutableDictionary<NSString *, NSMutableArray *> *pendingFetches;
+@end
+
+@implementation UAInAppMessageAssetStore
+
+- (instancetype)initWithDirectoryURL:(NSURL *)directoryURL
+                             maxSize:(NSUInteger)maxSize
+                             session:(NSURLSession *)session
+                          dispatcher:(UADispatcher *)dispatcher {
+    self = [super init];
+
+    if (self) {
+        self.directoryURL = directoryURL;
+        self.maxSize = maxSize;
+        self.session = session;
+        self.dispatcher = dispatcher;
+        self.fileManager = [NSFileManager defaultManager];
+        self.entries = [NSMutableDictionary dictionary];
+        self.pendingFetches = [NSMutableDictionary dictionary];
+
+        if (![self createDirectory]) {
+            return nil;
+        }
+
+        [self loadManifest];
+    }
+
+    return self;
+}
+
++ (instancetype)storeWithDirectoryURL:(NSURL *)directoryURL maxSize:(NSUInteger)maxSize session:(NSURLSession *)session {
+    return [self storeWithDirectoryURL:directoryURL maxSize:maxSize session:session dispatcher:[UADispatcher backgroundDispatcher]];
+}
+
++ (instancetype)storeWithDirectoryURL:(NSURL *)directoryURL
+                              maxSize:(NSUInteger)maxSize
+                              session:(NSURLSession *)session
+                           dispatcher:(UADispatcher *)dispatcher {
+    return [[self alloc] initWithDirectoryURL:directoryURL maxSize:maxSize session:session dispatcher:dispatcher];
+}
+
+- (NSURL *)fileURLForAssetURL:(NSURL *)assetURL scheduleId:(NSString *)scheduleId {
+    if (![self createDirectory]) {
+        return nil;
+    }
+
+    NSString *hash = [UAUtils sha256HashWithString:assetURL.absoluteString];
+
+    @synchronized (self) {
+        [self retainEntryForHash:hash scheduleId:scheduleId];
+    }
+
+    return [self.directoryURL URLByAppendingPathComponent:hash];
+}
+
+- (BOOL)isStored:(NSURL *)assetURL scheduleId:(NSString *)scheduleId {
+    NSString *hash = [UAUtils sha256HashWithString:assetURL.absoluteString];
+
+    @synchronized (self) {
+        // Check the disk, since prepare delegates may write files to the cache URL directly and
+        // the OS may purge files behind the store's back
+        UAInAppMessageAssetStoreEntry *entry = [self refreshEntryForHash:hash];
+        if (!entry.stored) {
+            return NO;
+        }
+
+        [self retainEntryForHash:hash scheduleId:scheduleId];
+        return YES;
+    }
+}
+
+- (void)fetchAssetURL:(NSURL *)assetURL
+           scheduleId:(NSString *)scheduleId
+    completionHandler:(void (^)(UAInAppMessagePrepareResult))completionHandler {
+
+    NSURL *fileURL = [self fileURLForAssetURL:assetURL scheduleId:scheduleId];
+    if (!fileURL) {
+        completionHandler(UAInAppMessagePrepareResultCancel);
+        return;
+    }
+
+    NSString *hash = fileURL.lastPathComponent;
+
+    @synchronized (self) {
+        NSMutableArray *handlers = self.pendingFetches[hash];
+        if (handlers) {
+            // Join the download already in flight
+            [handlers addObject:completionHandler];
+            return;
+        }
+
+        self.pendingFetches[hash] = [NSMutableArray arrayWithObject:completionHandler];
+    }
+
+    // The task only holds the store until it completes, and waiting handlers must always be called
+    [[self.session downloadTaskWithURL:assetURL completionHandler:^(NSURL * _Nullable temporaryFileLocation, NSURLResponse * _Nullable response, NSError * _Nullable error) {
+        UAInAppMessagePrepareResult result = [self storeDownload:temporaryFileLocation
+                                                        response:response
+                                                           error:error
+                                                        assetURL:assetURL
+                                                            hash:hash];
+
+        NSArray *handlers;
+        @synchronized (self) {
+            handlers = self.pendingFetches[hash];
+            [self.pendingFetches removeObjectForKey:hash];
+        }
+
+        for (void (^handler)(UAInAppMessagePrepareResult) in handlers) {
+            handler(result);
+        }
+    }] resume];
+}
+
+- (unsigned long long)sizeOfAssetURL:(NSURL *)assetURL {
+    NSString *hash = [UAUtils sha256HashWithString:assetURL.absoluteString];
+
+    @synchronized (self) {
+        UAInAppMessageAssetStoreEntry *entry = self.entries[hash];
+        if (!entry.stored) {
+            entry = [self refreshEntryForHash:hash];
+        }
+
+        return entry.stored ? entry.size : 0;
+    }
+}
+
+- (void)releaseAssetsForScheduleId:(NSString *)scheduleId {
+    @synchronized (self) {
+        BOOL changed = NO;
+        for (NSString *hash in self.entries.allKeys) {
+            UAInAppMessageAssetStoreEntry *entry = self.entries[hash];
+            if (![entry.scheduleIds containsObject:scheduleId]) {
+                continue;
+            }
+
+            [entry.scheduleIds removeObject:scheduleId];
+            changed = YES;
+
+            if (!entry.stored && !entry.scheduleIds.count && !self.pendingFetches[hash]) {
+                [self.entries removeObjectForKey:hash];
+            }
+        }
+
+        if (changed) {
+            [self evictIfNeeded];
+            [self setNeedsSaveManifest];
+        }
+    }
+}
+
+- (void)removeAllAssets {
+    @synchronized (self) {
+        [self.entries removeAllObjects];
+        [self.scheduledManifestWrite dispose];
+        self.scheduledManifestWrite = nil;
+
+        NSArray *fileNames = [self.fileManager contentsOfDirectoryAtPath:self.directoryURL.path error:nil];
+        for (NSString *fileName in fileNames) {
+            [self.fileManager removeItemAtURL:[self.directoryURL URLByAppendingPathComponent:fileName] error:nil];
+        }
+    }
+}
+
+#pragma mark -
+#pragma mark Storage
+
+- (UAInAppMessagePrepareResult)storeDownload:(NSURL *)temporaryFileLocation
+                                    response:(NSURLResponse *)response
+                                       error:(NSError *)error
+                                    assetURL:(NSURL *)assetURL
+                                        hash:(NSString *)hash {
+    if (error) {
+        UA_LERR(@"Error prefetching media at URL: %@, %@", assetURL, error.localizedDescription);
+        return UAInAppMessagePrepareResultCancel;
+    }
+
+    if ([response isKindOfClass:[NSHTTPURLResponse class]]) {
+        NSInteger status = ((NSHTTPURLResponse *)response).statusCode;
+        if (status >= 500 && status <= 599) {
+            return UAInAppMessagePrepareResultRetry;
+        } else if (status != 200) {
+            return UAInAppMessagePrepareResultCancel;
+        }
+    }
+
+    if (![self createDirectory]) {
+        return UAInAppMessagePrepareResultCancel;
+    }
+
+    NSURL *fileURL = [self.directoryURL URLByAppendingPathComponent:hash];
+
+    @synchronized (self) {
+        UAInAppMessageAssetStoreEntry *entry = self.entries[hash];
+        BOOL exists = [self.fileManager fileExistsAtPath:fileURL.path];
+
+        if (exists && entry.scheduleIds.count) {
+            // A referenced file may be open for display, so keep it instead of replacing it. Both
+            // copies came from the same URL.
+            [self.fileManager removeItemAtURL:temporaryFileLocation error:nil];
+            [self refreshEntryForHash:hash];
+            [self setNeedsSaveManifest];
+            return UAInAppMessagePrepareResultSuccess;
+        }
+
+        // Remove anything currently existing at the cache path
+        if (exists) {
+            [self.fileManager removeItemAtURL:fileURL error:&error];
+            if (error) {
+                UA_LERR(@"Error removing file %@: %@", fileURL.path, error.localizedDescription);
+                return UAInAppMessagePrepareResultCancel;
+            }
+        }
+
+        // Move temp file to cache location
+        [self.fileManager moveItemAtURL:temporaryFileLocation toURL:fileURL error:&error];
+        if (error) {
+            UA_LERR(@"Error moving temp file %@ to %@: %@", temporaryFileLocation.path, fileURL.path, error.localizedDescription);
+            return UAInAppMessagePrepareResultCancel;
+        }
+
+        if (!entry) {
+            // Every schedule released the asset while it was downloading
+            entry = [[UAInAppMessageAssetStoreEntry alloc] init];
+            self.entries[hash] = entry;
+        }
+
+        entry.size = [[self.fileManager attributesOfItemAtPath:fileURL.path error:nil] fileSize];
+        entry.lastAccess = [NSDate date];
+        entry.stored = YES;
+
+        [self evictIfNeeded];
+        [self setNeedsSaveManifest];
+    }
+
+    return UAInAppMessagePrepareResultSuccess;
+}
+
+// Must be called while synchronized on self
+- (void)retainEntryForHash:(NSString *)hash scheduleId:(NSString *)scheduleId {
+    UAInAppMessageAssetStoreEntry *entry = self.entries[hash];
+    if (!entry) {
+        entry = [[UAInAppMessageAssetStoreEntry alloc] init];
+        self.entries[hash] = entry;
+    }
+
+    entry.lastAccess = [NSDate date];
+
+    if (![entry.scheduleIds containsObject:scheduleId]) {
+        [entry.scheduleIds addObject:scheduleId];
+        [self setNeedsSaveManifest];
+    }
+}
+
+// Must be called while synchronized on self
+- (UAInAppMessageAssetStoreEntry *)refreshEntryForHash:(NSString *)hash {
+    UAInAppMessageAssetStoreEntry *entry = self.entries[hash];
+    NSDictionary *attributes = [self.fileManager attributesOfItemAtPath:[self.directoryURL URLByAppendingPathComponent:hash].path error:nil];
+
+    if (attributes) {
+        if (!entry) {
+            entry = [[UAInAppMessageAssetStoreEntry alloc] init];
+            self.entries[hash] = entry;
+        }
+
+        entry.stored = YES;
+        entry.size = attributes.fileSize;
+    } else if (entry) {
+        entry.stored = NO;
+        entry.size = 0;
+    }
+
+    return entry;
+}
+
+// Must be called while synchronized on self
+- (void)evictIfNeeded {
+    unsigned long long totalSize = 0;
+    NSMutableArray<NSString *> *evictable = [NSMutableArray array];
+
+    for (NSString *hash in self.entries.allKeys) {
+        UAInAppMessageAssetStoreEntry *entry = self.entries[hash];
+
+        // Files written directly by prepare delegates are only known once they are on disk
+        if (!entry.stored) {
+            [self refreshEntryForHash:hash];
+        }
+
+        totalSize += entry.size;
+
+        if (!entry.scheduleIds.count && !self.pendingFetches[hash]) {
+            [evictable addObject:hash];
+        }
+    }
+
+    if (totalSize <= self.maxSize) {
+        return;
+    }
+
+    // Least recently used first
+    [evictable sortUsingComparator:^NSComparisonResult(NSString *a, NSString *b) {
+        return [self.entries[a].lastAccess compare:self.entries[b].lastAccess];
+    }];
+
+    for (NSString *hash in evictable) {
+        if (totalSize <= self.maxSize) {
+            break;
+        }
+
+        totalSize -= self.entries[hash].size;
+        [self.entries removeObjectForKey:hash];
+        [self.fileManager removeItemAtURL:[self.directoryURL URLByAppendingPathComponent:hash] error:nil];
+    }
+}
+
+#pragma mark -
+#pragma mark Manifest
+
+- (NSURL *)manifestURL {
+    return [self.directoryURL URLByAppendingPathComponent:UAInAppMessageAssetStoreManifestFileName];
+}
+
+- (void)loadManifest {
+    NSDictionary *manifest = [NSDictionary dictionaryWithContentsOfURL:[self manifestURL]];
+
+    for (NSString *hash in manifest) {
+        NSDictionary *dictionary = manifest[hash];
+        if (![dictionary isKindOfClass:[NSDictionary class]]) {
+            continue;
+        }
+
+        if ([self.fileManager fileExistsAtPath:[self.directoryURL URLByAppendingPathComponent:hash].path]) {
+            self.entries[hash] = [UAInAppMessageAssetStoreEntry entryWithDictionary:dictionary];
+        }
+    }
+
+    // Remove files the manifest does not know about, e.g. from an interrupted write
+    NSArray *fileNames = [self.fileManager contentsOfDirectoryAtPath:self.directoryURL.path error:nil];
+    for (NSString *fileName in fileNames) {
+        if (!self.entries[fileName] && ![fileName isEqualToString:UAInAppMessageAssetStoreManifestFileName]) {
+            [self.fileManager removeItemAtURL:[self.directoryURL URLByAppendingPathComponent:fileName] error:nil];
+        }
+    }
+}
+
+// Must be called while synchronized on self
+- (void)setNeedsSaveManifest {
+    if (self.scheduledManifestWrite) {
+        return;
+    }
+
+    UA_WEAKIFY(self)
+    self.scheduledManifestWrite = [self.dispatcher dispatchAfter:UAInAppMessageAssetStoreManifestWriteDelay block:^{
+        UA_STRONGIFY(self)
+        @synchronized (self) {
+            self.scheduledManifestWrite = nil;
+            [self saveManifest];
+        }
+    }];
+}
+
+// Must be called while synchronized on self
+- (void)saveManifest {
+    NSMutableDictionary *manifest = [NSMutableDictionary dictionary];
+    for (NSString *hash in self.entries) {
+        UAInAppMessageAssetStoreEntry *entry = self.entries[hash];
+
+        // Entries for assets that were never stored are only meaningful while they are referenced
+        if (entry.stored || entry.scheduleIds.count) {
+            manifest[hash] = [entry dictionaryValue];
+        }
+    }
+
+    if (![manifest writeToURL:[self manifestURL] atomically:YES]) {
+        UA_LERR(@"Unable to write asset manifest at %@", [self manifestURL]);
+    }
+}
+
+- (BOOL)createDirectory {
+    if ([self.fileManager fileExistsAtPath:self.directoryURL.path]) {
+        return YES;
+    }
+
+    NSError *error;
+    [self.fileManager createDirectoryAtURL:self.directoryURL withIntermediateDirectories:YES attributes:nil error:&error];
+    if (error) {
+        UA_LERR(@"Unable to create assets directory at %@", self.directoryURL);
+        return NO;
+    }
+
+    return YES;
+}
+
+@end
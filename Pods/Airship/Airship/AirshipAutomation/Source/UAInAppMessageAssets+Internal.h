@@ -3,20 +3,38 @@
 #import <Foundation/Foundation.h>
 
 #import "UAInAppMessageAssets.h"
+#import "UAInAppMessageAssetManager.h"
+
+@class UAInAppMessageAssetStore;
 
 NS_ASSUME_NONNULL_BEGIN
 
 @interface UAInAppMessageAssets()
 
+/**
+ * The number of bytes downloaded through `cacheAsset:completionHandler:`.
+ */
+@property (nonatomic, readonly) unsigned long long fetchedBytes;
+
 /**
  * Factory method.
  *
- * @param rootURL Root URL in which to store assets.
+ * @param scheduleId The schedule ID the assets belong to.
+ * @param store The shared asset store.
+ */
++ (instancetype)assetsWithScheduleId:(NSString *)scheduleId store:(UAInAppMessageAssetStore *)store;
+
+/**
+ * Downloads an asset into the cache. Downloads of the same asset by other schedules are shared.
+ *
+ * @param assetURL URL from which the data is fetched
+ * @param completionHandler The completion handler.
  */
-+ (instancetype)assets:(NSURL *)rootURL;
+- (void)cacheAsset:(NSURL *)assetURL completionHandler:(void (^)(UAInAppMessagePrepareResult result))completionHandler;
 
 /**
- * Clear assets from cache
+ * Releases this schedule's references to its cached assets. Assets still referenced by other
+ * schedules are kept.
  */
 - (void)clearAssets;
 
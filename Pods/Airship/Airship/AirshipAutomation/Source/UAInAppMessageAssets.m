@@ -1,76 +1,51 @@
 /* Copyright Airship and Contributors */
 
 #import "UAInAppMessageAssets+Internal.h"
+#import "UAInAppMessageAssetStore+Internal.h"
 #import "UAAirshipAutomationCoreImport.h"
 
 @interface UAInAppMessageAssets()
 
-@property (nonatomic, strong) NSURL *rootURL;
+@property (nonatomic, copy) NSString *scheduleId;
+@property (nonatomic, strong) UAInAppMessageAssetStore *store;
+@property (atomic, assign) unsigned long long fetchedBytes;
 
 @end
 
 @implementation UAInAppMessageAssets
 
-+ (instancetype)assets:(NSURL *)rootURL {
-    return [[self alloc] initWithRootURL:rootURL];
++ (instancetype)assetsWithScheduleId:(NSString *)scheduleId store:(UAInAppMessageAssetStore *)store {
+    return [[self alloc] initWithScheduleId:scheduleId store:store];
 }
 
-- (instancetype)initWithRootURL:(NSURL *)rootURL {
+- (instancetype)initWithScheduleId:(NSString *)scheduleId store:(UAInAppMessageAssetStore *)store {
     self = [super init];
     if (self) {
-        self.rootURL = rootURL;
-        
-        if (![self createAssetsDirectory]) {
-            return nil;
-        }
+        self.scheduleId = scheduleId;
+        self.store = store;
     }
     return self;
 }
 
-- (BOOL)assetsDirectoryExists {
-    return [[NSFileManager defaultManager] fileExistsAtPath:[self.rootURL path]];
-}
-
-- (BOOL)createAssetsDirectory {
-    NSError *error;
-    [[NSFileManager defaultManager] createDirectoryAtURL:self.rootURL withIntermediateDirectories:YES attributes:nil error:&error];
-    if (error) {
-        UA_LERR(@"Unable to create assets directory at %@", self.rootURL);
-        return NO;
-    }
-    return YES;
-}
-
 - (nullable NSURL *)getCacheURL:(NSURL *)assetURL {
-    if (![self assetsDirectoryExists]) {
-        return nil;
-    }
-    
-    NSString *assetFilename = [UAUtils sha256HashWithString:[assetURL absoluteString]];
-
-    NSURL *cacheURL = [self.rootURL URLByAppendingPathComponent:assetFilename];
-    
-    return cacheURL;
+    return [self.store fileURLForAssetURL:assetURL scheduleId:self.scheduleId];
 }
 
 - (BOOL)isCached:(NSURL *)assetURL {
-    NSURL *cachedURL = [self getCacheURL:assetURL];
-    if (!cachedURL) {
-        return NO;
-    }
-    BOOL isCached = [[NSFileManager defaultManager] fileExistsAtPath:[cachedURL path]];
-    return isCached;
+    return [self.store isStored:assetURL scheduleId:self.scheduleId];
 }
 
--(void)clearAssets {
-    // remove cache directory and its contents
-    if ([self assetsDirectoryExists]) {
-        NSError *error;
-        [[NSFileManager defaultManager] removeItemAtURL:self.rootURL error:&error];
-        if (error) {
-            UA_LERR(@"Unable to remove assets directory at %@", self.rootURL);
+- (void)cacheAsset:(NSURL *)assetURL completionHandler:(void (^)(UAInAppMessagePrepareResult))completionHandler {
+    [self.store fetchAssetURL:assetURL scheduleId:self.scheduleId completionHandler:^(UAInAppMessagePrepareResult result) {
+        if (result == UAInAppMessagePrepareResultSuccess) {
+            self.fetchedBytes += [self.store sizeOfAssetURL:assetURL];
         }
-    }
+        completionHandler(result);
+    }];
+}
+
+-(void)clearAssets {
+    [self.store releaseAssetsForScheduleId:self.scheduleId];
 }
 
 @end
@@ -0,0 +1,90 @@
+/* Copyright Airship and Contributors */
+
+#import <UIKit/UIKit.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * A decoded, downsampled in-app message image. Animated images keep their frame timing and
+ * decode frames on demand when predecoding every frame would use too much memory.
+ *
+ * Decoded images are cached in memory by file URL and pixel size, so an image decoded while the
+ * message is prepared is ready when the media view is built.
+ */
+@interface UAInAppMessageImage : NSObject
+
+///---------------------------------------------------------------------------------------
+/// @name In-App Message Image Internal Properties
+///---------------------------------------------------------------------------------------
+
+/**
+ * The decoded image, or the first frame of an animated image.
+ */
+@property (nonatomic, readonly) UIImage *image;
+
+/**
+ * Whether the image has more than one frame.
+ */
+@property (nonatomic, readonly, getter=isAnimated) BOOL animated;
+
+/**
+ * The number of frames.
+ */
+@property (nonatomic, readonly) NSUInteger frameCount;
+
+/**
+ * The duration in seconds of each frame.
+ */
+@property (nonatomic, readonly) NSArray<NSNumber *> *frameDurations;
+
+///---------------------------------------------------------------------------------------
+/// @name In-App Message Image Internal Methods
+///---------------------------------------------------------------------------------------
+
+/**
+ * Returns the image for a file, decoding and caching it if it is not cached yet. Decoding is
+ * expensive and should not be done on the main queue.
+ *
+ * @param fileURL The image file URL.
+ * @param maxPixelSize The maximum width or height in pixels of the decoded image.
+ * @return The image, or `nil` if the file is not a decodable image.
+ */
++ (nullable instancetype)imageWithContentsOfURL:(NSURL *)fileURL maxPixelSize:(CGFloat)maxPixelSize;
+
+/**
+ * Returns a cached image without decoding.
+ *
+ * @param fileURL The image file URL.
+ * @param maxPixelSize The maximum width or height in pixels of the decoded image.
+ * @return The image, or `nil` if the image is not cached.
+ */
++ (nullable instancetype)cachedImageForURL:(NSURL *)fileURL maxPixelSize:(CGFloat)maxPixelSize;
+
+/**
+ * Decodes an image from data without caching it. Decoding is expensive and should not be done
+ * on the main queue.
+ *
+ * @param data The image data.
+ * @param maxPixelSize The maximum width or height in pixels of the decoded image.
+ * @return The image, or `nil` if the data is not a decodable image.
+ */
++ (nullable instancetype)imageWithData:(NSData *)data maxPixelSize:(CGFloat)maxPixelSize;
+
+/**
+ * The maximum pixel size in-app message images are decoded at, the longest side of the main screen.
+ *
+ * @return The maximum pixel size.
+ */
++ (CGFloat)defaultMaxPixelSize;
+
+/**
+ * Returns a decoded frame. Frames that were not predecoded are decoded on the calling queue.
+ *
+ * @param index The frame index.
+ * @return The frame, or `nil` if it can not be decoded.
+ */
+- (nullable UIImage *)frameAtIndex:(NSUInteger)index;
+
+@end
+
+NS_ASSUME_NONNULL_END
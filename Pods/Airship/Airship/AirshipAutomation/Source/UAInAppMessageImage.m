@@ -0,0 +1,213 @@
+/* Copyright Airship and Contributors */
+
+#import <ImageIO/ImageIO.h>
+
+#import "UAInAppMessageImage+Internal.h"
+
+// Animated images whose decoded frames fit in this many bytes have every frame predecoded
+static const NSUInteger UAInAppMessageImageMaxPredecodedBytes = 8 * 1024 * 1024;
+
+// Total decoded bytes kept in the in-memory cache
+static const NSUInteger UAInAppMessageImageCacheCostLimit = 40 * 1024 * 1024;
+
+// Frame delays at or below this are treated like browsers do, as the default delay
+static const NSTimeInterval UAInAppMessageImageMinFrameDuration = 0.011;
+static const NSTimeInterval UAInAppMessageImageDefaultFrameDuration = 0.1;
+
+@interface UAInAppMessageImage ()
+@property (nonatomic, strong) UIImage *image;
+@property (nonatomic, assign) NSUInteger frameCount;
+@property (nonatomic, copy) NSArray<NSNumber *> *frameDurations;
+@property (nonatomic, copy, nullable) NSArray<UIImage *> *frames;
+@property (nonatomic, assign) CGImageSourceRef source;
+@property (nonatomic, assign) CGFloat maxPixelSize;
+@property (nonatomic, assign) NSUInteger cost;
+@end
+
+@implementation UAInAppMessageImage
+
+- (nullable instancetype)initWithSource:(CGImageSourceRef)source maxPixelSize:(CGFloat)maxPixelSize {
+    self = [super init];
+
+    if (self) {
+        self.source = (CGImageSourceRef)CFRetain(source);
+        self.maxPixelSize = maxPixelSize;
+        self.frameCount = CGImageSourceGetCount(source);
+
+        if (!self.frameCount) {
+            return nil;
+        }
+
+        self.image = [self decodeFrameAtIndex:0];
+        if (!self.image) {
+            return nil;
+        }
+
+        NSUInteger frameBytes = CGImageGetBytesPerRow(self.image.CGImage) * CGImageGetHeight(self.image.CGImage);
+        self.cost = frameBytes;
+
+        if (self.frameCount > 1) {
+            NSMutableArray<NSNumber *> *durations = [NSMutableArray arrayWithCapacity:self.frameCount];
+            for (NSUInteger i = 0; i < self.frameCount; i++) {
+                [durations addObject:@([self durationOfFrameAtIndex:i])];
+            }
+            self.frameDurations = durations;
+
+            if (frameBytes * self.frameCount <= UAInAppMessageImageMaxPredecodedBytes) {
+                self.frames = [self decodeAllFrames];
+                self.cost = frameBytes * self.frameCount;
+            }
+        } else {
+            self.frameDurations = @[];
+        }
+    }
+
+    return self;
+}
+
+- (void)dealloc {
+    if (_source) {
+        CFRelease(_source);
+    }
+}
+
++ (NSCache<NSString *, UAInAppMessageImage *> *)cache {
+    static NSCache *cache;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        cache = [[NSCache alloc] init];
+        cache.totalCostLimit = UAInAppMessageImageCacheCostLimit;
+    });
+
+    return cache;
+}
+
++ (NSString *)cacheKeyForURL:(NSURL *)fileURL maxPixelSize:(CGFloat)maxPixelSize {
+    return [NSString stringWithFormat:@"%@#%.0f", fileURL.absoluteString, maxPixelSize];
+}
+
++ (nullable instancetype)imageWithContentsOfURL:(NSURL *)fileURL maxPixelSize:(CGFloat)maxPixelSize {
+    UAInAppMessageImage *image = [self cachedImageForURL:fileURL maxPixelSize:maxPixelSize];
+    if (image) {
+        return image;
+    }
+
+    // Decoding is done once below, so the source does not need to cache its own copy
+    CGImageSourceRef source = CGImageSourceCreateWithURL((__bridge CFURLRef)fileURL,
+                                                         (__bridge CFDictionaryRef)@{ (id)kCGImageSourceShouldCache : @NO });
+    if (!source) {
+        return nil;
+    }
+
+    image = [[self alloc] initWithSource:source maxPixelSize:maxPixelSize];
+    CFRelease(source);
+
+    if (image) {
+        [[self cache] setObject:image forKey:[self cacheKeyForURL:fileURL maxPixelSize:maxPixelSize] cost:image.cost];
+    }
+
+    return image;
+}
+
++ (nullable instancetype)cachedImageForURL:(NSURL *)fileURL maxPixelSize:(CGFloat)maxPixelSize {
+    return [[self cache] objectForKey:[self cacheKeyForURL:fileURL maxPixelSize:maxPixelSize]];
+}
+
++ (nullable instancetype)imageWithData:(NSData *)data maxPixelSize:(CGFloat)maxPixelSize {
+    CGImageSourceRef source = CGImageSourceCreateWithData((__bridge CFDataRef)data,
+                                                          (__bridge CFDictionaryRef)@{ (id)kCGImageSourceShouldCache : @NO });
+    if (!source) {
+        return nil;
+    }
+
+    UAInAppMessageImage *image = [[self alloc] initWithSource:source maxPixelSize:maxPixelSize];
+    CFRelease(source);
+
+    return image;
+}
+
++ (CGFloat)defaultMaxPixelSize {
+    // Media is laid out at most the size of the screen
+    CGSize nativeSize = [UIScreen mainScreen].nativeBounds.size;
+    return MAX(nativeSize.width, nativeSize.height);
+}
+
+- (BOOL)isAnimated {
+    return self.frameCount > 1;
+}
+
+- (nullable UIImage *)frameAtIndex:(NSUInteger)index {
+    if (index >= self.frameCount) {
+        return nil;
+    }
+
+    if (index == 0) {
+        return self.image;
+    }
+
+    if (self.frames) {
+        return self.frames[index];
+    }
+
+    return [self decodeFrameAtIndex:index];
+}
+
+#pragma mark -
+#pragma mark Decoding
+
+- (nullable UIImage *)decodeFrameAtIndex:(NSUInteger)index {
+    // Creating a thumbnail both downsamples and forces the decode now instead of at first render
+    NSDictionary *options = @{ (id)kCGImageSourceCreateThumbnailFromImageAlways : @YES,
+                               (id)kCGImageSourceCreateThumbnailWithTransform : @YES,
+                               (id)kCGImageSourceShouldCacheImmediately : @YES,
+                               (id)kCGImageSourceThumbnailMaxPixelSize : @(self.maxPixelSize) };
+
+    CGImageRef cgImage = CGImageSourceCreateThumbnailAtIndex(self.source, index, (__bridge CFDictionaryRef)options);
+    if (!cgImage) {
+        return nil;
+    }
+
+    // Scale 1 keeps the same point size the media view used with undecoded images
+    UIImage *image = [UIImage imageWithCGImage:cgImage scale:1 orientation:UIImageOrientationUp];
+    CGImageRelease(cgImage);
+
+    return image;
+}
+
+- (nullable NSArray<UIImage *> *)decodeAllFrames {
+    NSMutableArray<UIImage *> *frames = [NSMutableArray arrayWithCapacity:self.frameCount];
+    [frames addObject:self.image];
+
+    for (NSUInteger i = 1; i < self.frameCount; i++) {
+        UIImage *frame = [self decodeFrameAtIndex:i];
+        if (!frame) {
+            return nil;
+        }
+
+        [frames addObject:frame];
+    }
+
+    return frames;
+}
+
+- (NSTimeInterval)durationOfFrameAtIndex:(NSUInteger)index {
+    NSDictionary *properties = CFBridgingRelease(CGImageSourceCopyPropertiesAtIndex(self.source, index, NULL));
+
+    NSNumber *delay;
+    NSDictionary *gifProperties = properties[(id)kCGImagePropertyGIFDictionary];
+    NSDictionary *pngProperties = properties[(id)kCGImagePropertyPNGDictionary];
+
+    if (gifProperties) {
+        delay = gifProperties[(id)kCGImagePropertyGIFUnclampedDelayTime] ?: gifProperties[(id)kCGImagePropertyGIFDelayTime];
+    } else if (pngProperties) {
+        delay = pngProperties[(id)kCGImagePropertyAPNGUnclampedDelayTime] ?: pngProperties[(id)kCGImagePropertyAPNGDelayTime];
+    }
+
+    if (delay.doubleValue < UAInAppMessageImageMinFrameDuration) {
+        return UAInAppMessageImageDefaultFrameDuration;
+    }
+
+    return delay.doubleValue;
+}
+
+@end
@@ -10,6 +10,7 @@
 #import "UAInAppMessageDefaultDisplayCoordinator+Internal.h"
 #import "UAInAppMessageAssetManager+Internal.h"
 #import "UAInAppRemoteDataClient+Internal.h"
+#import "UAInAppMessagePrefetcher+Internal.h"
 #import "UAAirshipAutomationCoreImport.h"
 
 NS_ASSUME_NONNULL_BEGIN
@@ -25,6 +26,11 @@ NS_ASSUME_NONNULL_BEGIN
  */
 @property(nonatomic, strong) UAInAppMessageAssetManager *assetManager;
 
+/**
+ * In-app message prefetcher. Exposed for testing purposes.
+ */
+@property(nonatomic, strong) UAInAppMessagePrefetcher *prefetcher;
+
 /**
  * In-app remote data client. Exposed for testing purposes.
  */
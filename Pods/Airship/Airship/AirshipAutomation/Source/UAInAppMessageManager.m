@@ -137,7 +137,8 @@ NSString *const UAInAppMessageManagerPausedKey = @"UAInAppMessageManagerPaused";
 
     UATagGroupsLookupManager *lookupManager = [UATagGroupsLookupManager lookupManagerWithConfig:config
                                                                                       dataStore:dataStore
-                                                                               tagGroupsHistory:tagGroupsHistory];
+                                                                               tagGroupsHistory:tagGroupsHistory
+                                                                                        channel:channel];
 
     return [[UAInAppMessageManager alloc] initWithAutomationEngine:automationEngine
                                             tagGroupsLookupManager:lookupManager
@@ -181,6 +182,9 @@ NSString *const UAInAppMessageManagerPausedKey = @"UAInAppMessageManagerPaused";
         self.defaultDisplayCoordinator.displayInterval = self.displayInterval;
         self.immediateDisplayCoordinator = [UAInAppMessageImmediateDisplayCoordinator coordinator];
         self.assetManager = assetManager;
+        self.prefetcher = [UAInAppMessagePrefetcher prefetcherWithAutomationEngine:automationEngine
+                                                                      assetManager:assetManager
+                                                            tagGroupsLookupManager:tagGroupsLookupManager];
         self.analytics = analytics;
         [self setDefaultAdapterFactories];
 
@@ -274,6 +278,8 @@ NSString *const UAInAppMessageManagerPausedKey = @"UAInAppMessageManagerPaused";
     for (UASchedule *schedule in schedules) {
         [self.assetManager onSchedule:schedule];
     }
+
+    [self.prefetcher schedulesChanged];
 }
 
 - (void)cancelMessagesWithID:(NSString *)identifier completionHandler:(nullable void (^)(NSArray <UASchedule *> *))completionHandler {
@@ -554,7 +560,35 @@ NSString *const UAInAppMessageManagerPausedKey = @"UAInAppMessageManagerPaused";
         completionHandler(prepareResult);
     }];
 
-    [self.prepareSchedulePipeline addChainedRetriables:@[metadataCheck, createAdapter, audienceChecks, prepareMessageAssets, prepareMessageData]];
+    // The audience lookup and the asset download only depend on the metadata check, so they run
+    // alongside adapter creation. The data prep needs all three.
+    static NSDictionary<NSString *, NSNumber *> *prepareStageHistograms;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        prepareStageHistograms = @{ @"metadata" : @(UAMetricsHistogramInAppPrepareMetadata),
+                                    @"adapter" : @(UAMetricsHistogramInAppPrepareAdapter),
+                                    @"audience" : @(UAMetricsHistogramInAppPrepareAudience),
+                                    @"assets" : @(UAMetricsHistogramInAppPrepareAssets),
+                                    @"data" : @(UAMetricsHistogramInAppPrepareData) };
+    });
+
+    UARetriableGraph *graph = [UARetriableGraph graph];
+    [graph addRetriable:metadataCheck name:@"metadata" dependencies:nil];
+    [graph addRetriable:createAdapter name:@"adapter" dependencies:@[@"metadata"]];
+    [graph addRetriable:audienceChecks name:@"audience" dependencies:@[@"metadata"]];
+    [graph addRetriable:prepareMessageAssets name:@"assets" dependencies:@[@"metadata"]];
+    [graph addRetriable:prepareMessageData name:@"data" dependencies:@[@"adapter", @"audience", @"assets"]];
+
+    graph.latencyHandler = ^(NSString *name, UARetriableResult result, NSTimeInterval latency) {
+        UA_LTRACE(@"Prepare stage %@ for schedule %@ finished with result %lu in %.3f seconds", name, schedule.identifier, (unsigned long)result, latency);
+
+        NSNumber *histogram = prepareStageHistograms[name];
+        if (histogram) {
+            UAMetricsRecordDuration((UAMetricsHistogram)histogram.unsignedIntegerValue, latency);
+        }
+    };
+
+    [self.prepareSchedulePipeline addRetriableGraph:graph];
 }
 
 - (nullable id<UAInAppMessageDisplayCoordinator>)displayCoordinatorForMessage:(UAInAppMessage *)message {
@@ -737,14 +771,17 @@ NSString *const UAInAppMessageManagerPausedKey = @"UAInAppMessageManagerPaused";
         [self.analytics addEvent:event];
     }
 
+    [self.prefetcher scheduleFinished:schedule];
     [self.assetManager onScheduleFinished:schedule];
 }
 
 - (void)onScheduleCancelled:(UASchedule *)schedule {
+    [self.prefetcher scheduleFinished:schedule];
     [self.assetManager onScheduleFinished:schedule];
 }
 
 - (void)onScheduleLimitReached:(UASchedule *)schedule {
+    [self.prefetcher scheduleFinished:schedule];
     [self.assetManager onScheduleFinished:schedule];
 }
 
@@ -791,8 +828,10 @@ NSString *const UAInAppMessageManagerPausedKey = @"UAInAppMessageManagerPaused";
 - (void)updateEnginePauseState {
     if (self.componentEnabled && self.isEnabled) {
         [self.automationEngine resume];
+        self.prefetcher.enabled = YES;
     } else {
         [self.automationEngine pause];
+        self.prefetcher.enabled = NO;
     }
 }
 
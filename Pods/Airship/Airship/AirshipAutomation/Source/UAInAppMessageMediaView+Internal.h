@@ -4,6 +4,8 @@
 #import "UAInAppMessageMediaInfo.h"
 #import "UAInAppMessageMediaStyle.h"
 
+@class UAInAppMessageImage;
+
 NS_ASSUME_NONNULL_BEGIN
 
 /**
@@ -40,7 +42,8 @@ NS_ASSUME_NONNULL_BEGIN
 + (instancetype)mediaViewWithMediaInfo:(UAInAppMessageMediaInfo *)mediaInfo;
 
 /**
- * Factory method for creating an in-app message media view with image data.
+ * Factory method for creating an in-app message media view with image data. The image is
+ * decoded on the calling queue, prefer `mediaViewWithMediaInfo:image:`.
  *
  * @param mediaInfo The media info.
  * @param imageData The image data.
@@ -48,6 +51,15 @@ NS_ASSUME_NONNULL_BEGIN
 
 + (instancetype)mediaViewWithMediaInfo:(UAInAppMessageMediaInfo *)mediaInfo imageData:(NSData *)imageData;
 
+/**
+ * Factory method for creating an in-app message media view with a decoded image. Animated images
+ * are played natively.
+ *
+ * @param mediaInfo The media info.
+ * @param image The decoded image.
+ */
++ (instancetype)mediaViewWithMediaInfo:(UAInAppMessageMediaInfo *)mediaInfo image:(UAInAppMessageImage *)image;
+
 
 
 @end
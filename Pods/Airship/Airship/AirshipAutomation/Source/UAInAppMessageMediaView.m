@@ -3,6 +3,8 @@
 #import "UAInAppMessageMediaView+Internal.h"
 #import "AVFoundation/AVFoundation.h"
 #import "UAInAppMessageUtils+Internal.h"
+#import "UAInAppMessageImage+Internal.h"
+#import "UAInAppMessageAnimatedImageView+Internal.h"
 #import "UAAirshipAutomationCoreImport.h"
 
 NS_ASSUME_NONNULL_BEGIN
@@ -26,25 +28,25 @@ CGFloat const DefaultVideoAspectRatio = 16.0/9.0;
 @implementation UAInAppMessageMediaView
 
 + (instancetype)mediaViewWithMediaInfo:(UAInAppMessageMediaInfo *)mediaInfo {
-    return [[self alloc] initWithMediaInfo:mediaInfo imageData:nil];
+    return [[self alloc] initWithMediaInfo:mediaInfo image:nil];
 }
 
 + (instancetype)mediaViewWithMediaInfo:(UAInAppMessageMediaInfo *)mediaInfo imageData:(NSData *)imageData {
-    return [[self alloc] initWithMediaInfo:mediaInfo imageData:imageData];
+    UAInAppMessageImage *image = [UAInAppMessageImage imageWithData:imageData maxPixelSize:[UAInAppMessageImage defaultMaxPixelSize]];
+    return [[self alloc] initWithMediaInfo:mediaInfo image:image];
 }
 
-- (instancetype)initWithMediaInfo:(UAInAppMessageMediaInfo *)mediaInfo imageData:(nullable NSData *)imageData {
++ (instancetype)mediaViewWithMediaInfo:(UAInAppMessageMediaInfo *)mediaInfo image:(UAInAppMessageImage *)image {
+    return [[self alloc] initWithMediaInfo:mediaInfo image:image];
+}
+
+- (instancetype)initWithMediaInfo:(UAInAppMessageMediaInfo *)mediaInfo image:(nullable UAInAppMessageImage *)image {
     self = [super init];
 
     if (self) {
-        if ([UAInAppMessageUtils isGifData:imageData]) {
-            [self setUpWebBasedMediaView:mediaInfo];
-            self.webView.contentMode = UIViewContentModeScaleAspectFit;
-            [self.webView setBackgroundColor:[UIColor clearColor]];
-            [self.webView.scrollView setBackgroundColor:[UIColor clearColor]];
-            [self.webView loadData:imageData MIMEType:@"image/gif" characterEncodingName:@"UTF-8" baseURL:[NSURL URLWithString:self.mediaInfo.url]];
-        } else if (imageData) {
+        if (image) {
             self.translatesAutoresizingMaskIntoConstraints = NO;
+            self.mediaInfo = mediaInfo;
             self.webView = nil;
             self.mediaContainer = [[UIView alloc] init];
             self.mediaContainer.backgroundColor = [UIColor clearColor];
@@ -52,10 +54,17 @@ CGFloat const DefaultVideoAspectRatio = 16.0/9.0;
             [self addSubview:self.mediaContainer];
             [UAViewUtils applyContainerConstraintsToContainer:self containedView:self.mediaContainer];
 
-            self.imageView = [[UIImageView alloc] initWithFrame:self.frame];
+            // Animated images are played frame by frame instead of in a web view
+            if (image.isAnimated) {
+                UAInAppMessageAnimatedImageView *animatedImageView = [[UAInAppMessageAnimatedImageView alloc] initWithFrame:self.frame];
+                animatedImageView.animatedImage = image;
+                self.imageView = animatedImageView;
+            } else {
+                self.imageView = [[UIImageView alloc] initWithFrame:self.frame];
+                [self.imageView setImage:image.image];
+            }
+
             [self.mediaContainer addSubview:self.imageView];
-            UIImage *image = [UIImage imageWithData:imageData];
-            [self.imageView setImage:image];
             [UAViewUtils applyContainerConstraintsToContainer:self.mediaContainer containedView:self.imageView];
 
             // Apply style padding
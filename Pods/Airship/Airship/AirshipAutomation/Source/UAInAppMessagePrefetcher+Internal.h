@@ -0,0 +1,114 @@
+/* Copyright Airship and Contributors */
+
+#import <Foundation/Foundation.h>
+
+@class UAAutomationEngine;
+@class UAInAppMessageAssetManager;
+@class UATagGroupsLookupManager;
+@class UADispatcher;
+@class UASchedule;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * The default number of schedules prefetched per pass.
+ */
+extern const NSUInteger UAInAppMessagePrefetcherDefaultMaxSchedules;
+
+/**
+ * The default number of asset bytes prefetched per foreground session.
+ */
+extern const unsigned long long UAInAppMessagePrefetcherDefaultByteBudget;
+
+/**
+ * The default time to wait after the app foregrounds or schedules change before prefetching.
+ */
+extern const NSTimeInterval UAInAppMessagePrefetcherDefaultIdleDelay;
+
+/**
+ * Speculatively prefetches the assets and tag groups of the in-app messages most likely to trigger
+ * next, so they are ready when the trigger fires instead of being downloaded during prepare.
+ *
+ * Pending schedules are ranked by trigger type, progress toward their trigger goals and priority.
+ * The top schedules are prefetched once the app has been idle in the foreground for a moment,
+ * within a byte budget per foreground session. Prefetching is skipped in Low Power Mode or
+ * when the battery is low and not charging.
+ */
+@interface UAInAppMessagePrefetcher : NSObject
+
+///---------------------------------------------------------------------------------------
+/// @name In-App Message Prefetcher Internal Properties
+///---------------------------------------------------------------------------------------
+
+/**
+ * The maximum number of schedules prefetched per pass. Defaults to `UAInAppMessagePrefetcherDefaultMaxSchedules`.
+ */
+@property (atomic, assign) NSUInteger maxSchedules;
+
+/**
+ * The maximum number of asset bytes prefetched per foreground session. Defaults to `UAInAppMessagePrefetcherDefaultByteBudget`.
+ */
+@property (atomic, assign) unsigned long long byteBudget;
+
+/**
+ * Whether prefetching is enabled. Defaults to `YES`.
+ */
+@property (atomic, assign) BOOL enabled;
+
+///---------------------------------------------------------------------------------------
+/// @name In-App Message Prefetcher Internal Methods
+///---------------------------------------------------------------------------------------
+
+/**
+ * Factory method.
+ *
+ * @param automationEngine The automation engine holding the in-app message schedules.
+ * @param assetManager The asset manager.
+ * @param tagGroupsLookupManager The tag groups lookup manager.
+ * @return A prefetcher instance.
+ */
++ (instancetype)prefetcherWithAutomationEngine:(UAAutomationEngine *)automationEngine
+                                  assetManager:(UAInAppMessageAssetManager *)assetManager
+                        tagGroupsLookupManager:(UATagGroupsLookupManager *)tagGroupsLookupManager;
+
+/**
+ * Factory method. Used for testing.
+ *
+ * @param automationEngine The automation engine holding the in-app message schedules.
+ * @param assetManager The asset manager.
+ * @param tagGroupsLookupManager The tag groups lookup manager.
+ * @param notificationCenter The notification center.
+ * @param dispatcher The dispatcher used to wait for idle time.
+ * @return A prefetcher instance.
+ */
++ (instancetype)prefetcherWithAutomationEngine:(UAAutomationEngine *)automationEngine
+                                  assetManager:(UAInAppMessageAssetManager *)assetManager
+                        tagGroupsLookupManager:(UATagGroupsLookupManager *)tagGroupsLookupManager
+                            notificationCenter:(NSNotificationCenter *)notificationCenter
+                                    dispatcher:(UADispatcher *)dispatcher;
+
+/**
+ * Notifies the prefetcher that schedules were added or edited. A prefetch pass will run once idle.
+ */
+- (void)schedulesChanged;
+
+/**
+ * Notifies the prefetcher that a schedule finished and no longer needs prefetching.
+ *
+ * @param schedule The schedule.
+ */
+- (void)scheduleFinished:(UASchedule *)schedule;
+
+/**
+ * Ranks schedules by their likelihood to trigger next. Exposed for testing.
+ *
+ * @param schedules The schedules.
+ * @param progress Trigger goal progress keyed by schedule identifier, from 0 to 1.
+ * @return The schedules, most likely first.
+ */
++ (NSArray<UASchedule *> *)rankSchedules:(NSArray<UASchedule *> *)schedules
+                                progress:(NSDictionary<NSString *, NSNumber *> *)progress;
+
+@end
+
+NS_ASSUME_NONNULL_END
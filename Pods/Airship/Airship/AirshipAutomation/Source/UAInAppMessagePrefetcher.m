@@ -0,0 +1,316 @@
+/* Copyright Airship and Contributors */
+
+#import <UIKit/UIKit.h>
+
+#import "UAInAppMessagePrefetcher+Internal.h"
+#import "UAAutomationEngine+Internal.h"
+#import "UAInAppMessageAssetManager+Internal.h"
+#import "UATagGroupsLookupManager+Internal.h"
+#import "UAInAppMessageScheduleInfo.h"
+#import "UAInAppMessageAudience.h"
+#import "UAInAppMessageTagSelector+Internal.h"
+#import "UAScheduleTrigger.h"
+#import "UAAirshipAutomationCoreImport.h"
+
+const NSUInteger UAInAppMessagePrefetcherDefaultMaxSchedules = 5;
+const unsigned long long UAInAppMessagePrefetcherDefaultByteBudget = 10 * 1024 * 1024;
+const NSTimeInterval UAInAppMessagePrefetcherDefaultIdleDelay = 5;
+
+// Battery level below which prefetching stops while unplugged
+static const float UAInAppMessagePrefetcherMinBatteryLevel = 0.2;
+
+@interface UAInAppMessagePrefetcher ()
+@property (nonatomic, strong) UAAutomationEngine *automationEngine;
+@property (nonatomic, strong) UAInAppMessageAssetManager *assetManager;
+@property (nonatomic, strong) UATagGroupsLookupManager *tagGroupsLookupManager;
+@property (nonatomic, strong) NSNotificationCenter *notificationCenter;
+@property (nonatomic, strong) UADispatcher *dispatcher;
+
+// Schedules prefetched this foreground session
+@property (nonatomic, strong) NSMutableSet<NSString *> *prefetchedScheduleIDs;
+@property (nonatomic, assign) unsigned long long bytesPrefetched;
+@property (nonatomic, assign) BOOL inForeground;
+@property (nonatomic, assign) BOOL prefetching;
+@property (nonatomic, strong, nullable) UADisposable *pendingPrefetch;
+@end
+
+@implementation UAInAppMessagePrefetcher
+
+- (instancetype)initWithAutomationEngine:(UAAutomationEngine *)automationEngine
+                            assetManager:(UAInAppMessageAssetManager *)assetManager
+                  tagGroupsLookupManager:(UATagGroupsLookupManager *)tagGroupsLookupManager
+                      notificationCenter:(NSNotificationCenter *)notificationCenter
+                              dispatcher:(UADispatcher *)dispatcher {
+    self = [super init];
+
+    if (self) {
+        self.automationEngine = automationEngine;
+        self.assetManager = assetManager;
+        self.tagGroupsLookupManager = tagGroupsLookupManager;
+        self.notificationCenter = notificationCenter;
+        self.dispatcher = dispatcher;
+        self.prefetchedScheduleIDs = [NSMutableSet set];
+        self.maxSchedules = UAInAppMessagePrefetcherDefaultMaxSchedules;
+        self.byteBudget = UAInAppMessagePrefetcherDefaultByteBudget;
+        self.enabled = YES;
+        self.inForeground = [UAAppStateTracker shared].state == UAApplicationStateActive;
+
+        [self.notificationCenter addObserver:self
+                                    selector:@selector(applicationDidTransitionToForeground)
+                                        name:UAApplicationDidTransitionToForeground
+                                      object:nil];
+
+        [self.notificationCenter addObserver:self
+                                    selector:@selector(applicationDidEnterBackground)
+                                        name:UAApplicationDidEnterBackgroundNotification
+                                      object:nil];
+    }
+
+    return self;
+}
+
++ (instancetype)prefetcherWithAutomationEngine:(UAAutomationEngine *)automationEngine
+                                  assetManager:(UAInAppMessageAssetManager *)assetManager
+                        tagGroupsLookupManager:(UATagGroupsLookupManager *)tagGroupsLookupManager {
+    return [self prefetcherWithAutomationEngine:automationEngine
+                                   assetManager:assetManager
+                         tagGroupsLookupManager:tagGroupsLookupManager
+                             notificationCenter:[NSNotificationCenter defaultCenter]
+                                     dispatcher:[UADispatcher mainDispatcher]];
+}
+
++ (instancetype)prefetcherWithAutomationEngine:(UAAutomationEngine *)automationEngine
+                                  assetManager:(UAInAppMessageAssetManager *)assetManager
+                        tagGroupsLookupManager:(UATagGroupsLookupManager *)tagGroupsLookupManager
+                            notificationCenter:(NSNotificationCenter *)notificationCenter
+                                    dispatcher:(UADispatcher *)dispatcher {
+    return [[self alloc] initWithAutomationEngine:automationEngine
+                                     assetManager:assetManager
+                           tagGroupsLookupManager:tagGroupsLookupManager
+                               notificationCenter:notificationCenter
+                                       dispatcher:dispatcher];
+}
+
+- (void)dealloc {
+    [self.notificationCenter removeObserver:self];
+    [self.pendingPrefetch dispose];
+}
+
+- (void)schedulesChanged {
+    [self schedulePrefetch];
+}
+
+- (void)scheduleFinished:(UASchedule *)schedule {
+    @synchronized (self) {
+        [self.prefetchedScheduleIDs removeObject:schedule.identifier];
+    }
+}
+
+#pragma mark -
+#pragma mark App State
+
+- (void)applicationDidTransitionToForeground {
+    @synchronized (self) {
+        // Each foreground session gets a fresh budget
+        self.inForeground = YES;
+        self.bytesPrefetched = 0;
+        [self.prefetchedScheduleIDs removeAllObjects];
+    }
+
+    [self schedulePrefetch];
+}
+
+- (void)applicationDidEnterBackground {
+    @synchronized (self) {
+        self.inForeground = NO;
+        [self.pendingPrefetch dispose];
+        self.pendingPrefetch = nil;
+    }
+}
+
+#pragma mark -
+#pragma mark Prefetching
+
+- (void)schedulePrefetch {
+    @synchronized (self) {
+        if (!self.enabled || !self.inForeground) {
+            return;
+        }
+
+        // Debounce so a burst of changes results in one pass once things settle
+        [self.pendingPrefetch dispose];
+
+        UA_WEAKIFY(self)
+        self.pendingPrefetch = [self.dispatcher dispatchAfter:UAInAppMessagePrefetcherDefaultIdleDelay block:^{
+            UA_STRONGIFY(self)
+            [self prefetch];
+        }];
+    }
+}
+
+- (void)prefetch {
+    @synchronized (self) {
+        self.pendingPrefetch = nil;
+
+        if (self.prefetching || !self.inForeground || ![self isWithinBudget]) {
+            return;
+        }
+
+        self.prefetching = YES;
+    }
+
+    if (![self hasBatteryBudget]) {
+        UA_LTRACE(@"Skipping in-app message prefetch to save battery");
+        @synchronized (self) {
+            self.prefetching = NO;
+        }
+        return;
+    }
+
+    UA_WEAKIFY(self)
+    [self.automationEngine getSchedules:^(NSArray<UASchedule *> *schedules) {
+        UA_STRONGIFY(self)
+        [self.automationEngine getTriggerProgress:^(NSDictionary<NSString *, NSNumber *> *progress) {
+            UA_STRONGIFY(self)
+            NSMutableArray<UASchedule *> *candidates = [NSMutableArray array];
+            for (UASchedule *schedule in [UAInAppMessagePrefetcher rankSchedules:schedules progress:progress]) {
+                if (candidates.count >= self.maxSchedules) {
+                    break;
+                }
+
+                // Only schedules waiting on their triggers have progress, others are already in flight
+                if (!progress[schedule.identifier]) {
+                    continue;
+                }
+
+                @synchronized (self) {
+                    if (![self.prefetchedScheduleIDs containsObject:schedule.identifier]) {
+                        [candidates addObject:schedule];
+                    }
+                }
+            }
+
+            [self prefetchSchedules:candidates];
+        }];
+    }];
+}
+
+- (void)prefetchSchedules:(NSMutableArray<UASchedule *> *)schedules {
+    UASchedule *schedule = schedules.firstObject;
+
+    @synchronized (self) {
+        if (!schedule || !self.inForeground || ![self isWithinBudget]) {
+            self.prefetching = NO;
+            return;
+        }
+
+        [schedules removeObjectAtIndex:0];
+        [self.prefetchedScheduleIDs addObject:schedule.identifier];
+    }
+
+    UA_LTRACE(@"Prefetching in-app message schedule %@", schedule.identifier);
+
+    UA_WEAKIFY(self)
+    [self prefetchTagGroupsForSchedule:schedule completionHandler:^{
+        UA_STRONGIFY(self)
+        [self.assetManager prefetchAssetsForSchedule:schedule completionHandler:^(unsigned long long bytes) {
+            UA_STRONGIFY(self)
+            @synchronized (self) {
+                self.bytesPrefetched += bytes;
+            }
+
+            // Prefetch one schedule at a time to stay in the background of other traffic
+            [self prefetchSchedules:schedules];
+        }];
+    }];
+}
+
+- (void)prefetchTagGroupsForSchedule:(UASchedule *)schedule completionHandler:(void (^)(void))completionHandler {
+    UAInAppMessageScheduleInfo *info = (UAInAppMessageScheduleInfo *)schedule.info;
+    UATagGroups *requestedTagGroups = info.message.audience.tagSelector.tagGroups;
+
+    if (!requestedTagGroups.tags.count) {
+        completionHandler();
+        return;
+    }
+
+    // The lookup manager caches the response, so the audience check during prepare can skip the network
+    [self.tagGroupsLookupManager getTagGroups:requestedTagGroups completionHandler:^(UATagGroups *tagGroups, NSError *error) {
+        completionHandler();
+    }];
+}
+
+// Must be called while synchronized on self
+- (BOOL)isWithinBudget {
+    return self.bytesPrefetched < self.byteBudget;
+}
+
+- (BOOL)hasBatteryBudget {
+    if ([NSProcessInfo processInfo].lowPowerModeEnabled) {
+        return NO;
+    }
+
+    // Battery level is only available when the app has enabled monitoring
+    UIDevice *device = [UIDevice currentDevice];
+    if (device.batteryMonitoringEnabled && device.batteryState == UIDeviceBatteryStateUnplugged) {
+        return device.batteryLevel < 0 || device.batteryLevel >= UAInAppMessagePrefetcherMinBatteryLevel;
+    }
+
+    return YES;
+}
+
+#pragma mark -
+#pragma mark Ranking
+
++ (double)weightForTriggerType:(UAScheduleTriggerType)type {
+    switch (type) {
+        case UAScheduleTriggerAppForeground:
+        case UAScheduleTriggerAppInit:
+        case UAScheduleTriggerActiveSession:
+            return 1.0;
+        case UAScheduleTriggerScreen:
+            return 0.8;
+        case UAScheduleTriggerCustomEventCount:
+        case UAScheduleTriggerCustomEventValue:
+            return 0.5;
+        case UAScheduleTriggerVersion:
+        case UAScheduleTriggerRegionEnter:
+        case UAScheduleTriggerRegionExit:
+            return 0.3;
+        case UAScheduleTriggerAppBackground:
+            return 0.1;
+    }
+
+    return 0;
+}
+
++ (NSArray<UASchedule *> *)rankSchedules:(NSArray<UASchedule *> *)schedules
+                                progress:(NSDictionary<NSString *, NSNumber *> *)progress {
+    NSMutableDictionary<NSString *, NSNumber *> *scores = [NSMutableDictionary dictionary];
+
+    for (UASchedule *schedule in schedules) {
+        double triggerWeight = 0;
+        for (UAScheduleTrigger *trigger in schedule.info.triggers) {
+            triggerWeight = MAX(triggerWeight, [self weightForTriggerType:trigger.type]);
+        }
+
+        // Likely trigger types and triggers close to their goal count equally
+        scores[schedule.identifier] = @(triggerWeight + [progress[schedule.identifier] doubleValue]);
+    }
+
+    return [schedules sortedArrayUsingComparator:^NSComparisonResult(UASchedule *a, UASchedule *b) {
+        NSComparisonResult result = [scores[b.identifier] compare:scores[a.identifier]];
+        if (result != NSOrderedSame) {
+            return result;
+        }
+
+        // Schedules are executed by priority in ascending order
+        if (a.info.priority != b.info.priority) {
+            return a.info.priority < b.info.priority ? NSOrderedAscending : NSOrderedDescending;
+        }
+
+        return NSOrderedSame;
+    }];
+}
+
+@end
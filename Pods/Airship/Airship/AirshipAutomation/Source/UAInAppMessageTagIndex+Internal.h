@@ -0,0 +1,66 @@
+/* Copyright Airship and Contributors */
+
+#import <Foundation/Foundation.h>
+#import "UAAirshipAutomationCoreImport.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * Process-wide table that interns the tags referenced by tag selectors into dense identifiers.
+ *
+ * Device tags and tag group tags are interned separately, so a device tag never matches a tag
+ * with the same name in a group. The current tags are turned into a bitset indexed by identifier,
+ * which lets compiled tag selectors test many tags with a few word operations. Tags that no
+ * selector references are never interned.
+ */
+@interface UAInAppMessageTagIndex : NSObject
+
+///---------------------------------------------------------------------------------------
+/// @name Tag Index Internal Properties
+///---------------------------------------------------------------------------------------
+
+/**
+ * The number of interned tags.
+ */
+@property (nonatomic, readonly) NSUInteger count;
+
+///---------------------------------------------------------------------------------------
+/// @name Tag Index Internal Methods
+///---------------------------------------------------------------------------------------
+
+/**
+ * The shared tag index.
+ *
+ * @return The shared tag index.
+ */
++ (instancetype)shared;
+
+/**
+ * Factory method. Used for testing.
+ *
+ * @return A new tag index.
+ */
++ (instancetype)index;
+
+/**
+ * Interns a tag.
+ *
+ * @param tag The tag.
+ * @param group The tag group, or `nil` for a device tag.
+ * @return The tag identifier.
+ */
+- (NSUInteger)identifierForTag:(NSString *)tag group:(nullable NSString *)group;
+
+/**
+ * Returns the tag state as a bitset of `uint64_t` words, with the bit for each interned tag that
+ * is present set. The last tag state is reused while the tags and the table are unchanged.
+ *
+ * @param tags The device tags.
+ * @param tagGroups The tag groups.
+ * @return The tag state bitset.
+ */
+- (NSData *)tagStateWithTags:(nullable NSArray<NSString *> *)tags tagGroups:(nullable UATagGroups *)tagGroups;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,111 @@
+/* Copyright Airship and Contributors */
+
+#import "UAInAppMessageTagIndex+Internal.h"
+
+@interface UAInAppMessageTagIndex ()
+// Tag to identifier, by group. Device tags are keyed by NSNull.
+@property (nonatomic, strong) NSMutableDictionary<id, NSMutableDictionary<NSString *, NSNumber *> *> *identifiers;
+@property (nonatomic, assign) NSUInteger count;
+
+// Last tag state
+@property (nonatomic, copy, nullable) NSArray<NSString *> *lastTags;
+@property (nonatomic, strong, nullable) UATagGroups *lastTagGroups;
+@property (nonatomic, assign) NSUInteger lastCount;
+@property (nonatomic, strong, nullable) NSData *lastTagState;
+@end
+
+@implementation UAInAppMessageTagIndex
++ (instancetype)shared {
+    static dispatch_once_t onceToken;
+    static UAInAppMessageTagIndex *shared;
+
+    dispatch_once(&onceToken, ^{
+        shared = [UAInAppMessageTagIndex index];
+    });
+
+    return shared;
+}
+
+- (instancetype)init {
+    self = [super init];
+
+    if (self) {
+        self.identifiers = [NSMutableDictionary dictionary];
+        self.count = 0;
+    }
+
+    return self;
+}
+
++ (instancetype)index {
+    return [[self alloc] init];
+}
+
+- (NSUInteger)identifierForTag:(NSString *)tag group:(NSString *)group {
+    id groupKey = group ?: [NSNull null];
+
+    @synchronized (self) {
+        NSMutableDictionary<NSString *, NSNumber *> *groupIdentifiers = self.identifiers[groupKey];
+        if (!groupIdentifiers) {
+            groupIdentifiers = [NSMutableDictionary dictionary];
+            self.identifiers[groupKey] = groupIdentifiers;
+        }
+
+        NSNumber *identifier = groupIdentifiers[tag];
+        if (!identifier) {
+            identifier = @(self.count++);
+            groupIdentifiers[tag] = identifier;
+        }
+
+        return identifier.unsignedIntegerValue;
+    }
+}
+
+- (NSData *)tagStateWithTags:(NSArray<NSString *> *)tags tagGroups:(UATagGroups *)tagGroups {
+    @synchronized (self) {
+        // Tags interned since the last state was built would be missing from it
+        if (self.lastTagState && self.lastCount == self.count &&
+            (self.lastTags == tags || [self.lastTags isEqualToArray:tags]) &&
+            (self.lastTagGroups == tagGroups || [self.lastTagGroups isEqual:tagGroups])) {
+            return self.lastTagState;
+        }
+
+        NSUInteger wordCount = (self.count + 63) / 64;
+        NSMutableData *state = [NSMutableData dataWithLength:wordCount * sizeof(uint64_t)];
+        uint64_t *words = state.mutableBytes;
+
+        [self setBitsInWords:words forTags:tags groupIdentifiers:self.identifiers[[NSNull null]]];
+
+        for (NSString *group in tagGroups.tags) {
+            NSMutableDictionary<NSString *, NSNumber *> *groupIdentifiers = self.identifiers[group];
+            if (groupIdentifiers) {
+                [self setBitsInWords:words forTags:tagGroups.tags[group] groupIdentifiers:groupIdentifiers];
+            }
+        }
+
+        self.lastTags = tags;
+        self.lastTagGroups = tagGroups;
+        self.lastCount = self.count;
+        self.lastTagState = state;
+
+        return state;
+    }
+}
+
+- (void)setBitsInWords:(uint64_t *)words
+               forTags:(id<NSFastEnumeration>)tags
+      groupIdentifiers:(NSDictionary<NSString *, NSNumber *> *)groupIdentifiers {
+    if (!groupIdentifiers.count) {
+        return;
+    }
+
+    for (NSString *tag in tags) {
+        NSNumber *identifier = groupIdentifiers[tag];
+        if (identifier) {
+            NSUInteger value = identifier.unsignedIntegerValue;
+            words[value / 64] |= (uint64_t)1 << (value % 64);
+        }
+    }
+}
+
+@end
@@ -16,6 +16,16 @@ typedef NS_ENUM(NSInteger, UAInAppMessageTagSelectorErrorCode) {
     UAInAppMessageTagSelectorErrorCodeInvalidJSON,
 };
 
+/**
+ * Represents the type of the tag selector.
+ */
+typedef NS_ENUM(NSInteger, UAInAppMessageTagSelectorType) {
+    UAInAppMessageTagSelectorTypeOR,
+    UAInAppMessageTagSelectorTypeAND,
+    UAInAppMessageTagSelectorTypeNOT,
+    UAInAppMessageTagSelectorTypeTag
+};
+
 /**
  * Model object for an in-app message audience constraint's tag selector.
  */
@@ -23,6 +33,26 @@ typedef NS_ENUM(NSInteger, UAInAppMessageTagSelectorErrorCode) {
 
 @property (nonatomic, readonly) UATagGroups *tagGroups;
 
+/**
+ * The selector type.
+ */
+@property (nonatomic, readonly) UAInAppMessageTagSelectorType type;
+
+/**
+ * The tag, for tag selectors.
+ */
+@property (nonatomic, readonly, nullable) NSString *tag;
+
+/**
+ * The tag group, for tag selectors on a tag group.
+ */
+@property (nonatomic, readonly, nullable) NSString *group;
+
+/**
+ * The child selectors, for and, or and not selectors.
+ */
+@property (nonatomic, readonly, nullable) NSArray<UAInAppMessageTagSelector *> *selectors;
+
 /**
  * Parses a json value for a tag selector.
  *
@@ -63,6 +93,16 @@ typedef NS_ENUM(NSInteger, UAInAppMessageTagSelectorErrorCode) {
  */
 - (BOOL)apply:(NSArray<NSString *> *)tags tagGroups:(nullable UATagGroups *)tagGroups;
 
+/**
+ * Applies the tag selector by walking the selector tree instead of running the compiled program.
+ * Used for testing.
+ *
+ * @param tags The array of tags.
+ * @param tagGroups The tag groups.
+ * @return YES if the tag selector matches the tags, otherwise NO.
+ */
+- (BOOL)applyTree:(NSArray<NSString *> *)tags tagGroups:(nullable UATagGroups *)tagGroups;
+
 /**
  * Indicates whether the tag selector contains tag groups.
  *
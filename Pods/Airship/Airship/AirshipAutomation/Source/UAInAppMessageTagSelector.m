@@ -1,18 +1,10 @@
 /* Copyright Airship and Contributors */
 
 #import "UAInAppMessageTagSelector+Internal.h"
+#import "UAInAppMessageTagSelectorProgram+Internal.h"
+#import "UAInAppMessageTagIndex+Internal.h"
 #import "UAAirshipAutomationCoreImport.h"
 
-/**
- * Represents the type of the tag selector.
- */
-typedef NS_ENUM(NSInteger, UAInAppMessageTagSelectorType) {
-    UAInAppMessageTagSelectorTypeOR,
-    UAInAppMessageTagSelectorTypeAND,
-    UAInAppMessageTagSelectorTypeNOT,
-    UAInAppMessageTagSelectorTypeTag
-};
-
 NSString * const UAInAppMessageTagSelectorTagJSONKey = @"tag";
 NSString * const UAInAppMessageTagSelectorANDJSONKey = @"and";
 NSString * const UAInAppMessageTagSelectorORJSONKey = @"or";
@@ -24,9 +16,10 @@ NSString * const UAInAppMessageTagSelectorErrorDomain = @"com.urbanairship.in_ap
 @interface UAInAppMessageTagSelector()
 
 @property (nonatomic, assign) UAInAppMessageTagSelectorType type;
-@property (nonatomic, strong) NSString *tag;
-@property (nonatomic, strong) NSArray<UAInAppMessageTagSelector *> *selectors;
-@property (nonatomic, copy) NSString *group;
+@property (nonatomic, strong, nullable) NSString *tag;
+@property (nonatomic, strong, nullable) NSArray<UAInAppMessageTagSelector *> *selectors;
+@property (nonatomic, copy, nullable) NSString *group;
+@property (atomic, strong, nullable) UAInAppMessageTagSelectorProgram *program;
 
 @end
 
@@ -209,6 +202,20 @@ NSString * const UAInAppMessageTagSelectorErrorDomain = @"com.urbanairship.in_ap
 }
 
 - (BOOL)apply:(NSArray<NSString *> *)tags tagGroups:(UATagGroups *)tagGroups  {
+    UAInAppMessageTagIndex *tagIndex = [UAInAppMessageTagIndex shared];
+
+    UAInAppMessageTagSelectorProgram *program = self.program;
+    if (!program) {
+        // Compiling twice on a race is harmless, the programs are identical
+        program = [UAInAppMessageTagSelectorProgram programWithSelector:self tagIndex:tagIndex];
+        self.program = program;
+    }
+
+    // The tag state is built after compiling so it includes the tags the program interned
+    return [program evaluateTagState:[tagIndex tagStateWithTags:tags tagGroups:tagGroups]];
+}
+
+- (BOOL)applyTree:(NSArray<NSString *> *)tags tagGroups:(UATagGroups *)tagGroups {
     switch (self.type) {
         case UAInAppMessageTagSelectorTypeTag:
             if (self.group) {
@@ -219,11 +226,11 @@ NSString * const UAInAppMessageTagSelectorErrorDomain = @"com.urbanairship.in_ap
             return [tags containsObject:self.tag];
             
         case UAInAppMessageTagSelectorTypeNOT:
-            return ![self.selectors[0] apply:tags tagGroups:tagGroups];
+            return ![self.selectors[0] applyTree:tags tagGroups:tagGroups];
             
         case UAInAppMessageTagSelectorTypeAND:
             for (UAInAppMessageTagSelector *selector in self.selectors) {
-                if (![selector apply:tags tagGroups:tagGroups]) {
+                if (![selector applyTree:tags tagGroups:tagGroups]) {
                     return NO;
                 }
             }
@@ -231,7 +238,7 @@ NSString * const UAInAppMessageTagSelectorErrorDomain = @"com.urbanairship.in_ap
             
         case UAInAppMessageTagSelectorTypeOR:
             for (UAInAppMessageTagSelector *selector in self.selectors) {
-                if ([selector apply:tags tagGroups:tagGroups]) {
+                if ([selector applyTree:tags tagGroups:tagGroups]) {
                     return YES;
                 }
             }
@@ -263,16 +270,26 @@ NSString * const UAInAppMessageTagSelectorErrorDomain = @"com.urbanairship.in_ap
 }
 
 - (UATagGroups *)tagGroups {
-    if (self.group && self.tag) {
-        return [UATagGroups tagGroupsWithTags:@{self.group : @[self.tag]}];
-    } else {
-        UATagGroups *tagGroups = [UATagGroups tagGroupsWithTags:@{}];
+    // Collected in one pass instead of merging a tag groups copy per selector
+    NSMutableDictionary<NSString *, NSMutableSet<NSString *> *> *tags = [NSMutableDictionary dictionary];
+    [self collectTagGroups:tags];
+    return [UATagGroups tagGroupsWithTags:tags];
+}
 
-        for (UAInAppMessageTagSelector *selector in self.selectors) {
-            tagGroups = [tagGroups merge:selector.tagGroups];
+- (void)collectTagGroups:(NSMutableDictionary<NSString *, NSMutableSet<NSString *> *> *)tags {
+    if (self.group && self.tag) {
+        NSMutableSet<NSString *> *groupTags = tags[self.group];
+        if (!groupTags) {
+            groupTags = [NSMutableSet set];
+            tags[self.group] = groupTags;
         }
 
-        return tagGroups;
+        [groupTags addObject:self.tag];
+        return;
+    }
+
+    for (UAInAppMessageTagSelector *selector in self.selectors) {
+        [selector collectTagGroups:tags];
     }
 }
 
@@ -0,0 +1,50 @@
+/* Copyright Airship and Contributors */
+
+#import <Foundation/Foundation.h>
+
+@class UAInAppMessageTagSelector;
+@class UAInAppMessageTagIndex;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * A tag selector compiled into bitset operations over interned tag identifiers.
+ *
+ * The tag children of an and or an or selector are merged into a single mask, so the whole group
+ * is tested against the tag state at once. Nested selectors are compiled into short-circuit jumps.
+ */
+@interface UAInAppMessageTagSelectorProgram : NSObject
+
+///---------------------------------------------------------------------------------------
+/// @name Tag Selector Program Internal Properties
+///---------------------------------------------------------------------------------------
+
+/**
+ * The number of instructions.
+ */
+@property (nonatomic, readonly) NSUInteger instructionCount;
+
+///---------------------------------------------------------------------------------------
+/// @name Tag Selector Program Internal Methods
+///---------------------------------------------------------------------------------------
+
+/**
+ * Compiles a tag selector, interning its tags in the tag index.
+ *
+ * @param selector The tag selector.
+ * @param tagIndex The tag index.
+ * @return The compiled program.
+ */
++ (instancetype)programWithSelector:(UAInAppMessageTagSelector *)selector tagIndex:(UAInAppMessageTagIndex *)tagIndex;
+
+/**
+ * Evaluates the program against a tag state.
+ *
+ * @param tagState The tag state bitset from the same tag index the program was compiled with.
+ * @return `YES` if the tag state matches, otherwise `NO`.
+ */
+- (BOOL)evaluateTagState:(NSData *)tagState;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,234 @@
+/* Copyright Airship and Contributors */
+
+#import "UAInAppMessageTagSelectorProgram+Internal.h"
+#import "UAInAppMessageTagSelector+Internal.h"
+#import "UAInAppMessageTagIndex+Internal.h"
+
+/**
+ * Program opcodes. Instructions read and write a single result register.
+ */
+typedef NS_ENUM(uint8_t, UAInAppMessageTagSelectorOpcode) {
+    // result = every bit in masks[operand ..< operand + argument] is set in the tag state
+    UAInAppMessageTagSelectorOpcodeTestAll,
+
+    // result = any bit in masks[operand ..< operand + argument] is set in the tag state
+    UAInAppMessageTagSelectorOpcodeTestAny,
+
+    // result = !result
+    UAInAppMessageTagSelectorOpcodeNot,
+
+    // if !result, jump to operand
+    UAInAppMessageTagSelectorOpcodeJumpIfFalse,
+
+    // if result, jump to operand
+    UAInAppMessageTagSelectorOpcodeJumpIfTrue,
+};
+
+typedef struct {
+    UAInAppMessageTagSelectorOpcode opcode;
+    NSUInteger operand;
+    NSUInteger argument;
+} UAInAppMessageTagSelectorInstruction;
+
+// A non-zero word of a mask, sparse so high tag identifiers do not widen every mask
+typedef struct {
+    NSUInteger index;
+    uint64_t bits;
+} UAInAppMessageTagSelectorMaskWord;
+
+@interface UAInAppMessageTagSelectorProgram ()
+@property (nonatomic, strong) NSMutableData *instructionData;
+@property (nonatomic, strong) NSMutableData *maskData;
+@property (nonatomic, strong) UAInAppMessageTagIndex *tagIndex;
+@end
+
+@implementation UAInAppMessageTagSelectorProgram
+
+- (instancetype)initWithSelector:(UAInAppMessageTagSelector *)selector tagIndex:(UAInAppMessageTagIndex *)tagIndex {
+    self = [super init];
+
+    if (self) {
+        self.instructionData = [NSMutableData data];
+        self.maskData = [NSMutableData data];
+        self.tagIndex = tagIndex;
+
+        [self compileSelector:selector];
+
+        // Only needed while compiling
+        self.tagIndex = nil;
+    }
+
+    return self;
+}
+
++ (instancetype)programWithSelector:(UAInAppMessageTagSelector *)selector tagIndex:(UAInAppMessageTagIndex *)tagIndex {
+    return [[self alloc] initWithSelector:selector tagIndex:tagIndex];
+}
+
+- (NSUInteger)instructionCount {
+    return self.instructionData.length / sizeof(UAInAppMessageTagSelectorInstruction);
+}
+
+- (BOOL)evaluateTagState:(NSData *)tagState {
+    const UAInAppMessageTagSelectorInstruction *instructions = self.instructionData.bytes;
+    const UAInAppMessageTagSelectorMaskWord *masks = self.maskData.bytes;
+    const uint64_t *words = tagState.bytes;
+    NSUInteger wordCount = tagState.length / sizeof(uint64_t);
+    NSUInteger count = self.instructionCount;
+    BOOL result = YES;
+
+    NSUInteger pc = 0;
+    while (pc < count) {
+        UAInAppMessageTagSelectorInstruction instruction = instructions[pc++];
+
+        switch (instruction.opcode) {
+            case UAInAppMessageTagSelectorOpcodeTestAll:
+                result = YES;
+                for (NSUInteger i = instruction.operand; i < instruction.operand + instruction.argument; i++) {
+                    uint64_t word = masks[i].index < wordCount ? words[masks[i].index] : 0;
+                    if ((word & masks[i].bits) != masks[i].bits) {
+                        result = NO;
+                        break;
+                    }
+                }
+                break;
+
+            case UAInAppMessageTagSelectorOpcodeTestAny:
+                result = NO;
+                for (NSUInteger i = instruction.operand; i < instruction.operand + instruction.argument; i++) {
+                    uint64_t word = masks[i].index < wordCount ? words[masks[i].index] : 0;
+                    if (word & masks[i].bits) {
+                        result = YES;
+                        break;
+                    }
+                }
+                break;
+
+            case UAInAppMessageTagSelectorOpcodeNot:
+                result = !result;
+                break;
+
+            case UAInAppMessageTagSelectorOpcodeJumpIfFalse:
+                if (!result) {
+                    pc = instruction.operand;
+                }
+                break;
+
+            case UAInAppMessageTagSelectorOpcodeJumpIfTrue:
+                if (result) {
+                    pc = instruction.operand;
+                }
+                break;
+        }
+    }
+
+    return result;
+}
+
+#pragma mark -
+#pragma mark Compiler
+
+- (NSUInteger)emit:(UAInAppMessageTagSelectorOpcode)opcode operand:(NSUInteger)operand argument:(NSUInteger)argument {
+    UAInAppMessageTagSelectorInstruction instruction = { opcode, operand, argument };
+    [self.instructionData appendBytes:&instruction length:sizeof(instruction)];
+    return self.instructionCount - 1;
+}
+
+/**
+ * Emits a mask test for the tag identifiers.
+ */
+- (void)emitTest:(UAInAppMessageTagSelectorOpcode)opcode identifiers:(NSIndexSet *)identifiers {
+    NSUInteger start = self.maskData.length / sizeof(UAInAppMessageTagSelectorMaskWord);
+    __block UAInAppMessageTagSelectorMaskWord mask = { NSNotFound, 0 };
+
+    // Index sets enumerate in ascending order, so each word is complete before the next starts
+    [identifiers enumerateIndexesUsingBlock:^(NSUInteger identifier, BOOL *stop) {
+        if (mask.index != identifier / 64) {
+            if (mask.bits) {
+                [self.maskData appendBytes:&mask length:sizeof(mask)];
+            }
+
+            mask.index = identifier / 64;
+            mask.bits = 0;
+        }
+
+        mask.bits |= (uint64_t)1 << (identifier % 64);
+    }];
+
+    if (mask.bits) {
+        [self.maskData appendBytes:&mask length:sizeof(mask)];
+    }
+
+    NSUInteger end = self.maskData.length / sizeof(UAInAppMessageTagSelectorMaskWord);
+    [self emit:opcode operand:start argument:end - start];
+}
+
+- (void)compileSelector:(UAInAppMessageTagSelector *)selector {
+    switch (selector.type) {
+        case UAInAppMessageTagSelectorTypeTag: {
+            NSUInteger identifier = [self.tagIndex identifierForTag:selector.tag group:selector.group];
+            [self emitTest:UAInAppMessageTagSelectorOpcodeTestAll identifiers:[NSIndexSet indexSetWithIndex:identifier]];
+            break;
+        }
+
+        case UAInAppMessageTagSelectorTypeNOT:
+            [self compileSelector:selector.selectors.firstObject];
+            [self emit:UAInAppMessageTagSelectorOpcodeNot operand:0 argument:0];
+            break;
+
+        case UAInAppMessageTagSelectorTypeAND:
+            [self compileSelectors:selector.selectors
+                          maskTest:UAInAppMessageTagSelectorOpcodeTestAll
+                              jump:UAInAppMessageTagSelectorOpcodeJumpIfFalse];
+            break;
+
+        case UAInAppMessageTagSelectorTypeOR:
+            [self compileSelectors:selector.selectors
+                          maskTest:UAInAppMessageTagSelectorOpcodeTestAny
+                              jump:UAInAppMessageTagSelectorOpcodeJumpIfTrue];
+            break;
+    }
+}
+
+/**
+ * Compiles the children of an and or an or selector. The tag children are tested first with a single mask,
+ * then the other children in order, short circuiting to the end once the result is decided.
+ */
+- (void)compileSelectors:(NSArray<UAInAppMessageTagSelector *> *)selectors
+                maskTest:(UAInAppMessageTagSelectorOpcode)maskTest
+                    jump:(UAInAppMessageTagSelectorOpcode)jump {
+    NSMutableIndexSet *identifiers = [NSMutableIndexSet indexSet];
+    NSMutableArray<UAInAppMessageTagSelector *> *nested = [NSMutableArray array];
+
+    for (UAInAppMessageTagSelector *selector in selectors) {
+        if (selector.type == UAInAppMessageTagSelectorTypeTag) {
+            [identifiers addIndex:[self.tagIndex identifierForTag:selector.tag group:selector.group]];
+        } else {
+            [nested addObject:selector];
+        }
+    }
+
+    // An empty mask tests YES for and, NO for or, which matches an empty selector list
+    BOOL hasCheck = NO;
+    if (identifiers.count || !nested.count) {
+        [self emitTest:maskTest identifiers:identifiers];
+        hasCheck = YES;
+    }
+
+    NSMutableArray<NSNumber *> *jumps = [NSMutableArray array];
+    for (UAInAppMessageTagSelector *selector in nested) {
+        if (hasCheck) {
+            [jumps addObject:@([self emit:jump operand:0 argument:0])];
+        }
+
+        [self compileSelector:selector];
+        hasCheck = YES;
+    }
+
+    UAInAppMessageTagSelectorInstruction *instructions = self.instructionData.mutableBytes;
+    for (NSNumber *jumpIndex in jumps) {
+        instructions[jumpIndex.unsignedIntegerValue].operand = self.instructionCount;
+    }
+}
+
+@end
@@ -82,6 +82,14 @@
  */
 + (void)prepareMediaView:(UAInAppMessageMediaInfo *)media assets:(UAInAppMessageAssets *)assets completionHandler:(void (^)(UAInAppMessagePrepareResult, UAInAppMessageMediaView *))completionHandler;
 
+/**
+ * Returns the media of a banner, modal or full screen message.
+ *
+ * @param message The message.
+ * @return The media info, or `nil` if the message has no media.
+ */
++ (nullable UAInAppMessageMediaInfo *)mediaInfoForMessage:(UAInAppMessage *)message;
+
 /**
  * Informs the adapter of the ready state of the in-app message immediately before display.
  *
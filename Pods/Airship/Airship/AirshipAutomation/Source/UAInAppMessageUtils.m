@@ -3,6 +3,10 @@
 #import "UAInAppMessageUtils+Internal.h"
 #import "UAInAppMessageButtonView+Internal.h"
 #import "UAInAppMessageAssets.h"
+#import "UAInAppMessageImage+Internal.h"
+#import "UAInAppMessageBannerDisplayContent.h"
+#import "UAInAppMessageFullScreenDisplayContent.h"
+#import "UAInAppMessageModalDisplayContent.h"
 #import "UAAirshipAutomationCoreImport.h"
 
 NSString *const UADefaultSerifFont = @"Times New Roman";
@@ -373,13 +377,46 @@ CGFloat const CloseButtonHeight = 30;
     }
 
     NSURL *cacheURL = [assets getCacheURL:mediaURL];
-    NSData *data =  [[NSFileManager defaultManager] contentsAtPath:[cacheURL path]];
-    if (data) {
-        UAInAppMessageMediaView *mediaView = [UAInAppMessageMediaView mediaViewWithMediaInfo:media imageData:data];
-        completionHandler(UAInAppMessagePrepareResultSuccess, mediaView);
-    } else {
+    if (!cacheURL) {
         completionHandler(UAInAppMessagePrepareResultInvalidate, nil);
+        return;
+    }
+
+    // Normally decoded by the asset manager while the message was prepared
+    CGFloat maxPixelSize = [UAInAppMessageImage defaultMaxPixelSize];
+    UAInAppMessageImage *image = [UAInAppMessageImage cachedImageForURL:cacheURL maxPixelSize:maxPixelSize];
+    if (image) {
+        completionHandler(UAInAppMessagePrepareResultSuccess, [UAInAppMessageMediaView mediaViewWithMediaInfo:media image:image]);
+        return;
+    }
+
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+        UAInAppMessageImage *image = [UAInAppMessageImage imageWithContentsOfURL:cacheURL maxPixelSize:maxPixelSize];
+
+        [[UADispatcher mainDispatcher] dispatchAsync:^{
+            if (image) {
+                completionHandler(UAInAppMessagePrepareResultSuccess, [UAInAppMessageMediaView mediaViewWithMediaInfo:media image:image]);
+            } else {
+                completionHandler(UAInAppMessagePrepareResultInvalidate, nil);
+            }
+        }];
+    });
+}
+
++ (nullable UAInAppMessageMediaInfo *)mediaInfoForMessage:(UAInAppMessage *)message {
+    switch (message.displayType) {
+        case UAInAppMessageDisplayTypeBanner:
+            return ((UAInAppMessageBannerDisplayContent *)message.displayContent).media;
+        case UAInAppMessageDisplayTypeFullScreen:
+            return ((UAInAppMessageFullScreenDisplayContent *)message.displayContent).media;
+        case UAInAppMessageDisplayTypeModal:
+            return ((UAInAppMessageModalDisplayContent *)message.displayContent).media;
+        case UAInAppMessageDisplayTypeHTML:
+        case UAInAppMessageDisplayTypeCustom:
+            break;
     }
+
+    return nil;
 }
 
 + (BOOL)isReadyToDisplayWithMedia:(UAInAppMessageMediaInfo *)media {
@@ -126,6 +126,11 @@ NSString *const UALastDisplayedInAppMessageID = @"UALastDisplayedInAppMessageID"
     completionHandler(UIBackgroundFetchResultNoData);
 }
 
+-(UAPushableComponentPriority)pushProcessingPriority {
+    // Only schedules the message, which is cheap and easily lost if deferred
+    return UAPushableComponentPriorityHigh;
+}
+
 - (void)scheduleMessage:(UALegacyInAppMessage *)message {
     UAInAppMessageScheduleInfo *info =  [self.factoryDelegate scheduleInfoForMessage:message];
     if (!info) {
@@ -0,0 +1,70 @@
+/* Copyright Airship and Contributors */
+
+#import <Foundation/Foundation.h>
+#import "UARetriable+Internal.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * A block called with the latency of each completed retriable attempt.
+ *
+ * @param name The name of the retriable.
+ * @param result The result of the attempt.
+ * @param latency The time from the start of the attempt to its result.
+ */
+typedef void (^UARetriableGraphLatencyHandler)(NSString *name, UARetriableResult result, NSTimeInterval latency);
+
+/**
+ * A dependency graph of named retriables. A retriable runs once every retriable it depends on
+ * has succeeded, so retriables without a path between them run concurrently. Each retriable
+ * backs off and retries on its own.
+ *
+ * When a retriable cancels or invalidates, the graph short-circuits: no further retriables are
+ * started, and results of retriables already in flight are discarded.
+ */
+@interface UARetriableGraph : NSObject
+
+/**
+ * Optional handler called with the latency of each completed attempt.
+ */
+@property (nonatomic, copy, nullable) UARetriableGraphLatencyHandler latencyHandler;
+
+/**
+ * The names of the retriables, in the order they were added.
+ */
+@property (nonatomic, readonly) NSArray<NSString *> *names;
+
+/**
+ * UARetriableGraph class factory.
+ */
++ (instancetype)graph;
+
+/**
+ * Adds a retriable. Dependencies must be added before the retriables that depend on them,
+ * which keeps the graph acyclic. Unknown dependencies are ignored.
+ *
+ * @param retriable The retriable.
+ * @param name The unique name of the retriable.
+ * @param dependencies The names of the retriables that must succeed first.
+ */
+- (void)addRetriable:(UARetriable *)retriable name:(NSString *)name dependencies:(nullable NSArray<NSString *> *)dependencies;
+
+/**
+ * Returns a retriable by name.
+ *
+ * @param name The name of the retriable.
+ * @return The retriable, or `nil` if no retriable has that name.
+ */
+- (nullable UARetriable *)retriableWithName:(NSString *)name;
+
+/**
+ * Returns the dependencies of a retriable.
+ *
+ * @param name The name of the retriable.
+ * @return The names of the retriables it depends on.
+ */
+- (NSArray<NSString *> *)dependenciesOfRetriableWithName:(NSString *)name;
+
+@end
+
+NS_ASSUME_NONNULL_END
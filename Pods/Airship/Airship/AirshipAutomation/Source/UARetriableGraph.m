@@ -0,0 +1,62 @@
+/* Copyright Airship and Contributors */
+
+#import "UARetriableGraph+Internal.h"
+#import "UAGlobal.h"
+
+@interface UARetriableGraph ()
+@property (nonatomic, strong) NSMutableArray<NSString *> *orderedNames;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, UARetriable *> *retriables;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, NSArray<NSString *> *> *dependencies;
+@end
+
+@implementation UARetriableGraph
+
+- (instancetype)init {
+    self = [super init];
+
+    if (self) {
+        self.orderedNames = [NSMutableArray array];
+        self.retriables = [NSMutableDictionary dictionary];
+        self.dependencies = [NSMutableDictionary dictionary];
+    }
+
+    return self;
+}
+
++ (instancetype)graph {
+    return [[self alloc] init];
+}
+
+- (NSArray<NSString *> *)names {
+    return [self.orderedNames copy];
+}
+
+- (void)addRetriable:(UARetriable *)retriable name:(NSString *)name dependencies:(NSArray<NSString *> *)dependencies {
+    if (self.retriables[name]) {
+        UA_LERR(@"Retriable %@ already added to graph", name);
+        return;
+    }
+
+    NSMutableArray<NSString *> *knownDependencies = [NSMutableArray array];
+    for (NSString *dependency in dependencies) {
+        if (self.retriables[dependency]) {
+            [knownDependencies addObject:dependency];
+        } else {
+            UA_LERR(@"Ignoring unknown dependency %@ of retriable %@", dependency, name);
+        }
+    }
+
+    [self.orderedNames addObject:name];
+    self.retriables[name] = retriable;
+    self.dependencies[name] = knownDependencies;
+}
+
+- (UARetriable *)retriableWithName:(NSString *)name {
+    return self.retriables[name];
+}
+
+- (NSArray<NSString *> *)dependenciesOfRetriableWithName:(NSString *)name {
+    return self.dependencies[name] ?: @[];
+}
+
+@end
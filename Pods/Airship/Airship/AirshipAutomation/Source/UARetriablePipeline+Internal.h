@@ -2,6 +2,7 @@
 
 #import <Foundation/Foundation.h>
 #import "UARetriable+Internal.h"
+#import "UARetriableGraph+Internal.h"
 #import "UADispatcher.h"
 #import "UAAsyncOperation.h"
 
@@ -40,4 +41,13 @@
  */
 - (void)addChainedRetriables:(NSArray<UARetriable *> *)retriables;
 
+/**
+ * Adds a graph of retriables. Retriables whose dependencies have succeeded are started
+ * together, and each one retries with its own backoff. Unlike chained retriables, a graph
+ * retriable does not hold the queue while it waits for its result.
+ *
+ * @param graph The UARetriableGraph to run.
+ */
+- (void)addRetriableGraph:(UARetriableGraph *)graph;
+
 @end
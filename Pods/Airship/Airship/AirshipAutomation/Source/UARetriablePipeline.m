@@ -11,6 +11,16 @@
 @implementation UARetriableChain
 @end
 
+@interface UARetriableGraphExecution : NSObject
+@property (nonatomic, strong) UARetriableGraph *graph;
+@property (nonatomic, strong) NSMutableSet<NSString *> *started;
+@property (nonatomic, strong) NSMutableSet<NSString *> *succeeded;
+@property (nonatomic, assign) BOOL shortCircuited;
+@end
+
+@implementation UARetriableGraphExecution
+@end
+
 @interface UARetriablePipeline ()
 @property (nonatomic, strong) NSOperationQueue *queue;
 @property (nonatomic, strong) UADispatcher *dispatcher;
@@ -88,6 +98,108 @@
     [self.queue addOperation:operation];
 }
 
+- (void)addRetriableGraph:(UARetriableGraph *)graph {
+    UARetriableGraphExecution *execution = [[UARetriableGraphExecution alloc] init];
+    execution.graph = graph;
+    execution.started = [NSMutableSet set];
+    execution.succeeded = [NSMutableSet set];
+    [self executeReadyRetriablesInGraph:execution];
+}
+
+- (void)executeReadyRetriablesInGraph:(UARetriableGraphExecution *)execution {
+    NSMutableArray<NSString *> *ready = [NSMutableArray array];
+
+    @synchronized (execution) {
+        if (execution.shortCircuited) {
+            return;
+        }
+
+        for (NSString *name in execution.graph.names) {
+            if ([execution.started containsObject:name]) {
+                continue;
+            }
+
+            NSSet *dependencies = [NSSet setWithArray:[execution.graph dependenciesOfRetriableWithName:name]];
+            if ([dependencies isSubsetOfSet:execution.succeeded]) {
+                [execution.started addObject:name];
+                [ready addObject:name];
+            }
+        }
+    }
+
+    for (NSString *name in ready) {
+        [self executeRetriableWithName:name graph:execution backoff:0];
+    }
+}
+
+- (void)executeRetriableWithName:(NSString *)name graph:(UARetriableGraphExecution *)execution backoff:(NSTimeInterval)backoff {
+    UA_WEAKIFY(self)
+    UARetriable *retriable = [execution.graph retriableWithName:name];
+    NSTimeInterval nextBackoff = backoff == 0 ? retriable.minBackoffInterval : MIN(backoff * 2, retriable.maxBackoffInterval);
+
+    UAAsyncOperation *operation = [UAAsyncOperation operationWithBlock:^(UAAsyncOperation *operation) {
+        @synchronized (execution) {
+            if (execution.shortCircuited) {
+                [operation finish];
+                return;
+            }
+        }
+
+        NSDate *start = [NSDate date];
+        UARetriableCompletionHandler handler = ^(UARetriableResult result) {
+            UA_STRONGIFY(self)
+            @synchronized (execution) {
+                // A sibling already failed, the graph's outcome is decided
+                if (execution.shortCircuited) {
+                    return;
+                }
+
+                if (result == UARetriableResultSuccess) {
+                    [execution.succeeded addObject:name];
+                } else if (result == UARetriableResultCancel || result == UARetriableResultInvalidate) {
+                    execution.shortCircuited = YES;
+                }
+            }
+
+            if (execution.graph.latencyHandler) {
+                execution.graph.latencyHandler(name, result, [[NSDate date] timeIntervalSinceDate:start]);
+            }
+
+            switch(result) {
+                case UARetriableResultRetry:
+                    [self scheduleRetryWithBackoff:nextBackoff name:name graph:execution];
+                    break;
+                case UARetriableResultSuccess:
+                    [self executeReadyRetriablesInGraph:execution];
+                    break;
+                case UARetriableResultCancel:
+                    break;
+                case UARetriableResultInvalidate:
+                    break;
+            }
+
+            if (retriable.resultHandler) {
+                retriable.resultHandler(result);
+            }
+        };
+
+        retriable.runBlock(handler);
+
+        // Only starting the retriable is serialized, so independent retriables overlap
+        [operation finish];
+    }];
+
+    [self.queue addOperation:operation];
+}
+
+- (void)scheduleRetryWithBackoff:(NSTimeInterval)backoff name:(NSString *)name graph:(UARetriableGraphExecution *)execution {
+    UA_WEAKIFY(self)
+    [self.dispatcher dispatchAfter:backoff block:^{
+        UA_STRONGIFY(self)
+        [self executeRetriableWithName:name graph:execution backoff:backoff];
+    }];
+}
+
 - (void)scheduleRetryWithBackoff:(NSTimeInterval)backoff chain:(UARetriableChain *)chain {
     UA_WEAKIFY(self)
     [self.dispatcher dispatchAfter:backoff block:^{
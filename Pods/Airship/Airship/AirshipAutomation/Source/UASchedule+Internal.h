@@ -44,6 +44,22 @@ NS_ASSUME_NONNULL_BEGIN
                                   info:(UAScheduleInfo *)info
                               metadata:(nullable NSDictionary *)metadata;
 
+/**
+ * Factory method to create a schedule whose info and metadata are decoded on first access.
+ * The decoded values are kept for the lifetime of the schedule.
+ *
+ * @param identifier The schedule's identifier.
+ * @param group The schedule's group.
+ * @param priority The schedule's priority.
+ * @param metadataJSON The schedule's metadata as a JSON string.
+ * @param infoBlock A block that builds the schedule's info. Called at most once, from any thread.
+ */
++ (instancetype)scheduleWithIdentifier:(NSString *)identifier
+                                 group:(nullable NSString *)group
+                              priority:(NSInteger)priority
+                          metadataJSON:(nullable NSString *)metadataJSON
+                             infoBlock:(UAScheduleInfo * (^)(void))infoBlock;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -24,6 +24,16 @@ NS_ASSUME_NONNULL_BEGIN
  */
 @property(nonatomic, readonly) UAScheduleInfo *info;
 
+/**
+ * The schedule's group. Same as the info's group, but available without decoding the info.
+ */
+@property(nullable, nonatomic, readonly) NSString *group;
+
+/**
+ * The schedule's priority. Same as the info's priority, but available without decoding the info.
+ */
+@property(nonatomic, readonly) NSInteger priority;
+
 /**
  * The schedule's metadata.
  *
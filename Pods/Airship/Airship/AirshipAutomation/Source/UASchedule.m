@@ -1,6 +1,14 @@
 /* Copyright Airship and Contributors */
 
 #import "UASchedule+Internal.h"
+#import "UAAirshipAutomationCoreImport.h"
+
+@interface UASchedule ()
+@property(nonatomic, copy, nullable) NSString *lazyGroup;
+@property(nonatomic, assign) NSInteger lazyPriority;
+@property(nonatomic, copy, nullable) NSString *metadataJSON;
+@property(nonatomic, copy, nullable) UAScheduleInfo * (^infoBlock)(void);
+@end
 
 @implementation UASchedule
 
@@ -25,6 +33,55 @@
                                          metadata:metadata];
 }
 
++ (instancetype)scheduleWithIdentifier:(NSString *)identifier
+                                 group:(nullable NSString *)group
+                              priority:(NSInteger)priority
+                          metadataJSON:(nullable NSString *)metadataJSON
+                             infoBlock:(UAScheduleInfo * (^)(void))infoBlock {
+    UASchedule *schedule = [[UASchedule alloc] init];
+    schedule.identifier = identifier;
+    schedule.lazyGroup = group;
+    schedule.lazyPriority = priority;
+    schedule.metadataJSON = metadataJSON;
+    schedule.metadata = metadataJSON ? nil : @{};
+    schedule.infoBlock = infoBlock;
+    return schedule;
+}
+
+- (UAScheduleInfo *)info {
+    @synchronized (self) {
+        if (self.infoBlock) {
+            _info = self.infoBlock();
+            self.infoBlock = nil;
+        }
+
+        return _info;
+    }
+}
+
+- (NSDictionary *)metadata {
+    @synchronized (self) {
+        if (self.metadataJSON) {
+            _metadata = [NSJSONSerialization objectWithString:self.metadataJSON] ?: @{};
+            self.metadataJSON = nil;
+        }
+
+        return _metadata;
+    }
+}
+
+- (NSString *)group {
+    @synchronized (self) {
+        return self.infoBlock ? self.lazyGroup : _info.group;
+    }
+}
+
+- (NSInteger)priority {
+    @synchronized (self) {
+        return self.infoBlock ? self.lazyPriority : _info.priority;
+    }
+}
+
 - (BOOL)isEqualToSchedule:(UASchedule *)schedule {
     if (!schedule) {
         return NO;
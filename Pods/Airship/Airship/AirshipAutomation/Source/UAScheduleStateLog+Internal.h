@@ -0,0 +1,58 @@
+/* Copyright Airship and Contributors */
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * Append-only log of schedule state changes that have not been saved to the automation store yet.
+ *
+ * Each record is a JSON object written on its own line, so records appended before a crash can be
+ * read back and replayed. A partially written trailing record is ignored.
+ */
+@interface UAScheduleStateLog : NSObject
+
+///---------------------------------------------------------------------------------------
+/// @name Schedule State Log Internal Properties
+///---------------------------------------------------------------------------------------
+
+/**
+ * The number of records appended since the log was last truncated.
+ */
+@property (nonatomic, readonly) NSUInteger recordCount;
+
+///---------------------------------------------------------------------------------------
+/// @name Schedule State Log Internal Methods
+///---------------------------------------------------------------------------------------
+
+/**
+ * Factory method.
+ *
+ * @param fileURL The log file URL. The file is created if it does not exist.
+ * @return The log, or `nil` if the file could not be opened.
+ */
++ (nullable instancetype)logWithFileURL:(NSURL *)fileURL;
+
+/**
+ * Appends records to the log.
+ *
+ * @param records The JSON serializable records.
+ * @return `YES` if the records were written, otherwise `NO`.
+ */
+- (BOOL)appendRecords:(NSArray<NSDictionary *> *)records;
+
+/**
+ * Reads the records in the order they were appended.
+ *
+ * @return The records.
+ */
+- (NSArray<NSDictionary *> *)records;
+
+/**
+ * Removes all records.
+ */
+- (void)truncate;
+
+@end
+
+NS_ASSUME_NONNULL_END
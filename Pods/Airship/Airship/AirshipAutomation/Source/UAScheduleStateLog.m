@@ -0,0 +1,112 @@
+/* Copyright Airship and Contributors */
+
+#import "UAScheduleStateLog+Internal.h"
+#import "UAAirshipAutomationCoreImport.h"
+
+@interface UAScheduleStateLog ()
+@property (nonatomic, strong) NSURL *fileURL;
+@property (nonatomic, strong) NSFileHandle *fileHandle;
+@property (nonatomic, assign) NSUInteger recordCount;
+@end
+
+@implementation UAScheduleStateLog
+
+- (instancetype)initWithFileURL:(NSURL *)fileURL fileHandle:(NSFileHandle *)fileHandle {
+    self = [super init];
+
+    if (self) {
+        self.fileURL = fileURL;
+        self.fileHandle = fileHandle;
+        self.recordCount = 0;
+    }
+
+    return self;
+}
+
++ (nullable instancetype)logWithFileURL:(NSURL *)fileURL {
+    NSFileManager *fileManager = [NSFileManager defaultManager];
+    if (![fileManager fileExistsAtPath:fileURL.path] && ![fileManager createFileAtPath:fileURL.path contents:nil attributes:nil]) {
+        UA_LERR(@"Unable to create schedule state log at %@", fileURL);
+        return nil;
+    }
+
+    NSError *error;
+    NSFileHandle *fileHandle = [NSFileHandle fileHandleForUpdatingURL:fileURL error:&error];
+    if (!fileHandle) {
+        UA_LERR(@"Unable to open schedule state log at %@: %@", fileURL, error);
+        return nil;
+    }
+
+    return [[self alloc] initWithFileURL:fileURL fileHandle:fileHandle];
+}
+
+- (void)dealloc {
+    [_fileHandle closeFile];
+}
+
+- (BOOL)appendRecords:(NSArray<NSDictionary *> *)records {
+    NSMutableData *data = [NSMutableData data];
+
+    for (NSDictionary *record in records) {
+        NSError *error;
+        NSData *recordData = [UAJSONSerialization dataWithJSONObject:record options:0 error:&error];
+        if (!recordData) {
+            UA_LERR(@"Unable to serialize schedule state record %@: %@", record, error);
+            return NO;
+        }
+
+        [data appendData:recordData];
+        [data appendBytes:"\n" length:1];
+    }
+
+    // File handle writes raise instead of returning errors
+    @try {
+        [self.fileHandle seekToEndOfFile];
+        [self.fileHandle writeData:data];
+    } @catch (NSException *exception) {
+        UA_LERR(@"Unable to write schedule state log: %@", exception);
+        return NO;
+    }
+
+    self.recordCount += records.count;
+    return YES;
+}
+
+- (NSArray<NSDictionary *> *)records {
+    NSData *data = [NSData dataWithContentsOfURL:self.fileURL];
+    if (!data.length) {
+        return @[];
+    }
+
+    NSMutableArray<NSDictionary *> *records = [NSMutableArray array];
+    NSString *contents = [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding];
+
+    for (NSString *line in [contents componentsSeparatedByString:@"\n"]) {
+        if (!line.length) {
+            continue;
+        }
+
+        id record = [NSJSONSerialization JSONObjectWithData:[line dataUsingEncoding:NSUTF8StringEncoding] options:0 error:nil];
+        if (![record isKindOfClass:[NSDictionary class]]) {
+            // Only the last write can be torn, nothing valid follows it
+            break;
+        }
+
+        [records addObject:record];
+    }
+
+    return records;
+}
+
+- (void)truncate {
+    @try {
+        [self.fileHandle truncateFileAtOffset:0];
+    } @catch (NSException *exception) {
+        UA_LERR(@"Unable to truncate schedule state log: %@", exception);
+        return;
+    }
+
+    self.recordCount = 0;
+}
+
+@end
@@ -14,7 +14,7 @@
 @implementation UATagGroupsLookupAPIClient
 
 + (instancetype)clientWithConfig:(UARuntimeConfig *)config {
-    return [self clientWithConfig:config session:[UARequestSession sessionWithConfig:config]];
+    return [self clientWithConfig:config session:[UARequestSession sessionWithConfig:config requestClass:@"tag_group_lookup" priority:UARequestPriorityNormal]];
 }
 
 + (instancetype)clientWithConfig:(UARuntimeConfig *)config session:(UARequestSession *)session {
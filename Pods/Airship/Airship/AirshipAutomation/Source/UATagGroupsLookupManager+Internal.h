@@ -76,13 +76,19 @@ extern const NSTimeInterval UATagGroupsLookupManagerDefaultPreferLocalTagDataTim
  */
 @property (nonatomic, assign) NSTimeInterval cacheStaleReadTime;
 
+/**
+ * Whether a cached response that needs a refresh but is not yet stale is returned immediately while the
+ * cache is refreshed in the background. Defaults to `YES`.
+ */
+@property (nonatomic, assign) BOOL staleWhileRevalidate;
+
 /**
  * The tag group manager delegate.
  */
 @property (nonatomic, weak) NSObject<UATagGroupsLookupManagerDelegate> *delegate;
 
 /**
- * Performs a tag groups lookup.
+ * Performs a tag groups lookup. Concurrent lookups that need a cache refresh share a single lookup request.
  *
  * @param requestedTagGroups The requested tag groups.
  * @param completionHandler A completion handler taking the resulting tag groups, or an error indicating a failed lookup.
@@ -97,23 +103,27 @@ extern const NSTimeInterval UATagGroupsLookupManagerDefaultPreferLocalTagDataTim
  * @param config An instance of UARuntimeConfig.
  * @param dataStore A data store.
  * @param tagGroupsHistory The tag groups history.
+ * @param channel The channel.
  */
 + (instancetype)lookupManagerWithConfig:(UARuntimeConfig *)config
                               dataStore:(UAPreferenceDataStore *)dataStore
-                       tagGroupsHistory:(id<UATagGroupsHistory>)tagGroupsHistory;
+                       tagGroupsHistory:(id<UATagGroupsHistory>)tagGroupsHistory
+                                channel:(UAChannel *)channel;
 /**
- * UATagGroupsLookupManager class factory method.
+ * UATagGroupsLookupManager class factory method. Used for testing.
  *
  * @param client A tag groups lookup API client.
  * @param dataStore A data store.
  * @param cache A lookup response cache.
  * @param tagGroupsHistory The tag group history.
+ * @param channel The channel.
  * @param currentTime A UADate to be used for getting the current time.
  */
 + (instancetype)lookupManagerWithAPIClient:(UATagGroupsLookupAPIClient *)client
                                  dataStore:(UAPreferenceDataStore *)dataStore
                                      cache:(UATagGroupsLookupResponseCache *)cache
                           tagGroupsHistory:(id<UATagGroupsHistory>)tagGroupsHistory
+                                   channel:(UAChannel *)channel
                                currentTime:(UADate *)currentTime;
 
 
@@ -21,7 +21,14 @@ NSString * const UATagGroupsLookupManagerErrorDomain = @"com.urbanairship.tag_gr
 @property (nonatomic, strong) UATagGroupsLookupAPIClient *lookupAPIClient;
 @property (nonatomic, strong) UATagGroupsLookupResponseCache *cache;
 @property (nonatomic, readonly) NSTimeInterval maxSentMutationAge;
+@property (nonatomic, strong) UAChannel *channel;
 @property (nonatomic, strong) UADate *currentTime;
+
+// Single-flight refresh state, guarded by self
+@property (nonatomic, strong, nullable) UATagGroups *refreshingTagGroups;
+@property (nonatomic, strong, nullable) NSMutableArray<void(^)(void)> *refreshCompletionHandlers;
+@property (nonatomic, strong, nullable) UATagGroups *pendingRefreshTagGroups;
+@property (nonatomic, strong, nullable) NSMutableArray<void(^)(void)> *pendingRefreshCompletionHandlers;
 @end
 
 @implementation UATagGroupsLookupManager
@@ -30,6 +37,7 @@ NSString * const UATagGroupsLookupManagerErrorDomain = @"com.urbanairship.tag_gr
                         dataStore:(UAPreferenceDataStore *)dataStore
                             cache:(UATagGroupsLookupResponseCache *)cache
                  tagGroupsHistory:(id<UATagGroupsHistory>)tagGroupsHistory
+                          channel:(UAChannel *)channel
                       currentTime:(UADate *)currentTime {
 
     self = [super init];
@@ -39,7 +47,9 @@ NSString * const UATagGroupsLookupManagerErrorDomain = @"com.urbanairship.tag_gr
         self.cache = cache;
         self.tagGroupsHistory = tagGroupsHistory;
         self.lookupAPIClient = client;
+        self.channel = channel;
         self.currentTime = currentTime;
+        self.staleWhileRevalidate = YES;
 
         self.lookupAPIClient.enabled = self.enabled;
         [self updateMaxSentMutationAge];
@@ -50,12 +60,14 @@ NSString * const UATagGroupsLookupManagerErrorDomain = @"com.urbanairship.tag_gr
 
 + (instancetype)lookupManagerWithConfig:(UARuntimeConfig *)config
                               dataStore:(UAPreferenceDataStore *)dataStore
-                       tagGroupsHistory:(id<UATagGroupsHistory>)tagGroupsHistory {
+                       tagGroupsHistory:(id<UATagGroupsHistory>)tagGroupsHistory
+                                channel:(UAChannel *)channel {
 
     return [[self alloc] initWithAPIClient:[UATagGroupsLookupAPIClient clientWithConfig:config]
                                  dataStore:dataStore
-                                     cache:[UATagGroupsLookupResponseCache cacheWithDataStore:dataStore]
+                                     cache:[UATagGroupsLookupResponseCache cacheWithConfig:config dataStore:dataStore]
                           tagGroupsHistory:tagGroupsHistory
+                                   channel:channel
                                currentTime:[[UADate alloc] init]];
 }
 
@@ -63,9 +75,15 @@ NSString * const UATagGroupsLookupManagerErrorDomain = @"com.urbanairship.tag_gr
                                  dataStore:(UAPreferenceDataStore *)dataStore
                                      cache:(UATagGroupsLookupResponseCache *)cache
                           tagGroupsHistory:(id<UATagGroupsHistory>)tagGroupsHistory
+                                   channel:(UAChannel *)channel
                                currentTime:(UADate *)currentTime {
 
-    return [[self alloc] initWithAPIClient:client dataStore:dataStore cache:cache tagGroupsHistory:tagGroupsHistory currentTime:currentTime];
+    return [[self alloc] initWithAPIClient:client
+                                 dataStore:dataStore
+                                     cache:cache
+                          tagGroupsHistory:tagGroupsHistory
+                                   channel:channel
+                               currentTime:currentTime];
 }
 
 - (BOOL)enabled {
@@ -121,7 +139,7 @@ NSString * const UATagGroupsLookupManagerErrorDomain = @"com.urbanairship.tag_gr
 
 - (UATagGroups *)overrideDeviceTags:(UATagGroups *)tagGroups {
     NSMutableDictionary *newTags = [tagGroups.tags mutableCopy];
-    [newTags setObject:[UAirship channel].tags forKey:@"device"];
+    [newTags setObject:self.channel.tags forKey:@"device"];
     return [UATagGroups tagGroupsWithTags:newTags];
 }
 
@@ -136,7 +154,7 @@ NSString * const UATagGroupsLookupManagerErrorDomain = @"com.urbanairship.tag_gr
     UATagGroups *locallyModifiedTagGroups = [self.tagGroupsHistory applyHistory:cachedTagGroups maxAge:maxAge];
 
     // Override the device tags if needed
-    if ([UAirship channel].isChannelTagRegistrationEnabled) {
+    if (self.channel.isChannelTagRegistrationEnabled) {
         locallyModifiedTagGroups = [self overrideDeviceTags:locallyModifiedTagGroups];
     }
 
@@ -144,26 +162,76 @@ NSString * const UATagGroupsLookupManagerErrorDomain = @"com.urbanairship.tag_gr
     return [requestedTagGroups intersect:locallyModifiedTagGroups];
 }
 
+/**
+ * Refreshes the cache, coalescing concurrent refreshes. Callers whose tag groups are covered by the refresh
+ * in flight join it, anyone else is folded into a single follow up refresh.
+ *
+ * @param requestedTagGroups The requested tag groups.
+ * @param completionHandler The completion handler, called once the refresh covering the request finishes.
+ */
 - (void)refreshCacheWithRequestedTagGroups:(UATagGroups *)requestedTagGroups
                          completionHandler:(void(^)(void))completionHandler {
 
+    @synchronized (self) {
+        if (self.refreshingTagGroups) {
+            if ([self.refreshingTagGroups containsAllTags:requestedTagGroups]) {
+                [self.refreshCompletionHandlers addObject:completionHandler];
+            } else {
+                self.pendingRefreshTagGroups = self.pendingRefreshTagGroups ? [self.pendingRefreshTagGroups merge:requestedTagGroups] : requestedTagGroups;
+                self.pendingRefreshCompletionHandlers = self.pendingRefreshCompletionHandlers ?: [NSMutableArray array];
+                [self.pendingRefreshCompletionHandlers addObject:completionHandler];
+            }
+            return;
+        }
+
+        self.refreshingTagGroups = requestedTagGroups;
+        self.refreshCompletionHandlers = [NSMutableArray arrayWithObject:completionHandler];
+    }
+
+    [self performRefreshWithRequestedTagGroups:requestedTagGroups];
+}
+
+- (void)performRefreshWithRequestedTagGroups:(UATagGroups *)requestedTagGroups {
     [self.delegate gatherTagGroupsWithCompletionHandler:^(UATagGroups *tagGroups) {
         tagGroups = [requestedTagGroups merge:tagGroups];
-        [self.lookupAPIClient lookupTagGroupsWithChannelID:[UAirship channel].identifier
+        [self.lookupAPIClient lookupTagGroupsWithChannelID:self.channel.identifier
                                         requestedTagGroups:tagGroups
                                             cachedResponse:self.cache.response
                                          completionHandler:^(UATagGroupsLookupResponse *response) {
             if (response.status != 200) {
                 UA_LTRACE(@"Failed to refresh the cache. Status: %lu", (unsigned long)response.status);
             } else {
-                self.cache.response = response;
-                self.cache.requestedTagGroups = tagGroups;
+                [self.cache setResponse:response requestedTagGroups:tagGroups];
             }
-            completionHandler();
+
+            [self finishRefresh];
         }];
     }];
 }
 
+- (void)finishRefresh {
+    NSArray<void(^)(void)> *completionHandlers;
+    UATagGroups *nextTagGroups;
+
+    @synchronized (self) {
+        completionHandlers = self.refreshCompletionHandlers;
+        nextTagGroups = self.pendingRefreshTagGroups;
+
+        self.refreshingTagGroups = nextTagGroups;
+        self.refreshCompletionHandlers = self.pendingRefreshCompletionHandlers;
+        self.pendingRefreshTagGroups = nil;
+        self.pendingRefreshCompletionHandlers = nil;
+    }
+
+    for (void(^completionHandler)(void) in completionHandlers) {
+        completionHandler();
+    }
+
+    if (nextTagGroups) {
+        [self performRefreshWithRequestedTagGroups:nextTagGroups];
+    }
+}
+
 - (void)getTagGroups:(UATagGroups *)requestedTagGroups completionHandler:(void(^)(UATagGroups  * _Nullable tagGroups, NSError *error)) completionHandler {
     __block NSError *error;
 
@@ -173,11 +241,11 @@ NSString * const UATagGroupsLookupManagerErrorDomain = @"com.urbanairship.tag_gr
     }
 
     // Requesting only device tag groups when channel tag registration is enabled
-    if ([requestedTagGroups containsOnlyDeviceTags] && [UAirship channel].isChannelTagRegistrationEnabled) {
+    if ([requestedTagGroups containsOnlyDeviceTags] && self.channel.isChannelTagRegistrationEnabled) {
         return completionHandler([self overrideDeviceTags:requestedTagGroups], error);
     }
 
-    if (![UAirship channel].identifier) {
+    if (!self.channel.identifier) {
         error = [self errorWithCode:UATagGroupsLookupManagerErrorCodeChannelRequired message:@"Channel ID is required"];
         return completionHandler(nil, error);
     }
@@ -195,6 +263,14 @@ NSString * const UATagGroupsLookupManagerErrorDomain = @"com.urbanairship.tag_gr
                                              refreshDate:cacheRefreshDate], error);
     }
 
+    // Serve the cached response while it is still within the stale read time and revalidate in the background
+    if (cachedResponse && self.staleWhileRevalidate && ![self.cache isStale]) {
+        [self refreshCacheWithRequestedTagGroups:self.cache.requestedTagGroups completionHandler:^{}];
+        return completionHandler([self generateTagGroups:requestedTagGroups
+                                          cachedResponse:cachedResponse
+                                             refreshDate:cacheRefreshDate], error);
+    }
+
     [self refreshCacheWithRequestedTagGroups:requestedTagGroups completionHandler:^{
         cachedResponse = self.cache.response;
         cacheRefreshDate = self.cache.refreshDate;
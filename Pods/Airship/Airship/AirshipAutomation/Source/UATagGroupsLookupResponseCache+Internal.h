@@ -16,7 +16,8 @@ extern const NSTimeInterval UATagGroupsLookupResponseCacheDefaultMaxAgeTimeSecon
 extern const NSTimeInterval UATagGroupsLookupResponseCacheDefaultStaleReadTimeSeconds;
 
 /**
- * A persistent cache for tag group lookup responses.
+ * A persistent cache for tag group lookup responses. The cache is held in memory and written to
+ * a binary property list file whenever it changes.
  */
 @interface UATagGroupsLookupResponseCache : NSObject
 
@@ -48,9 +49,29 @@ extern const NSTimeInterval UATagGroupsLookupResponseCacheDefaultStaleReadTimeSe
 /**
  * UATagGroupsLookupResponseCache class factory method.
  *
+ * @param config The runtime config.
  * @param dataStore A data store.
  */
-+ (instancetype)cacheWithDataStore:(UAPreferenceDataStore *)dataStore;
++ (instancetype)cacheWithConfig:(UARuntimeConfig *)config dataStore:(UAPreferenceDataStore *)dataStore;
+
+/**
+ * UATagGroupsLookupResponseCache class factory method. Used for testing.
+ *
+ * @param dataStore A data store.
+ * @param fileURL The cache file URL.
+ * @param currentTime A UADate to be used for getting the current time.
+ */
++ (instancetype)cacheWithDataStore:(UAPreferenceDataStore *)dataStore
+                           fileURL:(NSURL *)fileURL
+                       currentTime:(UADate *)currentTime;
+
+/**
+ * Sets the response and the tag groups that were requested for it, writing the cache once.
+ *
+ * @param response The response.
+ * @param requestedTagGroups The requested tag groups.
+ */
+- (void)setResponse:(UATagGroupsLookupResponse *)response requestedTagGroups:(UATagGroups *)requestedTagGroups;
 
 /**
  * Indicates whether a refresh is required.
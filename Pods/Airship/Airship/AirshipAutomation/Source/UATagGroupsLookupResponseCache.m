@@ -7,6 +7,13 @@
 #define kUATagGroupsLookupResponseCacheMaxAgeTimeKey @"com.urbanairship.tag_groups.CACHE_MAX_AGE_TIME"
 #define kUATagGroupsLookupResponseCacheStaleReadTimeKey @"com.urbanairship.tag_groups.CACHE_STALE_READ_TIME"
 
+// Cache file keys
+#define kUATagGroupsLookupResponseCacheFileTagGroupsKey @"tag_groups"
+#define kUATagGroupsLookupResponseCacheFileLastModifiedKey @"last_modified"
+#define kUATagGroupsLookupResponseCacheFileStatusKey @"status"
+#define kUATagGroupsLookupResponseCacheFileRequestedTagGroupsKey @"requested_tag_groups"
+#define kUATagGroupsLookupResponseCacheFileRefreshDateKey @"refresh_date"
+
 #define kUATagGroupsLookupManagerMinCacheMaxAgeTimeSeconds 60 // 1 minute
 
 NSTimeInterval const UATagGroupsLookupResponseCacheDefaultMaxAgeTimeSeconds = 60 * 10; // 10 minutes
@@ -14,23 +21,44 @@ NSTimeInterval const UATagGroupsLookupResponseCacheDefaultStaleReadTimeSeconds =
 
 @interface UATagGroupsLookupResponseCache ()
 @property (nonatomic, strong) UAPreferenceDataStore *dataStore;
-@property (nonatomic, strong) NSDate *refreshDate;
+@property (nonatomic, strong) NSURL *fileURL;
+@property (nonatomic, strong) UADate *currentTime;
+@property (nonatomic, strong, nullable) UATagGroupsLookupResponse *cachedResponse;
+@property (nonatomic, strong, nullable) UATagGroups *cachedRequestedTagGroups;
+@property (nonatomic, strong, nullable) NSDate *cachedRefreshDate;
 @end
 
 @implementation UATagGroupsLookupResponseCache
 
-- (instancetype)initWithDataStore:(UAPreferenceDataStore *)dataStore {
+- (instancetype)initWithDataStore:(UAPreferenceDataStore *)dataStore fileURL:(NSURL *)fileURL currentTime:(UADate *)currentTime {
     self = [super init];
 
     if (self) {
         self.dataStore = dataStore;
+        self.fileURL = fileURL;
+        self.currentTime = currentTime;
+
+        if (![self migrateDataStoreCache]) {
+            [self load];
+        }
     }
 
     return self;
 }
 
-+ (instancetype)cacheWithDataStore:(UAPreferenceDataStore *)dataStore {
-    return [[self alloc] initWithDataStore:dataStore];
++ (instancetype)cacheWithConfig:(UARuntimeConfig *)config dataStore:(UAPreferenceDataStore *)dataStore {
+    NSURL *cachesURL = [[[NSFileManager defaultManager] URLsForDirectory:NSCachesDirectory inDomains:NSUserDomainMask] lastObject];
+    NSString *fileName = [NSString stringWithFormat:@"com.urbanairship.tag_groups.%@.plist", config.appKey];
+
+    return [[self alloc] initWithDataStore:dataStore
+                                   fileURL:[cachesURL URLByAppendingPathComponent:fileName]
+                               currentTime:[[UADate alloc] init]];
+}
+
++ (instancetype)cacheWithDataStore:(UAPreferenceDataStore *)dataStore
+                           fileURL:(NSURL *)fileURL
+                       currentTime:(UADate *)currentTime {
+    return [[self alloc] initWithDataStore:dataStore fileURL:fileURL currentTime:currentTime];
 }
 
 - (NSTimeInterval)maxAgeTime {
@@ -54,41 +82,142 @@ NSTimeInterval const UATagGroupsLookupResponseCacheDefaultStaleReadTimeSeconds =
 }
 
 - (UATagGroupsLookupResponse *)response {
-    NSData *encodedResponse = [self.dataStore objectForKey:kUATagGroupsLookupResponseCacheResponseKey];
-    return [NSKeyedUnarchiver unarchiveObjectWithData:encodedResponse];
+    @synchronized (self) {
+        return self.cachedResponse;
+    }
 }
 
 - (void)setResponse:(UATagGroupsLookupResponse *)response {
-    NSData *encodedResonse = [NSKeyedArchiver archivedDataWithRootObject:response];
-    [self.dataStore setObject:encodedResonse forKey:kUATagGroupsLookupResponseCacheResponseKey];
-    
-    self.refreshDate = [NSDate date];
+    @synchronized (self) {
+        self.cachedResponse = response;
+        self.cachedRefreshDate = [self.currentTime now];
+        [self save];
+    }
 }
 
 - (NSDate *)refreshDate {
-    return [self.dataStore objectForKey:kUATagGroupsLookupResponseCacheRefreshDateKey];
-}
-
-- (void)setRefreshDate:(NSDate *)refreshDate {
-    [self.dataStore setObject:refreshDate forKey:kUATagGroupsLookupResponseCacheRefreshDateKey];
+    @synchronized (self) {
+        return self.cachedRefreshDate;
+    }
 }
 
 - (UATagGroups *)requestedTagGroups {
-    NSData *encodedTagGroups = [self.dataStore objectForKey:kUATagGroupsLookupResponseCacheRequestTagGroupsKey];
-    return [NSKeyedUnarchiver unarchiveObjectWithData:encodedTagGroups];
+    @synchronized (self) {
+        return self.cachedRequestedTagGroups;
+    }
 }
 
 - (void)setRequestedTagGroups:(UATagGroups *)tagGroups {
-    NSData *encodedTagGroups = [NSKeyedArchiver archivedDataWithRootObject:tagGroups];
-    [self.dataStore setObject:encodedTagGroups forKey:kUATagGroupsLookupResponseCacheRequestTagGroupsKey];
+    @synchronized (self) {
+        self.cachedRequestedTagGroups = tagGroups;
+        [self save];
+    }
+}
+
+- (void)setResponse:(UATagGroupsLookupResponse *)response requestedTagGroups:(UATagGroups *)requestedTagGroups {
+    @synchronized (self) {
+        self.cachedResponse = response;
+        self.cachedRequestedTagGroups = requestedTagGroups;
+        self.cachedRefreshDate = [self.currentTime now];
+        [self save];
+    }
 }
 
 - (BOOL)needsRefresh {
-    return self.response && self.refreshDate && self.maxAgeTime <= [[NSDate date] timeIntervalSinceDate:self.refreshDate];
+    @synchronized (self) {
+        return self.cachedResponse && self.cachedRefreshDate && self.maxAgeTime <= [[self.currentTime now] timeIntervalSinceDate:self.cachedRefreshDate];
+    }
 }
 
 - (BOOL)isStale {
-    return self.staleReadTime <= [[NSDate date] timeIntervalSinceDate:self.refreshDate];
+    @synchronized (self) {
+        return self.staleReadTime <= [[self.currentTime now] timeIntervalSinceDate:self.cachedRefreshDate];
+    }
+}
+
+#pragma mark -
+#pragma mark Persistence
+
+/**
+ * Moves a cache archived into the data store by older SDK versions to the cache file.
+ *
+ * @return `YES` if a cache was migrated, otherwise `NO`.
+ */
+- (BOOL)migrateDataStoreCache {
+    NSData *encodedResponse = [self.dataStore objectForKey:kUATagGroupsLookupResponseCacheResponseKey];
+    NSData *encodedTagGroups = [self.dataStore objectForKey:kUATagGroupsLookupResponseCacheRequestTagGroupsKey];
+    NSDate *refreshDate = [self.dataStore objectForKey:kUATagGroupsLookupResponseCacheRefreshDateKey];
+
+    if (!encodedResponse && !encodedTagGroups && !refreshDate) {
+        return NO;
+    }
+
+    @try {
+        self.cachedResponse = encodedResponse ? [NSKeyedUnarchiver unarchiveObjectWithData:encodedResponse] : nil;
+        self.cachedRequestedTagGroups = encodedTagGroups ? [NSKeyedUnarchiver unarchiveObjectWithData:encodedTagGroups] : nil;
+        self.cachedRefreshDate = refreshDate;
+        [self save];
+    } @catch (NSException *exception) {
+        UA_LERR(@"Unable to migrate tag group lookup cache: %@", exception);
+    }
+
+    [self.dataStore removeObjectForKey:kUATagGroupsLookupResponseCacheResponseKey];
+    [self.dataStore removeObjectForKey:kUATagGroupsLookupResponseCacheRequestTagGroupsKey];
+    [self.dataStore removeObjectForKey:kUATagGroupsLookupResponseCacheRefreshDateKey];
+
+    return YES;
+}
+
+- (void)load {
+    NSData *data = [NSData dataWithContentsOfURL:self.fileURL];
+    if (!data) {
+        return;
+    }
+
+    NSError *error;
+    id contents = [NSPropertyListSerialization propertyListWithData:data options:NSPropertyListImmutable format:NULL error:&error];
+    if (![contents isKindOfClass:[NSDictionary class]]) {
+        UA_LERR(@"Unable to read tag group lookup cache: %@", error);
+        return;
+    }
+
+    NSDictionary *tags = contents[kUATagGroupsLookupResponseCacheFileTagGroupsKey];
+    NSDictionary *requestedTags = contents[kUATagGroupsLookupResponseCacheFileRequestedTagGroupsKey];
+    NSNumber *status = contents[kUATagGroupsLookupResponseCacheFileStatusKey];
+
+    if (status) {
+        self.cachedResponse = [UATagGroupsLookupResponse responseWithTagGroups:tags ? [UATagGroups tagGroupsWithTags:tags] : nil
+                                                                        status:status.unsignedIntegerValue
+                                                         lastModifiedTimestamp:contents[kUATagGroupsLookupResponseCacheFileLastModifiedKey]];
+    }
+
+    if (requestedTags) {
+        self.cachedRequestedTagGroups = [UATagGroups tagGroupsWithTags:requestedTags];
+    }
+
+    self.cachedRefreshDate = contents[kUATagGroupsLookupResponseCacheFileRefreshDateKey];
+}
+
+/**
+ * Writes the cache as a binary property list. Must be called while synchronized on self.
+ */
+- (void)save {
+    NSMutableDictionary *contents = [NSMutableDictionary dictionary];
+
+    if (self.cachedResponse) {
+        [contents setValue:@(self.cachedResponse.status) forKey:kUATagGroupsLookupResponseCacheFileStatusKey];
+        [contents setValue:[self.cachedResponse.tagGroups toJSON] forKey:kUATagGroupsLookupResponseCacheFileTagGroupsKey];
+        [contents setValue:self.cachedResponse.lastModifiedTimestamp forKey:kUATagGroupsLookupResponseCacheFileLastModifiedKey];
+    }
+
+    [contents setValue:[self.cachedRequestedTagGroups toJSON] forKey:kUATagGroupsLookupResponseCacheFileRequestedTagGroupsKey];
+    [contents setValue:self.cachedRefreshDate forKey:kUATagGroupsLookupResponseCacheFileRefreshDateKey];
+
+    NSError *error;
+    NSData *data = [NSPropertyListSerialization dataWithPropertyList:contents format:NSPropertyListBinaryFormat_v1_0 options:0 error:&error];
+    if (!data || ![data writeToURL:self.fileURL options:NSDataWritingAtomic error:&error]) {
+        UA_LERR(@"Unable to write tag group lookup cache: %@", error);
+    }
 }
 
 @end
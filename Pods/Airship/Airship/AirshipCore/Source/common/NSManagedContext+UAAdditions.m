@@ -3,6 +3,7 @@
 #import "NSManagedObjectContext+UAAdditions.h"
 #import "UAUtils+Internal.h"
 #import "UAGlobal.h"
+#import "UAMetrics+Internal.h"
 
 @implementation NSManagedObjectContext (UAAdditions)
 
@@ -104,10 +105,14 @@ NSString *const UAManagedContextStoreDirectory = @"com.urbanairship.no-backup";
         return NO;
     }
 
+    UAMetricsSpan span = UAMetricsSpanBegin(UAMetricsHistogramCoreDataSave);
     [self save:&error];
+    UAMetricsSpanEnd(span);
+    UAMetricsIncrement(UAMetricsCounterCoreDataSaves, 1);
 
     if (error) {
         UA_LERR(@"Error saving context %@", error);
+        UAMetricsIncrement(UAMetricsCounterCoreDataSaveFailures, 1);
         return NO;
     }
 
@@ -4,6 +4,11 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+/**
+ * The name of the Airship no backup directory, in the library or caches directory.
+ */
+extern NSString *const UAManagedContextStoreDirectory;
+
 @interface NSManagedObjectContext (UAAdditions)
 
 
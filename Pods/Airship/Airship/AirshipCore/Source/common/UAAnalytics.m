@@ -3,6 +3,7 @@
 #import "UAAnalytics+Internal.h"
 #import "UAPreferenceDataStore+Internal.h"
 #import "UAEventManager+Internal.h"
+#import "UAEventAggregator+Internal.h"
 #import "UARuntimeConfig.h"
 #import "UAEvent.h"
 #import "UAUtils+Internal.h"
@@ -27,6 +28,7 @@
 @property (nonatomic, strong) UAPreferenceDataStore *dataStore;
 @property (nonatomic, strong) UAChannel *channel;
 @property (nonatomic, strong) UAEventManager *eventManager;
+@property (nonatomic, strong) UAEventAggregator *eventAggregator;
 @property (nonatomic, strong) NSNotificationCenter *notificationCenter;
 @property (nonatomic, strong) UADate *date;
 @property (nonatomic, strong) UADispatcher *dispatcher;
@@ -80,6 +82,25 @@ NSString *const UAEventKey = @"event";
         self.eventManager.uploadsEnabled = self.isEnabled && self.componentEnabled;
         self.eventManager.delegate = self;
 
+        if (self.config.aggregatedEventNames.count) {
+            UA_WEAKIFY(self)
+            self.eventAggregator = [UAEventAggregator aggregatorWithEventNames:self.config.aggregatedEventNames
+                                                                        window:UAEventAggregatorDefaultWindow
+                                                                    maxEntries:UAEventAggregatorDefaultMaxEntries
+                                                                          date:self.date
+                                                                    dispatcher:self.dispatcher
+                                                                  eventHandler:^(UAEvent *event, NSString *sessionID) {
+                UA_STRONGIFY(self)
+                if (!event.isValid || !self.isEnabled) {
+                    UA_LERR(@"Dropping aggregated event %@.", event);
+                    return;
+                }
+
+                UA_LDEBUG(@"Adding aggregated %@ event %@.", event.eventType, event.eventID);
+                [self.eventManager addEvent:event sessionID:sessionID];
+            }];
+        }
+
         [self startSession];
 
         [self.notificationCenter addObserver:self
@@ -159,6 +180,13 @@ NSString *const UAEventKey = @"event";
 
     [self stopTrackingScreen];
 
+    // Flush aggregates after the final screen tracking event is added
+    UA_WEAKIFY(self)
+    [self.dispatcher dispatchAsync:^{
+        UA_STRONGIFY(self)
+        [self.eventAggregator flush];
+    }];
+
     // add app_background event
     [self addEvent:[UAAppBackgroundEvent event]];
 
@@ -209,9 +237,13 @@ NSString *const UAEventKey = @"event";
     [self.dispatcher dispatchAsync:^{
         UA_STRONGIFY(self)
 
-        UA_LDEBUG(@"Adding %@ event %@.", event.eventType, event.eventID);
-        [self.eventManager addEvent:event sessionID:self.sessionID];
-        UA_LTRACE(@"Event added: %@.", event);
+        if ([self.eventAggregator aggregateEvent:event sessionID:self.sessionID]) {
+            UA_LTRACE(@"Aggregated %@ event %@.", event.eventType, event.eventID);
+        } else {
+            UA_LDEBUG(@"Adding %@ event %@.", event.eventType, event.eventID);
+            [self.eventManager addEvent:event sessionID:self.sessionID];
+            UA_LTRACE(@"Event added: %@.", event);
+        }
 
         if (self.eventConsumer) {
             [self.eventConsumer eventAdded:event];
@@ -261,6 +293,7 @@ NSString *const UAEventKey = @"event";
     // If we are disabling the runtime flag clear all events
     if ([self.dataStore boolForKey:kUAAnalyticsEnabled] && !enabled) {
         UA_LINFO(@"Deleting all analytics events.");
+        [self.eventAggregator removeAllAggregates];
         [self.eventManager deleteAllEvents];
     }
 
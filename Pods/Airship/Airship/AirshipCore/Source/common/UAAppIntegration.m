@@ -5,6 +5,7 @@
 #import "UAAnalytics+Internal.h"
 #import "UAPush+Internal.h"
 #import "UAPushableComponent.h"
+#import "UAPushProcessingScheduler+Internal.h"
 
 #import "UADeviceRegistrationEvent+Internal.h"
 #import "UAPushReceivedEvent+Internal.h"
@@ -18,6 +19,7 @@
 #import "UAActionRegistry+Internal.h"
 
 #define kUANotificationActionKey @"com.urbanairship.interactive_actions"
+#define kUAPushProcessingDeadlineMargin 5
 
 @implementation UAAppIntegration
 
@@ -169,10 +171,16 @@
                  completionHandler:(void (^)(UIBackgroundFetchResult))completionHandler {
     UA_LINFO(@"Received notification: %@", notificationContent);
 
-    dispatch_group_t dispatchGroup = dispatch_group_create();
-    __block NSMutableArray *fetchResults = [NSMutableArray array];
     BOOL foreground = [UIApplication sharedApplication].applicationState == UIApplicationStateActive;
 
+    // Leave headroom in the background execution window
+    NSTimeInterval timeBudget = UAPushProcessingSchedulerDefaultTimeBudget;
+    if (!foreground) {
+        timeBudget = MAX(0, MIN(timeBudget, [UIApplication sharedApplication].backgroundTimeRemaining - kUAPushProcessingDeadlineMargin));
+    }
+
+    UAPushProcessingScheduler *scheduler = [UAPushProcessingScheduler schedulerWithTimeBudget:timeBudget];
+
     // Pushable components
     for (UAComponent *component in [UAirship shared].components) {
          if (![component conformsToProtocol:@protocol(UAPushableComponent)]) {
@@ -181,36 +189,39 @@
 
          UAComponent<UAPushableComponent> *pushable = (UAComponent<UAPushableComponent> *)component;
          if ([pushable respondsToSelector:@selector(receivedRemoteNotification:completionHandler:)]) {
-             dispatch_group_enter(dispatchGroup);
-             [pushable receivedRemoteNotification:notificationContent completionHandler:^(UIBackgroundFetchResult fetchResult) {
-                 @synchronized (fetchResults) {
-                     [fetchResults addObject:@(fetchResult)];
-                 }
-                 dispatch_group_leave(dispatchGroup);
+             UAPushableComponentPriority priority = UAPushableComponentPriorityNormal;
+             if ([pushable respondsToSelector:@selector(pushProcessingPriority)]) {
+                 priority = [pushable pushProcessingPriority];
+             }
+
+             NSTimeInterval expectedTime = 0;
+             if ([pushable respondsToSelector:@selector(expectedPushProcessingTime)]) {
+                 expectedTime = [pushable expectedPushProcessingTime];
+             }
+
+             [scheduler addTaskWithName:NSStringFromClass([pushable class])
+                               priority:priority
+                           expectedTime:expectedTime
+                                   task:^(void (^completionHandler)(UIBackgroundFetchResult)) {
+                 [pushable receivedRemoteNotification:notificationContent completionHandler:completionHandler];
              }];
          }
     }
 
     // Actions then push
-    dispatch_group_enter(dispatchGroup);
-    [self runActionsForRemoteNotification:notificationContent foregroundPresentation:foregroundPresentation completionHandler:^(UIBackgroundFetchResult result) {
-        @synchronized (fetchResults) {
-            [fetchResults addObject:@(result)];
-        }
-
-        // UAPush
-        [[UAirship push] handleRemoteNotification:notificationContent foreground:foreground completionHandler:^(UIBackgroundFetchResult result) {
-            @synchronized (fetchResults) {
-                [fetchResults addObject:@(result)];
-            }
-            dispatch_group_leave(dispatchGroup);
+    [scheduler addTaskWithName:@"UAPush"
+                      priority:UAPushableComponentPriorityHigh
+                  expectedTime:0
+                          task:^(void (^completionHandler)(UIBackgroundFetchResult)) {
+        [self runActionsForRemoteNotification:notificationContent foregroundPresentation:foregroundPresentation completionHandler:^(UIBackgroundFetchResult actionsResult) {
+            // UAPush
+            [[UAirship push] handleRemoteNotification:notificationContent foreground:foreground completionHandler:^(UIBackgroundFetchResult pushResult) {
+                completionHandler([UAUtils mergeFetchResults:@[@(actionsResult), @(pushResult)]]);
+            }];
         }];
     }];
 
-    dispatch_group_notify(dispatchGroup, dispatch_get_main_queue(), ^{
-        // all processing of incoming notification is complete
-        completionHandler([UAUtils mergeFetchResults:fetchResults]);
-    });
+    [scheduler runWithCompletionHandler:completionHandler];
 }
 
 #pragma mark -
@@ -42,6 +42,10 @@ NSString *const UAAttributeRemoveActionKey = @"remove";
     return self;
 }
 
++ (instancetype)pendingMutationsWithPayload:(NSArray<NSDictionary *> *)mutationsPayload {
+    return [[UAAttributePendingMutations alloc] initWithPendingMutationsPayload:mutationsPayload];
+}
+
 - (instancetype)initWithPendingMutationsPayload:(NSArray<NSDictionary *> *)mutationsPayload {
     self = [super init];
 
@@ -6,11 +6,25 @@
 @class UAAttributePendingMutations;
 @class UAAttributeAPIClient;
 @class UADate;
+@class UADispatcher;
 
 NS_ASSUME_NONNULL_BEGIN
 
+/**
+ The time in seconds mutations are buffered before they are saved and uploaded.
+ */
+extern const NSTimeInterval UAAttributeRegistrarFlushDelay;
+
+/**
+ The maximum number of mutations in a single upload. A full buffer is flushed right away.
+ */
+extern const NSUInteger UAAttributeRegistrarMaxUploadMutations;
+
 /**
  The registrar responsible for routing requests to the channel attributes API.
+
+ Saved mutations are buffered in memory, keeping only the latest mutation of each attribute, and
+ written to the persistent queue and uploaded together when the buffer flushes.
  */
 @interface UAAttributeRegistrar : UAComponent
 
@@ -33,13 +47,15 @@ NS_ASSUME_NONNULL_BEGIN
  @param operationQueue An NSOperation queue used to synchronize changes to attributes.
  @param application The application.
  @param date The date for setting the timestamp.
+ @param dispatcher The dispatcher used to schedule buffer flushes.
  @return A new attributes registrar instance.
  */
 + (instancetype)registrarWithDataStore:(UAPreferenceDataStore *)dataStore
                              apiClient:(UAAttributeAPIClient *)apiClient
                         operationQueue:(NSOperationQueue *)operationQueue
                            application:(UIApplication *)application
-                                  date:(UADate *)date;
+                                  date:(UADate *)date
+                            dispatcher:(UADispatcher *)dispatcher;
 
 /**
  Method to save pending mutations for asynchronous upload.
@@ -47,6 +63,11 @@ NS_ASSUME_NONNULL_BEGIN
 */
 - (void)savePendingMutations:(UAAttributePendingMutations *)mutations;
 
+/**
+ Method to save the buffered mutations and upload them if the channel is known.
+*/
+- (void)flushBufferedMutations;
+
 /**
  Method to update remote attributes with new mutations.
  @param identifier The channel identifier.
@@ -9,9 +9,14 @@
 #import "UAUtils.h"
 #import "UADate.h"
 #import "UAComponent.h"
+#import "UADispatcher.h"
+#import "UADisposable.h"
 
 NSString *const PersistentQueueKey = @"com.urbanairship.channel_attributes.registrar_persistent_queue_key";
 
+const NSTimeInterval UAAttributeRegistrarFlushDelay = 1;
+const NSUInteger UAAttributeRegistrarMaxUploadMutations = 100;
+
 @interface UAAttributeRegistrar()
 @property(nonatomic, strong) UAPersistentQueue *pendingAttributeMutationsQueue;
 @property(nonatomic, strong) UAAttributeAPIClient *client;
@@ -19,6 +24,13 @@ NSString *const PersistentQueueKey = @"com.urbanairship.channel_attributes.regis
 @property(nonatomic, strong) NSOperationQueue *operationQueue;
 @property(nonatomic, strong) UIApplication *application;
 @property(nonatomic, strong) UADate *date;
+@property(nonatomic, strong) UADispatcher *dispatcher;
+@property(nonatomic, copy, nullable) NSString *channelID;
+
+// Buffered mutations, latest mutation per attribute key in the order the keys were last written
+@property(nonatomic, strong) NSMutableDictionary<NSString *, NSDictionary *> *bufferedMutations;
+@property(nonatomic, strong) NSMutableOrderedSet<NSString *> *bufferedKeys;
+@property(nonatomic, strong, nullable) UADisposable *flushDisposable;
 @end
 
 @implementation UAAttributeRegistrar
@@ -29,26 +41,30 @@ NSString *const PersistentQueueKey = @"com.urbanairship.channel_attributes.regis
                                                  apiClient:[UAAttributeAPIClient clientWithConfig:config]
                                             operationQueue:[[NSOperationQueue alloc] init]
                                                application:[UIApplication sharedApplication]
-                                                      date:[[UADate alloc] init]];
+                                                      date:[[UADate alloc] init]
+                                                dispatcher:[UADispatcher mainDispatcher]];
 }
 
 + (instancetype)registrarWithDataStore:(UAPreferenceDataStore *)dataStore
                              apiClient:(UAAttributeAPIClient *)apiClient
                         operationQueue:(NSOperationQueue *)operationQueue
                            application:(UIApplication *)application
-                                  date:(UADate *)date {
+                                  date:(UADate *)date
+                            dispatcher:(UADispatcher *)dispatcher {
     return [[UAAttributeRegistrar alloc] initWithDataStore:dataStore
                                                  apiClient:apiClient
                                             operationQueue:operationQueue
                                                application:application
-                                                      date:date];
+                                                      date:date
+                                                dispatcher:dispatcher];
 }
 
 - (instancetype)initWithDataStore:(UAPreferenceDataStore *)dataStore
                         apiClient:(UAAttributeAPIClient *)apiClient
                    operationQueue:(NSOperationQueue *)operationQueue
                       application:application
-                             date:date {
+                             date:date
+                       dispatcher:(UADispatcher *)dispatcher {
     self = [super initWithDataStore:dataStore];
 
     if (self) {
@@ -60,12 +76,22 @@ NSString *const PersistentQueueKey = @"com.urbanairship.channel_attributes.regis
         self.pendingAttributeMutationsQueue = [UAPersistentQueue persistentQueueWithDataStore:dataStore key:PersistentQueueKey];
         self.operationQueue = operationQueue;
         self.operationQueue.maxConcurrentOperationCount = 1;
+        self.dispatcher = dispatcher;
+        self.bufferedMutations = [NSMutableDictionary dictionary];
+        self.bufferedKeys = [NSMutableOrderedSet orderedSet];
+
+        [[NSNotificationCenter defaultCenter] addObserver:self
+                                                 selector:@selector(flushBufferedMutations)
+                                                     name:UIApplicationDidEnterBackgroundNotification
+                                                   object:nil];
     }
 
     return self;
 }
 
 -(void)dealloc {
+    [self.flushDisposable dispose];
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
     [self.operationQueue cancelAllOperations];
 }
 
@@ -75,15 +101,75 @@ NSString *const PersistentQueueKey = @"com.urbanairship.channel_attributes.regis
         return;
     }
 
-    [self.pendingAttributeMutationsQueue addObject:mutations];
+    BOOL bufferFull;
+
+    @synchronized(self) {
+        for (NSDictionary *mutation in mutations.mutationsPayload) {
+            NSString *key = mutation[UAAttributeNameKey];
+            if (!key) {
+                continue;
+            }
+
+            // Last write wins, the key moves to the end so uploads keep the write order
+            [self.bufferedKeys removeObject:key];
+            [self.bufferedKeys addObject:key];
+            self.bufferedMutations[key] = mutation;
+        }
+
+        bufferFull = self.bufferedKeys.count >= UAAttributeRegistrarMaxUploadMutations;
+
+        // The first buffered mutation opens the window, later ones are batched into it
+        if (!bufferFull && !self.flushDisposable) {
+            UA_WEAKIFY(self);
+            self.flushDisposable = [self.dispatcher dispatchAfter:UAAttributeRegistrarFlushDelay block:^{
+                UA_STRONGIFY(self);
+                [self flushBufferedMutations];
+            }];
+        }
+    }
+
+    if (bufferFull) {
+        [self flushBufferedMutations];
+    }
+}
+
+- (void)flushBufferedMutations {
+    NSArray<NSDictionary *> *mutationsPayload;
+    NSString *channelID;
+
+    @synchronized(self) {
+        [self.flushDisposable dispose];
+        self.flushDisposable = nil;
+
+        if (!self.bufferedKeys.count) {
+            return;
+        }
+
+        mutationsPayload = [self.bufferedMutations objectsForKeys:self.bufferedKeys.array notFoundMarker:[NSNull null]];
+        [self.bufferedKeys removeAllObjects];
+        [self.bufferedMutations removeAllObjects];
+        channelID = self.channelID;
+    }
+
+    // Persisting on the operation queue keeps the queue from changing under an upload
+    UAAttributePendingMutations *mutations = [UAAttributePendingMutations pendingMutationsWithPayload:mutationsPayload];
+    [self.operationQueue addOperationWithBlock:^{
+        NSArray<UAAttributePendingMutations *> *queued = [self.pendingAttributeMutationsQueue objects];
+        UAAttributePendingMutations *collapsed = [UAAttributePendingMutations collapseMutations:[queued arrayByAddingObject:mutations]];
+        [self.pendingAttributeMutationsQueue setObjects:@[collapsed]];
+    }];
+
+    if (channelID) {
+        [self updateAttributesForChannel:channelID];
+    }
 }
 
 - (void)collapseQueuedPendingMutations {
     UAPersistentQueue *queue = self.pendingAttributeMutationsQueue;
     NSArray<UAAttributePendingMutations *> *mutationsToCollapse = [[queue objects] mutableCopy];
 
-    if (mutationsToCollapse.count == 0) {
-        // Nothing in the queue to collapse
+    if (mutationsToCollapse.count <= 1) {
+        // Flushes keep the queue collapsed, only queues saved by older versions need collapsing
         return;
     }
 
@@ -91,11 +177,36 @@ NSString *const PersistentQueueKey = @"com.urbanairship.channel_attributes.regis
     [queue setObjects:@[mutations]];
 }
 
+/**
+ * Removes uploaded mutations from the front of the collapsed queue.
+ *
+ * @param count The number of uploaded mutations.
+ */
+- (void)removeUploadedMutations:(NSUInteger)count {
+    UAAttributePendingMutations *queued = (UAAttributePendingMutations *)[self.pendingAttributeMutationsQueue peekObject];
+    NSArray<NSDictionary *> *remaining = [queued.mutationsPayload subarrayWithRange:NSMakeRange(count, queued.mutationsPayload.count - count)];
+
+    if (remaining.count) {
+        [self.pendingAttributeMutationsQueue setObjects:@[[UAAttributePendingMutations pendingMutationsWithPayload:remaining]]];
+    } else {
+        [self.pendingAttributeMutationsQueue popObject];
+    }
+}
+
 - (void)updateAttributesForChannel:(NSString *)identifier {
     if (!self.componentEnabled) {
         return;
     }
 
+    @synchronized(self) {
+        self.channelID = identifier;
+
+        if (self.bufferedKeys.count) {
+            // Buffered mutations are uploaded once the buffer flushes
+            return;
+        }
+    }
+
     UAAsyncOperation *operation = [UAAsyncOperation operationWithBlock:^(UAAsyncOperation *operation) {
         UA_WEAKIFY(self);
         __block UIBackgroundTaskIdentifier backgroundTaskIdentifier = [self.application beginBackgroundTaskWithExpirationHandler:^{
@@ -122,11 +233,14 @@ NSString *const PersistentQueueKey = @"com.urbanairship.channel_attributes.regis
             return;
         }
 
-        UAAttributePendingMutations *nextPendingMutation = (UAAttributePendingMutations *)[self.pendingAttributeMutationsQueue peekObject];
+        // Upload at most the server's limit, the rest goes in the next request
+        UAAttributePendingMutations *queuedMutations = (UAAttributePendingMutations *)[self.pendingAttributeMutationsQueue peekObject];
+        NSUInteger uploadCount = MIN(queuedMutations.mutationsPayload.count, UAAttributeRegistrarMaxUploadMutations);
+        UAAttributePendingMutations *nextPendingMutation = [UAAttributePendingMutations pendingMutationsWithPayload:[queuedMutations.mutationsPayload subarrayWithRange:NSMakeRange(0, uploadCount)]];
 
         [self.client updateChannel:identifier withAttributePayload:nextPendingMutation.payload onSuccess:^{
-            // Success - pop uploaded mutation
-            [self.pendingAttributeMutationsQueue popObject];
+            // Success - remove uploaded mutations
+            [self removeUploadedMutations:uploadCount];
 
             // Continue updating attributes for channel if operation has not been canceled and there are remaining mutations to upload
             if (!operation.isCancelled && self.pendingAttributeMutationsQueue.objects.count > 0) {
@@ -139,8 +253,8 @@ NSString *const PersistentQueueKey = @"com.urbanairship.channel_attributes.regis
             UA_LDEBUG("UAAttributeRegistrar - update attribute request failed with status code:%lu", (unsigned long)statusCode);
 
             if (statusCode == 400 || statusCode == 403) {
-                // Unrecoverable failure - pop mutation and end the background task
-                [self.pendingAttributeMutationsQueue popObject];
+                // Unrecoverable failure - remove mutations and end the background task
+                [self removeUploadedMutations:uploadCount];
                 [self endBackgroundTask:backgroundTaskIdentifier];
             }
 
@@ -127,6 +127,20 @@ typedef NS_ENUM(NSUInteger, UACloudSite) {
  */
 @property (nonatomic, assign, getter=isAnalyticsEnabled) BOOL analyticsEnabled;
 
+/**
+ * If set to `YES`, analytics events are stored in an append-only log instead of Core Data.
+ * Events already stored are migrated to the log. Defaults to `NO`.
+ */
+@property (nonatomic, assign, getter=isAnalyticsEventLogEnabled) BOOL analyticsEventLogEnabled;
+
+/**
+ * Custom event names that are aggregated into one event per minute instead of being stored
+ * individually. Include `screen_tracking` to aggregate screen tracking events by screen.
+ * Aggregated events carry the count, the value sum and the first and last event times.
+ * Defaults to an empty array.
+ */
+@property (nonatomic, copy) NSArray<NSString *> *aggregatedEventNames;
+
 /**
  * Apps may be set to self-configure based on the APS-environment set in the
  * embedded.mobileprovision file by using detectProvisioningMode. If
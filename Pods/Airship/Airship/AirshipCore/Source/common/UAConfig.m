@@ -45,6 +45,8 @@ NSString *const UALogLevelTraceName = @"TRACE";
         self.requestAuthorizationToUseNotifications = YES;
         self.automaticSetupEnabled = YES;
         self.analyticsEnabled = YES;
+        self.analyticsEventLogEnabled = NO;
+        self.aggregatedEventNames = @[];
         self.profilePath = [[NSBundle mainBundle] pathForResource:@"embedded" ofType:@"mobileprovision"];
         self.clearUserOnAppRestore = NO;
         self.whitelist = @[];
@@ -82,6 +84,8 @@ NSString *const UALogLevelTraceName = @"TRACE";
 
         _automaticSetupEnabled = config.automaticSetupEnabled;
         _analyticsEnabled = config.analyticsEnabled;
+        _analyticsEventLogEnabled = config.analyticsEventLogEnabled;
+        _aggregatedEventNames = config.aggregatedEventNames;
         _profilePath = config.profilePath;
         _clearUserOnAppRestore = config.clearUserOnAppRestore;
         _whitelist = config.whitelist;
@@ -115,6 +119,8 @@ NSString *const UALogLevelTraceName = @"TRACE";
             "Detect Provisioning Mode: %d\n"
             "Request Authorization To Use Notifications: %@\n"
             "Analytics Enabled: %d\n"
+            "Analytics Event Log Enabled: %d\n"
+            "Aggregated Event Names: %@\n"
             "Analytics URL: %@\n"
             "Device API URL: %@\n"
             "Remote Data API URL: %@\n"
@@ -145,6 +151,8 @@ NSString *const UALogLevelTraceName = @"TRACE";
             self.detectProvisioningMode,
             self.requestAuthorizationToUseNotifications ? @"YES" : @"NO",
             self.analyticsEnabled,
+            self.analyticsEventLogEnabled,
+            self.aggregatedEventNames,
             self.analyticsURL,
             self.deviceAPIURL,
             self.remoteDataAPIURL,
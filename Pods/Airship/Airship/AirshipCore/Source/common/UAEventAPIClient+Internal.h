@@ -42,6 +42,15 @@ NS_ASSUME_NONNULL_BEGIN
  */
 -(void)uploadEvents:(NSArray *)events headers:(NSDictionary<NSString *, NSString *> *)headers completionHandler:(void (^)(NSHTTPURLResponse * nullable))completionHandler;
 
+/**
+ * Uploads pre-serialized analytic events. The fragments are streamed straight into
+ * the compressed request body.
+ * @param fragments The JSON object fragments, one per event.
+ * @param headers The event headers.
+ * @param completionHandler A completion handler.
+ */
+-(void)uploadEventFragments:(NSArray<NSData *> *)fragments headers:(NSDictionary<NSString *, NSString *> *)headers completionHandler:(void (^)(NSHTTPURLResponse * nullable))completionHandler;
+
 @end
 
 NS_ASSUME_NONNULL_END
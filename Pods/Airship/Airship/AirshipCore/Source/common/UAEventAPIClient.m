@@ -3,14 +3,13 @@
 #import <UIKit/UIKit.h>
 
 #import "UAEventAPIClient+Internal.h"
-#import "NSJSONSerialization+UAAdditions.h"
 #import "UAJSONSerialization.h"
 #import "UAAnalytics+Internal.h"
 
 @implementation UAEventAPIClient
 
 + (instancetype)clientWithConfig:(UARuntimeConfig *)config {
-    return [[UAEventAPIClient alloc] initWithConfig:config session:[UARequestSession sessionWithConfig:config]];
+    return [[UAEventAPIClient alloc] initWithConfig:config session:[UARequestSession sessionWithConfig:config requestClass:@"events" priority:UARequestPriorityNormal]];
 }
 
 + (instancetype)clientWithConfig:(UARuntimeConfig *)config session:(UARequestSession *)session {
@@ -18,13 +17,27 @@
 }
 
 -(void)uploadEvents:(NSArray *)events headers:(NSDictionary *)headers completionHandler:(void (^)(NSHTTPURLResponse *))completionHandler {
-    UARequest *request = [self requestWithEvents:events headers:headers];
+    NSMutableArray<NSData *> *fragments = [NSMutableArray arrayWithCapacity:events.count];
+    for (id event in events) {
+        NSData *fragment = [UAJSONSerialization dataWithJSONObject:event options:0 error:nil];
+        if (fragment) {
+            [fragments addObject:fragment];
+        }
+    }
+
+    [self uploadEventFragments:fragments headers:headers completionHandler:completionHandler];
+}
+
+-(void)uploadEventFragments:(NSArray<NSData *> *)fragments headers:(NSDictionary *)headers completionHandler:(void (^)(NSHTTPURLResponse *))completionHandler {
+    UARequest *request = [self requestWithEventFragments:fragments headers:headers];
 
     if (uaLogLevel >= UALogLevelTrace) {
-        UA_LTRACE(@"Sending analytics events with IDs: %@", [events valueForKey:@"event_id"]);
+        UA_LTRACE(@"Sending %lu analytics events", (unsigned long)fragments.count);
         UA_LTRACE(@"Sending to server: %@", self.config.analyticsURL);
         UA_LTRACE(@"Sending analytics headers: %@", [request.headers descriptionWithLocale:nil indent:1]);
-        UA_LTRACE(@"Sending analytics body: %@", [NSJSONSerialization stringWithObject:events options:NSJSONWritingPrettyPrinted]);
+        for (NSData *fragment in fragments) {
+            UA_LTRACE(@"Sending analytics event: %@", [[NSString alloc] initWithData:fragment encoding:NSUTF8StringEncoding]);
+        }
     }
 
     // Perform the upload
@@ -37,14 +50,29 @@
     }];
 }
 
-- (UARequest *)requestWithEvents:(NSArray *)events headers:(NSDictionary<NSString *, NSString *> *)headers {
+- (UARequest *)requestWithEventFragments:(NSArray<NSData *> *)fragments headers:(NSDictionary<NSString *, NSString *> *)headers {
     UARequest *request = [UARequest requestWithBuilderBlock:^(UARequestBuilder *builder) {
         builder.URL = [NSURL URLWithString:[NSString stringWithFormat:@"%@%@", self.config.analyticsURL, @"/warp9/"]];
         builder.method = @"POST";
 
-        // Body
+        // Body, compressed as the JSON array is written
+        NSUInteger expectedLength = fragments.count + 1;
+        for (NSData *fragment in fragments) {
+            expectedLength += fragment.length;
+        }
+
         builder.compressBody = YES;
-        builder.body = [UAJSONSerialization dataWithJSONObject:events options:0 error:nil];
+        builder.expectedBodyLength = expectedLength;
+        builder.bodyWriter = ^(id<UARequestBodyWriter> writer) {
+            [writer appendBytes:"[" length:1];
+            for (NSUInteger i = 0; i < fragments.count; i++) {
+                if (i > 0) {
+                    [writer appendBytes:"," length:1];
+                }
+                [writer appendData:fragments[i]];
+            }
+            [writer appendBytes:"]" length:1];
+        };
 
         // Headers
         [builder addHeaders:headers];
@@ -0,0 +1,97 @@
+/* Copyright Airship and Contributors */
+
+#import <Foundation/Foundation.h>
+
+@class UAEvent;
+@class UADate;
+@class UADispatcher;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * Default aggregation window in seconds.
+ */
+extern const NSTimeInterval UAEventAggregatorDefaultWindow;
+
+/**
+ * Default max number of aggregates held in memory.
+ */
+extern const NSUInteger UAEventAggregatorDefaultMaxEntries;
+
+/**
+ * Aggregated event property keys.
+ */
+extern NSString * const UAEventAggregatorCountKey;
+extern NSString * const UAEventAggregatorFirstTimeKey;
+extern NSString * const UAEventAggregatorLastTimeKey;
+extern NSString * const UAEventAggregatorScreenKey;
+
+/**
+ * Rolls high frequency events up into one custom event per window.
+ *
+ * Custom events are aggregated by event name, and screen tracking events by screen when the
+ * `screen_tracking` event type is configured. Each aggregate is emitted as a custom event with the
+ * same name, the sum of the values or screen durations as its value, and the count and first and
+ * last event times as properties. Properties, interaction IDs and transaction IDs of the
+ * aggregated events are not kept, so custom events with a transaction ID are never aggregated.
+ *
+ * An aggregate is emitted when its window ends, when its session changes, when it is evicted to
+ * keep the number of aggregates bounded, before its value sum would leave the range of a custom event
+ * value, or on flush.
+ */
+@interface UAEventAggregator : NSObject
+
+///---------------------------------------------------------------------------------------
+/// @name Event Aggregator Internal Methods
+///---------------------------------------------------------------------------------------
+
+/**
+ * Factory method.
+ *
+ * @param eventNames The custom event names to aggregate, and `screen_tracking` to aggregate screen tracking events.
+ * @param eventHandler Called with each aggregated event and its session ID.
+ * @return The event aggregator.
+ */
++ (instancetype)aggregatorWithEventNames:(NSArray<NSString *> *)eventNames
+                            eventHandler:(void (^)(UAEvent *event, NSString *sessionID))eventHandler;
+
+/**
+ * Factory method. Used for testing.
+ *
+ * @param eventNames The custom event names to aggregate, and `screen_tracking` to aggregate screen tracking events.
+ * @param window The aggregation window in seconds.
+ * @param maxEntries The max number of aggregates held in memory.
+ * @param date The date.
+ * @param dispatcher The dispatcher used to end windows.
+ * @param eventHandler Called with each aggregated event and its session ID.
+ * @return The event aggregator.
+ */
++ (instancetype)aggregatorWithEventNames:(NSArray<NSString *> *)eventNames
+                                  window:(NSTimeInterval)window
+                              maxEntries:(NSUInteger)maxEntries
+                                    date:(UADate *)date
+                              dispatcher:(UADispatcher *)dispatcher
+                            eventHandler:(void (^)(UAEvent *event, NSString *sessionID))eventHandler;
+
+/**
+ * Aggregates an event if its name is configured.
+ *
+ * @param event The event.
+ * @param sessionID The event's session ID.
+ * @return `YES` if the event was aggregated, `NO` if it should be added as is.
+ */
+- (BOOL)aggregateEvent:(UAEvent *)event sessionID:(NSString *)sessionID;
+
+/**
+ * Emits all aggregates.
+ */
+- (void)flush;
+
+/**
+ * Discards all aggregates without emitting them.
+ */
+- (void)removeAllAggregates;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,283 @@
+/* Copyright Airship and Contributors */
+
+#import "UAEventAggregator+Internal.h"
+#import "UAEvent+Internal.h"
+#import "UACustomEvent.h"
+#import "UAScreenTrackingEvent+Internal.h"
+#import "UADate.h"
+#import "UADispatcher.h"
+#import "UADisposable.h"
+#import "UAGlobal.h"
+
+const NSTimeInterval UAEventAggregatorDefaultWindow = 60;
+const NSUInteger UAEventAggregatorDefaultMaxEntries = 100;
+
+NSString * const UAEventAggregatorCountKey = @"count";
+NSString * const UAEventAggregatorFirstTimeKey = @"first_time";
+NSString * const UAEventAggregatorLastTimeKey = @"last_time";
+NSString * const UAEventAggregatorScreenKey = @"screen";
+
+/**
+ * The running totals of an aggregate.
+ */
+@interface UAEventAggregatorEntry : NSObject
+@property (nonatomic, copy) NSString *name;
+@property (nonatomic, copy, nullable) NSString *screen;
+@property (nonatomic, copy) NSString *sessionID;
+@property (nonatomic, assign) NSUInteger count;
+@property (nonatomic, strong, nullable) NSDecimalNumber *valueSum;
+@property (nonatomic, assign) NSTimeInterval firstTime;
+@property (nonatomic, assign) NSTimeInterval lastTime;
+@property (nonatomic, strong) NSDate *windowEnd;
+@end
+
+@implementation UAEventAggregatorEntry
+@end
+
+@interface UAEventAggregator ()
+@property (nonatomic, copy) NSSet<NSString *> *eventNames;
+@property (nonatomic, assign) NSTimeInterval window;
+@property (nonatomic, assign) NSUInteger maxEntries;
+@property (nonatomic, strong) UADate *date;
+@property (nonatomic, strong) UADispatcher *dispatcher;
+@property (nonatomic, copy) void (^eventHandler)(UAEvent *, NSString *);
+
+// Aggregates keyed by event type and name, or screen for screen tracking
+@property (nonatomic, strong) NSMutableDictionary<NSArray<NSString *> *, UAEventAggregatorEntry *> *entries;
+@property (nonatomic, strong, nullable) UADisposable *flushDisposable;
+@end
+
+@implementation UAEventAggregator
+
+- (instancetype)initWithEventNames:(NSArray<NSString *> *)eventNames
+                            window:(NSTimeInterval)window
+                        maxEntries:(NSUInteger)maxEntries
+                              date:(UADate *)date
+                        dispatcher:(UADispatcher *)dispatcher
+                      eventHandler:(void (^)(UAEvent *, NSString *))eventHandler {
+    self = [super init];
+
+    if (self) {
+        self.eventNames = [NSSet setWithArray:eventNames];
+        self.window = window;
+        self.maxEntries = MAX(maxEntries, 1);
+        self.date = date;
+        self.dispatcher = dispatcher;
+        self.eventHandler = eventHandler;
+        self.entries = [NSMutableDictionary dictionary];
+    }
+
+    return self;
+}
+
++ (instancetype)aggregatorWithEventNames:(NSArray<NSString *> *)eventNames
+                            eventHandler:(void (^)(UAEvent *, NSString *))eventHandler {
+    return [[self alloc] initWithEventNames:eventNames
+                                     window:UAEventAggregatorDefaultWindow
+                                 maxEntries:UAEventAggregatorDefaultMaxEntries
+                                       date:[[UADate alloc] init]
+                                 dispatcher:[UADispatcher mainDispatcher]
+                               eventHandler:eventHandler];
+}
+
++ (instancetype)aggregatorWithEventNames:(NSArray<NSString *> *)eventNames
+                                  window:(NSTimeInterval)window
+                              maxEntries:(NSUInteger)maxEntries
+                                    date:(UADate *)date
+                              dispatcher:(UADispatcher *)dispatcher
+                            eventHandler:(void (^)(UAEvent *, NSString *))eventHandler {
+    return [[self alloc] initWithEventNames:eventNames
+                                     window:window
+                                 maxEntries:maxEntries
+                                       date:date
+                                 dispatcher:dispatcher
+                               eventHandler:eventHandler];
+}
+
+- (void)dealloc {
+    [_flushDisposable dispose];
+}
+
+- (BOOL)aggregateEvent:(UAEvent *)event sessionID:(NSString *)sessionID {
+    NSString *name;
+    NSString *screen;
+    NSDecimalNumber *value;
+
+    if ([event isKindOfClass:[UACustomEvent class]]) {
+        UACustomEvent *customEvent = (UACustomEvent *)event;
+
+        // Transactions are counted individually for conversion reporting
+        if (![self.eventNames containsObject:customEvent.eventName] || customEvent.transactionID) {
+            return NO;
+        }
+
+        name = customEvent.eventName;
+        value = customEvent.eventValue;
+    } else if ([event isKindOfClass:[UAScreenTrackingEvent class]]) {
+        if (![self.eventNames containsObject:kUAScreenTrackingEventType]) {
+            return NO;
+        }
+
+        UAScreenTrackingEvent *screenEvent = (UAScreenTrackingEvent *)event;
+        name = kUAScreenTrackingEventType;
+        screen = screenEvent.screen;
+        value = [NSDecimalNumber decimalNumberWithDecimal:@(screenEvent.duration).decimalValue];
+    } else {
+        return NO;
+    }
+
+    NSArray<NSString *> *key = @[event.eventType, screen ?: name];
+    NSTimeInterval time = event.time.doubleValue;
+    NSMutableArray<UAEventAggregatorEntry *> *emitted = [NSMutableArray array];
+
+    @synchronized (self) {
+        UAEventAggregatorEntry *entry = self.entries[key];
+
+        // Aggregates never span sessions, and end before their value sum is out of range for a custom event
+        if (entry && (![entry.sessionID isEqualToString:sessionID] || ![self canAddValue:value toEntry:entry])) {
+            [emitted addObject:entry];
+            [self.entries removeObjectForKey:key];
+            entry = nil;
+        }
+
+        if (!entry) {
+            if (self.entries.count >= self.maxEntries) {
+                NSArray<NSString *> *oldestKey = [self keyOfOldestEntry];
+                [emitted addObject:self.entries[oldestKey]];
+                [self.entries removeObjectForKey:oldestKey];
+            }
+
+            entry = [[UAEventAggregatorEntry alloc] init];
+            entry.name = name;
+            entry.screen = screen;
+            entry.sessionID = sessionID;
+            entry.firstTime = time;
+            entry.windowEnd = [self.date.now dateByAddingTimeInterval:self.window];
+            self.entries[key] = entry;
+
+            [self scheduleFlushAfter:self.window];
+        }
+
+        entry.count++;
+        entry.firstTime = MIN(entry.firstTime, time);
+        entry.lastTime = MAX(entry.lastTime, time);
+        if (value) {
+            entry.valueSum = entry.valueSum ? [entry.valueSum decimalNumberByAdding:value] : value;
+        }
+    }
+
+    [self emitEntries:emitted];
+    return YES;
+}
+
+- (void)flush {
+    NSArray<UAEventAggregatorEntry *> *emitted;
+
+    @synchronized (self) {
+        [self.flushDisposable dispose];
+        self.flushDisposable = nil;
+
+        emitted = self.entries.allValues;
+        [self.entries removeAllObjects];
+    }
+
+    [self emitEntries:emitted];
+}
+
+- (void)removeAllAggregates {
+    @synchronized (self) {
+        [self.flushDisposable dispose];
+        self.flushDisposable = nil;
+        [self.entries removeAllObjects];
+    }
+}
+
+#pragma mark -
+#pragma mark Windows
+
+/**
+ * Schedules the next window check, unless one is already scheduled. Must be called while synchronized on self.
+ */
+- (void)scheduleFlushAfter:(NSTimeInterval)delay {
+    if (self.flushDisposable) {
+        return;
+    }
+
+    UA_WEAKIFY(self)
+    self.flushDisposable = [self.dispatcher dispatchAfter:delay block:^{
+        UA_STRONGIFY(self)
+        [self flushEndedWindows];
+    }];
+}
+
+- (void)flushEndedWindows {
+    NSMutableArray<UAEventAggregatorEntry *> *emitted = [NSMutableArray array];
+
+    @synchronized (self) {
+        self.flushDisposable = nil;
+
+        NSDate *now = self.date.now;
+        NSDate *nextWindowEnd;
+
+        for (NSArray<NSString *> *key in self.entries.allKeys) {
+            UAEventAggregatorEntry *entry = self.entries[key];
+            if ([entry.windowEnd compare:now] != NSOrderedDescending) {
+                [emitted addObject:entry];
+                [self.entries removeObjectForKey:key];
+            } else if (!nextWindowEnd || [entry.windowEnd compare:nextWindowEnd] == NSOrderedAscending) {
+                nextWindowEnd = entry.windowEnd;
+            }
+        }
+
+        if (nextWindowEnd) {
+            [self scheduleFlushAfter:[nextWindowEnd timeIntervalSinceDate:now]];
+        }
+    }
+
+    [self emitEntries:emitted];
+}
+
+/**
+ * Checks if a value can be added to an entry without its sum leaving the range of a custom event value.
+ */
+- (BOOL)canAddValue:(nullable NSDecimalNumber *)value toEntry:(UAEventAggregatorEntry *)entry {
+    if (!value || !entry.valueSum) {
+        return YES;
+    }
+
+    NSDecimalNumber *sum = [entry.valueSum decimalNumberByAdding:value];
+    return [sum compare:@(INT32_MAX)] != NSOrderedDescending && [sum compare:@(INT32_MIN)] != NSOrderedAscending;
+}
+
+/**
+ * Must be called while synchronized on self.
+ */
+- (NSArray<NSString *> *)keyOfOldestEntry {
+    NSArray<NSString *> *oldestKey;
+    for (NSArray<NSString *> *key in self.entries) {
+        if (!oldestKey || [self.entries[key].windowEnd compare:self.entries[oldestKey].windowEnd] == NSOrderedAscending) {
+            oldestKey = key;
+        }
+    }
+
+    return oldestKey;
+}
+
+- (void)emitEntries:(NSArray<UAEventAggregatorEntry *> *)entries {
+    for (UAEventAggregatorEntry *entry in entries) {
+        UACustomEvent *event = [UACustomEvent eventWithName:entry.name];
+        event.eventValue = entry.valueSum;
+        [event setNumberProperty:@(entry.count) forKey:UAEventAggregatorCountKey];
+        [event setNumberProperty:@(entry.firstTime) forKey:UAEventAggregatorFirstTimeKey];
+        [event setNumberProperty:@(entry.lastTime) forKey:UAEventAggregatorLastTimeKey];
+
+        if (entry.screen) {
+            [event setStringProperty:entry.screen forKey:UAEventAggregatorScreenKey];
+        }
+
+        UA_LTRACE(@"Emitting aggregate of %lu %@ events", (unsigned long)entry.count, entry.name);
+        self.eventHandler(event, entry.sessionID);
+    }
+}
+
+@end
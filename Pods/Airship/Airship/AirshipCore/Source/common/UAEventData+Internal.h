@@ -2,6 +2,7 @@
 
 #import <Foundation/Foundation.h>
 #import <CoreData/CoreData.h>
+#import "UAEventStoreProtocol+Internal.h"
 
 /**
  * CoreData class representing the backing data for
@@ -9,7 +10,7 @@
  *
  * This class should not ordinarily be used directly.
  */
-@interface UAEventData : NSManagedObject
+@interface UAEventData : NSManagedObject <UAEventStoreEvent>
 
 ///---------------------------------------------------------------------------------------
 /// @name Event Data Internal Properties
@@ -21,10 +22,17 @@
 @property (nullable, nonatomic, retain) NSString *sessionID;
 
 /**
- * The event's Data.
+ * The event's Data. Either the JSON event body, or the complete JSON upload
+ * fragment when `envelope` is set.
  */
 @property (nullable, nonatomic, retain) NSData *data;
 
+/**
+ * Whether `data` holds the pre-serialized upload fragment, including the event ID,
+ * time, type and session ID. Events stored by older SDK versions only hold the body.
+ */
+@property (nullable, nonatomic, retain) NSNumber *envelope;
+
 /**
  * The event's creation time.
  */
@@ -50,4 +58,34 @@
  */
 @property (nullable, nonatomic, retain) NSDate *storeDate;
 
+///---------------------------------------------------------------------------------------
+/// @name Event Data Internal Methods
+///---------------------------------------------------------------------------------------
+
+/**
+ * Builds the JSON upload fragment for an event.
+ *
+ * @param identifier The event ID.
+ * @param type The event type.
+ * @param time The event time.
+ * @param body The event body.
+ * @param sessionID The session ID.
+ * @param error The serialization error, if any.
+ * @return The serialized fragment, or `nil` if the body is not valid JSON.
+ */
++ (nullable NSData *)uploadFragmentWithID:(nullable NSString *)identifier
+                                     type:(nullable NSString *)type
+                                     time:(nullable NSString *)time
+                                     body:(nullable id)body
+                                sessionID:(nullable NSString *)sessionID
+                                    error:(NSError * _Nullable * _Nullable)error;
+
+/**
+ * The JSON upload fragment for this event. Returned as stored for events with
+ * an envelope, otherwise assembled from the legacy body.
+ *
+ * @return The serialized fragment, or `nil` if the stored data is corrupt.
+ */
+- (nullable NSData *)uploadFragment;
+
 @end
@@ -1,6 +1,8 @@
 /* Copyright Airship and Contributors */
 
 #import "UAEventData+Internal.h"
+#import "UAJSONSerialization.h"
+#import "UAGlobal.h"
 
 @implementation UAEventData
 
@@ -11,5 +13,50 @@
 @dynamic type;
 @dynamic storeDate;
 @dynamic identifier;
+@dynamic envelope;
+
++ (NSData *)uploadFragmentWithID:(NSString *)identifier
+                            type:(NSString *)type
+                            time:(NSString *)time
+                            body:(id)body
+                       sessionID:(NSString *)sessionID
+                           error:(NSError **)error {
+    NSMutableDictionary *data = [body isKindOfClass:[NSDictionary class]] ? [body mutableCopy] : [NSMutableDictionary dictionary];
+    [data setValue:sessionID forKey:@"session_id"];
+
+    NSMutableDictionary *fragment = [NSMutableDictionary dictionary];
+    [fragment setValue:identifier forKey:@"event_id"];
+    [fragment setValue:time forKey:@"time"];
+    [fragment setValue:type forKey:@"type"];
+    [fragment setValue:data forKey:@"data"];
+
+    return [UAJSONSerialization dataWithJSONObject:fragment options:0 error:error];
+}
+
+- (NSData *)uploadFragment {
+    if (self.envelope.boolValue) {
+        return self.data;
+    }
+
+    NSError *error = nil;
+    id body = [NSJSONSerialization JSONObjectWithData:self.data options:0 error:&error];
+    if (error) {
+        UA_LERR(@"Failed to deserialize event %@: %@", self, error);
+        return nil;
+    }
+
+    NSData *fragment = [UAEventData uploadFragmentWithID:self.identifier
+                                                    type:self.type
+                                                    time:self.time
+                                                    body:body
+                                               sessionID:self.sessionID
+                                                   error:&error];
+    if (error) {
+        UA_LERR(@"Failed to serialize event %@: %@", self, error);
+        return nil;
+    }
+
+    return fragment;
+}
 
 @end
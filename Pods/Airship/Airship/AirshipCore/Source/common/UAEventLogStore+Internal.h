@@ -0,0 +1,51 @@
+/* Copyright Airship and Contributors */
+
+#import <Foundation/Foundation.h>
+#import "UAEventStoreProtocol+Internal.h"
+
+@class UARuntimeConfig;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * Default segment size in bytes.
+ */
+extern const NSUInteger UAEventLogStoreDefaultSegmentSize;
+
+/**
+ * Analytic event store backed by an append-only segmented log.
+ *
+ * Events are appended to fixed-size segment files as length and CRC framed records, and read in
+ * the order they were saved from a persisted read cursor. Deleting an uploaded batch advances
+ * the cursor, and segments behind the cursor are deleted whole. A torn record at the end of the
+ * last segment is truncated when the log is opened.
+ *
+ * Events left in the Core Data store or in the pre Core Data database are migrated into the log
+ * before any other work runs.
+ */
+@interface UAEventLogStore : NSObject <UAEventStoreProtocol>
+
+///---------------------------------------------------------------------------------------
+/// @name Event Log Store Internal Methods
+///---------------------------------------------------------------------------------------
+
+/**
+ * Default factory method.
+ *
+ * @param config The airship config.
+ * @return The event log store.
+ */
++ (instancetype)eventLogStoreWithConfig:(UARuntimeConfig *)config;
+
+/**
+ * Factory method. Used for testing.
+ *
+ * @param directoryURL The directory holding the segments. Created if it does not exist.
+ * @param segmentSize The segment size in bytes. Records larger than a segment get a segment of their own.
+ * @return The event log store.
+ */
++ (instancetype)eventLogStoreWithDirectoryURL:(NSURL *)directoryURL segmentSize:(NSUInteger)segmentSize;
+
+@end
+
+NS_ASSUME_NONNULL_END
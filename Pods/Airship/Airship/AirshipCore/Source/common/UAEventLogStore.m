@@ -0,0 +1,622 @@
+/* Copyright Airship and Contributors */
+
+#import <zlib.h>
+
+#import "UAEventLogStore+Internal.h"
+#import "UAEventStore+Internal.h"
+#import "UAEventData+Internal.h"
+#import "UAEvent.h"
+#import "UARuntimeConfig.h"
+#import "UAUtils.h"
+#import "UAGlobal.h"
+#import "UAMetrics+Internal.h"
+#import "NSManagedObjectContext+UAAdditions.h"
+
+const NSUInteger UAEventLogStoreDefaultSegmentSize = 64 * 1024;
+
+static NSString * const UAEventLogStoreDirectoryFormat = @"Events-%@.log";
+static NSString * const UAEventLogStoreCursorFileName = @"cursor";
+static NSString * const UAEventLogStoreSegmentExtension = @"segment";
+
+// Record header, followed by the payload: the identifier length as a uint16_t, the UTF-8
+// identifier, then the upload fragment. The CRC-32 covers the whole payload.
+typedef struct {
+    uint32_t length;
+    uint32_t crc;
+} UAEventLogStoreRecordHeader;
+
+// A position in the log
+typedef struct {
+    uint64_t segment;
+    uint64_t offset;
+} UAEventLogStorePosition;
+
+/**
+ * Reads the record at an offset.
+ *
+ * @return The record length, or 0 if the record is truncated or fails its CRC.
+ */
+static uint64_t UAEventLogStoreReadRecord(NSData *data, uint64_t offset, NSString **identifier, NSData **fragment) {
+    UAEventLogStoreRecordHeader header;
+    if (data.length < offset + sizeof(header)) {
+        return 0;
+    }
+
+    [data getBytes:&header range:NSMakeRange((NSUInteger)offset, sizeof(header))];
+
+    uint64_t payloadOffset = offset + sizeof(header);
+    if (header.length < sizeof(uint16_t) || data.length - payloadOffset < header.length) {
+        return 0;
+    }
+
+    const uint8_t *payload = (const uint8_t *)data.bytes + payloadOffset;
+    if ((uint32_t)crc32(0L, payload, header.length) != header.crc) {
+        return 0;
+    }
+
+    uint16_t identifierLength;
+    memcpy(&identifierLength, payload, sizeof(identifierLength));
+    if (sizeof(identifierLength) + identifierLength > header.length) {
+        return 0;
+    }
+
+    if (identifier) {
+        *identifier = [[NSString alloc] initWithBytes:payload + sizeof(identifierLength)
+                                               length:identifierLength
+                                             encoding:NSUTF8StringEncoding];
+    }
+
+    if (fragment) {
+        NSUInteger fragmentOffset = (NSUInteger)payloadOffset + sizeof(identifierLength) + identifierLength;
+        *fragment = [data subdataWithRange:NSMakeRange(fragmentOffset, header.length - sizeof(identifierLength) - identifierLength)];
+    }
+
+    return sizeof(header) + header.length;
+}
+
+/**
+ * An event read from the log.
+ */
+@interface UAEventLogStoreEvent : NSObject <UAEventStoreEvent>
+@property (nonatomic, copy, nullable) NSString *identifier;
+@property (nonatomic, strong, nullable) NSData *fragment;
+
+// The position after the event's record
+@property (nonatomic, assign) UAEventLogStorePosition end;
+@end
+
+@implementation UAEventLogStoreEvent
+
+- (NSData *)uploadFragment {
+    return self.fragment;
+}
+
+@end
+
+@interface UAEventLogStore ()
+@property (nonatomic, strong) NSURL *directoryURL;
+@property (nonatomic, assign) NSUInteger segmentSize;
+
+// Serial queue, all other state is only accessed on it
+@property (nonatomic, strong) NSOperationQueue *queue;
+
+// Segment numbers in ascending order, the last one is being written
+@property (nonatomic, strong) NSMutableArray<NSNumber *> *segments;
+@property (nonatomic, strong, nullable) NSFileHandle *writeHandle;
+@property (nonatomic, assign) uint64_t writeOffset;
+@property (nonatomic, assign) UAEventLogStorePosition cursor;
+
+// The last fetched batch, and IDs of that batch deleted out of order
+@property (nonatomic, copy) NSArray<UAEventLogStoreEvent *> *fetchedEvents;
+@property (nonatomic, strong) NSMutableSet<NSString *> *deletedIDs;
+@end
+
+@implementation UAEventLogStore
+
+- (instancetype)initWithDirectoryURL:(NSURL *)directoryURL
+                         segmentSize:(NSUInteger)segmentSize
+                              config:(nullable UARuntimeConfig *)config {
+    self = [super init];
+
+    if (self) {
+        self.directoryURL = directoryURL;
+        self.segmentSize = segmentSize;
+        self.segments = [NSMutableArray array];
+        self.fetchedEvents = @[];
+        self.deletedIDs = [NSMutableSet set];
+
+        self.queue = [[NSOperationQueue alloc] init];
+        self.queue.maxConcurrentOperationCount = 1;
+
+        [self.queue addOperationWithBlock:^{
+            [self open];
+
+            if (config) {
+                [self migrateOldDatabaseWithConfig:config];
+            }
+        }];
+    }
+
+    return self;
+}
+
++ (instancetype)eventLogStoreWithConfig:(UARuntimeConfig *)config {
+    NSFileManager *fileManager = [NSFileManager defaultManager];
+    NSURL *libraryDirectoryURL = [[fileManager URLsForDirectory:NSLibraryDirectory inDomains:NSUserDomainMask] lastObject];
+    NSString *directoryName = [NSString stringWithFormat:UAEventLogStoreDirectoryFormat, config.appKey];
+    NSURL *directoryURL = [[libraryDirectoryURL URLByAppendingPathComponent:UAManagedContextStoreDirectory] URLByAppendingPathComponent:directoryName];
+
+    return [[self alloc] initWithDirectoryURL:directoryURL
+                                  segmentSize:UAEventLogStoreDefaultSegmentSize
+                                       config:config];
+}
+
++ (instancetype)eventLogStoreWithDirectoryURL:(NSURL *)directoryURL segmentSize:(NSUInteger)segmentSize {
+    return [[self alloc] initWithDirectoryURL:directoryURL segmentSize:segmentSize config:nil];
+}
+
+- (void)dealloc {
+    [_writeHandle closeFile];
+}
+
+#pragma mark -
+#pragma mark Event Store
+
+- (void)saveEvent:(UAEvent *)event sessionID:(NSString *)sessionID {
+    [self.queue addOperationWithBlock:^{
+        UA_METRICS_SCOPED_SPAN(UAMetricsHistogramEventStoreWrite);
+
+        [self appendEventWithID:event.eventID
+                      eventType:event.eventType
+                      eventTime:event.time
+                      eventBody:event.data
+                      sessionID:sessionID];
+
+        UAMetricsIncrement(UAMetricsCounterEventsStored, 1);
+    }];
+}
+
+- (void)fetchEventsWithMaxBatchSize:(NSUInteger)maxBatchSize
+                  completionHandler:(void (^)(NSArray<id<UAEventStoreEvent>> *))completionHandler {
+    [self.queue addOperationWithBlock:^{
+        self.fetchedEvents = [self readEventsWithMaxBatchSize:maxBatchSize];
+        [self.deletedIDs removeAllObjects];
+        completionHandler(self.fetchedEvents);
+    }];
+}
+
+- (void)deleteEventsWithIDs:(NSArray<NSString *> *)eventIDs {
+    [self.queue addOperationWithBlock:^{
+        [self.deletedIDs addObjectsFromArray:eventIDs];
+
+        // Only a deleted prefix of the fetched batch can be skipped by the cursor
+        NSUInteger count = 0;
+        for (UAEventLogStoreEvent *event in self.fetchedEvents) {
+            if (event.identifier.length) {
+                if (![self.deletedIDs containsObject:event.identifier]) {
+                    break;
+                }
+
+                [self.deletedIDs removeObject:event.identifier];
+            }
+
+            self.cursor = event.end;
+            count++;
+        }
+
+        if (!count) {
+            return;
+        }
+
+        self.fetchedEvents = [self.fetchedEvents subarrayWithRange:NSMakeRange(count, self.fetchedEvents.count - count)];
+        [self commitCursor];
+    }];
+}
+
+- (void)trimEventsToStoreSize:(NSUInteger)maxSize {
+    [self.queue addOperationWithBlock:^{
+        uint64_t size = 0;
+        for (NSNumber *segment in self.segments) {
+            size += [self sizeOfSegment:segment.unsignedLongLongValue];
+        }
+        size -= self.cursor.offset;
+
+        if (!size || size < maxSize) {
+            return;
+        }
+
+        // Whole segments are dropped, oldest first
+        while (size && size >= maxSize) {
+            if (self.cursor.segment == self.segments.lastObject.unsignedLongLongValue) {
+                // Only the segment being written is left, start a new one so it can be dropped
+                [self rollSegment];
+            }
+
+            size -= [self sizeOfSegment:self.cursor.segment] - self.cursor.offset;
+            self.cursor = (UAEventLogStorePosition){ [self segmentAfter:self.cursor.segment], 0 };
+        }
+
+        UA_LDEBUG(@"Trimmed analytic event log to %llu bytes", size);
+
+        self.fetchedEvents = @[];
+        [self commitCursor];
+    }];
+}
+
+- (void)deleteAllEvents {
+    [self.queue addOperationWithBlock:^{
+        [self.writeHandle closeFile];
+        self.writeHandle = nil;
+
+        uint64_t nextSegment = self.segments.lastObject.unsignedLongLongValue + 1;
+        for (NSNumber *segment in self.segments) {
+            [[NSFileManager defaultManager] removeItemAtURL:[self URLForSegment:segment.unsignedLongLongValue] error:nil];
+        }
+
+        [self.segments removeAllObjects];
+        self.cursor = (UAEventLogStorePosition){ nextSegment, 0 };
+        [self writeCursor];
+
+        [self createSegment:nextSegment];
+        [self openLastSegment];
+
+        self.fetchedEvents = @[];
+        [self.deletedIDs removeAllObjects];
+    }];
+}
+
+#pragma mark -
+#pragma mark Log
+
+/**
+ * Loads the segments and the cursor, and truncates a torn record at the end of the last segment.
+ */
+- (void)open {
+    NSFileManager *fileManager = [NSFileManager defaultManager];
+
+    NSError *error;
+    if (![fileManager createDirectoryAtURL:self.directoryURL withIntermediateDirectories:YES attributes:nil error:&error]) {
+        UA_LERR(@"Unable to create analytic event log at %@: %@", self.directoryURL, error);
+        return;
+    }
+
+    [UAUtils addSkipBackupAttributeToItemAtURL:self.directoryURL];
+
+    NSArray<NSURL *> *contents = [fileManager contentsOfDirectoryAtURL:self.directoryURL includingPropertiesForKeys:nil options:0 error:nil];
+    for (NSURL *URL in contents) {
+        if ([URL.pathExtension isEqualToString:UAEventLogStoreSegmentExtension]) {
+            [self.segments addObject:@(strtoull(URL.lastPathComponent.UTF8String, NULL, 10))];
+        }
+    }
+
+    [self.segments sortUsingSelector:@selector(compare:)];
+
+    UAEventLogStorePosition cursor = { self.segments.firstObject.unsignedLongLongValue, 0 };
+    NSData *cursorData = [NSData dataWithContentsOfURL:[self.directoryURL URLByAppendingPathComponent:UAEventLogStoreCursorFileName]];
+    if (cursorData.length == sizeof(cursor)) {
+        [cursorData getBytes:&cursor length:sizeof(cursor)];
+    }
+
+    self.cursor = cursor;
+    [self dropSegmentsBeforeCursor];
+
+    if (!self.segments.count) {
+        [self createSegment:self.cursor.segment];
+    } else if (self.segments.firstObject.unsignedLongLongValue != self.cursor.segment) {
+        // The cursor segment is gone, start from the next one
+        self.cursor = (UAEventLogStorePosition){ self.segments.firstObject.unsignedLongLongValue, 0 };
+    }
+
+    [self recoverLastSegment];
+    [self openLastSegment];
+}
+
+- (void)recoverLastSegment {
+    uint64_t segment = self.segments.lastObject.unsignedLongLongValue;
+    NSData *data = [self dataForSegment:segment];
+
+    uint64_t validLength = 0;
+    uint64_t length;
+    while ((length = UAEventLogStoreReadRecord(data, validLength, NULL, NULL))) {
+        validLength += length;
+    }
+
+    if (validLength < data.length) {
+        UA_LDEBUG(@"Truncating %llu bytes of torn records from analytic event log", (uint64_t)data.length - validLength);
+
+        NSFileHandle *handle = [NSFileHandle fileHandleForWritingToURL:[self URLForSegment:segment] error:nil];
+        @try {
+            [handle truncateFileAtOffset:validLength];
+        } @catch (NSException *exception) {
+            UA_LERR(@"Unable to truncate analytic event log: %@", exception);
+        }
+        [handle closeFile];
+    }
+
+    if (self.cursor.segment == segment && self.cursor.offset > validLength) {
+        self.cursor = (UAEventLogStorePosition){ segment, validLength };
+    }
+}
+
+- (void)appendEventWithID:(NSString *)eventID
+                eventType:(NSString *)eventType
+                eventTime:(NSString *)eventTime
+                eventBody:(id)eventBody
+                sessionID:(NSString *)sessionID {
+    NSError *error;
+    NSData *fragment = [UAEventData uploadFragmentWithID:eventID
+                                                    type:eventType
+                                                    time:eventTime
+                                                    body:eventBody
+                                               sessionID:sessionID
+                                                   error:&error];
+    if (error || !fragment) {
+        UA_LERR(@"Unable to save event. %@", error);
+        return;
+    }
+
+    [self appendEventWithID:eventID fragment:fragment];
+    UA_LTRACE(@"Event saved: %@", eventID);
+}
+
+/**
+ * Appends an event record to the current segment.
+ *
+ * @param eventID The event ID.
+ * @param fragment The event's upload fragment.
+ * @return `YES` if the record was written, otherwise `NO`.
+ */
+- (BOOL)appendEventWithID:(NSString *)eventID fragment:(NSData *)fragment {
+    NSData *identifier = [eventID ?: @"" dataUsingEncoding:NSUTF8StringEncoding];
+    if (identifier.length > UINT16_MAX || fragment.length > UINT32_MAX - sizeof(uint16_t) - identifier.length) {
+        UA_LERR(@"Unable to save event %@, too large", eventID);
+        return NO;
+    }
+
+    uint16_t identifierLength = (uint16_t)identifier.length;
+    NSMutableData *payload = [NSMutableData dataWithCapacity:sizeof(identifierLength) + identifier.length + fragment.length];
+    [payload appendBytes:&identifierLength length:sizeof(identifierLength)];
+    [payload appendData:identifier];
+    [payload appendData:fragment];
+
+    UAEventLogStoreRecordHeader header = { (uint32_t)payload.length, (uint32_t)crc32(0L, payload.bytes, (uInt)payload.length) };
+    NSMutableData *record = [NSMutableData dataWithBytes:&header length:sizeof(header)];
+    [record appendData:payload];
+
+    if (self.writeOffset && self.writeOffset + record.length > self.segmentSize) {
+        [self rollSegment];
+    }
+
+    if (!self.writeHandle) {
+        UA_LERR(@"Unable to save event %@, analytic event log unavailable", eventID);
+        return NO;
+    }
+
+    // File handle writes raise instead of returning errors
+    @try {
+        [self.writeHandle writeData:record];
+    } @catch (NSException *exception) {
+        UA_LERR(@"Unable to write analytic event log: %@", exception);
+
+        // Keep later records out of a segment that may end in a partial record
+        [self rollSegment];
+        return NO;
+    }
+
+    self.writeOffset += record.length;
+    return YES;
+}
+
+/**
+ * Reads events from the cursor, in the order they were saved.
+ */
+- (NSArray<UAEventLogStoreEvent *> *)readEventsWithMaxBatchSize:(NSUInteger)maxBatchSize {
+    NSMutableArray<UAEventLogStoreEvent *> *events = [NSMutableArray array];
+    NSUInteger batchSize = 0;
+
+    for (NSNumber *segmentNumber in self.segments) {
+        uint64_t segment = segmentNumber.unsignedLongLongValue;
+        if (segment < self.cursor.segment) {
+            continue;
+        }
+
+        NSData *data = [self dataForSegment:segment];
+        uint64_t offset = segment == self.cursor.segment ? self.cursor.offset : 0;
+
+        while (offset < data.length) {
+            NSString *identifier;
+            NSData *fragment;
+            uint64_t length = UAEventLogStoreReadRecord(data, offset, &identifier, &fragment);
+            if (!length) {
+                // The last segment is truncated to whole records on open, anything else is corrupt
+                UA_LERR(@"Skipping corrupt analytic event log segment %llu from offset %llu", segment, offset);
+                break;
+            }
+
+            if (events.count && batchSize + fragment.length > maxBatchSize) {
+                return events;
+            }
+
+            offset += length;
+
+            UAEventLogStoreEvent *event = [[UAEventLogStoreEvent alloc] init];
+            event.identifier = identifier;
+            event.fragment = fragment;
+            event.end = (UAEventLogStorePosition){ segment, offset };
+            [events addObject:event];
+
+            batchSize += fragment.length;
+        }
+    }
+
+    return events;
+}
+
+/**
+ * Moves the cursor past fully read segments, persists it, then drops the segments behind it.
+ */
+- (void)commitCursor {
+    while (self.cursor.segment != self.segments.lastObject.unsignedLongLongValue &&
+           self.cursor.offset >= [self sizeOfSegment:self.cursor.segment]) {
+        self.cursor = (UAEventLogStorePosition){ [self segmentAfter:self.cursor.segment], 0 };
+    }
+
+    // Persisted first so a crash can only leave extra segments behind, never skip events
+    [self writeCursor];
+    [self dropSegmentsBeforeCursor];
+}
+
+- (void)writeCursor {
+    UAEventLogStorePosition cursor = self.cursor;
+    NSData *data = [NSData dataWithBytes:&cursor length:sizeof(cursor)];
+    if (![data writeToURL:[self.directoryURL URLByAppendingPathComponent:UAEventLogStoreCursorFileName] atomically:YES]) {
+        UA_LERR(@"Unable to write analytic event log cursor");
+    }
+}
+
+- (void)dropSegmentsBeforeCursor {
+    while (self.segments.count && self.segments.firstObject.unsignedLongLongValue < self.cursor.segment) {
+        [[NSFileManager defaultManager] removeItemAtURL:[self URLForSegment:self.segments.firstObject.unsignedLongLongValue] error:nil];
+        [self.segments removeObjectAtIndex:0];
+    }
+}
+
+- (void)rollSegment {
+    [self.writeHandle closeFile];
+    self.writeHandle = nil;
+
+    [self createSegment:self.segments.lastObject.unsignedLongLongValue + 1];
+    [self openLastSegment];
+}
+
+- (void)createSegment:(uint64_t)segment {
+    if (![[NSFileManager defaultManager] createFileAtPath:[self URLForSegment:segment].path contents:nil attributes:nil]) {
+        UA_LERR(@"Unable to create analytic event log segment %llu", segment);
+    }
+
+    [self.segments addObject:@(segment)];
+}
+
+- (void)openLastSegment {
+    NSError *error;
+    self.writeHandle = [NSFileHandle fileHandleForWritingToURL:[self URLForSegment:self.segments.lastObject.unsignedLongLongValue] error:&error];
+    if (!self.writeHandle) {
+        UA_LERR(@"Unable to open analytic event log: %@", error);
+        self.writeOffset = 0;
+        return;
+    }
+
+    self.writeOffset = [self.writeHandle seekToEndOfFile];
+}
+
+- (uint64_t)sizeOfSegment:(uint64_t)segment {
+    if (segment == self.segments.lastObject.unsignedLongLongValue) {
+        return self.writeOffset;
+    }
+
+    NSDictionary *attributes = [[NSFileManager defaultManager] attributesOfItemAtPath:[self URLForSegment:segment].path error:nil];
+    return attributes.fileSize;
+}
+
+- (uint64_t)segmentAfter:(uint64_t)segment {
+    for (NSNumber *next in self.segments) {
+        if (next.unsignedLongLongValue > segment) {
+            return next.unsignedLongLongValue;
+        }
+    }
+
+    return self.segments.lastObject.unsignedLongLongValue;
+}
+
+- (NSData *)dataForSegment:(uint64_t)segment {
+    return [NSData dataWithContentsOfURL:[self URLForSegment:segment] options:NSDataReadingMappedIfSafe error:nil] ?: [NSData data];
+}
+
+- (NSURL *)URLForSegment:(uint64_t)segment {
+    NSString *name = [NSString stringWithFormat:@"%020llu.%@", segment, UAEventLogStoreSegmentExtension];
+    return [self.directoryURL URLByAppendingPathComponent:name];
+}
+
+#pragma mark -
+#pragma mark Migration
+
+/**
+ * Moves the events from the pre Core Data database and the Core Data store into the log.
+ */
+- (void)migrateOldDatabaseWithConfig:(UARuntimeConfig *)config {
+    [UAEventStore migrateOldDatabaseWithEventHandler:^(NSString *eventID, NSString *eventType, NSString *eventTime, id eventBody, NSString *sessionID) {
+        [self appendEventWithID:eventID
+                      eventType:eventType
+                      eventTime:eventTime
+                      eventBody:eventBody
+                      sessionID:sessionID];
+    }];
+
+    if (![UAEventStore persistentStoreExistsWithConfig:config]) {
+        return;
+    }
+
+    UA_LTRACE(@"Migrating Core Data analytic store.");
+
+    // The events are read on the Core Data queue and handed back to this operation, so the log is
+    // only written on the log queue and everything queued behind the migration stays behind it
+    __block NSArray<UAEventLogStoreEvent *> *migratedEvents;
+    __block NSUInteger drainedCount = 0;
+    dispatch_semaphore_t drainSemaphore = dispatch_semaphore_create(0);
+    dispatch_semaphore_t appendSemaphore = dispatch_semaphore_create(0);
+
+    UAEventStore *eventStore = [UAEventStore eventStoreWithConfig:config];
+    [eventStore drainEventsWithBlock:^NSUInteger(NSArray<UAEventData *> *events) {
+        NSMutableArray<UAEventLogStoreEvent *> *eventsToMigrate = [NSMutableArray arrayWithCapacity:events.count];
+        for (UAEventData *eventData in events) {
+            UAEventLogStoreEvent *event = [[UAEventLogStoreEvent alloc] init];
+            event.identifier = eventData.identifier;
+            event.fragment = [eventData uploadFragment];
+            [eventsToMigrate addObject:event];
+        }
+
+        migratedEvents = eventsToMigrate;
+        dispatch_semaphore_signal(drainSemaphore);
+        dispatch_semaphore_wait(appendSemaphore, DISPATCH_TIME_FOREVER);
+        return drainedCount;
+    } completionHandler:^{
+        dispatch_semaphore_signal(drainSemaphore);
+    }];
+
+    // Signaled by the drain block, or only by the completion handler if the store could not be read
+    dispatch_semaphore_wait(drainSemaphore, DISPATCH_TIME_FOREVER);
+    if (!migratedEvents) {
+        return;
+    }
+
+    drainedCount = [self appendMigratedEvents:migratedEvents];
+    dispatch_semaphore_signal(appendSemaphore);
+
+    // Wait for the drained events to be removed from the Core Data store
+    dispatch_semaphore_wait(drainSemaphore, DISPATCH_TIME_FOREVER);
+}
+
+/**
+ * Appends migrated events to the log.
+ *
+ * @param events The events, oldest first.
+ * @return The number of events, from the start of the array, that no longer need to be migrated.
+ */
+- (NSUInteger)appendMigratedEvents:(NSArray<UAEventLogStoreEvent *> *)events {
+    for (NSUInteger i = 0; i < events.count; i++) {
+        if (!events[i].fragment) {
+            // Can never be uploaded, dropped rather than blocking the migration
+            UA_LERR(@"Unable to migrate event %@, invalid event data", events[i].identifier);
+            continue;
+        }
+
+        // Stop at the first failure so the rest stay in the Core Data store, in order, for the next launch
+        if (![self appendEventWithID:events[i].identifier fragment:events[i].fragment]) {
+            return i;
+        }
+    }
+
+    return events.count;
+}
+
+@end
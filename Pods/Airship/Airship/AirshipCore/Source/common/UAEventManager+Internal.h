@@ -3,12 +3,12 @@
 #import <Foundation/Foundation.h>
 #import "UAAppStateTracker.h"
 #import "UAChannel.h"
+#import "UAEventStoreProtocol+Internal.h"
 
 @class UAEvent;
 @class UARuntimeConfig;
 @class UAPreferenceDataStore;
 @class UAEventAPIClient;
-@class UAEventStore;
 
 /**
  * Delegate protocol for the event manager.
@@ -98,7 +98,7 @@
 + (instancetype)eventManagerWithConfig:(UARuntimeConfig *)config
                              dataStore:(UAPreferenceDataStore *)dataStore
                                channel:(UAChannel *)channel
-                            eventStore:(UAEventStore *)eventStore
+                            eventStore:(id<UAEventStoreProtocol>)eventStore
                                 client:(UAEventAPIClient *)client
                                  queue:(NSOperationQueue *)queue
                     notificationCenter:(NSNotificationCenter *)notificationCenter
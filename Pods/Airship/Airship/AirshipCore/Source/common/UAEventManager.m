@@ -4,6 +4,7 @@
 #import "UAEventManager+Internal.h"
 #import "UAPreferenceDataStore+Internal.h"
 #import "UAEventStore+Internal.h"
+#import "UAEventLogStore+Internal.h"
 #import "UAEventData+Internal.h"
 #import "UAAsyncOperation.h"
 #import "UAEventAPIClient+Internal.h"
@@ -14,11 +15,12 @@
 #import "NSOperationQueue+UAAdditions.h"
 #import "UADispatcher.h"
 #import "UAAppStateTracker.h"
+#import "UAMetrics+Internal.h"
 
 @interface UAEventManager()
 
 @property (nonatomic, strong, nonnull) UARuntimeConfig *config;
-@property (nonatomic, strong, nonnull) UAEventStore *eventStore;
+@property (nonatomic, strong, nonnull) id<UAEventStoreProtocol> eventStore;
 @property (nonatomic, strong, nonnull) UAPreferenceDataStore *dataStore;
 @property (nonatomic, strong, nonnull) UAEventAPIClient *client;
 @property (nonatomic, strong, nonnull) NSNotificationCenter *notificationCenter;
@@ -47,7 +49,7 @@ const NSTimeInterval BackgroundLowPriorityEventUploadInterval = 900;
 - (instancetype)initWithConfig:(UARuntimeConfig *)config
                      dataStore:(UAPreferenceDataStore *)dataStore
                        channel:(UAChannel *)channel
-                    eventStore:(UAEventStore *)eventStore
+                    eventStore:(id<UAEventStoreProtocol>)eventStore
                         client:(UAEventAPIClient *)client
                          queue:(NSOperationQueue *)queue
             notificationCenter:(NSNotificationCenter *)notificationCenter
@@ -99,7 +101,13 @@ const NSTimeInterval BackgroundLowPriorityEventUploadInterval = 900;
 + (instancetype)eventManagerWithConfig:(UARuntimeConfig *)config
                              dataStore:(UAPreferenceDataStore *)dataStore
                                channel:(UAChannel *)channel {
-    UAEventStore *eventStore = [UAEventStore eventStoreWithConfig:config];
+    id<UAEventStoreProtocol> eventStore;
+    if (config.analyticsEventLogEnabled) {
+        eventStore = [UAEventLogStore eventLogStoreWithConfig:config];
+    } else {
+        eventStore = [UAEventStore eventStoreWithConfig:config];
+    }
+
     UAEventAPIClient *client = [UAEventAPIClient clientWithConfig:config];
 
     NSOperationQueue *queue = [[NSOperationQueue alloc] init];
@@ -119,7 +127,7 @@ const NSTimeInterval BackgroundLowPriorityEventUploadInterval = 900;
 + (instancetype)eventManagerWithConfig:(UARuntimeConfig *)config
                              dataStore:(UAPreferenceDataStore *)dataStore
                                channel:(UAChannel *)channel
-                            eventStore:(UAEventStore *)eventStore
+                            eventStore:(id<UAEventStoreProtocol>)eventStore
                                 client:(UAEventAPIClient *)client
                                  queue:(NSOperationQueue *)queue
                     notificationCenter:(NSNotificationCenter *)notificationCenter
@@ -352,7 +360,7 @@ const NSTimeInterval BackgroundLowPriorityEventUploadInterval = 900;
         [self.eventStore trimEventsToStoreSize:self.maxTotalDBSize];
 
         // Fetch events
-        [self.eventStore fetchEventsWithMaxBatchSize:self.maxBatchSize completionHandler:^(NSArray<UAEventData *> *result) {
+        [self.eventStore fetchEventsWithMaxBatchSize:self.maxBatchSize completionHandler:^(NSArray<id<UAEventStoreEvent>> *result) {
 
             // Make sure we are not cancelled
             if (operation.isCancelled) {
@@ -365,25 +373,32 @@ const NSTimeInterval BackgroundLowPriorityEventUploadInterval = 900;
                 return;
             }
 
-            NSMutableArray *preparedEvents = [NSMutableArray arrayWithCapacity:result.count];
+            NSMutableArray<NSData *> *fragments = [NSMutableArray arrayWithCapacity:result.count];
+            NSMutableArray<NSString *> *eventIDs = [NSMutableArray arrayWithCapacity:result.count];
+            NSMutableArray<NSString *> *corruptEventIDs = [NSMutableArray array];
 
-            for (UAEventData *eventData in result) {
-                NSMutableDictionary *eventBody = [NSMutableDictionary dictionary];
-                [eventBody setValue:eventData.identifier forKey:@"event_id"];
-                [eventBody setValue:eventData.time forKey:@"time"];
-                [eventBody setValue:eventData.type forKey:@"type"];
+            for (id<UAEventStoreEvent> eventData in result) {
+                NSData *fragment = [eventData uploadFragment];
+                if (!fragment) {
+                    if (eventData.identifier) {
+                        [corruptEventIDs addObject:eventData.identifier];
+                    }
+                    continue;
+                }
 
-                NSError *error = nil;
-                NSMutableDictionary *data = [[NSJSONSerialization JSONObjectWithData:eventData.data options:0 error:&error] mutableCopy];
-                if (error) {
-                    UA_LERR(@"Failed to deserialize event %@: %@", eventData, error);
-                    [[eventData managedObjectContext] deleteObject:eventData];
+                [fragments addObject:fragment];
+                if (eventData.identifier) {
+                    [eventIDs addObject:eventData.identifier];
                 }
+            }
 
-                [data setValue:eventData.sessionID forKey:@"session_id"];
-                [eventBody setValue:data forKey:@"data"];
+            if (corruptEventIDs.count) {
+                [self.eventStore deleteEventsWithIDs:corruptEventIDs];
+            }
 
-                [preparedEvents addObject:eventBody];
+            if (!fragments.count) {
+                [operation finish];
+                return;
             }
 
             // Make sure we are not cancelled
@@ -405,18 +420,24 @@ const NSTimeInterval BackgroundLowPriorityEventUploadInterval = 900;
                 NSDictionary *headers = [self.delegate analyticsHeaders] ?: @{};
 
                 UA_STRONGIFY(self);
-                [self.client uploadEvents:preparedEvents headers:headers completionHandler:^(NSHTTPURLResponse *response) {
+                UAMetricsSpan span = UAMetricsSpanBegin(UAMetricsHistogramEventUpload);
+                UAMetricsIncrement(UAMetricsCounterEventUploadBatches, 1);
+
+                [self.client uploadEventFragments:fragments headers:headers completionHandler:^(NSHTTPURLResponse *response) {
 
                     UA_STRONGIFY(self);
+                    UAMetricsSpanEnd(span);
                     self.lastSendTime = [NSDate date];
 
                     if (response.statusCode == 200) {
                         UA_LTRACE(@"Analytic upload success");
                         UA_LTRACE(@"Response: %@", response);
-                        [self.eventStore deleteEventsWithIDs:[preparedEvents valueForKey:@"event_id"]];
+                        UAMetricsIncrement(UAMetricsCounterEventsUploaded, fragments.count);
+                        [self.eventStore deleteEventsWithIDs:eventIDs];
                         [self updateAnalyticsParametersWithResponse:response];
                     } else {
                         UA_LTRACE(@"Analytics upload request failed: %ld", (unsigned long)response.statusCode);
+                        UAMetricsIncrement(UAMetricsCounterEventUploadFailures, 1);
                         [self scheduleUploadWithDelay:FailedUploadRetryDelay];
                     }
 
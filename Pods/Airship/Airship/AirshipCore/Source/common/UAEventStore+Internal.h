@@ -2,14 +2,15 @@
 
 #import <Foundation/Foundation.h>
 #import "UAEventData+Internal.h"
+#import "UAEventStoreProtocol+Internal.h"
 
 @class UAEvent;
 @class UARuntimeConfig;
 
 /**
- * Storage access for analytic events.
+ * Core Data storage access for analytic events.
  */
-@interface UAEventStore : NSObject
+@interface UAEventStore : NSObject <UAEventStoreProtocol>
 
 ///---------------------------------------------------------------------------------------
 /// @name Event Store Internal Methods
@@ -24,38 +25,38 @@
 + (instancetype)eventStoreWithConfig:(UARuntimeConfig *)config;
 
 /**
- * Saves an event.
+ * Factory method. Used for testing. The pre Core Data database is not migrated.
  *
- * @param event The event to store.
- * @param sessionID The event's session ID.
+ * @param storeName The store file name.
+ * @return UAEventStore instance.
  */
-- (void)saveEvent:(UAEvent *)event sessionID:(NSString *)sessionID;
++ (instancetype)eventStoreWithStoreName:(NSString *)storeName;
 
 /**
- * Fetches a batch of events.
+ * Indicates whether the Core Data store file exists for the config.
  *
- * @param maxBatchSize The max event batch size.
- * @param completionHandler A completion handler with the event data.
+ * @param config The airship config.
+ * @return `YES` if the store file exists, otherwise `NO`.
  */
-- (void)fetchEventsWithMaxBatchSize:(NSUInteger)maxBatchSize
-                  completionHandler:(void (^)(NSArray<UAEventData *> *))completionHandler;
++ (BOOL)persistentStoreExistsWithConfig:(UARuntimeConfig *)config;
 
 /**
- * Deletes a set of events.
+ * Migrates the events in the pre Core Data SQLite database, if it exists, then deletes the database.
  *
- * @param eventIds The event IDs to delete.
- */
-- (void)deleteEventsWithIDs:(NSArray<NSString *> *)eventIds;
-
-/**
- * Deletes event session until the underlying store is below a given size.
- * @param bytes The desired size in bytes for the store size.
+ * @param eventHandler Called with each migrated event, in the order the events were stored.
  */
-- (void)trimEventsToStoreSize:(NSUInteger)bytes;
++ (void)migrateOldDatabaseWithEventHandler:(void (^)(NSString *eventID, NSString *eventType, NSString *eventTime, id eventBody, NSString *sessionID))eventHandler;
 
 /**
- * Deletes all events in the event store.
+ * Hands all events to a block, oldest first, then destroys the persistent store once every event was
+ * drained. Used to migrate the events to another backend. If the block drains fewer events, only those
+ * are deleted and the store is kept so the rest can be drained later.
+ *
+ * @param block The block, called on the store's queue while the events are valid. Returns the number
+ * of events, from the start of the array, that were drained.
+ * @param completionHandler Called once the drained events are removed.
  */
-- (void)deleteAllEvents;
+- (void)drainEventsWithBlock:(NSUInteger (^)(NSArray<UAEventData *> *events))block
+           completionHandler:(void (^)(void))completionHandler;
 
 @end
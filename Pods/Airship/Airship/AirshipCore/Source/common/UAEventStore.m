@@ -10,6 +10,7 @@
 #import "UAEvent.h"
 #import "UAirship.h"
 #import "UASQLite+Internal.h"
+#import "UAMetrics+Internal.h"
 #import "UAJSONSerialization.h"
 #import "UAirshipCoreResources.h"
 
@@ -19,16 +20,18 @@ NSString *const UAEventDataEntityName = @"UAEventData";
 @interface UAEventStore ()
 @property (nonatomic, strong) NSManagedObjectContext *managedContext;
 @property (nonatomic, copy) NSString *storeName;
+@property (nonatomic, assign) BOOL migratesOldDatabase;
 
 @end
 
 @implementation UAEventStore
 
-- (instancetype)initWithConfig:(UARuntimeConfig *)config {
+- (instancetype)initWithStoreName:(NSString *)storeName migrateOldDatabase:(BOOL)migrateOldDatabase {
     self = [super init];
 
     if (self) {
-        self.storeName = [NSString stringWithFormat:UAEventStoreFileFormat, config.appKey];
+        self.storeName = storeName;
+        self.migratesOldDatabase = migrateOldDatabase;
         NSURL *modelURL = [[UAirshipCoreResources bundle] URLForResource:@"UAEvents" withExtension:@"momd"];
         self.managedContext = [NSManagedObjectContext managedObjectContextForModelURL:modelURL
                                                                       concurrencyType:NSPrivateQueueConcurrencyType];
@@ -40,7 +43,27 @@ NSString *const UAEventDataEntityName = @"UAEventData";
 }
 
 + (instancetype)eventStoreWithConfig:(UARuntimeConfig *)config {
-    return [[UAEventStore alloc] initWithConfig:config];
+    return [[UAEventStore alloc] initWithStoreName:[NSString stringWithFormat:UAEventStoreFileFormat, config.appKey]
+                                 migrateOldDatabase:YES];
+}
+
++ (instancetype)eventStoreWithStoreName:(NSString *)storeName {
+    return [[UAEventStore alloc] initWithStoreName:storeName migrateOldDatabase:NO];
+}
+
++ (BOOL)persistentStoreExistsWithConfig:(UARuntimeConfig *)config {
+    NSFileManager *fileManager = [NSFileManager defaultManager];
+    NSString *storeName = [NSString stringWithFormat:UAEventStoreFileFormat, config.appKey];
+
+    for (NSNumber *directory in @[@(NSLibraryDirectory), @(NSCachesDirectory)]) {
+        NSURL *directoryURL = [[fileManager URLsForDirectory:directory.unsignedIntegerValue inDomains:NSUserDomainMask] lastObject];
+        NSURL *storeURL = [[directoryURL URLByAppendingPathComponent:UAManagedContextStoreDirectory] URLByAppendingPathComponent:storeName];
+        if ([fileManager fileExistsAtPath:storeURL.path]) {
+            return YES;
+        }
+    }
+
+    return NO;
 }
 
 - (void)addPersistentStore {
@@ -52,7 +75,9 @@ NSString *const UAEventDataEntityName = @"UAEventData";
             return;
         }
 
-        [self migrateOldDatabase];
+        if (self.migratesOldDatabase) {
+            [self migrateOldDatabase];
+        }
     }];
 
 }
@@ -69,6 +94,8 @@ NSString *const UAEventDataEntityName = @"UAEventData";
             return;
         }
 
+        UA_METRICS_SCOPED_SPAN(UAMetricsHistogramEventStoreWrite);
+
         [self storeEventWithID:event.eventID
                      eventType:event.eventType
                      eventTime:event.time
@@ -76,11 +103,12 @@ NSString *const UAEventDataEntityName = @"UAEventData";
                      sessionID:sessionID];
 
         [self.managedContext safeSave];
+        UAMetricsIncrement(UAMetricsCounterEventsStored, 1);
     }];
 }
 
 - (void)fetchEventsWithMaxBatchSize:(NSUInteger)maxBatchSize
-                  completionHandler:(void (^)(NSArray<UAEventData *> *))completionHandler {
+                  completionHandler:(void (^)(NSArray<id<UAEventStoreEvent>> *))completionHandler {
 
 
     [self.managedContext safePerformBlock:^(BOOL isSafe) {
@@ -172,6 +200,18 @@ NSString *const UAEventDataEntityName = @"UAEventData";
 }
 
 - (void)migrateOldDatabase {
+    [UAEventStore migrateOldDatabaseWithEventHandler:^(NSString *eventID, NSString *eventType, NSString *eventTime, id eventBody, NSString *sessionID) {
+        [self storeEventWithID:eventID
+                     eventType:eventType
+                     eventTime:eventTime
+                     eventBody:eventBody
+                     sessionID:sessionID];
+    }];
+
+    [self.managedContext safeSave];
+}
+
++ (void)migrateOldDatabaseWithEventHandler:(void (^)(NSString *, NSString *, NSString *, id, NSString *))eventHandler {
     NSString *libraryPath = [NSSearchPathForDirectoriesInDomains(NSLibraryDirectory, NSUserDomainMask, YES) lastObject];
     NSString *writableDBPath = [libraryPath stringByAppendingPathComponent:@"UAAnalyticsDB"];
 
@@ -212,11 +252,7 @@ NSString *const UAEventDataEntityName = @"UAEventData";
                 continue;
             }
 
-            [self storeEventWithID:event[@"event_id"]
-                         eventType:event[@"type"]
-                         eventTime:event[@"time"]
-                         eventBody:data
-                         sessionID:event[@"session_id"]];
+            eventHandler(event[@"event_id"], event[@"type"], event[@"time"], data, event[@"session_id"]);
 
             // delete
             [db executeUpdate:@"DELETE FROM analytics WHERE event_id = ?", [event objectForKey:@"event_id"]];
@@ -230,14 +266,63 @@ NSString *const UAEventDataEntityName = @"UAEventData";
 
     [db close];
     [[NSFileManager defaultManager] removeItemAtPath:writableDBPath error:nil];
+}
 
-    [self.managedContext safeSave];
+- (void)drainEventsWithBlock:(NSUInteger (^)(NSArray<UAEventData *> *))block
+           completionHandler:(void (^)(void))completionHandler {
+    [self.managedContext safePerformBlock:^(BOOL isSafe) {
+        if (!isSafe) {
+            completionHandler();
+            return;
+        }
+
+        NSFetchRequest *request = [NSFetchRequest fetchRequestWithEntityName:UAEventDataEntityName];
+        request.sortDescriptors = @[ [NSSortDescriptor sortDescriptorWithKey:@"storeDate" ascending:YES] ];
+
+        NSError *error;
+        NSArray *result = [self.managedContext executeFetchRequest:request error:&error];
+        if (error) {
+            // Leave the store in place so the events are not lost
+            UA_LERR(@"Error fetching events to drain %@", error);
+            completionHandler();
+            return;
+        }
+
+        NSUInteger drainedCount = block(result);
+        if (drainedCount < result.count) {
+            // Only the drained events are removed, the store is kept for the rest
+            UA_LERR(@"Unable to drain %lu events, keeping analytic event store", (unsigned long)(result.count - drainedCount));
+            for (NSUInteger i = 0; i < drainedCount; i++) {
+                [self.managedContext deleteObject:result[i]];
+            }
+
+            [self.managedContext safeSave];
+            completionHandler();
+            return;
+        }
+
+        NSPersistentStoreCoordinator *coordinator = self.managedContext.persistentStoreCoordinator;
+        for (NSPersistentStore *store in [coordinator.persistentStores copy]) {
+            [coordinator removePersistentStore:store error:nil];
+            if (![coordinator destroyPersistentStoreAtURL:store.URL withType:store.type options:store.options error:&error]) {
+                UA_LERR(@"Error destroying analytic event store %@", error);
+            }
+        }
+
+        completionHandler();
+    }];
 }
 
 - (void)storeEventWithID:(NSString *)eventID eventType:(NSString *)eventType eventTime:(NSString *)eventTime eventBody:(id)eventBody sessionID:(NSString *)sessionID {
+    // Serialize the full upload fragment once so uploads never have to re-parse the event
     NSError *error;
-    id json = [UAJSONSerialization dataWithJSONObject:eventBody options:0 error:&error];
-    if (error) {
+    NSData *fragment = [UAEventData uploadFragmentWithID:eventID
+                                                    type:eventType
+                                                    time:eventTime
+                                                    body:eventBody
+                                               sessionID:sessionID
+                                                   error:&error];
+    if (error || !fragment) {
         UA_LERR(@"Unable to save event. %@", error);
         return;
     }
@@ -249,11 +334,12 @@ NSString *const UAEventDataEntityName = @"UAEventData";
     eventData.type = eventType;
     eventData.time = eventTime;
     eventData.identifier = eventID;
-    eventData.data = json;
+    eventData.data = fragment;
+    eventData.envelope = @YES;
     eventData.storeDate = [NSDate date];
 
-    // Approximate size
-    eventData.bytes = @(eventData.sessionID.length + eventData.type.length + eventData.time.length + eventData.identifier.length + eventData.data.length);
+    // The fragment already contains every field
+    eventData.bytes = @(eventData.data.length);
 
     UA_LTRACE(@"Event saved: %@", eventID);
 }
@@ -0,0 +1,83 @@
+/* Copyright Airship and Contributors */
+
+#import <Foundation/Foundation.h>
+
+@class UAEvent;
+
+NS_ASSUME_NONNULL_BEGIN
+
+//---------------------------------------------------------------------------------------
+// UAEventStoreProtocol Protocol
+//---------------------------------------------------------------------------------------
+
+/**
+ * A stored analytics event, as returned by an event store.
+ */
+@protocol UAEventStoreEvent <NSObject>
+
+@required
+
+/**
+ * The event's identifier.
+ */
+@property (nonatomic, readonly, nullable) NSString *identifier;
+
+/**
+ * The JSON upload fragment for this event.
+ *
+ * @return The serialized fragment, or `nil` if the stored data is corrupt.
+ */
+- (nullable NSData *)uploadFragment;
+
+@end
+
+/**
+ * Protocol to be implemented by analytics event store backends.
+ */
+@protocol UAEventStoreProtocol <NSObject>
+
+///---------------------------------------------------------------------------------------
+/// @name Event Store Protocol Internal Methods
+///---------------------------------------------------------------------------------------
+
+@required
+
+/**
+ * Saves an event.
+ *
+ * @param event The event to store.
+ * @param sessionID The event's session ID.
+ */
+- (void)saveEvent:(UAEvent *)event sessionID:(NSString *)sessionID;
+
+/**
+ * Fetches a batch of events.
+ *
+ * @param maxBatchSize The max event batch size in bytes.
+ * @param completionHandler A completion handler with the events.
+ */
+- (void)fetchEventsWithMaxBatchSize:(NSUInteger)maxBatchSize
+                  completionHandler:(void (^)(NSArray<id<UAEventStoreEvent>> *))completionHandler;
+
+/**
+ * Deletes a set of events.
+ *
+ * @param eventIds The event IDs to delete.
+ */
+- (void)deleteEventsWithIDs:(NSArray<NSString *> *)eventIds;
+
+/**
+ * Deletes the oldest events until the underlying store is below a given size.
+ *
+ * @param bytes The desired size in bytes for the store size.
+ */
+- (void)trimEventsToStoreSize:(NSUInteger)bytes;
+
+/**
+ * Deletes all events in the event store.
+ */
+- (void)deleteAllEvents;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,82 @@
+/* Copyright Airship and Contributors */
+
+#import <Foundation/Foundation.h>
+#import "UARequest.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * Incrementally gzip compresses data as it is appended, so a request body can be
+ * built without first materializing the full uncompressed payload.
+ *
+ * Deflate streams and their output buffers are pooled and reused by later writers once
+ * a writer finishes.
+ * @note For internal use only. :nodoc:
+ */
+@interface UAGzipWriter : NSObject <UARequestBodyWriter>
+
+///---------------------------------------------------------------------------------------
+/// @name Gzip Writer Internal Properties
+///---------------------------------------------------------------------------------------
+
+/**
+ * The number of uncompressed bytes appended so far.
+ */
+@property (nonatomic, readonly) NSUInteger uncompressedLength;
+
+///---------------------------------------------------------------------------------------
+/// @name Gzip Writer Internal Methods
+///---------------------------------------------------------------------------------------
+
+/**
+ * Factory method.
+ *
+ * @return A gzip writer, or `nil` if the deflate stream could not be initialized.
+ */
++ (nullable instancetype)writer;
+
+/**
+ * Factory method. The compression level is picked from the expected length: small payloads
+ * favor speed since the gzip framing dominates, and large payloads trade some ratio for speed.
+ *
+ * @param expectedLength The expected uncompressed length, or 0 if unknown.
+ * @return A gzip writer, or `nil` if the deflate stream could not be initialized.
+ */
++ (nullable instancetype)writerWithExpectedLength:(NSUInteger)expectedLength;
+
+/**
+ * Gzip compresses data.
+ *
+ * @param data The data.
+ * @return The compressed data, or `nil` if compression failed or the data is empty.
+ */
++ (nullable NSData *)gzipData:(NSData *)data;
+
+/**
+ * Compresses and appends bytes.
+ *
+ * @param bytes The bytes.
+ * @param length The number of bytes.
+ * @return `YES` on success, `NO` if the deflate stream failed or the writer is already finished.
+ */
+- (BOOL)appendBytes:(const void *)bytes length:(NSUInteger)length;
+
+/**
+ * Compresses and appends data.
+ *
+ * @param data The data.
+ * @return `YES` on success, `NO` if the deflate stream failed or the writer is already finished.
+ */
+- (BOOL)appendData:(NSData *)data;
+
+/**
+ * Finishes the gzip stream and returns the deflate stream to the pool. The writer can not be
+ * appended to afterwards.
+ *
+ * @return The compressed data, or `nil` if compression failed or nothing was appended.
+ */
+- (nullable NSData *)finish;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,271 @@
+/* Copyright Airship and Contributors */
+
+#import <zlib.h>
+
+#import "UAGzipWriter+Internal.h"
+
+// Initial size of a context's output buffer. Buffers double when full.
+#define kUAGzipWriterInitialBufferSize 32768
+
+// 15 window bits + 16 selects the gzip wrapper
+#define kUAGzipWriterWindowBits (15 + 16)
+
+// Number of idle deflate contexts kept for reuse
+#define kUAGzipWriterMaxPooledContexts 2
+
+// Output buffers larger than this are released instead of pooled
+#define kUAGzipWriterMaxPooledBufferSize (512 * 1024)
+
+// Below this size the gzip framing dominates, so favor speed
+#define kUAGzipWriterSmallPayloadLength 1024
+
+// Above this size deflate time dominates, so trade some ratio for speed
+#define kUAGzipWriterLargePayloadLength (256 * 1024)
+
+#define kUAGzipWriterLargePayloadLevel 3
+
+/**
+ * A deflate stream and its output buffer. Contexts are reset and pooled after a writer
+ * finishes so subsequent requests skip the deflate allocation and buffer growth.
+ */
+@interface UAGzipDeflateContext : NSObject {
+    @public
+    z_stream _stream;
+}
+@property (nonatomic, strong) NSMutableData *buffer;
+@property (nonatomic, assign) int level;
+@end
+
+@implementation UAGzipDeflateContext
+
+- (instancetype)initWithLevel:(int)level {
+    self = [super init];
+
+    if (self) {
+        _stream.zalloc = Z_NULL;
+        _stream.zfree = Z_NULL;
+        _stream.opaque = Z_NULL;
+
+        if (deflateInit2(&_stream, level, Z_DEFLATED, kUAGzipWriterWindowBits, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+            return nil;
+        }
+
+        self.level = level;
+        self.buffer = [NSMutableData dataWithLength:kUAGzipWriterInitialBufferSize];
+    }
+
+    return self;
+}
+
+- (void)dealloc {
+    deflateEnd(&_stream);
+}
+
+- (BOOL)resetWithLevel:(int)level {
+    if (deflateReset(&_stream) != Z_OK) {
+        return NO;
+    }
+
+    // No input has been written since the reset, so changing parameters does not flush anything
+    if (level != self.level) {
+        if (deflateParams(&_stream, level, Z_DEFAULT_STRATEGY) != Z_OK) {
+            return NO;
+        }
+        self.level = level;
+    }
+
+    return YES;
+}
+
+@end
+
+@interface UAGzipWriter ()
+@property (nonatomic, strong) UAGzipDeflateContext *context;
+@property (nonatomic, assign) NSUInteger uncompressedLength;
+@property (nonatomic, assign) BOOL finished;
+@property (nonatomic, assign) BOOL failed;
+@end
+
+@implementation UAGzipWriter
+
+- (instancetype)initWithContext:(UAGzipDeflateContext *)context {
+    self = [super init];
+
+    if (self) {
+        self.context = context;
+    }
+
+    return self;
+}
+
++ (instancetype)writer {
+    return [self writerWithExpectedLength:0];
+}
+
++ (instancetype)writerWithExpectedLength:(NSUInteger)expectedLength {
+    UAGzipDeflateContext *context = [self dequeueContextWithLevel:[self compressionLevelForLength:expectedLength]];
+    if (!context) {
+        return nil;
+    }
+
+    // Size the buffer for the worst case up front so the expected payload never grows it
+    if (expectedLength) {
+        NSUInteger bound = deflateBound(&context->_stream, (uLong)expectedLength);
+        if (context.buffer.length < bound) {
+            context.buffer.length = bound;
+        }
+    }
+
+    return [[self alloc] initWithContext:context];
+}
+
++ (int)compressionLevelForLength:(NSUInteger)length {
+    if (length && length < kUAGzipWriterSmallPayloadLength) {
+        return Z_BEST_SPEED;
+    }
+
+    if (length > kUAGzipWriterLargePayloadLength) {
+        return kUAGzipWriterLargePayloadLevel;
+    }
+
+    return Z_DEFAULT_COMPRESSION;
+}
+
++ (NSData *)gzipData:(NSData *)data {
+    UAGzipWriter *writer = [self writerWithExpectedLength:data.length];
+    [writer appendData:data];
+    return [writer finish];
+}
+
+- (BOOL)appendData:(NSData *)data {
+    return [self appendBytes:data.bytes length:data.length];
+}
+
+- (BOOL)appendBytes:(const void *)bytes length:(NSUInteger)length {
+    if (self.finished || self.failed) {
+        return NO;
+    }
+
+    if (!length) {
+        return YES;
+    }
+
+    z_stream *stream = &self.context->_stream;
+    stream->next_in = (Bytef *)bytes;
+    stream->avail_in = (uInt)length;
+
+    if (![self deflateWithFlush:Z_NO_FLUSH]) {
+        return NO;
+    }
+
+    self.uncompressedLength += length;
+    return YES;
+}
+
+- (NSData *)finish {
+    if (self.finished) {
+        return nil;
+    }
+
+    self.finished = YES;
+
+    z_stream *stream = &self.context->_stream;
+    stream->next_in = Z_NULL;
+    stream->avail_in = 0;
+
+    BOOL success = !self.failed && [self deflateWithFlush:Z_FINISH];
+
+    NSData *compressed = nil;
+    if (success && self.uncompressedLength) {
+        // One exact-size copy instead of handing out the pooled buffer
+        compressed = [NSData dataWithBytes:self.context.buffer.bytes length:stream->total_out];
+    }
+
+    // A failed stream is left mid-deflate, so it is released instead of pooled
+    if (success) {
+        [UAGzipWriter enqueueContext:self.context];
+    }
+
+    self.context = nil;
+    return compressed;
+}
+
+- (BOOL)deflateWithFlush:(int)flush {
+    z_stream *stream = &self.context->_stream;
+    NSMutableData *buffer = self.context.buffer;
+
+    int status;
+    do {
+        // Grow geometrically so a stream that outgrows its estimate is copied a logarithmic number of times
+        if (stream->total_out >= buffer.length) {
+            buffer.length = buffer.length * 2;
+        }
+
+        stream->next_out = (Bytef *)buffer.mutableBytes + stream->total_out;
+        stream->avail_out = (uInt)(buffer.length - stream->total_out);
+
+        status = deflate(stream, flush);
+
+        if (status == Z_STREAM_ERROR) {
+            self.failed = YES;
+            return NO;
+        }
+    } while (stream->avail_out == 0 || (flush == Z_FINISH && status != Z_STREAM_END));
+
+    return YES;
+}
+
+#pragma mark -
+#pragma mark Context Pool
+
++ (NSMutableArray<UAGzipDeflateContext *> *)contextPool {
+    static dispatch_once_t onceToken;
+    static NSMutableArray *pool;
+
+    dispatch_once(&onceToken, ^{
+        pool = [NSMutableArray array];
+    });
+
+    return pool;
+}
+
++ (UAGzipDeflateContext *)dequeueContextWithLevel:(int)level {
+    NSMutableArray<UAGzipDeflateContext *> *pool = [self contextPool];
+    UAGzipDeflateContext *context = nil;
+
+    @synchronized (pool) {
+        // Prefer a context already at the requested level to skip deflateParams
+        for (UAGzipDeflateContext *pooled in pool) {
+            if (pooled.level == level) {
+                context = pooled;
+                break;
+            }
+        }
+
+        context = context ?: pool.lastObject;
+        if (context) {
+            [pool removeObjectIdenticalTo:context];
+        }
+    }
+
+    if (context && [context resetWithLevel:level]) {
+        return context;
+    }
+
+    return [[UAGzipDeflateContext alloc] initWithLevel:level];
+}
+
++ (void)enqueueContext:(UAGzipDeflateContext *)context {
+    if (context.buffer.length > kUAGzipWriterMaxPooledBufferSize) {
+        return;
+    }
+
+    NSMutableArray<UAGzipDeflateContext *> *pool = [self contextPool];
+    @synchronized (pool) {
+        if (pool.count < kUAGzipWriterMaxPooledContexts) {
+            [pool addObject:context];
+        }
+    }
+}
+
+@end
@@ -0,0 +1,24 @@
+/* Copyright Airship and Contributors */
+
+#import "UAJSONPredicate.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface UAJSONPredicate ()
+
+///---------------------------------------------------------------------------------------
+/// @name JSON Predicate Internal Methods
+///---------------------------------------------------------------------------------------
+
+/**
+ * Evaluates the predicate by walking the predicate tree instead of running the compiled program.
+ * Used for testing.
+ *
+ * @param object The object to evaluate.
+ * @return `YES` if the object matches, otherwise `NO`.
+ */
+- (BOOL)evaluateTreeWithObject:(nullable id)object;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -1,12 +1,16 @@
 /* Copyright Airship and Contributors */
 
-#import "UAJSONPredicate.h"
+#import "UAJSONPredicate+Internal.h"
 #import "UAJSONMatcher.h"
+#import "UAJSONPredicateProgram+Internal.h"
 
 @interface UAJSONPredicate()
 @property (nonatomic, copy) NSString *type;
 @property (nonatomic, copy) NSArray *subpredicates;
 @property (nonatomic, strong) UAJSONMatcher *jsonMatcher;
+
+// Compiled on first evaluation
+@property (atomic, strong) UAJSONPredicateProgram *program;
 @end
 
 NSString *const UAJSONPredicateAndType = @"and";
@@ -46,10 +50,21 @@ NSString * const UAJSONPredicateErrorDomain = @"com.urbanairship.json_predicate"
 }
 
 - (BOOL)evaluateObject:(id)object {
+    UAJSONPredicateProgram *program = self.program;
+    if (!program) {
+        // Compiling twice on a race is harmless, the programs are identical
+        program = [UAJSONPredicateProgram programWithPredicate:self];
+        self.program = program;
+    }
+
+    return [program evaluateObject:object];
+}
+
+- (BOOL)evaluateTreeWithObject:(id)object {
     // And
     if ([self.type isEqualToString:UAJSONPredicateAndType]) {
         for (UAJSONPredicate *predicate in self.subpredicates) {
-            if (![predicate evaluateObject:object]) {
+            if (![predicate evaluateTreeWithObject:object]) {
                 return NO;
             }
         }
@@ -59,7 +74,7 @@ NSString * const UAJSONPredicateErrorDomain = @"com.urbanairship.json_predicate"
     // Or
     if ([self.type isEqualToString:UAJSONPredicateOrType]) {
         for (UAJSONPredicate *predicate in self.subpredicates) {
-            if ([predicate evaluateObject:object]) {
+            if ([predicate evaluateTreeWithObject:object]) {
                 return YES;
             }
         }
@@ -69,7 +84,7 @@ NSString * const UAJSONPredicateErrorDomain = @"com.urbanairship.json_predicate"
     // Not
     if ([self.type isEqualToString:UAJSONPredicateNotType]) {
         // The factory methods prevent NOT from ever having more than 1 predicate
-        return ![[self.subpredicates firstObject] evaluateObject:object];
+        return ![[self.subpredicates firstObject] evaluateTreeWithObject:object];
     }
 
     // Matcher
@@ -0,0 +1,58 @@
+/* Copyright Airship and Contributors */
+
+#import <Foundation/Foundation.h>
+
+@class UAJSONPredicate;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * A JSON predicate compiled into a flat instruction sequence.
+ *
+ * Key paths are interned into a path table and constants are normalized at compile time, so evaluating
+ * the program walks the instructions without re-reading the predicate JSON or allocating. And, or and
+ * not are compiled into short-circuit jumps. Array predicates are compiled into nested programs.
+ */
+@interface UAJSONPredicateProgram : NSObject
+
+///---------------------------------------------------------------------------------------
+/// @name JSON Predicate Program Internal Properties
+///---------------------------------------------------------------------------------------
+
+/**
+ * The number of instructions, not including nested programs.
+ */
+@property (nonatomic, readonly) NSUInteger instructionCount;
+
+///---------------------------------------------------------------------------------------
+/// @name JSON Predicate Program Internal Methods
+///---------------------------------------------------------------------------------------
+
+/**
+ * Compiles a predicate.
+ *
+ * @param predicate The predicate.
+ * @return The compiled program.
+ */
++ (instancetype)programWithPredicate:(UAJSONPredicate *)predicate;
+
+/**
+ * Compiles predicate JSON. The JSON is validated the same way as `UAJSONPredicate predicateWithJSON:error:`.
+ *
+ * @param json The predicate JSON.
+ * @param error The error if the JSON is invalid.
+ * @return The compiled program, or `nil` if the JSON is invalid.
+ */
++ (nullable instancetype)programWithJSON:(id)json error:(NSError * _Nullable *)error;
+
+/**
+ * Evaluates the program against an object.
+ *
+ * @param object The object, usually an event payload.
+ * @return `YES` if the object matches, otherwise `NO`.
+ */
+- (BOOL)evaluateObject:(nullable id)object;
+
+@end
+
+NS_ASSUME_NONNULL_END
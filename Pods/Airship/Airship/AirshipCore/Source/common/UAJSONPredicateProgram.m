@@ -0,0 +1,431 @@
+/* Copyright Airship and Contributors */
+
+#import "UAJSONPredicateProgram+Internal.h"
+#import "UAJSONPredicate.h"
+#import "UAJSONMatcher.h"
+#import "UAJSONValueMatcher.h"
+#import "UAVersionMatcher.h"
+
+// Predicate and matcher payload keys, see UAJSONPredicate, UAJSONMatcher and UAJSONValueMatcher
+static NSString * const UAJSONPredicateProgramAndKey = @"and";
+static NSString * const UAJSONPredicateProgramOrKey = @"or";
+static NSString * const UAJSONPredicateProgramNotKey = @"not";
+static NSString * const UAJSONPredicateProgramKeyKey = @"key";
+static NSString * const UAJSONPredicateProgramScopeKey = @"scope";
+static NSString * const UAJSONPredicateProgramValueKey = @"value";
+static NSString * const UAJSONPredicateProgramIgnoreCaseKey = @"ignore_case";
+static NSString * const UAJSONPredicateProgramEqualsKey = @"equals";
+static NSString * const UAJSONPredicateProgramAtLeastKey = @"at_least";
+static NSString * const UAJSONPredicateProgramAtMostKey = @"at_most";
+static NSString * const UAJSONPredicateProgramIsPresentKey = @"is_present";
+static NSString * const UAJSONPredicateProgramVersionKey = @"version_matches";
+static NSString * const UAJSONPredicateProgramArrayContainsKey = @"array_contains";
+static NSString * const UAJSONPredicateProgramArrayIndexKey = @"index";
+
+/**
+ * Program opcodes. Instructions read and write two registers: the value being matched and the result.
+ */
+typedef NS_ENUM(uint8_t, UAJSONPredicateOpcode) {
+    // value = the evaluated object resolved through paths[operand]
+    UAJSONPredicateOpcodeLoad,
+
+    // result = YES
+    UAJSONPredicateOpcodeTrue,
+
+    // result = (value != nil) == operand
+    UAJSONPredicateOpcodeIsPresent,
+
+    // result = value is equal to constants[operand]
+    UAJSONPredicateOpcodeEquals,
+
+    // result = value is a string equal to constants[operand], ignoring case
+    UAJSONPredicateOpcodeEqualsStringIgnoreCase,
+
+    // result = value is equal to the array or dictionary constants[operand], ignoring case of nested strings
+    UAJSONPredicateOpcodeEqualsIgnoreCase,
+
+    // result = value is a number >= constants[operand]
+    UAJSONPredicateOpcodeAtLeast,
+
+    // result = value is a number <= constants[operand]
+    UAJSONPredicateOpcodeAtMost,
+
+    // result = value is a string matched by the version matcher constants[operand]
+    UAJSONPredicateOpcodeVersion,
+
+    // result = value is an array with an element matched by the program constants[operand]
+    UAJSONPredicateOpcodeArrayContains,
+
+    // result = value is an array whose element at argument is matched by the program constants[operand]
+    UAJSONPredicateOpcodeArrayContainsAtIndex,
+
+    // result = !result
+    UAJSONPredicateOpcodeNot,
+
+    // if !result, jump to operand
+    UAJSONPredicateOpcodeJumpIfFalse,
+
+    // if result, jump to operand
+    UAJSONPredicateOpcodeJumpIfTrue,
+};
+
+typedef struct {
+    UAJSONPredicateOpcode opcode;
+    NSUInteger operand;
+    NSInteger argument;
+} UAJSONPredicateInstruction;
+
+static id UAJSONPredicateProgramResolvePath(id object, NSArray<NSString *> *path) {
+    for (NSString *key in path) {
+        if (![object isKindOfClass:[NSDictionary class]]) {
+            return nil;
+        }
+
+        object = [object objectForKey:key];
+    }
+
+    return object;
+}
+
+// Same rules as -[UAJSONValueMatcher value:isEqualToValue:ignoreCase:] with ignoreCase set
+static BOOL UAJSONPredicateProgramEqualIgnoringCase(id valueOne, id valueTwo) {
+    if (valueOne == valueTwo) {
+        return YES;
+    }
+
+    if ([valueOne isKindOfClass:[NSString class]]) {
+        return [valueTwo isKindOfClass:[NSString class]] && [valueOne caseInsensitiveCompare:valueTwo] == NSOrderedSame;
+    }
+
+    if ([valueOne isKindOfClass:[NSArray class]]) {
+        if (![valueTwo isKindOfClass:[NSArray class]] || [valueTwo count] != [valueOne count]) {
+            return NO;
+        }
+
+        NSUInteger count = [valueOne count];
+        for (NSUInteger i = 0; i < count; i++) {
+            if (!UAJSONPredicateProgramEqualIgnoringCase([valueOne objectAtIndex:i], [valueTwo objectAtIndex:i])) {
+                return NO;
+            }
+        }
+
+        return YES;
+    }
+
+    if ([valueOne isKindOfClass:[NSDictionary class]]) {
+        if (![valueTwo isKindOfClass:[NSDictionary class]] || [valueTwo count] != [valueOne count]) {
+            return NO;
+        }
+
+        for (id key in valueOne) {
+            if (!UAJSONPredicateProgramEqualIgnoringCase([valueOne objectForKey:key], [valueTwo objectForKey:key])) {
+                return NO;
+            }
+        }
+
+        return YES;
+    }
+
+    return [valueOne isEqual:valueTwo];
+}
+
+@interface UAJSONPredicateProgram ()
+@property (nonatomic, strong) NSMutableData *instructionData;
+@property (nonatomic, strong) NSMutableArray *constants;
+@property (nonatomic, strong) NSMutableArray<NSArray<NSString *> *> *paths;
+@property (nonatomic, strong) NSMutableDictionary<NSArray<NSString *> *, NSNumber *> *pathIndexes;
+@end
+
+@implementation UAJSONPredicateProgram
+
+- (instancetype)initWithPayload:(NSDictionary *)payload {
+    self = [super init];
+
+    if (self) {
+        self.instructionData = [NSMutableData data];
+        self.constants = [NSMutableArray array];
+        self.paths = [NSMutableArray array];
+        self.pathIndexes = [NSMutableDictionary dictionary];
+
+        [self compilePredicate:payload];
+
+        // Only needed while compiling
+        self.pathIndexes = nil;
+    }
+
+    return self;
+}
+
++ (instancetype)programWithPredicate:(UAJSONPredicate *)predicate {
+    return [[self alloc] initWithPayload:predicate.payload];
+}
+
++ (nullable instancetype)programWithJSON:(id)json error:(NSError **)error {
+    UAJSONPredicate *predicate = [UAJSONPredicate predicateWithJSON:json error:error];
+    if (!predicate) {
+        return nil;
+    }
+
+    return [self programWithPredicate:predicate];
+}
+
+- (NSUInteger)instructionCount {
+    return self.instructionData.length / sizeof(UAJSONPredicateInstruction);
+}
+
+- (BOOL)evaluateObject:(id)object {
+    const UAJSONPredicateInstruction *instructions = self.instructionData.bytes;
+    NSUInteger count = self.instructionCount;
+
+    __unsafe_unretained NSArray *constants = self.constants;
+    __unsafe_unretained NSArray<NSArray<NSString *> *> *paths = self.paths;
+    __unsafe_unretained id value = nil;
+    BOOL result = YES;
+
+    NSUInteger pc = 0;
+    while (pc < count) {
+        UAJSONPredicateInstruction instruction = instructions[pc++];
+
+        switch (instruction.opcode) {
+            case UAJSONPredicateOpcodeLoad:
+                value = UAJSONPredicateProgramResolvePath(object, [paths objectAtIndex:instruction.operand]);
+                break;
+
+            case UAJSONPredicateOpcodeTrue:
+                result = YES;
+                break;
+
+            case UAJSONPredicateOpcodeIsPresent:
+                result = (BOOL)instruction.operand == (value != nil);
+                break;
+
+            case UAJSONPredicateOpcodeEquals: {
+                id constant = [constants objectAtIndex:instruction.operand];
+                result = constant == value || [constant isEqual:value];
+                break;
+            }
+
+            case UAJSONPredicateOpcodeEqualsStringIgnoreCase:
+                result = [value isKindOfClass:[NSString class]] &&
+                    [[constants objectAtIndex:instruction.operand] caseInsensitiveCompare:value] == NSOrderedSame;
+                break;
+
+            case UAJSONPredicateOpcodeEqualsIgnoreCase:
+                result = UAJSONPredicateProgramEqualIgnoringCase([constants objectAtIndex:instruction.operand], value);
+                break;
+
+            case UAJSONPredicateOpcodeAtLeast:
+                result = [value isKindOfClass:[NSNumber class]] &&
+                    [[constants objectAtIndex:instruction.operand] compare:value] != NSOrderedDescending;
+                break;
+
+            case UAJSONPredicateOpcodeAtMost:
+                result = [value isKindOfClass:[NSNumber class]] &&
+                    [[constants objectAtIndex:instruction.operand] compare:value] != NSOrderedAscending;
+                break;
+
+            case UAJSONPredicateOpcodeVersion:
+                result = [value isKindOfClass:[NSString class]] &&
+                    [[constants objectAtIndex:instruction.operand] evaluateObject:value];
+                break;
+
+            case UAJSONPredicateOpcodeArrayContains: {
+                result = NO;
+                if ([value isKindOfClass:[NSArray class]]) {
+                    UAJSONPredicateProgram *program = [constants objectAtIndex:instruction.operand];
+                    for (id element in value) {
+                        if ([program evaluateObject:element]) {
+                            result = YES;
+                            break;
+                        }
+                    }
+                }
+                break;
+            }
+
+            case UAJSONPredicateOpcodeArrayContainsAtIndex:
+                result = [value isKindOfClass:[NSArray class]] &&
+                    instruction.argument >= 0 && instruction.argument < (NSInteger)[value count] &&
+                    [[constants objectAtIndex:instruction.operand] evaluateObject:[value objectAtIndex:instruction.argument]];
+                break;
+
+            case UAJSONPredicateOpcodeNot:
+                result = !result;
+                break;
+
+            case UAJSONPredicateOpcodeJumpIfFalse:
+                if (!result) {
+                    pc = instruction.operand;
+                }
+                break;
+
+            case UAJSONPredicateOpcodeJumpIfTrue:
+                if (result) {
+                    pc = instruction.operand;
+                }
+                break;
+        }
+    }
+
+    return result;
+}
+
+#pragma mark -
+#pragma mark Compiler
+
+- (NSUInteger)emit:(UAJSONPredicateOpcode)opcode operand:(NSUInteger)operand argument:(NSInteger)argument {
+    UAJSONPredicateInstruction instruction = { opcode, operand, argument };
+    [self.instructionData appendBytes:&instruction length:sizeof(instruction)];
+    return self.instructionCount - 1;
+}
+
+- (NSUInteger)emit:(UAJSONPredicateOpcode)opcode operand:(NSUInteger)operand {
+    return [self emit:opcode operand:operand argument:0];
+}
+
+/**
+ * Points the jump instructions at the next instruction.
+ */
+- (void)patchJumps:(NSArray<NSNumber *> *)jumps {
+    UAJSONPredicateInstruction *instructions = self.instructionData.mutableBytes;
+    for (NSNumber *jump in jumps) {
+        instructions[jump.unsignedIntegerValue].operand = self.instructionCount;
+    }
+}
+
+- (NSUInteger)addConstant:(id)constant {
+    [self.constants addObject:constant];
+    return self.constants.count - 1;
+}
+
+- (NSUInteger)internPath:(NSArray<NSString *> *)path {
+    NSNumber *index = self.pathIndexes[path];
+    if (!index) {
+        index = @(self.paths.count);
+        [self.paths addObject:path];
+        self.pathIndexes[path] = index;
+    }
+
+    return index.unsignedIntegerValue;
+}
+
+- (void)compilePredicate:(NSDictionary *)payload {
+    for (NSString *type in @[UAJSONPredicateProgramAndKey, UAJSONPredicateProgramOrKey]) {
+        NSArray *subpredicates = payload[type];
+        if (!subpredicates) {
+            continue;
+        }
+
+        // Short circuit to the end once the result is decided
+        UAJSONPredicateOpcode jump = [type isEqualToString:UAJSONPredicateProgramAndKey] ? UAJSONPredicateOpcodeJumpIfFalse : UAJSONPredicateOpcodeJumpIfTrue;
+        NSMutableArray<NSNumber *> *jumps = [NSMutableArray array];
+
+        for (NSUInteger i = 0; i < subpredicates.count; i++) {
+            [self compilePredicate:subpredicates[i]];
+
+            if (i < subpredicates.count - 1) {
+                [jumps addObject:@([self emit:jump operand:0])];
+            }
+        }
+
+        [self patchJumps:jumps];
+        return;
+    }
+
+    NSArray *notPredicates = payload[UAJSONPredicateProgramNotKey];
+    if (notPredicates) {
+        [self compilePredicate:notPredicates.firstObject];
+        [self emit:UAJSONPredicateOpcodeNot operand:0];
+        return;
+    }
+
+    [self compileMatcher:payload];
+}
+
+- (void)compileMatcher:(NSDictionary *)payload {
+    NSMutableArray<NSString *> *path = [NSMutableArray arrayWithArray:payload[UAJSONPredicateProgramScopeKey] ?: @[]];
+    if (payload[UAJSONPredicateProgramKeyKey]) {
+        [path addObject:payload[UAJSONPredicateProgramKeyKey]];
+    }
+
+    [self emit:UAJSONPredicateOpcodeLoad operand:[self internPath:path]];
+    [self compileValueMatcher:payload[UAJSONPredicateProgramValueKey] ignoreCase:[payload[UAJSONPredicateProgramIgnoreCaseKey] boolValue]];
+}
+
+/**
+ * Compiles the value matcher checks in the same order the value matcher evaluates them, stopping at the first failure.
+ */
+- (void)compileValueMatcher:(NSDictionary *)payload ignoreCase:(BOOL)ignoreCase {
+    if (payload[UAJSONPredicateProgramIsPresentKey]) {
+        [self emit:UAJSONPredicateOpcodeIsPresent operand:[payload[UAJSONPredicateProgramIsPresentKey] boolValue]];
+        return;
+    }
+
+    NSMutableArray<NSNumber *> *jumps = [NSMutableArray array];
+    BOOL hasCheck = NO;
+
+    id equals = payload[UAJSONPredicateProgramEqualsKey];
+    if (equals) {
+        UAJSONPredicateOpcode opcode = UAJSONPredicateOpcodeEquals;
+        if (ignoreCase && [equals isKindOfClass:[NSString class]]) {
+            opcode = UAJSONPredicateOpcodeEqualsStringIgnoreCase;
+        } else if (ignoreCase && ([equals isKindOfClass:[NSArray class]] || [equals isKindOfClass:[NSDictionary class]])) {
+            opcode = UAJSONPredicateOpcodeEqualsIgnoreCase;
+        }
+
+        [self emit:opcode operand:[self addConstant:equals]];
+        hasCheck = YES;
+    }
+
+    NSNumber *atLeast = payload[UAJSONPredicateProgramAtLeastKey];
+    if (atLeast) {
+        if (hasCheck) {
+            [jumps addObject:@([self emit:UAJSONPredicateOpcodeJumpIfFalse operand:0])];
+        }
+        [self emit:UAJSONPredicateOpcodeAtLeast operand:[self addConstant:atLeast]];
+        hasCheck = YES;
+    }
+
+    NSNumber *atMost = payload[UAJSONPredicateProgramAtMostKey];
+    if (atMost) {
+        if (hasCheck) {
+            [jumps addObject:@([self emit:UAJSONPredicateOpcodeJumpIfFalse operand:0])];
+        }
+        [self emit:UAJSONPredicateOpcodeAtMost operand:[self addConstant:atMost]];
+        hasCheck = YES;
+    }
+
+    NSString *versionConstraint = payload[UAJSONPredicateProgramVersionKey];
+    UAVersionMatcher *versionMatcher = versionConstraint ? [UAVersionMatcher matcherWithVersionConstraint:versionConstraint] : nil;
+    if (versionMatcher) {
+        if (hasCheck) {
+            [jumps addObject:@([self emit:UAJSONPredicateOpcodeJumpIfFalse operand:0])];
+        }
+        [self emit:UAJSONPredicateOpcodeVersion operand:[self addConstant:versionMatcher]];
+        hasCheck = YES;
+    }
+
+    NSDictionary *arrayPredicate = payload[UAJSONPredicateProgramArrayContainsKey];
+    if (arrayPredicate) {
+        if (hasCheck) {
+            [jumps addObject:@([self emit:UAJSONPredicateOpcodeJumpIfFalse operand:0])];
+        }
+
+        UAJSONPredicateProgram *program = [[UAJSONPredicateProgram alloc] initWithPayload:arrayPredicate];
+        NSNumber *index = payload[UAJSONPredicateProgramArrayIndexKey];
+        if (index) {
+            [self emit:UAJSONPredicateOpcodeArrayContainsAtIndex operand:[self addConstant:program] argument:index.integerValue];
+        } else {
+            [self emit:UAJSONPredicateOpcodeArrayContains operand:[self addConstant:program]];
+        }
+        hasCheck = YES;
+    }
+
+    if (!hasCheck) {
+        [self emit:UAJSONPredicateOpcodeTrue operand:0];
+    }
+
+    [self patchJumps:jumps];
+}
+
+@end
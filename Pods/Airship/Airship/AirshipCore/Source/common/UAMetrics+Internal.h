@@ -0,0 +1,90 @@
+/* Copyright Airship and Contributors */
+
+#import "UAMetrics.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * A span started with `UAMetricsSpanBegin`.
+ */
+typedef struct {
+    UAMetricsHistogram histogram;
+    uint64_t start;
+} UAMetricsSpan;
+
+/**
+ * Whether metrics are recorded. Read through `UAMetricsIsRecording` only.
+ */
+extern BOOL UAMetricsRecordingEnabled;
+
+/**
+ * Recording functions, called through the inline helpers below so disabled metrics cost a single branch.
+ */
+extern void UAMetricsAddToCounter(UAMetricsCounter counter, uint64_t amount);
+extern void UAMetricsAddToHistogram(UAMetricsHistogram histogram, uint64_t nanoseconds);
+extern uint64_t UAMetricsTimestamp(void);
+extern void UAMetricsSpanFinish(UAMetricsSpan span);
+
+/**
+ * Checks if metrics are recorded.
+ */
+static inline BOOL UAMetricsIsRecording(void) {
+    return __builtin_expect(__atomic_load_n(&UAMetricsRecordingEnabled, __ATOMIC_RELAXED), NO);
+}
+
+/**
+ * Increments a counter.
+ */
+static inline void UAMetricsIncrement(UAMetricsCounter counter, uint64_t amount) {
+    if (UAMetricsIsRecording()) {
+        UAMetricsAddToCounter(counter, amount);
+    }
+}
+
+/**
+ * Records a duration measured elsewhere.
+ */
+static inline void UAMetricsRecordDuration(UAMetricsHistogram histogram, NSTimeInterval duration) {
+    if (UAMetricsIsRecording() && duration >= 0) {
+        UAMetricsAddToHistogram(histogram, (uint64_t)(duration * NSEC_PER_SEC));
+    }
+}
+
+/**
+ * Starts a span. Spans may be ended on any thread, so they can be passed into completion blocks.
+ */
+static inline UAMetricsSpan UAMetricsSpanBegin(UAMetricsHistogram histogram) {
+    UAMetricsSpan span = { histogram, 0 };
+    if (UAMetricsIsRecording()) {
+        span.start = UAMetricsTimestamp();
+    }
+    return span;
+}
+
+/**
+ * Ends a span. Spans started while metrics were disabled are ignored.
+ */
+static inline void UAMetricsSpanEnd(UAMetricsSpan span) {
+    if (span.start) {
+        UAMetricsSpanFinish(span);
+    }
+}
+
+/**
+ * Ends a span through a pointer, for `UA_METRICS_SCOPED_SPAN` cleanup.
+ */
+static inline void UAMetricsSpanEndScope(UAMetricsSpan *span) {
+    UAMetricsSpanEnd(*span);
+}
+
+#define UA_METRICS_CONCAT_(a, b) a ## b
+#define UA_METRICS_CONCAT(a, b) UA_METRICS_CONCAT_(a, b)
+
+/**
+ * Starts a span that ends when the enclosing scope exits.
+ */
+#define UA_METRICS_SCOPED_SPAN(histogram) \
+    __attribute__((cleanup(UAMetricsSpanEndScope), unused)) \
+    UAMetricsSpan UA_METRICS_CONCAT(uaMetricsSpan_, __LINE__) = UAMetricsSpanBegin(histogram)
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,193 @@
+/* Copyright Airship and Contributors */
+
+#import <Foundation/Foundation.h>
+#import "UAMetricsExporter.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * SDK counters.
+ */
+typedef NS_ENUM(NSUInteger, UAMetricsCounter) {
+    /**
+     * Analytics events written to the event store.
+     */
+    UAMetricsCounterEventsStored,
+
+    /**
+     * Analytics upload batches sent.
+     */
+    UAMetricsCounterEventUploadBatches,
+
+    /**
+     * Analytics events uploaded.
+     */
+    UAMetricsCounterEventsUploaded,
+
+    /**
+     * Analytics upload batches that failed.
+     */
+    UAMetricsCounterEventUploadFailures,
+
+    /**
+     * Automation triggers evaluated.
+     */
+    UAMetricsCounterTriggersEvaluated,
+
+    /**
+     * Automation schedules triggered.
+     */
+    UAMetricsCounterSchedulesTriggered,
+
+    /**
+     * Remote data refreshes.
+     */
+    UAMetricsCounterRemoteDataRefreshes,
+
+    /**
+     * Remote data refreshes that failed.
+     */
+    UAMetricsCounterRemoteDataRefreshFailures,
+
+    /**
+     * Core Data context saves.
+     */
+    UAMetricsCounterCoreDataSaves,
+
+    /**
+     * Core Data context saves that failed.
+     */
+    UAMetricsCounterCoreDataSaveFailures,
+
+    /**
+     * HTTP requests completed.
+     */
+    UAMetricsCounterHTTPRequests,
+
+    /**
+     * HTTP requests that failed without a response.
+     */
+    UAMetricsCounterHTTPRequestFailures,
+
+    /**
+     * HTTP requests retried.
+     */
+    UAMetricsCounterHTTPRequestRetries,
+
+    /**
+     * The number of counters.
+     * @note For internal use only. :nodoc:
+     */
+    UAMetricsCounterCount
+};
+
+/**
+ * SDK duration histograms. Spans record into the histogram they were started with.
+ */
+typedef NS_ENUM(NSUInteger, UAMetricsHistogram) {
+    /**
+     * Time to write an analytics event to the event store.
+     */
+    UAMetricsHistogramEventStoreWrite,
+
+    /**
+     * Time to upload an analytics batch.
+     */
+    UAMetricsHistogramEventUpload,
+
+    /**
+     * Time to evaluate the automation triggers for an event.
+     */
+    UAMetricsHistogramTriggerEvaluation,
+
+    /**
+     * Time to refresh remote data, including notifying subscribers.
+     */
+    UAMetricsHistogramRemoteDataRefresh,
+
+    /**
+     * Time to save a Core Data context.
+     */
+    UAMetricsHistogramCoreDataSave,
+
+    /**
+     * Time an HTTP request spends in flight.
+     */
+    UAMetricsHistogramHTTPRequest,
+
+    /**
+     * Time an HTTP request waits for a connection slot.
+     */
+    UAMetricsHistogramHTTPQueueWait,
+
+    /**
+     * In-app message prepare stages.
+     */
+    UAMetricsHistogramInAppPrepareMetadata,
+    UAMetricsHistogramInAppPrepareAdapter,
+    UAMetricsHistogramInAppPrepareAudience,
+    UAMetricsHistogramInAppPrepareAssets,
+    UAMetricsHistogramInAppPrepareData,
+
+    /**
+     * The number of histograms.
+     * @note For internal use only. :nodoc:
+     */
+    UAMetricsHistogramCount
+};
+
+/**
+ * SDK metrics and tracing.
+ *
+ * Metrics are recorded with atomic operations into fixed counters and histograms, and are exported
+ * as deltas to the exporter on a fixed interval. When metrics are disabled, which is the default,
+ * recording is a single branch at each call site.
+ */
+@interface UAMetrics : NSObject
+
+/**
+ * The shared metrics instance.
+ *
+ * @return The shared metrics instance.
+ */
++ (instancetype)shared;
+
+/**
+ * Enables or disables recording. Disabling discards anything not yet exported. Defaults to `NO`.
+ */
+@property (nonatomic, assign, getter=isEnabled) BOOL enabled;
+
+/**
+ * The exporter.
+ */
+@property (atomic, strong, nullable) id<UAMetricsExporter> exporter;
+
+/**
+ * The export interval in seconds. Defaults to 60.
+ */
+@property (nonatomic, assign) NSTimeInterval exportInterval;
+
+/**
+ * Exports the metrics recorded since the previous export now.
+ */
+- (void)exportMetrics;
+
+/**
+ * Returns the name used to export a counter.
+ *
+ * @param counter The counter.
+ * @return The counter name.
+ */
++ (NSString *)nameForCounter:(UAMetricsCounter)counter;
+
+/**
+ * Returns the name used to export a histogram and its spans.
+ *
+ * @param histogram The histogram.
+ * @return The histogram name.
+ */
++ (NSString *)nameForHistogram:(UAMetricsHistogram)histogram;
+
+@end
+
+NS_ASSUME_NONNULL_END
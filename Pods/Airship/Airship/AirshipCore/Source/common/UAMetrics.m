@@ -0,0 +1,294 @@
+/* Copyright Airship and Contributors */
+
+#import <time.h>
+#import "UAMetrics+Internal.h"
+#import "UAMetricsSnapshot+Internal.h"
+#import "UADispatcher.h"
+#import "UADisposable.h"
+#import "UAGlobal.h"
+
+static const NSTimeInterval UAMetricsDefaultExportInterval = 60;
+
+// Bucket i holds durations up to 2^i microseconds, the last bucket holds everything longer
+#define UAMetricsBucketCount 25
+
+typedef struct {
+    uint64_t count;
+    uint64_t sum;
+    uint64_t max;
+    uint64_t buckets[UAMetricsBucketCount];
+} UAMetricsHistogramState;
+
+BOOL UAMetricsRecordingEnabled = NO;
+
+// Only read when an exporter implements the span callback, so spans skip the exporter lookup otherwise
+static BOOL UAMetricsSpanExportEnabled = NO;
+
+static uint64_t UAMetricsCounters[UAMetricsCounterCount];
+static UAMetricsHistogramState UAMetricsHistograms[UAMetricsHistogramCount];
+
+static NSString * const UAMetricsCounterNames[UAMetricsCounterCount] = {
+    [UAMetricsCounterEventsStored] = @"analytics.events_stored",
+    [UAMetricsCounterEventUploadBatches] = @"analytics.upload_batches",
+    [UAMetricsCounterEventsUploaded] = @"analytics.events_uploaded",
+    [UAMetricsCounterEventUploadFailures] = @"analytics.upload_failures",
+    [UAMetricsCounterTriggersEvaluated] = @"automation.triggers_evaluated",
+    [UAMetricsCounterSchedulesTriggered] = @"automation.schedules_triggered",
+    [UAMetricsCounterRemoteDataRefreshes] = @"remote_data.refreshes",
+    [UAMetricsCounterRemoteDataRefreshFailures] = @"remote_data.refresh_failures",
+    [UAMetricsCounterCoreDataSaves] = @"core_data.saves",
+    [UAMetricsCounterCoreDataSaveFailures] = @"core_data.save_failures",
+    [UAMetricsCounterHTTPRequests] = @"http.requests",
+    [UAMetricsCounterHTTPRequestFailures] = @"http.request_failures",
+    [UAMetricsCounterHTTPRequestRetries] = @"http.request_retries",
+};
+
+static NSString * const UAMetricsHistogramNames[UAMetricsHistogramCount] = {
+    [UAMetricsHistogramEventStoreWrite] = @"analytics.event_store_write",
+    [UAMetricsHistogramEventUpload] = @"analytics.upload",
+    [UAMetricsHistogramTriggerEvaluation] = @"automation.trigger_evaluation",
+    [UAMetricsHistogramRemoteDataRefresh] = @"remote_data.refresh",
+    [UAMetricsHistogramCoreDataSave] = @"core_data.save",
+    [UAMetricsHistogramHTTPRequest] = @"http.request",
+    [UAMetricsHistogramHTTPQueueWait] = @"http.queue_wait",
+    [UAMetricsHistogramInAppPrepareMetadata] = @"in_app.prepare.metadata",
+    [UAMetricsHistogramInAppPrepareAdapter] = @"in_app.prepare.adapter",
+    [UAMetricsHistogramInAppPrepareAudience] = @"in_app.prepare.audience",
+    [UAMetricsHistogramInAppPrepareAssets] = @"in_app.prepare.assets",
+    [UAMetricsHistogramInAppPrepareData] = @"in_app.prepare.data",
+};
+
+@interface UAMetrics ()
+@property (nonatomic, strong) UADispatcher *dispatcher;
+@property (nonatomic, strong) NSDate *intervalStartDate;
+@property (nonatomic, strong, nullable) UADisposable *exportDisposable;
+
+- (void)exportSpanWithHistogram:(UAMetricsHistogram)histogram duration:(NSTimeInterval)duration;
+@end
+
+#pragma mark -
+#pragma mark Recording
+
+void UAMetricsAddToCounter(UAMetricsCounter counter, uint64_t amount) {
+    if (counter >= UAMetricsCounterCount) {
+        return;
+    }
+
+    __atomic_fetch_add(&UAMetricsCounters[counter], amount, __ATOMIC_RELAXED);
+}
+
+void UAMetricsAddToHistogram(UAMetricsHistogram histogram, uint64_t nanoseconds) {
+    if (histogram >= UAMetricsHistogramCount) {
+        return;
+    }
+
+    UAMetricsHistogramState *state = &UAMetricsHistograms[histogram];
+
+    uint64_t microseconds = nanoseconds / NSEC_PER_USEC;
+    NSUInteger bucket = microseconds <= 1 ? 0 : 64 - __builtin_clzll(microseconds - 1);
+    __atomic_fetch_add(&state->buckets[MIN(bucket, UAMetricsBucketCount - 1)], 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&state->sum, nanoseconds, __ATOMIC_RELAXED);
+
+    uint64_t max = __atomic_load_n(&state->max, __ATOMIC_RELAXED);
+    while (nanoseconds > max && !__atomic_compare_exchange_n(&state->max, &max, nanoseconds, YES, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        // max is reloaded by the failed exchange
+    }
+
+    __atomic_fetch_add(&state->count, 1, __ATOMIC_RELAXED);
+}
+
+uint64_t UAMetricsTimestamp(void) {
+    return clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+}
+
+void UAMetricsSpanFinish(UAMetricsSpan span) {
+    uint64_t end = UAMetricsTimestamp();
+    uint64_t duration = end > span.start ? end - span.start : 0;
+    UAMetricsAddToHistogram(span.histogram, duration);
+
+    if (__atomic_load_n(&UAMetricsSpanExportEnabled, __ATOMIC_RELAXED)) {
+        [[UAMetrics shared] exportSpanWithHistogram:span.histogram duration:(NSTimeInterval)duration / NSEC_PER_SEC];
+    }
+}
+
+@implementation UAMetrics
+
++ (instancetype)shared {
+    static dispatch_once_t onceToken;
+    static UAMetrics *shared;
+    dispatch_once(&onceToken, ^{
+        shared = [[UAMetrics alloc] init];
+    });
+    return shared;
+}
+
+- (instancetype)init {
+    self = [super init];
+
+    if (self) {
+        self.dispatcher = [UADispatcher backgroundDispatcher];
+        self.intervalStartDate = [NSDate date];
+        _exportInterval = UAMetricsDefaultExportInterval;
+    }
+
+    return self;
+}
+
++ (NSString *)nameForCounter:(UAMetricsCounter)counter {
+    return counter < UAMetricsCounterCount ? UAMetricsCounterNames[counter] : @"unknown";
+}
+
++ (NSString *)nameForHistogram:(UAMetricsHistogram)histogram {
+    return histogram < UAMetricsHistogramCount ? UAMetricsHistogramNames[histogram] : @"unknown";
+}
+
+- (BOOL)isEnabled {
+    return __atomic_load_n(&UAMetricsRecordingEnabled, __ATOMIC_RELAXED);
+}
+
+- (void)setEnabled:(BOOL)enabled {
+    @synchronized (self) {
+        if (self.isEnabled == enabled) {
+            return;
+        }
+
+        __atomic_store_n(&UAMetricsRecordingEnabled, enabled, __ATOMIC_RELAXED);
+
+        // Start every enabled period from empty metrics
+        [self collectMetrics];
+        [self scheduleExport];
+    }
+}
+
+- (void)setExporter:(id<UAMetricsExporter>)exporter {
+    @synchronized (self) {
+        _exporter = exporter;
+
+        BOOL exportSpans = [exporter respondsToSelector:@selector(spanNamed:didEndWithDuration:)];
+        __atomic_store_n(&UAMetricsSpanExportEnabled, exportSpans, __ATOMIC_RELAXED);
+
+        [self scheduleExport];
+    }
+}
+
+- (id<UAMetricsExporter>)exporter {
+    @synchronized (self) {
+        return _exporter;
+    }
+}
+
+- (void)setExportInterval:(NSTimeInterval)exportInterval {
+    @synchronized (self) {
+        _exportInterval = MAX(exportInterval, 1);
+
+        [self.exportDisposable dispose];
+        self.exportDisposable = nil;
+        [self scheduleExport];
+    }
+}
+
+- (void)exportMetrics {
+    UAMetricsSnapshot *snapshot;
+    id<UAMetricsExporter> exporter;
+
+    @synchronized (self) {
+        [self.exportDisposable dispose];
+        self.exportDisposable = nil;
+
+        if (!self.isEnabled) {
+            return;
+        }
+
+        snapshot = [self collectMetrics];
+        exporter = _exporter;
+        [self scheduleExport];
+    }
+
+    // Called outside the lock since exporters may do their own I/O
+    [exporter exportMetrics:snapshot];
+}
+
+#pragma mark -
+#pragma mark Export
+
+/**
+ * Hands an ended span to the exporter. Spans end on hot paths, so the exporter is looked up and called on the
+ * background dispatcher instead of the thread that ended the span.
+ */
+- (void)exportSpanWithHistogram:(UAMetricsHistogram)histogram duration:(NSTimeInterval)duration {
+    [self.dispatcher dispatchAsync:^{
+        id<UAMetricsExporter> exporter = self.exporter;
+        if ([exporter respondsToSelector:@selector(spanNamed:didEndWithDuration:)]) {
+            [exporter spanNamed:[UAMetrics nameForHistogram:histogram] didEndWithDuration:duration];
+        }
+    }];
+}
+
+/**
+ * Schedules the next export, unless one is already scheduled. Must be called while synchronized on self.
+ */
+- (void)scheduleExport {
+    if (!self.isEnabled || !_exporter) {
+        [self.exportDisposable dispose];
+        self.exportDisposable = nil;
+        return;
+    }
+
+    if (self.exportDisposable) {
+        return;
+    }
+
+    UA_WEAKIFY(self)
+    self.exportDisposable = [self.dispatcher dispatchAfter:self.exportInterval block:^{
+        UA_STRONGIFY(self)
+        [self exportMetrics];
+    }];
+}
+
+/**
+ * Swaps every counter and histogram back to zero and returns what they held. Values recorded while
+ * the swap is in progress land in either this snapshot or the next. Must be called while
+ * synchronized on self.
+ */
+- (UAMetricsSnapshot *)collectMetrics {
+    NSMutableDictionary<NSString *, NSNumber *> *counters = [NSMutableDictionary dictionary];
+    for (NSUInteger i = 0; i < UAMetricsCounterCount; i++) {
+        uint64_t value = __atomic_exchange_n(&UAMetricsCounters[i], 0, __ATOMIC_RELAXED);
+        if (value) {
+            counters[UAMetricsCounterNames[i]] = @(value);
+        }
+    }
+
+    NSMutableDictionary<NSString *, UAMetricsHistogramSnapshot *> *histograms = [NSMutableDictionary dictionary];
+    for (NSUInteger i = 0; i < UAMetricsHistogramCount; i++) {
+        UAMetricsHistogramState *state = &UAMetricsHistograms[i];
+
+        uint64_t count = __atomic_exchange_n(&state->count, 0, __ATOMIC_RELAXED);
+        uint64_t sum = __atomic_exchange_n(&state->sum, 0, __ATOMIC_RELAXED);
+        uint64_t max = __atomic_exchange_n(&state->max, 0, __ATOMIC_RELAXED);
+
+        NSMutableArray<NSNumber *> *buckets = [NSMutableArray arrayWithCapacity:UAMetricsBucketCount];
+        for (NSUInteger bucket = 0; bucket < UAMetricsBucketCount; bucket++) {
+            [buckets addObject:@(__atomic_exchange_n(&state->buckets[bucket], 0, __ATOMIC_RELAXED))];
+        }
+
+        if (count) {
+            histograms[UAMetricsHistogramNames[i]] = [UAMetricsHistogramSnapshot snapshotWithCount:(NSUInteger)count
+                                                                                               sum:(NSTimeInterval)sum / NSEC_PER_SEC
+                                                                                               max:(NSTimeInterval)max / NSEC_PER_SEC
+                                                                                      bucketCounts:buckets];
+        }
+    }
+
+    NSDate *now = [NSDate date];
+    UAMetricsSnapshot *snapshot = [UAMetricsSnapshot snapshotWithStartDate:self.intervalStartDate
+                                                                   endDate:now
+                                                                  counters:counters
+                                                                histograms:histograms];
+    self.intervalStartDate = now;
+
+    UA_LTRACE(@"Collected metrics: %@", snapshot);
+    return snapshot;
+}
+
+@end
@@ -0,0 +1,36 @@
+/* Copyright Airship and Contributors */
+
+#import <Foundation/Foundation.h>
+
+@class UAMetricsSnapshot;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * Protocol for receiving SDK metrics, for example to forward them to an APM.
+ */
+@protocol UAMetricsExporter <NSObject>
+
+@required
+
+/**
+ * Called periodically with the metrics recorded since the previous export. Called on a background queue.
+ *
+ * @param snapshot The metrics snapshot.
+ */
+- (void)exportMetrics:(UAMetricsSnapshot *)snapshot;
+
+@optional
+
+/**
+ * Called each time a span ends. Called on a background queue shortly after the span ends, spans that
+ * end close together may be reported out of order.
+ *
+ * @param name The span name.
+ * @param duration The span duration in seconds.
+ */
+- (void)spanNamed:(NSString *)name didEndWithDuration:(NSTimeInterval)duration;
+
+@end
+
+NS_ASSUME_NONNULL_END
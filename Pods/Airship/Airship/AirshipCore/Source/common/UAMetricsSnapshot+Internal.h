@@ -0,0 +1,51 @@
+/* Copyright Airship and Contributors */
+
+#import "UAMetricsSnapshot.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface UAMetricsHistogramSnapshot ()
+
+///---------------------------------------------------------------------------------------
+/// @name Metrics Histogram Snapshot Internal Methods
+///---------------------------------------------------------------------------------------
+
+/**
+ * Factory method.
+ *
+ * @param count The number of recorded durations.
+ * @param sum The sum of the recorded durations in seconds.
+ * @param max The longest recorded duration in seconds.
+ * @param bucketCounts The number of durations in each bucket.
+ * @return The histogram snapshot.
+ */
++ (instancetype)snapshotWithCount:(NSUInteger)count
+                              sum:(NSTimeInterval)sum
+                              max:(NSTimeInterval)max
+                     bucketCounts:(NSArray<NSNumber *> *)bucketCounts;
+
+@end
+
+@interface UAMetricsSnapshot ()
+
+///---------------------------------------------------------------------------------------
+/// @name Metrics Snapshot Internal Methods
+///---------------------------------------------------------------------------------------
+
+/**
+ * Factory method.
+ *
+ * @param startDate The start of the interval.
+ * @param endDate The end of the interval.
+ * @param counters Counter increments, keyed by counter name.
+ * @param histograms Histograms, keyed by histogram name.
+ * @return The snapshot.
+ */
++ (instancetype)snapshotWithStartDate:(NSDate *)startDate
+                              endDate:(NSDate *)endDate
+                             counters:(NSDictionary<NSString *, NSNumber *> *)counters
+                           histograms:(NSDictionary<NSString *, UAMetricsHistogramSnapshot *> *)histograms;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,70 @@
+/* Copyright Airship and Contributors */
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * Durations recorded by a histogram during an export interval.
+ */
+@interface UAMetricsHistogramSnapshot : NSObject
+
+/**
+ * The number of recorded durations.
+ */
+@property (nonatomic, readonly) NSUInteger count;
+
+/**
+ * The sum of the recorded durations in seconds.
+ */
+@property (nonatomic, readonly) NSTimeInterval sum;
+
+/**
+ * The longest recorded duration in seconds.
+ */
+@property (nonatomic, readonly) NSTimeInterval max;
+
+/**
+ * The number of durations in each bucket. Bucket `i` holds durations up to `2^i` microseconds,
+ * the last bucket holds everything longer.
+ */
+@property (nonatomic, readonly) NSArray<NSNumber *> *bucketCounts;
+
+/**
+ * Estimates a percentile from the buckets.
+ *
+ * @param percentile The percentile, between 0 and 1.
+ * @return The upper bound in seconds of the bucket holding the percentile, capped at the max.
+ */
+- (NSTimeInterval)valueAtPercentile:(double)percentile;
+
+@end
+
+/**
+ * The metrics recorded during an export interval. Metrics that did not change are omitted.
+ */
+@interface UAMetricsSnapshot : NSObject
+
+/**
+ * The start of the interval.
+ */
+@property (nonatomic, readonly) NSDate *startDate;
+
+/**
+ * The end of the interval.
+ */
+@property (nonatomic, readonly) NSDate *endDate;
+
+/**
+ * Counter increments, keyed by counter name.
+ */
+@property (nonatomic, readonly) NSDictionary<NSString *, NSNumber *> *counters;
+
+/**
+ * Histograms, keyed by histogram name.
+ */
+@property (nonatomic, readonly) NSDictionary<NSString *, UAMetricsHistogramSnapshot *> *histograms;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,102 @@
+/* Copyright Airship and Contributors */
+
+#import "UAMetricsSnapshot+Internal.h"
+
+@interface UAMetricsHistogramSnapshot ()
+@property (nonatomic, assign) NSUInteger count;
+@property (nonatomic, assign) NSTimeInterval sum;
+@property (nonatomic, assign) NSTimeInterval max;
+@property (nonatomic, copy) NSArray<NSNumber *> *bucketCounts;
+@end
+
+@implementation UAMetricsHistogramSnapshot
+
+- (instancetype)initWithCount:(NSUInteger)count
+                          sum:(NSTimeInterval)sum
+                          max:(NSTimeInterval)max
+                 bucketCounts:(NSArray<NSNumber *> *)bucketCounts {
+    self = [super init];
+
+    if (self) {
+        self.count = count;
+        self.sum = sum;
+        self.max = max;
+        self.bucketCounts = bucketCounts;
+    }
+
+    return self;
+}
+
++ (instancetype)snapshotWithCount:(NSUInteger)count
+                              sum:(NSTimeInterval)sum
+                              max:(NSTimeInterval)max
+                     bucketCounts:(NSArray<NSNumber *> *)bucketCounts {
+    return [[self alloc] initWithCount:count sum:sum max:max bucketCounts:bucketCounts];
+}
+
+- (NSTimeInterval)valueAtPercentile:(double)percentile {
+    if (!self.count) {
+        return 0;
+    }
+
+    // Nearest rank
+    NSUInteger rank = MAX((NSUInteger)ceil(percentile * self.count), 1);
+    NSUInteger seen = 0;
+
+    for (NSUInteger i = 0; i < self.bucketCounts.count; i++) {
+        seen += self.bucketCounts[i].unsignedIntegerValue;
+        if (seen >= rank) {
+            // The last bucket has no upper bound
+            BOOL isLast = i + 1 == self.bucketCounts.count;
+            return isLast ? self.max : MIN(ldexp(1, (int)i) / USEC_PER_SEC, self.max);
+        }
+    }
+
+    return self.max;
+}
+
+- (NSString *)description {
+    return [NSString stringWithFormat:@"<UAMetricsHistogramSnapshot count: %lu, sum: %f, max: %f>",
+            (unsigned long)self.count, self.sum, self.max];
+}
+
+@end
+
+@interface UAMetricsSnapshot ()
+@property (nonatomic, strong) NSDate *startDate;
+@property (nonatomic, strong) NSDate *endDate;
+@property (nonatomic, copy) NSDictionary<NSString *, NSNumber *> *counters;
+@property (nonatomic, copy) NSDictionary<NSString *, UAMetricsHistogramSnapshot *> *histograms;
+@end
+
+@implementation UAMetricsSnapshot
+
+- (instancetype)initWithStartDate:(NSDate *)startDate
+                          endDate:(NSDate *)endDate
+                         counters:(NSDictionary<NSString *, NSNumber *> *)counters
+                       histograms:(NSDictionary<NSString *, UAMetricsHistogramSnapshot *> *)histograms {
+    self = [super init];
+
+    if (self) {
+        self.startDate = startDate;
+        self.endDate = endDate;
+        self.counters = counters;
+        self.histograms = histograms;
+    }
+
+    return self;
+}
+
++ (instancetype)snapshotWithStartDate:(NSDate *)startDate
+                              endDate:(NSDate *)endDate
+                             counters:(NSDictionary<NSString *, NSNumber *> *)counters
+                           histograms:(NSDictionary<NSString *, UAMetricsHistogramSnapshot *> *)histograms {
+    return [[self alloc] initWithStartDate:startDate endDate:endDate counters:counters histograms:histograms];
+}
+
+- (NSString *)description {
+    return [NSString stringWithFormat:@"<UAMetricsSnapshot start: %@, end: %@, counters: %@, histograms: %@>",
+            self.startDate, self.endDate, self.counters, self.histograms];
+}
+
+@end
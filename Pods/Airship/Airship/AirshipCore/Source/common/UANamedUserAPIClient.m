@@ -15,7 +15,7 @@
 @implementation UANamedUserAPIClient
 
 + (instancetype)clientWithConfig:(UARuntimeConfig *)config {
-    return [[self alloc] initWithConfig:config session:[UARequestSession sessionWithConfig:config]];
+    return [[self alloc] initWithConfig:config session:[UARequestSession sessionWithConfig:config requestClass:@"named_user" priority:UARequestPriorityHigh]];
 }
 
 + (instancetype)clientWithConfig:(UARuntimeConfig *)config session:(UARequestSession *)session {
@@ -0,0 +1,96 @@
+/* Copyright Airship and Contributors */
+
+#import <Foundation/Foundation.h>
+
+@class UADispatcher;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * The default delay before pending writes are flushed to NSUserDefaults.
+ */
+extern const NSTimeInterval UAPreferenceCacheDefaultWriteDelay;
+
+/**
+ * In-memory, write-behind cache in front of NSUserDefaults.
+ *
+ * Reads are served from memory after the first lookup of a key. Writes update memory
+ * immediately and are coalesced into a single flush after `writeDelay`, when the app
+ * enters the background or is about to terminate, or when `flush` is called.
+ *
+ * Keys are the fully prefixed NSUserDefaults keys, so every data store sharing the
+ * same defaults should share the same cache.
+ * @note For internal use only. :nodoc:
+ */
+@interface UAPreferenceCache : NSObject
+
+///---------------------------------------------------------------------------------------
+/// @name Preference Cache Internal Properties
+///---------------------------------------------------------------------------------------
+
+/**
+ * The delay before pending writes are flushed. Defaults to `UAPreferenceCacheDefaultWriteDelay`.
+ */
+@property (atomic, assign) NSTimeInterval writeDelay;
+
+///---------------------------------------------------------------------------------------
+/// @name Preference Cache Internal Methods
+///---------------------------------------------------------------------------------------
+
+/**
+ * The shared cache backed by the standard user defaults.
+ */
++ (instancetype)shared;
+
+/**
+ * Factory method. Used for testing.
+ *
+ * @param defaults The backing user defaults.
+ * @param notificationCenter The notification center used to observe flush points.
+ * @param dispatcher The dispatcher used to schedule delayed flushes.
+ * @return A preference cache instance.
+ */
++ (instancetype)cacheWithDefaults:(NSUserDefaults *)defaults
+               notificationCenter:(NSNotificationCenter *)notificationCenter
+                       dispatcher:(UADispatcher *)dispatcher;
+
+/**
+ * Returns the value for the key, loading it from the user defaults on first access.
+ *
+ * @param key The full preference key.
+ * @return The value, or `nil` if the key does not exist.
+ */
+- (nullable id)objectForKey:(NSString *)key;
+
+/**
+ * Sets the value for the key. The value is written to the user defaults on the next flush.
+ *
+ * @param object The value. Must be a property list object or an NSURL. `nil` removes the key.
+ * @param key The full preference key.
+ */
+- (void)setObject:(nullable id)object forKey:(NSString *)key;
+
+/**
+ * Removes every key with the given prefix from the cache and the user defaults. Pending
+ * writes for those keys are dropped.
+ *
+ * @param prefix The key prefix.
+ */
+- (void)removeKeysWithPrefix:(NSString *)prefix;
+
+/**
+ * Writes all pending values to the user defaults.
+ */
+- (void)flush;
+
+/**
+ * Returns the number of reads and writes per key since the cache was created.
+ *
+ * @param prefix Only keys with this prefix are returned. The prefix is stripped from the returned keys.
+ * @return A map of key to access count.
+ */
+- (NSDictionary<NSString *, NSNumber *> *)accessCountsForKeysWithPrefix:(NSString *)prefix;
+
+@end
+
+NS_ASSUME_NONNULL_END
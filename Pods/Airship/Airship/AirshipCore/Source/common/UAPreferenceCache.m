@@ -0,0 +1,189 @@
+/* Copyright Airship and Contributors */
+
+#import "UAPreferenceCache+Internal.h"
+#import "UAAppStateTracker.h"
+#import "UADispatcher.h"
+#import "UADisposable.h"
+#import "UAGlobal.h"
+
+const NSTimeInterval UAPreferenceCacheDefaultWriteDelay = 1;
+
+@interface UAPreferenceCache ()
+@property (nonatomic, strong) NSUserDefaults *defaults;
+@property (nonatomic, strong) NSNotificationCenter *notificationCenter;
+@property (nonatomic, strong) UADispatcher *dispatcher;
+
+// Values keyed by full preference key. Missing keys are cached as NSNull.
+@property (nonatomic, strong) NSMutableDictionary<NSString *, id> *values;
+
+// Writes not yet applied to the defaults. Removals are stored as NSNull.
+@property (nonatomic, strong) NSMutableDictionary<NSString *, id> *pendingWrites;
+
+@property (nonatomic, strong) NSCountedSet<NSString *> *accessCounts;
+@property (nonatomic, strong) UADisposable *scheduledFlush;
+@end
+
+@implementation UAPreferenceCache
+
+- (instancetype)initWithDefaults:(NSUserDefaults *)defaults
+              notificationCenter:(NSNotificationCenter *)notificationCenter
+                      dispatcher:(UADispatcher *)dispatcher {
+    self = [super init];
+
+    if (self) {
+        self.defaults = defaults;
+        self.notificationCenter = notificationCenter;
+        self.dispatcher = dispatcher;
+        self.values = [NSMutableDictionary dictionary];
+        self.pendingWrites = [NSMutableDictionary dictionary];
+        self.accessCounts = [NSCountedSet set];
+        self.writeDelay = UAPreferenceCacheDefaultWriteDelay;
+
+        [self.notificationCenter addObserver:self
+                                    selector:@selector(flush)
+                                        name:UAApplicationDidEnterBackgroundNotification
+                                      object:nil];
+
+        [self.notificationCenter addObserver:self
+                                    selector:@selector(flush)
+                                        name:UAApplicationWillTerminateNotification
+                                      object:nil];
+    }
+
+    return self;
+}
+
++ (instancetype)shared {
+    static dispatch_once_t onceToken;
+    static UAPreferenceCache *shared;
+
+    dispatch_once(&onceToken, ^{
+        shared = [self cacheWithDefaults:[NSUserDefaults standardUserDefaults]
+                      notificationCenter:[NSNotificationCenter defaultCenter]
+                              dispatcher:[UADispatcher backgroundDispatcher]];
+    });
+
+    return shared;
+}
+
++ (instancetype)cacheWithDefaults:(NSUserDefaults *)defaults
+               notificationCenter:(NSNotificationCenter *)notificationCenter
+                       dispatcher:(UADispatcher *)dispatcher {
+    return [[self alloc] initWithDefaults:defaults notificationCenter:notificationCenter dispatcher:dispatcher];
+}
+
+- (void)dealloc {
+    [self.notificationCenter removeObserver:self];
+    [self flush];
+}
+
+- (id)objectForKey:(NSString *)key {
+    @synchronized (self) {
+        [self.accessCounts addObject:key];
+
+        id value = self.values[key];
+        if (!value) {
+            value = [self.defaults objectForKey:key] ?: [NSNull null];
+            self.values[key] = value;
+        }
+
+        return value == [NSNull null] ? nil : value;
+    }
+}
+
+- (void)setObject:(id)object forKey:(NSString *)key {
+    // Match NSUserDefaults, which never hands back a mutable container that was set
+    id value = [object conformsToProtocol:@protocol(NSCopying)] ? [object copy] : object;
+    value = value ?: [NSNull null];
+
+    @synchronized (self) {
+        [self.accessCounts addObject:key];
+
+        id current = self.values[key];
+        if (current && (current == value || [current isEqual:value])) {
+            return;
+        }
+
+        self.values[key] = value;
+        self.pendingWrites[key] = value;
+        [self scheduleFlush];
+    }
+}
+
+- (void)removeKeysWithPrefix:(NSString *)prefix {
+    @synchronized (self) {
+        for (NSString *key in self.values.allKeys) {
+            if ([key hasPrefix:prefix]) {
+                [self.values removeObjectForKey:key];
+            }
+        }
+
+        for (NSString *key in self.pendingWrites.allKeys) {
+            if ([key hasPrefix:prefix]) {
+                [self.pendingWrites removeObjectForKey:key];
+            }
+        }
+
+        // Removed under the lock so a concurrent cache miss can't load a value that is about to be removed
+        for (NSString *key in [[self.defaults dictionaryRepresentation] allKeys]) {
+            if ([key hasPrefix:prefix]) {
+                [self.defaults removeObjectForKey:key];
+            }
+        }
+        [self.defaults synchronize];
+    }
+}
+
+- (void)flush {
+    @synchronized (self) {
+        [self.scheduledFlush dispose];
+        self.scheduledFlush = nil;
+
+        if (!self.pendingWrites.count) {
+            return;
+        }
+
+        // Applied under the lock so a concurrent cache miss never reads a stale value from the defaults
+        for (NSString *key in self.pendingWrites) {
+            id value = self.pendingWrites[key];
+            if (value == [NSNull null]) {
+                [self.defaults removeObjectForKey:key];
+            } else if ([value isKindOfClass:[NSURL class]]) {
+                [self.defaults setURL:value forKey:key];
+            } else {
+                [self.defaults setObject:value forKey:key];
+            }
+        }
+
+        [self.pendingWrites removeAllObjects];
+    }
+}
+
+- (NSDictionary<NSString *, NSNumber *> *)accessCountsForKeysWithPrefix:(NSString *)prefix {
+    NSMutableDictionary *counts = [NSMutableDictionary dictionary];
+
+    @synchronized (self) {
+        for (NSString *key in self.accessCounts) {
+            if ([key hasPrefix:prefix]) {
+                counts[[key substringFromIndex:prefix.length]] = @([self.accessCounts countForObject:key]);
+            }
+        }
+    }
+
+    return counts;
+}
+
+// Must be called while synchronized on self
+- (void)scheduleFlush {
+    if (self.scheduledFlush) {
+        return;
+    }
+
+    UA_WEAKIFY(self)
+    self.scheduledFlush = [self.dispatcher dispatchAfter:self.writeDelay block:^{
+        UA_STRONGIFY(self)
+        [self flush];
+    }];
+}
+
+@end
@@ -3,6 +3,8 @@
 #import <Foundation/Foundation.h>
 #import "UAPreferenceDataStore.h"
 
+@class UAPreferenceCache;
+
 NS_ASSUME_NONNULL_BEGIN
 
 @interface UAPreferenceDataStore ()
@@ -11,6 +13,28 @@ NS_ASSUME_NONNULL_BEGIN
 /// @name Preference Data Store Internal Methods
 ///---------------------------------------------------------------------------------------
 
+/**
+ * Factory method. Used for testing.
+ * @param keyPrefix The prefix to automatically apply to all keys.
+ * @param defaults The user defaults.
+ * @param cache The preference cache in front of the user defaults.
+ */
++ (instancetype)preferenceDataStoreWithKeyPrefix:(NSString *)keyPrefix
+                                        defaults:(NSUserDefaults *)defaults
+                                           cache:(UAPreferenceCache *)cache;
+
+/**
+ * Writes any pending values to NSUserDefaults. Writes are otherwise coalesced and
+ * flushed shortly after they are made, or when the app backgrounds or terminates.
+ */
+- (void)synchronize;
+
+/**
+ * Returns the number of reads and writes per key, to help find hot preferences.
+ * @return A map of unprefixed key to access count.
+ */
+- (NSDictionary<NSString *, NSNumber *> *)accessCounts;
+
 /**
  * Migrates any values in NSUserDefaults that are not prefixed.
  * @param keys The keys to migrate.
@@ -1,9 +1,11 @@
 /* Copyright Airship and Contributors */
 
 #import "UAPreferenceDataStore+Internal.h"
+#import "UAPreferenceCache+Internal.h"
 
 @interface UAPreferenceDataStore()
 @property (nonatomic, strong) NSUserDefaults *defaults;
+@property (nonatomic, strong) UAPreferenceCache *cache;
 @property (nonatomic, copy) NSString *keyPrefix;
 @end
 
@@ -11,8 +13,17 @@
 @implementation UAPreferenceDataStore
 
 + (instancetype)preferenceDataStoreWithKeyPrefix:(NSString *)keyPrefix {
+    return [self preferenceDataStoreWithKeyPrefix:keyPrefix
+                                         defaults:[NSUserDefaults standardUserDefaults]
+                                            cache:[UAPreferenceCache shared]];
+}
+
++ (instancetype)preferenceDataStoreWithKeyPrefix:(NSString *)keyPrefix
+                                        defaults:(NSUserDefaults *)defaults
+                                           cache:(UAPreferenceCache *)cache {
     UAPreferenceDataStore *dataStore = [[UAPreferenceDataStore alloc] init];
-    dataStore.defaults = [NSUserDefaults standardUserDefaults];
+    dataStore.defaults = defaults;
+    dataStore.cache = cache;
     dataStore.keyPrefix = keyPrefix;
     return dataStore;
 }
@@ -22,15 +33,15 @@
 }
 
 - (id)valueForKey:(NSString *)key {
-    return [self.defaults valueForKey:[self prefixKey:key]];
+    return [self objectForKey:key];
 }
 
 - (void)setValue:(id)value forKey:(NSString *)key {
-    [self.defaults setValue:value forKey:[self prefixKey:key]];
+    [self setObject:value forKey:key];
 }
 
 - (void)removeObjectForKey:(NSString *)key {
-    [self.defaults removeObjectForKey:[self prefixKey:key]];
+    [self.cache setObject:nil forKey:[self prefixKey:key]];
 }
 
 - (BOOL)keyExists:(NSString *)key {
@@ -38,39 +49,73 @@
 }
 
 - (id)objectForKey:(NSString *)key {
-    return [self.defaults objectForKey:[self prefixKey:key]];
+    return [self.cache objectForKey:[self prefixKey:key]];
+}
+
+- (id)objectForKey:(NSString *)key ofClass:(Class)expectedClass {
+    id value = [self objectForKey:key];
+    return [value isKindOfClass:expectedClass] ? value : nil;
 }
 
 - (NSString *)stringForKey:(NSString *)key {
-    return [self.defaults stringForKey:[self prefixKey:key]];
+    id value = [self objectForKey:key];
+
+    // NSUserDefaults converts numbers to strings
+    if ([value isKindOfClass:[NSNumber class]]) {
+        return [value stringValue];
+    }
+
+    return [value isKindOfClass:[NSString class]] ? value : nil;
 }
 
 - (NSArray *)arrayForKey:(NSString *)key {
-    return [self.defaults arrayForKey:[self prefixKey:key]];
+    return [self objectForKey:key ofClass:[NSArray class]];
 }
 
 - (NSDictionary *)dictionaryForKey:(NSString *)key {
-    return [self.defaults dictionaryForKey:[self prefixKey:key]];
+    return [self objectForKey:key ofClass:[NSDictionary class]];
 }
 
 - (NSData *)dataForKey:(NSString *)key {
-    return [self.defaults dataForKey:[self prefixKey:key]];
+    return [self objectForKey:key ofClass:[NSData class]];
 }
 
 - (NSArray *)stringArrayForKey:(NSString *)key {
-    return [self.defaults stringArrayForKey:[self prefixKey:key]];
+    NSArray *array = [self arrayForKey:key];
+    for (id value in array) {
+        if (![value isKindOfClass:[NSString class]]) {
+            return nil;
+        }
+    }
+
+    return array;
 }
 
 - (NSInteger)integerForKey:(NSString *)key {
-    return [self.defaults integerForKey:[self prefixKey:key]];
+    id value = [self objectForKey:key];
+    if ([value isKindOfClass:[NSNumber class]] || [value isKindOfClass:[NSString class]]) {
+        return [value integerValue];
+    }
+
+    return 0;
 }
 
 - (float)floatForKey:(NSString *)key {
-    return [self.defaults floatForKey:[self prefixKey:key]];
+    id value = [self objectForKey:key];
+    if ([value isKindOfClass:[NSNumber class]] || [value isKindOfClass:[NSString class]]) {
+        return [value floatValue];
+    }
+
+    return 0;
 }
 
 - (double)doubleForKey:(NSString *)key {
-    return [self.defaults doubleForKey:[self prefixKey:key]];
+    id value = [self objectForKey:key];
+    if ([value isKindOfClass:[NSNumber class]] || [value isKindOfClass:[NSString class]]) {
+        return [value doubleValue];
+    }
+
+    return 0;
 }
 
 - (double)doubleForKey:(NSString *)key defaultValue:(double)defaultValue {
@@ -82,7 +127,12 @@
 }
 
 - (BOOL)boolForKey:(NSString *)key {
-    return [self.defaults boolForKey:[self prefixKey:key]];
+    id value = [self objectForKey:key];
+    if ([value isKindOfClass:[NSNumber class]] || [value isKindOfClass:[NSString class]]) {
+        return [value boolValue];
+    }
+
+    return NO;
 }
 
 - (BOOL)boolForKey:(NSString *)key defaultValue:(BOOL)defaultValue {
@@ -94,31 +144,55 @@
 }
 
 - (NSURL *)URLForKey:(NSString *)key {
-    return [self.defaults URLForKey:[self prefixKey:key]];
+    id value = [self objectForKey:key];
+
+    if ([value isKindOfClass:[NSURL class]]) {
+        return value;
+    }
+
+    // Values written by NSUserDefaults' setURL:forKey: are either archived URLs or file paths
+    if ([value isKindOfClass:[NSData class]]) {
+        id unarchived = [NSKeyedUnarchiver unarchiveObjectWithData:value];
+        return [unarchived isKindOfClass:[NSURL class]] ? unarchived : nil;
+    }
+
+    if ([value isKindOfClass:[NSString class]]) {
+        return [NSURL fileURLWithPath:[value stringByExpandingTildeInPath]];
+    }
+
+    return nil;
 }
 
 - (void)setInteger:(NSInteger)value forKey:(NSString *)key {
-    [self.defaults setInteger:value forKey:[self prefixKey:key]];
+    [self setObject:@(value) forKey:key];
 }
 
 - (void)setFloat:(float)value forKey:(NSString *)key {
-    [self.defaults setFloat:value forKey:[self prefixKey:key]];
+    [self setObject:@(value) forKey:key];
 }
 
 - (void)setDouble:(double)value forKey:(NSString *)key {
-    [self.defaults setDouble:value forKey:[self prefixKey:key]];
+    [self setObject:@(value) forKey:key];
 }
 
 - (void)setBool:(BOOL)value forKey:(NSString *)key {
-    [self.defaults setBool:value forKey:[self prefixKey:key]];
+    [self setObject:@(value) forKey:key];
 }
 
 - (void)setURL:(NSURL *)value forKey:(NSString *)key {
-    [self.defaults setURL:value forKey:[self prefixKey:key]];
+    [self setObject:value forKey:key];
 }
 
 - (void)setObject:(id)value forKey:(NSString *)key {
-    [self.defaults setObject:value forKey:[self prefixKey:key]];
+    [self.cache setObject:value forKey:[self prefixKey:key]];
+}
+
+- (void)synchronize {
+    [self.cache flush];
+}
+
+- (NSDictionary<NSString *, NSNumber *> *)accessCounts {
+    return [self.cache accessCountsForKeysWithPrefix:self.keyPrefix];
 }
 
 - (void)migrateUnprefixedKeys:(NSArray *)keys {
@@ -126,19 +200,17 @@
     for (NSString *key in keys) {
         id value = [self.defaults objectForKey:key];
         if (value) {
-            [self.defaults setValue:value forKey:[self prefixKey:key]];
+            [self setObject:value forKey:key];
             [self.defaults removeObjectForKey:key];
         }
     }
+
+    // Don't let the migrated values sit in memory once the originals are gone
+    [self.cache flush];
 }
 
 - (void)removeAll {
-    for (NSString *key in [[self.defaults dictionaryRepresentation] allKeys]) {
-        if ([key hasPrefix:self.keyPrefix]) {
-            [self.defaults removeObjectForKey:key];
-        }
-    }
-    [self.defaults synchronize];
+    [self.cache removeKeysWithPrefix:self.keyPrefix];
 }
 
 @end
@@ -0,0 +1,84 @@
+/* Copyright Airship and Contributors */
+
+#import <UIKit/UIKit.h>
+#import "UAPushableComponent.h"
+
+@class UADispatcher;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * The default time budget for processing a remote notification, leaving headroom in the 30 second
+ * background execution window.
+ */
+extern const NSTimeInterval UAPushProcessingSchedulerDefaultTimeBudget;
+
+/**
+ * A push processing task block. The block must call the completion handler with its fetch result.
+ */
+typedef void (^UAPushProcessingTask)(void (^completionHandler)(UIBackgroundFetchResult));
+
+/**
+ * Runs remote notification processing tasks against a deadline.
+ *
+ * Tasks are started in priority order. Tasks whose expected processing time does not fit in the remaining
+ * budget are deferred until after the completion handler is called, unless they are high priority or expect no
+ * processing time. The completion handler is called with the merged fetch result once every high and normal
+ * priority task finishes, or once the deadline passes and every high priority task finishes, whichever comes first.
+ * Low priority tasks are never waited on. Results of tasks that finish later are dropped.
+ */
+@interface UAPushProcessingScheduler : NSObject
+
+///---------------------------------------------------------------------------------------
+/// @name Push Processing Scheduler Internal Properties
+///---------------------------------------------------------------------------------------
+
+/**
+ * The time in seconds each task took, keyed by task name. Tasks that have not finished are not included.
+ */
+@property (nonatomic, readonly) NSDictionary<NSString *, NSNumber *> *taskTimings;
+
+///---------------------------------------------------------------------------------------
+/// @name Push Processing Scheduler Internal Methods
+///---------------------------------------------------------------------------------------
+
+/**
+ * Factory method.
+ *
+ * @param timeBudget The time in seconds before the completion handler must be called.
+ * @return The scheduler.
+ */
++ (instancetype)schedulerWithTimeBudget:(NSTimeInterval)timeBudget;
+
+/**
+ * Factory method. Used for testing.
+ *
+ * @param timeBudget The time in seconds before the completion handler must be called.
+ * @param dispatcher The dispatcher used for the deadline and the completion handler.
+ * @return The scheduler.
+ */
++ (instancetype)schedulerWithTimeBudget:(NSTimeInterval)timeBudget dispatcher:(UADispatcher *)dispatcher;
+
+/**
+ * Adds a task. Tasks must be added before the scheduler is run.
+ *
+ * @param name The task name, used for timings and logging.
+ * @param priority The task priority.
+ * @param expectedTime The expected processing time in seconds.
+ * @param task The task.
+ */
+- (void)addTaskWithName:(NSString *)name
+               priority:(UAPushableComponentPriority)priority
+           expectedTime:(NSTimeInterval)expectedTime
+                   task:(UAPushProcessingTask)task;
+
+/**
+ * Runs the tasks.
+ *
+ * @param completionHandler The completion handler, called once on the dispatcher with the merged fetch result.
+ */
+- (void)runWithCompletionHandler:(void (^)(UIBackgroundFetchResult))completionHandler;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,230 @@
+/* Copyright Airship and Contributors */
+
+#import "UAPushProcessingScheduler+Internal.h"
+#import "UADispatcher.h"
+#import "UAUtils+Internal.h"
+#import "UAGlobal.h"
+
+const NSTimeInterval UAPushProcessingSchedulerDefaultTimeBudget = 25;
+
+@interface UAPushProcessingSchedulerEntry : NSObject
+@property (nonatomic, copy) NSString *name;
+@property (nonatomic, assign) UAPushableComponentPriority priority;
+@property (nonatomic, assign) NSTimeInterval expectedTime;
+@property (nonatomic, copy) UAPushProcessingTask task;
+@end
+
+@implementation UAPushProcessingSchedulerEntry
+@end
+
+@interface UAPushProcessingScheduler ()
+@property (nonatomic, assign) NSTimeInterval timeBudget;
+@property (nonatomic, strong) UADispatcher *dispatcher;
+@property (nonatomic, strong) NSMutableArray<UAPushProcessingSchedulerEntry *> *entries;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, NSNumber *> *timings;
+@property (nonatomic, strong) NSMutableArray<NSNumber *> *fetchResults;
+@property (nonatomic, strong) NSMutableSet<NSString *> *waitingTaskNames;
+@property (nonatomic, strong) NSMutableSet<NSString *> *waitingHighPriorityTaskNames;
+@property (nonatomic, strong) NSMutableArray<UAPushProcessingSchedulerEntry *> *deferredEntries;
+@property (nonatomic, copy, nullable) void (^completionHandler)(UIBackgroundFetchResult);
+@property (nonatomic, strong, nullable) UADisposable *deadlineDisposable;
+@property (nonatomic, assign) NSTimeInterval startTime;
+@property (nonatomic, assign) BOOL starting;
+@property (nonatomic, assign) BOOL deadlinePassed;
+@property (nonatomic, assign) BOOL finished;
+@end
+
+@implementation UAPushProcessingScheduler
+
+- (instancetype)initWithTimeBudget:(NSTimeInterval)timeBudget dispatcher:(UADispatcher *)dispatcher {
+    self = [super init];
+
+    if (self) {
+        self.timeBudget = timeBudget;
+        self.dispatcher = dispatcher;
+        self.entries = [NSMutableArray array];
+        self.timings = [NSMutableDictionary dictionary];
+        self.fetchResults = [NSMutableArray array];
+        self.waitingTaskNames = [NSMutableSet set];
+        self.waitingHighPriorityTaskNames = [NSMutableSet set];
+        self.deferredEntries = [NSMutableArray array];
+    }
+
+    return self;
+}
+
++ (instancetype)schedulerWithTimeBudget:(NSTimeInterval)timeBudget {
+    return [[self alloc] initWithTimeBudget:timeBudget dispatcher:[UADispatcher mainDispatcher]];
+}
+
++ (instancetype)schedulerWithTimeBudget:(NSTimeInterval)timeBudget dispatcher:(UADispatcher *)dispatcher {
+    return [[self alloc] initWithTimeBudget:timeBudget dispatcher:dispatcher];
+}
+
+- (NSDictionary<NSString *, NSNumber *> *)taskTimings {
+    @synchronized (self) {
+        return [self.timings copy];
+    }
+}
+
+- (void)addTaskWithName:(NSString *)name
+               priority:(UAPushableComponentPriority)priority
+           expectedTime:(NSTimeInterval)expectedTime
+                   task:(UAPushProcessingTask)task {
+    UAPushProcessingSchedulerEntry *entry = [[UAPushProcessingSchedulerEntry alloc] init];
+    entry.name = name;
+    entry.priority = priority;
+    entry.expectedTime = expectedTime;
+    entry.task = task;
+
+    @synchronized (self) {
+        [self.entries addObject:entry];
+    }
+}
+
+- (void)runWithCompletionHandler:(void (^)(UIBackgroundFetchResult))completionHandler {
+    NSArray<UAPushProcessingSchedulerEntry *> *entries;
+
+    @synchronized (self) {
+        self.completionHandler = completionHandler;
+        self.startTime = [NSProcessInfo processInfo].systemUptime;
+        self.starting = YES;
+
+        // Stable sort keeps the order tasks were added in within a priority
+        entries = [self.entries sortedArrayWithOptions:NSSortStable usingComparator:^NSComparisonResult(UAPushProcessingSchedulerEntry *a, UAPushProcessingSchedulerEntry *b) {
+            return [@(a.priority) compare:@(b.priority)];
+        }];
+    }
+
+    for (UAPushProcessingSchedulerEntry *entry in entries) {
+        // Tasks can finish synchronously, so the remaining budget shrinks as tasks are started
+        NSTimeInterval remaining = self.timeBudget - ([NSProcessInfo processInfo].systemUptime - self.startTime);
+
+        @synchronized (self) {
+            // Tasks that expect no processing time always fit, even once the budget is spent
+            if (entry.priority != UAPushableComponentPriorityHigh && entry.expectedTime > 0 && entry.expectedTime > remaining) {
+                UA_LDEBUG(@"Deferring push processing for %@, expected time %.1fs exceeds the remaining budget %.1fs", entry.name, entry.expectedTime, remaining);
+                [self.deferredEntries addObject:entry];
+                continue;
+            }
+
+            if (entry.priority != UAPushableComponentPriorityLow) {
+                [self.waitingTaskNames addObject:entry.name];
+            }
+
+            if (entry.priority == UAPushableComponentPriorityHigh) {
+                [self.waitingHighPriorityTaskNames addObject:entry.name];
+            }
+        }
+
+        [self startEntry:entry];
+    }
+
+    BOOL done;
+    NSTimeInterval remaining;
+
+    @synchronized (self) {
+        self.starting = NO;
+        done = !self.waitingTaskNames.count;
+        remaining = self.timeBudget - ([NSProcessInfo processInfo].systemUptime - self.startTime);
+
+        if (!done) {
+            self.deadlineDisposable = [self.dispatcher dispatchAfter:MAX(0, remaining) block:^{
+                [self deadlineReached];
+            }];
+        }
+    }
+
+    if (done) {
+        [self finishAtDeadline:NO];
+    }
+}
+
+#pragma mark -
+#pragma mark Helpers
+
+- (void)startEntry:(UAPushProcessingSchedulerEntry *)entry {
+    NSTimeInterval taskStartTime = [NSProcessInfo processInfo].systemUptime;
+
+    entry.task(^(UIBackgroundFetchResult result) {
+        NSTimeInterval duration = [NSProcessInfo processInfo].systemUptime - taskStartTime;
+        BOOL done = NO;
+        BOOL deadline = NO;
+
+        @synchronized (self) {
+            self.timings[entry.name] = @(duration);
+
+            if (self.finished) {
+                UA_LTRACE(@"Push processing for %@ finished after the completion handler in %.3fs", entry.name, duration);
+                return;
+            }
+
+            [self.fetchResults addObject:@(result)];
+            [self.waitingTaskNames removeObject:entry.name];
+            [self.waitingHighPriorityTaskNames removeObject:entry.name];
+
+            deadline = self.deadlinePassed;
+            if (deadline) {
+                done = !self.waitingHighPriorityTaskNames.count;
+            } else {
+                done = !self.starting && !self.waitingTaskNames.count;
+            }
+        }
+
+        if (done) {
+            [self finishAtDeadline:deadline];
+        }
+    });
+}
+
+- (void)deadlineReached {
+    @synchronized (self) {
+        self.deadlinePassed = YES;
+
+        // High priority tasks are always waited on, the deadline only stops waiting on the others
+        if (self.waitingHighPriorityTaskNames.count) {
+            UA_LDEBUG(@"Push processing deadline reached, waiting on high priority tasks %@", self.waitingHighPriorityTaskNames.allObjects);
+            return;
+        }
+    }
+
+    [self finishAtDeadline:YES];
+}
+
+- (void)finishAtDeadline:(BOOL)deadline {
+    NSArray<NSNumber *> *fetchResults;
+    NSArray<UAPushProcessingSchedulerEntry *> *deferredEntries;
+    void (^completionHandler)(UIBackgroundFetchResult);
+
+    @synchronized (self) {
+        if (self.finished) {
+            return;
+        }
+
+        self.finished = YES;
+        [self.deadlineDisposable dispose];
+        self.deadlineDisposable = nil;
+
+        if (deadline) {
+            UA_LDEBUG(@"Push processing deadline reached, not waiting on %@", self.waitingTaskNames.allObjects);
+        }
+
+        UA_LDEBUG(@"Push processing finished in %.3fs, task timings: %@", [NSProcessInfo processInfo].systemUptime - self.startTime, self.timings);
+
+        fetchResults = [self.fetchResults copy];
+        deferredEntries = [self.deferredEntries copy];
+        completionHandler = self.completionHandler;
+        self.completionHandler = nil;
+    }
+
+    [self.dispatcher dispatchAsyncIfNecessary:^{
+        completionHandler([UAUtils mergeFetchResults:fetchResults]);
+
+        // Best effort, the app may be suspended before these finish
+        for (UAPushProcessingSchedulerEntry *entry in deferredEntries) {
+            [self startEntry:entry];
+        }
+    }];
+}
+
+@end
@@ -4,6 +4,27 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+/**
+ * Remote notification processing priority.
+ * @note For internal use only. :nodoc:
+ */
+typedef NS_ENUM(NSInteger, UAPushableComponentPriority) {
+    /**
+     * Always started and always waited on, even past the processing deadline.
+     */
+    UAPushableComponentPriorityHigh = 0,
+
+    /**
+     * Waited on until the processing deadline. Deferred if a non-zero expected processing time does not fit in the remaining budget.
+     */
+    UAPushableComponentPriorityNormal,
+
+    /**
+     * Not waited on. Deferred if a non-zero expected processing time does not fit in the remaining budget.
+     */
+    UAPushableComponentPriorityLow,
+};
+
 /**
  * Internal protocol to fan out push handling to UAComponents.
  * @note For internal use only. :nodoc:
@@ -19,6 +40,18 @@ NS_ASSUME_NONNULL_BEGIN
  */
 -(void)receivedRemoteNotification:(UANotificationContent *)notification completionHandler:(void (^)(UIBackgroundFetchResult))completionHandler;
 
+/**
+ * The priority of processing a remote notification. Defaults to `UAPushableComponentPriorityNormal`.
+ * @return The priority.
+ */
+-(UAPushableComponentPriority)pushProcessingPriority;
+
+/**
+ * The expected time in seconds to process a remote notification. Defaults to 0.
+ * @return The expected processing time.
+ */
+-(NSTimeInterval)expectedPushProcessingTime;
+
 /**
  * Called when a notification response is received.
  * @param response The notification response.
@@ -16,9 +16,11 @@ NS_ASSUME_NONNULL_BEGIN
  * A block called when the refresh of the remote data succeeded.
  *
  * @param statusCode The request status code.
- * @param remoteData The refreshed remote data.
+ * @param remoteData The refreshed remote data. For a delta response, only the payloads of changed types.
+ * @param unchangedTypes For a delta response, the cached types that did not change. `nil` for a full response,
+ * which replaces all cached remote data.
  */
-typedef void (^UARemoteDataRefreshSuccessBlock)(NSUInteger statusCode, NSArray<NSDictionary *> * __nullable remoteData);
+typedef void (^UARemoteDataRefreshSuccessBlock)(NSUInteger statusCode, NSArray<NSDictionary *> * __nullable remoteData, NSSet<NSString *> * __nullable unchangedTypes);
 
 /**
  * A block called when the refresh of the remote data failed.
@@ -56,6 +58,12 @@ typedef void (^UARemoteDataRefreshFailureBlock)(void);
 /**
  * Refresh the remote data by calling the remote data cloud API.
  *
+ * If a previous response included per-type versions, they are sent back so the server can reply with a
+ * delta: `{"delta": true, "payloads": [...], "removed_types": [...], "versions": {...}}`, where `payloads`
+ * only holds the changed types and every other versioned type is unchanged. Only the versions of types with
+ * payloads in the cache are sent back. Servers without delta support reply with the full document, which is
+ * always accepted.
+ *
  * @param successBlock The block called when the refresh of the remote data succeeds.
  * @param failureBlock The block called when the refresh of the remote data fails.
  * @return A UADisposable token which can be used to cancel callback execution.
@@ -66,7 +74,7 @@ typedef void (^UARemoteDataRefreshFailureBlock)(void);
                         onFailure:(UARemoteDataRefreshFailureBlock)failureBlock;
 
 /**
- * Clears the last modified time for message list requests.
+ * Clears the last modified time and the per-type versions, so the next refresh fetches the full document.
  */
 - (void)clearLastModifiedTime;
 
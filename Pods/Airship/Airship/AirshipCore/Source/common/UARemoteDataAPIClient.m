@@ -16,6 +16,13 @@
 NSString * const kRemoteDataPath = @"api/remote-data/app";
 
 NSString * const kUALastRemoteDataModifiedTime = @"UALastRemoteDataModifiedTime";
+NSString * const kUARemoteDataTypeVersions = @"UARemoteDataTypeVersions";
+
+static NSString * const UARemoteDataVersionsHeader = @"X-UA-Remote-Data-Versions";
+static NSString * const UARemoteDataPayloadsKey = @"payloads";
+static NSString * const UARemoteDataVersionsKey = @"versions";
+static NSString * const UARemoteDataDeltaKey = @"delta";
+static NSString * const UARemoteDataRemovedTypesKey = @"removed_types";
 
 - (UARemoteDataAPIClient *)initWithConfig:(UARuntimeConfig *)config
                                 dataStore:(UAPreferenceDataStore *)dataStore
@@ -32,7 +39,7 @@ NSString * const kUALastRemoteDataModifiedTime = @"UALastRemoteDataModifiedTime"
 + (UARemoteDataAPIClient *)clientWithConfig:(UARuntimeConfig *)config dataStore:(UAPreferenceDataStore *)dataStore {
     return [[self alloc] initWithConfig:config
                               dataStore:dataStore
-                                session:[UARequestSession sessionWithConfig:config]];
+                                session:[UARequestSession sessionWithConfig:config requestClass:@"remote_data" priority:UARequestPriorityLow]];
 }
 
 + (UARemoteDataAPIClient *)clientWithConfig:(UARuntimeConfig *)config
@@ -46,7 +53,10 @@ NSString * const kUALastRemoteDataModifiedTime = @"UALastRemoteDataModifiedTime"
 - (UADisposable *)fetchRemoteData:(UARemoteDataRefreshSuccessBlock)successBlock
                         onFailure:(UARemoteDataRefreshFailureBlock)failureBlock {
 
-    UARequest *refreshRequest = [self requestToRefreshRemoteData];
+    // Captured with the request, since the delta is relative to what was sent. Versions only describe the
+    // cache while the last response is still stored.
+    NSDictionary<NSString *, NSString *> *sentVersions = [self.dataStore stringForKey:kUALastRemoteDataModifiedTime] ? [self typeVersions] : nil;
+    UARequest *refreshRequest = [self requestToRefreshRemoteDataWithVersions:sentVersions];
 
     UA_LTRACE(@"Request to refresh remote data: %@", refreshRequest.URL);
 
@@ -83,7 +93,7 @@ NSString * const kUALastRemoteDataModifiedTime = @"UALastRemoteDataModifiedTime"
         // 304, no changes
         if (httpResponse.statusCode == 304) {
             if (refreshRemoteDataSuccessBlock) {
-                refreshRemoteDataSuccessBlock(httpResponse.statusCode, nil);
+                refreshRemoteDataSuccessBlock(httpResponse.statusCode, nil, nil);
             }
             return;
         }
@@ -117,12 +127,34 @@ NSString * const kUALastRemoteDataModifiedTime = @"UALastRemoteDataModifiedTime"
 
         UA_LTRACE(@"Retrieved remote data with status: %ld jsonResponse: %@", (unsigned long)httpResponse.statusCode, jsonResponse);
         
-        NSArray *remoteData = [jsonResponse objectForKey:@"payloads"];
-        
+        NSArray *remoteData = [jsonResponse objectForKey:UARemoteDataPayloadsKey];
+
+        NSSet<NSString *> *unchangedTypes = nil;
+        if ([[jsonResponse objectForKey:UARemoteDataDeltaKey] isEqual:@YES]) {
+            unchangedTypes = [UARemoteDataAPIClient unchangedTypesWithVersions:sentVersions
+                                                                    remoteData:remoteData
+                                                                  removedTypes:[jsonResponse objectForKey:UARemoteDataRemovedTypesKey]];
+
+            // A delta against versions that were never sent can't be applied
+            if (!unchangedTypes) {
+                UA_LERR(@"Unable to apply remote data delta, falling back to a full refresh.");
+                [self clearLastModifiedTime];
+                if (refreshRemoteDataFailureBlock) {
+                    refreshRemoteDataFailureBlock();
+                }
+                return;
+            }
+
+            UA_LTRACE(@"Retrieved remote data delta, unchanged types: %@", unchangedTypes);
+        }
+
         [self.dataStore setValue:lastModified forKey:kUALastRemoteDataModifiedTime];
-        
+        [self setTypeVersions:[UARemoteDataAPIClient cachedTypeVersions:[UARemoteDataAPIClient typeVersionsFromJSON:[jsonResponse objectForKey:UARemoteDataVersionsKey]]
+                                                             remoteData:remoteData
+                                                         unchangedTypes:unchangedTypes]];
+
         if (refreshRemoteDataSuccessBlock) {
-            refreshRemoteDataSuccessBlock(httpResponse.statusCode, remoteData);
+            refreshRemoteDataSuccessBlock(httpResponse.statusCode, remoteData, unchangedTypes);
         }
     }];
     
@@ -130,7 +162,7 @@ NSString * const kUALastRemoteDataModifiedTime = @"UALastRemoteDataModifiedTime"
 
 }
 
-- (UARequest *)requestToRefreshRemoteData {
+- (UARequest *)requestToRefreshRemoteDataWithVersions:(nullable NSDictionary<NSString *, NSString *> *)versions {
     UA_WEAKIFY(self)
     UARequest *request = [UARequest requestWithBuilderBlock:^(UARequestBuilder * _Nonnull builder) {
         UA_STRONGIFY(self)
@@ -143,6 +175,11 @@ NSString * const kUALastRemoteDataModifiedTime = @"UALastRemoteDataModifiedTime"
         if (lastModified) {
             [builder setValue:lastModified forHeader:@"If-Modified-Since"];
         }
+
+        NSString *versionsHeader = [UARemoteDataAPIClient headerValueForVersions:versions];
+        if (versionsHeader) {
+            [builder setValue:versionsHeader forHeader:UARemoteDataVersionsHeader];
+        }
     }];
     
     return request;
@@ -178,6 +215,109 @@ NSString * const kUALastRemoteDataModifiedTime = @"UALastRemoteDataModifiedTime"
 
 - (void)clearLastModifiedTime {
     [self.dataStore removeObjectForKey:kUALastRemoteDataModifiedTime];
+    [self.dataStore removeObjectForKey:kUARemoteDataTypeVersions];
+}
+
+#pragma mark -
+#pragma mark Delta
+
+- (nullable NSDictionary<NSString *, NSString *> *)typeVersions {
+    return [UARemoteDataAPIClient typeVersionsFromJSON:[self.dataStore objectForKey:kUARemoteDataTypeVersions]];
+}
+
+- (void)setTypeVersions:(nullable NSDictionary<NSString *, NSString *> *)versions {
+    if (versions.count) {
+        [self.dataStore setObject:versions forKey:kUARemoteDataTypeVersions];
+    } else {
+        [self.dataStore removeObjectForKey:kUARemoteDataTypeVersions];
+    }
+}
+
+/**
+ * Parses a type to version map. Entries that are not strings are dropped.
+ */
++ (nullable NSDictionary<NSString *, NSString *> *)typeVersionsFromJSON:(id)json {
+    if (![json isKindOfClass:[NSDictionary class]]) {
+        return nil;
+    }
+
+    NSMutableDictionary<NSString *, NSString *> *versions = [NSMutableDictionary dictionary];
+    for (id type in json) {
+        id version = json[type];
+        if ([type isKindOfClass:[NSString class]] && [version isKindOfClass:[NSString class]]) {
+            versions[type] = version;
+        }
+    }
+
+    return versions.count ? versions : nil;
+}
+
++ (nullable NSString *)headerValueForVersions:(nullable NSDictionary<NSString *, NSString *> *)versions {
+    if (!versions.count) {
+        return nil;
+    }
+
+    NSData *data = [NSJSONSerialization dataWithJSONObject:versions options:NSJSONWritingSortedKeys error:nil];
+    return data ? [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding] : nil;
+}
+
+/**
+ * The versioned types that are neither in the delta's payloads nor removed, or `nil` if no versions were sent.
+ */
++ (nullable NSSet<NSString *> *)unchangedTypesWithVersions:(nullable NSDictionary<NSString *, NSString *> *)versions
+                                                remoteData:(nullable NSArray *)remoteData
+                                              removedTypes:(nullable id)removedTypes {
+    if (!versions.count) {
+        return nil;
+    }
+
+    NSMutableSet<NSString *> *unchangedTypes = [NSMutableSet setWithArray:versions.allKeys];
+    [unchangedTypes minusSet:[UARemoteDataAPIClient typesInRemoteData:remoteData]];
+
+    if ([removedTypes isKindOfClass:[NSArray class]]) {
+        for (id type in removedTypes) {
+            if ([type isKindOfClass:[NSString class]]) {
+                [unchangedTypes removeObject:type];
+            }
+        }
+    }
+
+    return unchangedTypes;
+}
+
+/**
+ * The versions of the types the cache holds payloads for once the response is applied: the types in the
+ * payloads and the unchanged types. A versioned type without payloads is never stored, so sending its version
+ * would make every delta fail on the missing type.
+ */
++ (nullable NSDictionary<NSString *, NSString *> *)cachedTypeVersions:(nullable NSDictionary<NSString *, NSString *> *)versions
+                                                           remoteData:(nullable NSArray *)remoteData
+                                                       unchangedTypes:(nullable NSSet<NSString *> *)unchangedTypes {
+    NSMutableSet<NSString *> *cachedTypes = [UARemoteDataAPIClient typesInRemoteData:remoteData];
+    if (unchangedTypes) {
+        [cachedTypes unionSet:unchangedTypes];
+    }
+
+    NSMutableDictionary<NSString *, NSString *> *cachedVersions = [NSMutableDictionary dictionary];
+    for (NSString *type in versions) {
+        if ([cachedTypes containsObject:type]) {
+            cachedVersions[type] = versions[type];
+        }
+    }
+
+    return cachedVersions.count ? cachedVersions : nil;
+}
+
++ (NSMutableSet<NSString *> *)typesInRemoteData:(nullable NSArray *)remoteData {
+    NSMutableSet<NSString *> *types = [NSMutableSet set];
+    for (id payload in remoteData) {
+        id type = [payload isKindOfClass:[NSDictionary class]] ? payload[UARemoteDataTypeKey] : nil;
+        if ([type isKindOfClass:[NSString class]]) {
+            [types addObject:type];
+        }
+    }
+
+    return types;
 }
 
 @end
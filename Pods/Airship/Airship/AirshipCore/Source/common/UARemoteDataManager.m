@@ -9,6 +9,7 @@
 #import "UAirshipVersion.h"
 #import "UAUtils+Internal.h"
 #import "UAAppStateTracker.h"
+#import "UAMetrics+Internal.h"
 
 NSString * const kUACoreDataStoreName = @"RemoteData-%@.sqlite";
 NSString * const UARemoteDataRefreshIntervalKey = @"remotedata.REFRESH_INTERVAL";
@@ -27,7 +28,7 @@ NSInteger const UARemoteDataRefreshIntervalDefault = 0;
 
 @property (nonatomic, copy) NSArray<NSString *> *payloadTypes;
 @property (nonatomic, copy) UARemoteDataPublishBlock publishBlock;
-@property (nonatomic, strong) NSArray<UARemoteDataPayload *> *previousPayloads;
+@property (nonatomic, copy, nullable) NSDictionary<NSString *, NSString *> *previousTypeHashes;
 
 @end
 
@@ -40,7 +41,8 @@ NSInteger const UARemoteDataRefreshIntervalDefault = 0;
 - (nonnull instancetype)initWithTypes:(NSArray<NSString *> *)payloadTypes block:(UARemoteDataPublishBlock)publishBlock {
     self = [super init];
     if (self) {
-        self.payloadTypes = payloadTypes;
+        // Duplicate types would otherwise deliver the same payloads twice
+        self.payloadTypes = [NSOrderedSet orderedSetWithArray:payloadTypes].array;
         self.publishBlock = publishBlock;
     }
     return self;
@@ -50,19 +52,21 @@ NSInteger const UARemoteDataRefreshIntervalDefault = 0;
  * Notifies a single remote data subscriber.
  *
  * @param remoteDataPayloads The remote data payloads to be sent to the subscriber.
+ * @param typeHashes The content hash of each subscribed type present in the payloads.
  * @param completionHandler Optional completion handler called after the subscriber has been notified.
  */
 - (void)notifyRemoteData:(NSArray<UARemoteDataPayload *> *)remoteDataPayloads
+              typeHashes:(NSDictionary<NSString *, NSString *> *)typeHashes
               dispatcher:(UADispatcher *)dispatcher
        completionHandler:(void (^)(void))completionHandler {
 
     [dispatcher dispatchAsync:^{
-        if (remoteDataPayloads.count && ![self.previousPayloads isEqualToArray:remoteDataPayloads]) {
+        if (remoteDataPayloads.count && ![self.previousTypeHashes isEqualToDictionary:typeHashes]) {
             @synchronized(self) {
                 if (self.publishBlock) {
                     self.publishBlock(remoteDataPayloads);
                 }
-                self.previousPayloads = remoteDataPayloads;
+                self.previousTypeHashes = typeHashes;
             }
         }
         if (completionHandler) {
@@ -73,6 +77,161 @@ NSInteger const UARemoteDataRefreshIntervalDefault = 0;
 
 @end
 
+/**
+ * Payloads grouped by type, built once per refresh and shared by all subscriptions. Types kept in the store by a
+ * delta are only known by their content hash, and are loaded from the store for the subscriptions that need them.
+ */
+@interface UARemoteDataTypeIndex : NSObject
+
+@property (nonatomic, strong) NSMutableDictionary<NSString *, NSMutableArray<UARemoteDataPayload *> *> *payloadsByType;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, NSString *> *hashesByType;
+@property (nonatomic, copy) NSSet<NSString *> *storedTypes;
+@property (nonatomic, strong, nullable) UARemoteDataStore *remoteDataStore;
+
+@end
+
+@implementation UARemoteDataTypeIndex
+
++ (instancetype)indexWithPayloads:(NSArray<UARemoteDataPayload *> *)payloads {
+    return [[self alloc] initWithPayloads:payloads storedTypes:[NSSet set] contentHashes:nil remoteDataStore:nil];
+}
+
++ (instancetype)indexWithPayloads:(NSArray<UARemoteDataPayload *> *)payloads
+                      storedTypes:(NSSet<NSString *> *)storedTypes
+                    contentHashes:(NSDictionary<NSString *, NSString *> *)contentHashes
+                  remoteDataStore:(UARemoteDataStore *)remoteDataStore {
+    return [[self alloc] initWithPayloads:payloads storedTypes:storedTypes contentHashes:contentHashes remoteDataStore:remoteDataStore];
+}
+
++ (NSArray<UARemoteDataPayload *> *)payloadsWithStorePayloads:(NSArray<UARemoteDataStorePayload *> *)storePayloads {
+    NSMutableArray<UARemoteDataPayload *> *payloads = [NSMutableArray arrayWithCapacity:storePayloads.count];
+
+    for (UARemoteDataStorePayload *payload in storePayloads) {
+        [payloads addObject:[[UARemoteDataPayload alloc] initWithType:payload.type timestamp:payload.timestamp data:payload.data metadata:payload.metadata]];
+    }
+
+    return payloads;
+}
+
+- (instancetype)initWithPayloads:(NSArray<UARemoteDataPayload *> *)payloads
+                     storedTypes:(NSSet<NSString *> *)storedTypes
+                   contentHashes:(nullable NSDictionary<NSString *, NSString *> *)contentHashes
+                 remoteDataStore:(nullable UARemoteDataStore *)remoteDataStore {
+    self = [super init];
+    if (self) {
+        NSMutableDictionary<NSString *, NSMutableArray<UARemoteDataPayload *> *> *payloadsByType = [NSMutableDictionary dictionary];
+        for (UARemoteDataPayload *payload in payloads) {
+            NSMutableArray *typePayloads = payloadsByType[payload.type];
+            if (!typePayloads) {
+                typePayloads = [NSMutableArray array];
+                payloadsByType[payload.type] = typePayloads;
+            }
+            [typePayloads addObject:payload];
+        }
+
+        self.payloadsByType = payloadsByType;
+
+        // Hashes already known from the store are reused instead of rehashing the type
+        self.hashesByType = contentHashes ? [contentHashes mutableCopy] : [NSMutableDictionary dictionary];
+
+        // Stored types without a hash always count as changed
+        for (NSString *type in storedTypes) {
+            if (!self.hashesByType[type]) {
+                self.hashesByType[type] = [NSUUID UUID].UUIDString;
+            }
+        }
+
+        self.storedTypes = storedTypes;
+        self.remoteDataStore = remoteDataStore;
+    }
+    return self;
+}
+
+/**
+ * Content hash for the type, computed on first use so types nobody subscribes to are never hashed.
+ */
+- (NSString *)hashForType:(NSString *)type {
+    @synchronized (self) {
+        NSString *hash = self.hashesByType[type];
+        if (!hash) {
+            // Unhashable content always counts as changed
+            hash = [UARemoteDataPayload contentHashForPayloads:self.payloadsByType[type]] ?: [NSUUID UUID].UUIDString;
+            self.hashesByType[type] = hash;
+        }
+        return hash;
+    }
+}
+
+/**
+ * Notifies the subscription with its payloads, ordered by the subscription's type order. Stored types are loaded
+ * only if the subscription's hashes changed.
+ */
+- (void)notifySubscription:(UARemoteDataSubscription *)subscription
+                dispatcher:(UADispatcher *)dispatcher
+         completionHandler:(nullable void (^)(void))completionHandler {
+    NSMutableArray<UARemoteDataPayload *> *payloads = [NSMutableArray array];
+    NSMutableDictionary<NSString *, NSString *> *typeHashes = [NSMutableDictionary dictionary];
+    NSMutableArray<NSString *> *unloadedTypes = [NSMutableArray array];
+
+    @synchronized (self) {
+        for (NSString *type in subscription.payloadTypes) {
+            NSArray *typePayloads = self.payloadsByType[type];
+            if (typePayloads.count) {
+                [payloads addObjectsFromArray:typePayloads];
+                typeHashes[type] = [self hashForType:type];
+            } else if (!typePayloads && [self.storedTypes containsObject:type]) {
+                [unloadedTypes addObject:type];
+                typeHashes[type] = [self hashForType:type];
+            }
+        }
+    }
+
+    if (!unloadedTypes.count) {
+        [subscription notifyRemoteData:payloads typeHashes:typeHashes dispatcher:dispatcher completionHandler:completionHandler];
+        return;
+    }
+
+    BOOL unchanged;
+    @synchronized (subscription) {
+        unchanged = [subscription.previousTypeHashes isEqualToDictionary:typeHashes];
+    }
+
+    if (unchanged) {
+        // Nothing is published for empty payloads, only the completion handler is called
+        [subscription notifyRemoteData:@[] typeHashes:typeHashes dispatcher:dispatcher completionHandler:completionHandler];
+        return;
+    }
+
+    NSPredicate *fetchPredicate = [NSPredicate predicateWithFormat:@"(type IN %@)", unloadedTypes];
+
+    // The index is only held by the refresh that built it, so the fetch keeps it alive
+    [self.remoteDataStore fetchRemoteDataFromCacheWithPredicate:fetchPredicate completionHandler:^(NSArray<UARemoteDataStorePayload *> *storePayloads) {
+        NSArray<UARemoteDataPayload *> *loadedPayloads = [UARemoteDataTypeIndex payloadsWithStorePayloads:storePayloads];
+
+        @synchronized (self) {
+            NSMutableDictionary<NSString *, NSMutableArray<UARemoteDataPayload *> *> *loadedPayloadsByType = [NSMutableDictionary dictionary];
+            for (NSString *type in unloadedTypes) {
+                loadedPayloadsByType[type] = [NSMutableArray array];
+            }
+
+            for (UARemoteDataPayload *payload in loadedPayloads) {
+                [loadedPayloadsByType[payload.type] addObject:payload];
+            }
+
+            // Another subscription may have loaded the same types first
+            for (NSString *type in loadedPayloadsByType) {
+                if (!self.payloadsByType[type]) {
+                    self.payloadsByType[type] = loadedPayloadsByType[type];
+                }
+            }
+        }
+
+        [self notifySubscription:subscription dispatcher:dispatcher completionHandler:completionHandler];
+    }];
+}
+
+@end
+
 @interface UARemoteDataManager()
 @property (nonatomic, strong) UAPreferenceDataStore *dataStore;
 @property (nonatomic, strong) UARemoteDataAPIClient *remoteDataAPIClient;
@@ -285,6 +444,43 @@ completionHandler:(void(^)(BOOL success))completionHandler {
     }];
 }
 
+- (void)onNewDelta:(NSArray<UARemoteDataPayload *> *)remoteData
+    unchangedTypes:(NSSet<NSString *> *)unchangedTypes
+          metadata:(NSDictionary *)metadata
+      lastModified:(NSDate *)lastModified
+ completionHandler:(void(^)(BOOL success))completionHandler {
+    // Only the changed types are parsed, the unchanged types stay in the store
+    NSArray<UARemoteDataPayload *> *payloads = [UARemoteDataPayload remoteDataPayloadsFromJSON:remoteData metadata:metadata];
+
+    UA_WEAKIFY(self);
+    [self.remoteDataStore applyRemoteDataDelta:payloads unchangedTypes:unchangedTypes completionHandler:^(NSDictionary<NSString *, NSString *> *contentHashes) {
+        UA_STRONGIFY(self);
+        if (!contentHashes) {
+            // The next refresh falls back to a full fetch
+            [self.remoteDataAPIClient clearLastModifiedTime];
+            if (completionHandler) {
+                completionHandler(NO);
+            }
+            return;
+        }
+
+        [self.dataStore setObject:lastModified forKey:UARemoteDataLastRefreshTimeKey];
+        self.lastMetadata = metadata;
+
+        // notify remote data subscribers, the unchanged types are only loaded for subscribers that also need a changed type
+        UARemoteDataTypeIndex *index = [UARemoteDataTypeIndex indexWithPayloads:payloads
+                                                                    storedTypes:unchangedTypes
+                                                                  contentHashes:contentHashes
+                                                                remoteDataStore:self.remoteDataStore];
+
+        [self notifySubscribersWithIndex:index completionHandler:^{
+            if (completionHandler) {
+                completionHandler(YES);
+            }
+        }];
+    }];
+}
+
 - (void)refreshWithCompletionHandler:(void(^)(BOOL success))completionHandler {
     UA_WEAKIFY(self);
 
@@ -292,7 +488,10 @@ completionHandler:(void(^)(BOOL success))completionHandler {
         [self.remoteDataAPIClient clearLastModifiedTime];
     }
 
-    [self.remoteDataAPIClient fetchRemoteData:^(NSUInteger statusCode, NSArray<UARemoteDataPayload *> *allRemoteDataFromCloud) {
+    UAMetricsSpan span = UAMetricsSpanBegin(UAMetricsHistogramRemoteDataRefresh);
+    UAMetricsIncrement(UAMetricsCounterRemoteDataRefreshes, 1);
+
+    [self.remoteDataAPIClient fetchRemoteData:^(NSUInteger statusCode, NSArray<UARemoteDataPayload *> *allRemoteDataFromCloud, NSSet<NSString *> *unchangedTypes) {
         UA_STRONGIFY(self);
         if (statusCode == 200) {
             NSString *currentAppVersion = [[[NSBundle mainBundle] infoDictionary] objectForKey:@"CFBundleShortVersionString"];
@@ -300,14 +499,28 @@ completionHandler:(void(^)(BOOL success))completionHandler {
 
             NSDictionary *metadata = [self createMetadata:[NSLocale autoupdatingCurrentLocale]];
 
-            [self onNewData:allRemoteDataFromCloud metadata:metadata lastModified:[NSDate date] completionHandler:completionHandler];
+            void (^dataHandler)(BOOL) = ^(BOOL success) {
+                UAMetricsSpanEnd(span);
+                if (completionHandler) {
+                    completionHandler(success);
+                }
+            };
+
+            if (unchangedTypes) {
+                [self onNewDelta:allRemoteDataFromCloud unchangedTypes:unchangedTypes metadata:metadata lastModified:[NSDate date] completionHandler:dataHandler];
+            } else {
+                [self onNewData:allRemoteDataFromCloud metadata:metadata lastModified:[NSDate date] completionHandler:dataHandler];
+            }
         } else {
             // statusCode == 304
+            UAMetricsSpanEnd(span);
             if (completionHandler) {
                 completionHandler(YES);
             }
         }
     } onFailure:^{
+        UAMetricsSpanEnd(span);
+        UAMetricsIncrement(UAMetricsCounterRemoteDataRefreshFailures, 1);
         if (completionHandler) {
             completionHandler(NO);
         }
@@ -355,7 +568,20 @@ completionHandler:(void(^)(BOOL success))completionHandler {
  * @param completionHandler Optional completion handler.
  */
 - (void)notifySubscribersWithRemoteData:(NSArray<UARemoteDataPayload *> *)remoteDataPayloads completionHandler:(void (^)(void))completionHandler {
-    NSArray *subscriptions = [self.subscriptions copy];
+    [self notifySubscribersWithIndex:[UARemoteDataTypeIndex indexWithPayloads:remoteDataPayloads] completionHandler:completionHandler];
+}
+
+/**
+ * Notifies all subscriptions from a type index.
+ *
+ * @param index The payloads and content hashes by type.
+ * @param completionHandler Optional completion handler.
+ */
+- (void)notifySubscribersWithIndex:(UARemoteDataTypeIndex *)index completionHandler:(void (^)(void))completionHandler {
+    NSArray *subscriptions;
+    @synchronized(self.subscriptions) {
+        subscriptions = [self.subscriptions copy];
+    }
 
     dispatch_group_t dispatchGroup = dispatch_group_create();
 
@@ -363,21 +589,7 @@ completionHandler:(void(^)(BOOL success))completionHandler {
     for (UARemoteDataSubscription *subscription in subscriptions) {
         dispatch_group_enter(dispatchGroup);
 
-        NSPredicate *predicate = [NSPredicate predicateWithFormat:@"(type IN %@)", subscription.payloadTypes];
-        NSArray *filteredPayloads = [remoteDataPayloads filteredArrayUsingPredicate:predicate];
-
-        NSArray *sorted = [filteredPayloads sortedArrayUsingComparator:^NSComparisonResult(id  _Nonnull obj1, id  _Nonnull obj2) {
-            UARemoteDataPayload *payload1 = (UARemoteDataPayload *)obj1;
-            UARemoteDataPayload *payload2 = (UARemoteDataPayload *)obj2;
-            NSUInteger indexObj1 = [subscription.payloadTypes indexOfObject:payload1.type];
-            NSUInteger indexObj2 = [subscription.payloadTypes indexOfObject:payload2.type];
-            if (indexObj1 == indexObj2) {
-                return NSOrderedSame;
-            }
-            return indexObj1 > indexObj2 ? NSOrderedDescending : NSOrderedAscending;
-        }];
-
-        [subscription notifyRemoteData:sorted dispatcher:self.dispatcher completionHandler:^{
+        [index notifySubscription:subscription dispatcher:self.dispatcher completionHandler:^{
             dispatch_group_leave(dispatchGroup);
         }];
     }
@@ -403,14 +615,8 @@ completionHandler:(void(^)(BOOL success))completionHandler {
     UA_WEAKIFY(self);
     [self.remoteDataStore fetchRemoteDataFromCacheWithPredicate:fetchPredicate completionHandler:^(NSArray<UARemoteDataStorePayload *> *payloads) {
         UA_STRONGIFY(self);
-        NSMutableArray<UARemoteDataPayload *> *remoteDataPayloads = [NSMutableArray arrayWithCapacity:payloads.count];
-
-        for (UARemoteDataStorePayload *payload in payloads) {
-            UARemoteDataPayload *remoteData = [[UARemoteDataPayload alloc] initWithType:payload.type timestamp:payload.timestamp data:payload.data metadata:payload.metadata];
-            [remoteDataPayloads addObject:remoteData];
-        }
-
-        [subscription notifyRemoteData:remoteDataPayloads dispatcher:self.dispatcher completionHandler:nil];
+        UARemoteDataTypeIndex *index = [UARemoteDataTypeIndex indexWithPayloads:[UARemoteDataTypeIndex payloadsWithStorePayloads:payloads]];
+        [index notifySubscription:subscription dispatcher:self.dispatcher completionHandler:nil];
     }];
 }
 
@@ -428,6 +634,15 @@ completionHandler:(void(^)(BOOL success))completionHandler {
     }];
 }
 
+-(UAPushableComponentPriority)pushProcessingPriority {
+    return UAPushableComponentPriorityNormal;
+}
+
+-(NSTimeInterval)expectedPushProcessingTime {
+    // Remote data refresh request
+    return 5;
+}
+
 #pragma mark -
 
 @end
@@ -5,6 +5,11 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+/**
+ * Remote data payload JSON keys.
+ */
+extern NSString * const UARemoteDataTypeKey;
+
 @interface UARemoteDataPayload ()
 
 ///---------------------------------------------------------------------------------------
@@ -31,6 +36,15 @@ NS_ASSUME_NONNULL_BEGIN
  */
 + (NSArray<UARemoteDataPayload *> *)remoteDataPayloadsFromJSON:(NSArray *)remoteDataPayloadsAsJSON metadata:(NSDictionary *)metadata;
 
+/**
+ * Computes a content hash over the type, timestamp, data and metadata of the payloads.
+ * Equal content produces the same hash regardless of dictionary key order.
+ *
+ * @param payloads The payloads.
+ * @return A SHA-256 hex string, or `nil` if the payloads could not be serialized.
+ */
++ (nullable NSString *)contentHashForPayloads:(NSArray<UARemoteDataPayload *> *)payloads;
+
 @end
 
 NS_ASSUME_NONNULL_END
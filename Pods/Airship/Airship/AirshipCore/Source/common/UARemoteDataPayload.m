@@ -3,6 +3,7 @@
 #import "UARemoteDataPayload+Internal.h"
 #import "UAUtils+Internal.h"
 #import "UAGlobal.h"
+#import <CommonCrypto/CommonDigest.h>
 
 @implementation UARemoteDataPayload
 
@@ -130,4 +131,35 @@ NSString * const UARemoteDataMetaDataKey = @"metadata";
     return remoteDataPayload;
 }
 
++ (NSString *)contentHashForPayloads:(NSArray<UARemoteDataPayload *> *)payloads {
+    NSMutableArray *contents = [NSMutableArray arrayWithCapacity:payloads.count];
+    for (UARemoteDataPayload *payload in payloads) {
+        NSMutableDictionary *content = [NSMutableDictionary dictionary];
+        [content setValue:payload.type forKey:UARemoteDataTypeKey];
+        [content setValue:@(payload.timestamp.timeIntervalSince1970) forKey:UARemoteDataTimestampKey];
+        [content setValue:payload.data forKey:UARemoteDataDataKey];
+        [content setValue:payload.metadata forKey:UARemoteDataMetaDataKey];
+        [contents addObject:content];
+    }
+
+    if (![NSJSONSerialization isValidJSONObject:contents]) {
+        return nil;
+    }
+
+    NSData *json = [NSJSONSerialization dataWithJSONObject:contents options:NSJSONWritingSortedKeys error:nil];
+    if (!json) {
+        return nil;
+    }
+
+    unsigned char digest[CC_SHA256_DIGEST_LENGTH];
+    CC_SHA256(json.bytes, (CC_LONG)json.length, digest);
+
+    NSMutableString *hash = [NSMutableString stringWithCapacity:(CC_SHA256_DIGEST_LENGTH * 2)];
+    for (int i = 0; i < CC_SHA256_DIGEST_LENGTH; i++) {
+        [hash appendFormat:@"%02x", digest[i]];
+    }
+
+    return hash;
+}
+
 @end
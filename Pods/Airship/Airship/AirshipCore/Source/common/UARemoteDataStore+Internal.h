@@ -38,7 +38,8 @@ NS_ASSUME_NONNULL_BEGIN
 + (instancetype)storeWithName:(NSString *)storeName;
 
 /**
- * Updates the remote data store with the array of remote data.
+ * Updates the remote data store with the array of remote data. Payloads are compared by type and content hash,
+ * types that did not change are left untouched, changed types are updated in place and missing types are deleted.
  *
  * @param remoteDataPayloads An array of remote data as JSON
  * @param completionHandler The completion handler with the sync result.
@@ -47,6 +48,21 @@ NS_ASSUME_NONNULL_BEGIN
 - (void)overwriteCachedRemoteDataWithResponse:(NSArray<UARemoteDataPayload *> *)remoteDataPayloads
                  completionHandler:(void(^)(BOOL))completionHandler;
 
+/**
+ * Applies a remote data delta. The payloads of the changed types are written as in
+ * `overwriteCachedRemoteDataWithResponse:completionHandler:`, the unchanged types are kept as stored and
+ * every other type is deleted. Nothing is changed if any unchanged type is missing from the store.
+ *
+ * @param remoteDataPayloads The payloads of the changed types.
+ * @param unchangedTypes The types that did not change.
+ * @param completionHandler The completion handler, called with the stored content hashes of the unchanged types keyed
+ * by type, or `nil` if the delta could not be applied. The unchanged payloads are not loaded. Types stored without a
+ * content hash are left out.
+ */
+- (void)applyRemoteDataDelta:(NSArray<UARemoteDataPayload *> *)remoteDataPayloads
+              unchangedTypes:(NSSet<NSString *> *)unchangedTypes
+           completionHandler:(void(^)(NSDictionary<NSString *, NSString *> * _Nullable contentHashes))completionHandler;
+
 /**
  * Fetches remote data with a specified predicate on the background context.
  *
@@ -30,12 +30,7 @@
         self.managedContext = [NSManagedObjectContext managedObjectContextForModelURL:modelURL
                                                                       concurrencyType:NSPrivateQueueConcurrencyType];
         
-        [self.managedContext addPersistentSqlStore:self.storeName completionHandler:^(BOOL success, NSError *error) {
-            if (!success) {
-                UA_LERR(@"Failed to create remote data persistent store: %@", error);
-                return;
-            }
-        }];
+        [self addPersistentStore];
         
         [[NSNotificationCenter defaultCenter] addObserver:self
                                                  selector:@selector(protectedDataAvailable)
@@ -53,14 +48,24 @@
     return [[self alloc] initWithName:storeName inMemory:NO];
 }
 
+- (void)addPersistentStore {
+    void (^completionHandler)(BOOL, NSError *) = ^(BOOL success, NSError *error) {
+        if (!success) {
+            UA_LERR(@"Failed to create remote data persistent store: %@", error);
+            return;
+        }
+    };
+
+    if (self.inMemory) {
+        [self.managedContext addPersistentInMemoryStore:self.storeName completionHandler:completionHandler];
+    } else {
+        [self.managedContext addPersistentSqlStore:self.storeName completionHandler:completionHandler];
+    }
+}
+
 - (void)protectedDataAvailable {
     if (!self.managedContext.persistentStoreCoordinator.persistentStores.count) {
-        [self.managedContext addPersistentSqlStore:self.storeName completionHandler:^(BOOL success, NSError *error) {
-            if (!success) {
-                UA_LERR(@"Failed to create remote data persistent store: %@", error);
-                return;
-            }
-        }];
+        [self addPersistentStore];
     }
 }
 
@@ -110,31 +115,160 @@
             completionHandler(NO);
             return;
         }
-        
-        // Delete all stored remote data
-        NSFetchRequest *request = [NSFetchRequest fetchRequestWithEntityName:kUARemoteDataDBEntityName];
-        NSBatchDeleteRequest *deleteRequest = [[NSBatchDeleteRequest alloc] initWithFetchRequest:request];
-        NSError *error;
-        [self.managedContext executeRequest:deleteRequest error:&error];
-
-        for (UARemoteDataPayload *remoteDataPayload in remoteDataPayloads) {
-            [self addRemoteDataStorePayloadFromRemoteData:remoteDataPayload];
+
+        completionHandler([self syncRemoteData:remoteDataPayloads unchangedTypes:[NSSet set] unchangedContentHashes:nil]);
+    }];
+}
+
+- (void)applyRemoteDataDelta:(NSArray<UARemoteDataPayload *> *)remoteDataPayloads
+              unchangedTypes:(NSSet<NSString *> *)unchangedTypes
+           completionHandler:(void(^)(NSDictionary<NSString *, NSString *> * _Nullable))completionHandler {
+    [self safePerformBlock:^(BOOL isSafe) {
+        if (!isSafe) {
+            completionHandler(nil);
+            return;
         }
-        
-        completionHandler([self.managedContext safeSave]);
+
+        NSMutableDictionary<NSString *, NSString *> *contentHashes = [NSMutableDictionary dictionary];
+        if (![self syncRemoteData:remoteDataPayloads unchangedTypes:unchangedTypes unchangedContentHashes:contentHashes]) {
+            completionHandler(nil);
+            return;
+        }
+
+        completionHandler(contentHashes);
     }];
 }
 
+/**
+ * Writes the payloads by type and content hash, keeping the stored payloads of the unchanged types and deleting
+ * every other type. Must be called on the managed context's queue.
+ *
+ * @param remoteDataPayloads The payloads of the types that changed.
+ * @param unchangedTypes The types to keep as stored. Every one of them must be stored.
+ * @param unchangedContentHashes If provided, filled with the stored content hashes of the unchanged types, keyed by type.
+ * Types stored without a content hash are left out.
+ * @return `YES` if the store was updated, otherwise `NO` and the store is left as it was.
+ */
+- (BOOL)syncRemoteData:(NSArray<UARemoteDataPayload *> *)remoteDataPayloads
+        unchangedTypes:(NSSet<NSString *> *)unchangedTypes
+unchangedContentHashes:(nullable NSMutableDictionary<NSString *, NSString *> *)unchangedContentHashes {
+    NSMutableDictionary<NSString *, NSMutableArray<UARemoteDataPayload *> *> *payloadsByType = [NSMutableDictionary dictionary];
+    for (UARemoteDataPayload *remoteDataPayload in remoteDataPayloads) {
+        NSMutableArray *typePayloads = payloadsByType[remoteDataPayload.type];
+        if (!typePayloads) {
+            typePayloads = [NSMutableArray array];
+            payloadsByType[remoteDataPayload.type] = typePayloads;
+        }
+        [typePayloads addObject:remoteDataPayload];
+    }
+
+    // Only the keys are needed to compare, so they are fetched as dictionaries without loading the payload blobs
+    NSExpressionDescription *objectIDDescription = [[NSExpressionDescription alloc] init];
+    objectIDDescription.name = @"objectID";
+    objectIDDescription.expression = [NSExpression expressionForEvaluatedObject];
+    objectIDDescription.expressionResultType = NSObjectIDAttributeType;
+
+    NSFetchRequest *request = [NSFetchRequest fetchRequestWithEntityName:kUARemoteDataDBEntityName];
+    request.resultType = NSDictionaryResultType;
+    request.propertiesToFetch = @[objectIDDescription, @"type", @"contentHash"];
+
+    NSError *error;
+    NSArray<NSDictionary *> *storedRows = [self.managedContext executeFetchRequest:request error:&error];
+    if (error) {
+        UA_LERR(@"Error executing fetch request: %@ with error: %@", request, error);
+        return NO;
+    }
+
+    NSMutableSet<NSString *> *missingUnchangedTypes = [unchangedTypes mutableCopy];
+    NSMutableDictionary<NSString *, NSMutableArray<NSDictionary *> *> *storedRowsByType = [NSMutableDictionary dictionary];
+    for (NSDictionary *storedRow in storedRows) {
+        NSString *type = storedRow[@"type"];
+        if (type && [unchangedTypes containsObject:type]) {
+            // Every row of a type is written with the same hash, so the unchanged payloads are never loaded
+            [missingUnchangedTypes removeObject:type];
+            [unchangedContentHashes setValue:storedRow[@"contentHash"] forKey:type];
+            continue;
+        }
+
+        if (!type || !payloadsByType[type]) {
+            [self.managedContext deleteObject:[self.managedContext objectWithID:storedRow[@"objectID"]]];
+            continue;
+        }
+
+        NSMutableArray *typeRows = storedRowsByType[type];
+        if (!typeRows) {
+            typeRows = [NSMutableArray array];
+            storedRowsByType[type] = typeRows;
+        }
+        [typeRows addObject:storedRow];
+    }
+
+    // A delta can only be applied on top of the cache it was computed against
+    if (missingUnchangedTypes.count) {
+        UA_LERR(@"Unable to apply remote data delta, missing cached types: %@", missingUnchangedTypes);
+        [self.managedContext rollback];
+        return NO;
+    }
+
+    for (NSString *type in payloadsByType) {
+        NSArray<UARemoteDataPayload *> *typePayloads = payloadsByType[type];
+        NSArray<NSDictionary *> *storedTypeRows = storedRowsByType[type] ?: @[];
+
+        // Payloads that can't be hashed are always rewritten
+        NSString *contentHash = [UARemoteDataPayload contentHashForPayloads:typePayloads];
+        if (contentHash && storedTypeRows.count == typePayloads.count && [self rows:storedTypeRows haveContentHash:contentHash]) {
+            continue;
+        }
+
+        UA_LTRACE(@"Updating cached remote data type %@", type);
+
+        for (NSUInteger i = 0; i < MAX(typePayloads.count, storedTypeRows.count); i++) {
+            if (i >= typePayloads.count) {
+                [self.managedContext deleteObject:[self.managedContext objectWithID:storedTypeRows[i][@"objectID"]]];
+                continue;
+            }
+
+            // Only the payloads of a changed type are loaded, and only to be overwritten
+            UARemoteDataStorePayload *storedPayload = i < storedTypeRows.count ?
+                (UARemoteDataStorePayload *)[self.managedContext objectWithID:storedTypeRows[i][@"objectID"]] :
+                (UARemoteDataStorePayload *)[NSEntityDescription insertNewObjectForEntityForName:kUARemoteDataDBEntityName
+                                                                           inManagedObjectContext:self.managedContext];
+
+            [self updateRemoteDataStorePayload:storedPayload fromRemoteData:typePayloads[i] contentHash:contentHash];
+        }
+    }
+
+    if (!self.managedContext.hasChanges) {
+        return YES;
+    }
+
+    if (![self.managedContext safeSave]) {
+        [self.managedContext rollback];
+        return NO;
+    }
+
+    return YES;
+}
+
+- (BOOL)rows:(NSArray<NSDictionary *> *)rows haveContentHash:(NSString *)contentHash {
+    for (NSDictionary *row in rows) {
+        if (![row[@"contentHash"] isEqualToString:contentHash]) {
+            return NO;
+        }
+    }
+
+    return YES;
+}
 
-- (void)addRemoteDataStorePayloadFromRemoteData:(UARemoteDataPayload *)remoteDataPayload {
-    // create the NSManagedObject
-    UARemoteDataStorePayload *remoteDataStorePayload = (UARemoteDataStorePayload *)[NSEntityDescription insertNewObjectForEntityForName:kUARemoteDataDBEntityName
-                                                                                                                 inManagedObjectContext:self.managedContext];
+- (void)updateRemoteDataStorePayload:(UARemoteDataStorePayload *)remoteDataStorePayload
+                      fromRemoteData:(UARemoteDataPayload *)remoteDataPayload
+                         contentHash:(nullable NSString *)contentHash {
     // set the properties
     remoteDataStorePayload.type = remoteDataPayload.type;
     remoteDataStorePayload.timestamp = remoteDataPayload.timestamp;
     remoteDataStorePayload.data = remoteDataPayload.data;
     remoteDataStorePayload.metadata = remoteDataPayload.metadata;
+    remoteDataStorePayload.contentHash = contentHash;
 }
 
 - (void)waitForIdle {
@@ -38,6 +38,11 @@ NS_ASSUME_NONNULL_BEGIN
  */
 @property (nullable, nonatomic, retain) NSDictionary *metadata;
 
+/**
+ * The content hash of all payloads of this payload's type, used to skip rewriting unchanged types.
+ */
+@property (nullable, nonatomic, copy) NSString *contentHash;
+
 NS_ASSUME_NONNULL_END
 
 @end
@@ -8,5 +8,6 @@
 @dynamic timestamp;
 @dynamic data;
 @dynamic metadata;
+@dynamic contentHash;
 
 @end
@@ -5,6 +5,36 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+/**
+ * Receives a request body as it is written.
+ * @note For internal use only. :nodoc:
+ */
+@protocol UARequestBodyWriter <NSObject>
+
+/**
+ * Appends bytes to the body.
+ *
+ * @param bytes The bytes.
+ * @param length The number of bytes.
+ * @return `YES` on success, otherwise `NO`.
+ */
+- (BOOL)appendBytes:(const void *)bytes length:(NSUInteger)length;
+
+/**
+ * Appends data to the body.
+ *
+ * @param data The data.
+ * @return `YES` on success, otherwise `NO`.
+ */
+- (BOOL)appendData:(NSData *)data;
+
+@end
+
+/**
+ * Block that writes a request body.
+ */
+typedef void (^UARequestBodyWriterBlock)(id<UARequestBodyWriter> writer);
+
 /**
  * The request builder.
  * @note For internal use only. :nodoc:
@@ -36,6 +66,19 @@ NS_ASSUME_NONNULL_BEGIN
  */
 @property (nonatomic, copy, nullable) NSData *body;
 
+/**
+ * Optional block that writes the request body incrementally. When set, the body is
+ * compressed as it is written instead of after it is fully built. Takes precedence over `body`.
+ * If compression fails the block is called again to write the body uncompressed.
+ */
+@property (nonatomic, copy, nullable) UARequestBodyWriterBlock bodyWriter;
+
+/**
+ * The expected length of the body written by the `bodyWriter`, used to size buffers and
+ * pick a compression level. Defaults to 0, meaning unknown.
+ */
+@property (nonatomic, assign) NSUInteger expectedBodyLength;
+
 /**
  * Flag to compress the request body using GZIP or not.
  */
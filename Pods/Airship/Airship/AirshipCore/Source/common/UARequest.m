@@ -1,12 +1,42 @@
 /* Copyright Airship and Contributors */
 
-#import <zlib.h>
-
 #import "UARequest.h"
 #import "UAirship.h"
 #import "UADisposable.h"
 #import "UARuntimeConfig.h"
 #import "UADelayOperation+Internal.h"
+#import "UAGzipWriter+Internal.h"
+
+/**
+ * Body writer for uncompressed bodies.
+ */
+@interface UARequestDataBodyWriter : NSObject <UARequestBodyWriter>
+@property (nonatomic, strong) NSMutableData *data;
+@end
+
+@implementation UARequestDataBodyWriter
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity {
+    self = [super init];
+
+    if (self) {
+        self.data = [NSMutableData dataWithCapacity:capacity];
+    }
+
+    return self;
+}
+
+- (BOOL)appendBytes:(const void *)bytes length:(NSUInteger)length {
+    [self.data appendBytes:bytes length:length];
+    return YES;
+}
+
+- (BOOL)appendData:(NSData *)data {
+    [self.data appendData:data];
+    return YES;
+}
+
+@end
 
 @interface UARequestBuilder()
 @property (nonatomic, strong) NSMutableDictionary *headers;
@@ -65,11 +95,32 @@
             [headers addEntriesFromDictionary:builder.headers];
         }
 
-        if (builder.body) {
+        if (builder.bodyWriter) {
+            if (builder.compressBody) {
+                UAGzipWriter *writer = [UAGzipWriter writerWithExpectedLength:builder.expectedBodyLength];
+                if (writer) {
+                    builder.bodyWriter(writer);
+                    self.body = [writer finish];
+                }
+            }
+
+            if (self.body) {
+                headers[@"Content-Encoding"] = @"gzip";
+            } else {
+                // Uncompressed, or compression failed and the body is sent as is
+                UARequestDataBodyWriter *writer = [[UARequestDataBodyWriter alloc] initWithCapacity:builder.expectedBodyLength];
+                builder.bodyWriter(writer);
+                self.body = writer.data;
+            }
+        } else if (builder.body) {
             if (builder.compressBody) {
                 self.body = [UARequest gzipCompress:builder.body];
+            }
+
+            if (self.body) {
                 headers[@"Content-Encoding"] = @"gzip";
             } else {
+                // Uncompressed, or compression failed and the body is sent as is
                 self.body = builder.body;
             }
         }
@@ -97,52 +148,7 @@
 }
 
 + (NSData *)gzipCompress:(NSData *)uncompressedData {
-
-    if ([uncompressedData length] == 0) {
-        return nil;
-    }
-
-    z_stream strm;
-
-    NSUInteger chunkSize = 32768;// 32K chunks
-
-    strm.zalloc = Z_NULL;
-    strm.zfree = Z_NULL;
-    strm.opaque = Z_NULL;
-    strm.total_out = 0;
-    strm.next_in=(Bytef *)[uncompressedData bytes];
-    strm.avail_in = (uInt)[uncompressedData length];
-
-    if (deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, (15+16), 8, Z_DEFAULT_STRATEGY) != Z_OK) {
-        return nil;
-    }
-
-    int status;
-    NSMutableData *compressed = [NSMutableData dataWithLength:chunkSize];
-    do {
-
-        if (strm.total_out >= [compressed length]) {
-            [compressed increaseLengthBy:chunkSize];
-        }
-
-        strm.next_out = [compressed mutableBytes] + strm.total_out;
-        strm.avail_out = (uInt)([compressed length] - strm.total_out);
-
-        status = deflate(&strm, Z_FINISH);
-
-        if (status == Z_STREAM_ERROR) {
-            //error - bail completely
-            deflateEnd(&strm);
-            return nil;
-        }
-
-    } while (strm.avail_out == 0);
-
-    deflateEnd(&strm);
-
-    [compressed setLength: strm.total_out];
-    
-    return compressed;
+    return [UAGzipWriter gzipData:uncompressedData];
 }
 
 @end
@@ -0,0 +1,140 @@
+/* Copyright Airship and Contributors */
+
+#import <Foundation/Foundation.h>
+#import "UARequestSession.h"
+#import "UADisposable.h"
+
+@class UADispatcher;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * The default maximum number of requests in flight across all hosts.
+ */
+extern const NSUInteger UARequestSchedulerDefaultMaxConcurrentRequests;
+
+/**
+ * The default maximum number of requests in flight to a single host.
+ */
+extern const NSUInteger UARequestSchedulerDefaultMaxConcurrentRequestsPerHost;
+
+/**
+ * Snapshot of the timings of a request class.
+ * @note For internal use only. :nodoc:
+ */
+@interface UARequestSchedulerMetrics : NSObject
+
+/**
+ * The number of requests that have completed, excluding retried attempts.
+ */
+@property (nonatomic, readonly) NSUInteger completedCount;
+
+/**
+ * The number of attempts that were retried.
+ */
+@property (nonatomic, readonly) NSUInteger retryCount;
+
+/**
+ * The number of requests that were cancelled.
+ */
+@property (nonatomic, readonly) NSUInteger cancelledCount;
+
+/**
+ * Total time attempts spent queued before being sent, including backoff.
+ */
+@property (nonatomic, readonly) NSTimeInterval totalQueueWaitTime;
+
+/**
+ * The longest time a single attempt spent queued.
+ */
+@property (nonatomic, readonly) NSTimeInterval maxQueueWaitTime;
+
+/**
+ * Total time attempts spent in flight.
+ */
+@property (nonatomic, readonly) NSTimeInterval totalInFlightTime;
+
+/**
+ * The longest time a single attempt spent in flight.
+ */
+@property (nonatomic, readonly) NSTimeInterval maxInFlightTime;
+
+@end
+
+/**
+ * Schedules requests from every UARequestSession over a single NSURLSession.
+ *
+ * Requests are started in priority order within global and per-host concurrency limits.
+ * Requests of the same request class are sent one at a time in the order they were
+ * scheduled, and retries back off per request class, so a client retrying one request
+ * holds back its later requests without delaying other clients.
+ * @note For internal use only. :nodoc:
+ */
+@interface UARequestScheduler : NSObject
+
+///---------------------------------------------------------------------------------------
+/// @name Request Scheduler Internal Properties
+///---------------------------------------------------------------------------------------
+
+/**
+ * The maximum number of requests in flight. Defaults to `UARequestSchedulerDefaultMaxConcurrentRequests`.
+ */
+@property (atomic, assign) NSUInteger maxConcurrentRequests;
+
+/**
+ * The maximum number of requests in flight to a single host. Defaults to `UARequestSchedulerDefaultMaxConcurrentRequestsPerHost`.
+ */
+@property (atomic, assign) NSUInteger maxConcurrentRequestsPerHost;
+
+///---------------------------------------------------------------------------------------
+/// @name Request Scheduler Internal Methods
+///---------------------------------------------------------------------------------------
+
+/**
+ * The shared scheduler.
+ */
++ (instancetype)shared;
+
+/**
+ * Factory method. Used for testing.
+ *
+ * @param session The URL session used to perform requests.
+ * @param dispatcher The dispatcher used to wake up after a backoff.
+ * @return A request scheduler instance.
+ */
++ (instancetype)schedulerWithSession:(NSURLSession *)session dispatcher:(UADispatcher *)dispatcher;
+
+/**
+ * Schedules a request.
+ *
+ * @param request The URL request.
+ * @param requestClass The request class, used for ordering, backoff, cancellation and metrics.
+ * @param priority The request priority.
+ * @param retryBlock An optional block deciding whether the response should be retried.
+ * @param completionHandler Called with the final response. Not called if the request is cancelled.
+ * @return A disposable that cancels the request.
+ */
+- (UADisposable *)scheduleRequest:(NSURLRequest *)request
+                     requestClass:(NSString *)requestClass
+                         priority:(UARequestPriority)priority
+                       retryWhere:(nullable UARequestRetryBlock)retryBlock
+                completionHandler:(UARequestCompletionHandler)completionHandler;
+
+/**
+ * Cancels all queued and in-flight requests of a request class.
+ *
+ * @param requestClass The request class.
+ */
+- (void)cancelRequestsWithClass:(NSString *)requestClass;
+
+/**
+ * Returns the timings of a request class.
+ *
+ * @param requestClass The request class.
+ * @return The metrics snapshot.
+ */
+- (UARequestSchedulerMetrics *)metricsForRequestClass:(NSString *)requestClass;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,384 @@
+/* Copyright Airship and Contributors */
+
+#import "UARequestScheduler+Internal.h"
+#import "UADispatcher.h"
+#import "UAGlobal.h"
+#import "UAMetrics+Internal.h"
+
+const NSUInteger UARequestSchedulerDefaultMaxConcurrentRequests = 4;
+const NSUInteger UARequestSchedulerDefaultMaxConcurrentRequestsPerHost = 2;
+
+static const NSTimeInterval UARequestSchedulerInitialRetryDelay = 30;
+static const NSTimeInterval UARequestSchedulerMaxRetryDelay = 3000;
+
+@interface UARequestSchedulerMetrics () <NSCopying>
+@property (nonatomic, assign) NSUInteger completedCount;
+@property (nonatomic, assign) NSUInteger retryCount;
+@property (nonatomic, assign) NSUInteger cancelledCount;
+@property (nonatomic, assign) NSTimeInterval totalQueueWaitTime;
+@property (nonatomic, assign) NSTimeInterval maxQueueWaitTime;
+@property (nonatomic, assign) NSTimeInterval totalInFlightTime;
+@property (nonatomic, assign) NSTimeInterval maxInFlightTime;
+@end
+
+@implementation UARequestSchedulerMetrics
+
+- (id)copyWithZone:(NSZone *)zone {
+    UARequestSchedulerMetrics *copy = [[UARequestSchedulerMetrics allocWithZone:zone] init];
+    copy.completedCount = self.completedCount;
+    copy.retryCount = self.retryCount;
+    copy.cancelledCount = self.cancelledCount;
+    copy.totalQueueWaitTime = self.totalQueueWaitTime;
+    copy.maxQueueWaitTime = self.maxQueueWaitTime;
+    copy.totalInFlightTime = self.totalInFlightTime;
+    copy.maxInFlightTime = self.maxInFlightTime;
+    return copy;
+}
+
+@end
+
+/**
+ * A scheduled request and its retry state.
+ */
+@interface UARequestSchedulerTask : NSObject
+@property (nonatomic, strong) NSURLRequest *request;
+@property (nonatomic, copy) NSString *requestClass;
+@property (nonatomic, copy) NSString *host;
+@property (nonatomic, assign) UARequestPriority priority;
+@property (nonatomic, copy, nullable) UARequestRetryBlock retryBlock;
+@property (nonatomic, copy, nullable) UARequestCompletionHandler completionHandler;
+@property (nonatomic, assign) NSTimeInterval retryDelay;
+@property (nonatomic, strong) NSDate *enqueueDate;
+@property (nonatomic, strong, nullable) NSDate *startDate;
+@property (nonatomic, strong, nullable) NSURLSessionTask *dataTask;
+@property (nonatomic, assign) BOOL cancelled;
+@end
+
+@implementation UARequestSchedulerTask
+@end
+
+/**
+ * Ordering and backoff state shared by every request of a request class.
+ */
+@interface UARequestSchedulerClassState : NSObject
+@property (nonatomic, assign, getter=isActive) BOOL active;
+@property (nonatomic, strong, nullable) NSDate *backoffUntil;
+@end
+
+@implementation UARequestSchedulerClassState
+@end
+
+@interface UARequestScheduler ()
+@property (nonatomic, strong) NSURLSession *session;
+@property (nonatomic, strong) UADispatcher *dispatcher;
+
+// Pending tasks per priority, FIFO within a priority. Indexed by UARequestPriority.
+@property (nonatomic, strong) NSArray<NSMutableArray<UARequestSchedulerTask *> *> *pending;
+@property (nonatomic, strong) NSMutableSet<UARequestSchedulerTask *> *active;
+@property (nonatomic, strong) NSCountedSet<NSString *> *activeHosts;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, UARequestSchedulerClassState *> *classes;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, UARequestSchedulerMetrics *> *metrics;
+
+@property (nonatomic, strong, nullable) UADisposable *wakeup;
+@property (nonatomic, strong, nullable) NSDate *wakeupDate;
+@end
+
+@implementation UARequestScheduler
+
+- (instancetype)initWithSession:(NSURLSession *)session dispatcher:(UADispatcher *)dispatcher {
+    self = [super init];
+
+    if (self) {
+        self.session = session;
+        self.dispatcher = dispatcher;
+        self.pending = @[[NSMutableArray array], [NSMutableArray array], [NSMutableArray array]];
+        self.active = [NSMutableSet set];
+        self.activeHosts = [NSCountedSet set];
+        self.classes = [NSMutableDictionary dictionary];
+        self.metrics = [NSMutableDictionary dictionary];
+        self.maxConcurrentRequests = UARequestSchedulerDefaultMaxConcurrentRequests;
+        self.maxConcurrentRequestsPerHost = UARequestSchedulerDefaultMaxConcurrentRequestsPerHost;
+    }
+
+    return self;
+}
+
++ (instancetype)shared {
+    static dispatch_once_t onceToken;
+    static UARequestScheduler *shared;
+
+    dispatch_once(&onceToken, ^{
+        NSURLSessionConfiguration *sessionConfig = [NSURLSessionConfiguration defaultSessionConfiguration];
+
+        // Disable the default HTTP cache so that 304 responses can be received. API clients using
+        // UARequestSession are expected to provide their own caching.
+        sessionConfig.URLCache = nil;
+        sessionConfig.requestCachePolicy = NSURLRequestReloadIgnoringLocalCacheData;
+
+        // Force min 1.2 even though our backend will always negotiate 1.2+
+        sessionConfig.TLSMinimumSupportedProtocol = kTLSProtocol12;
+
+        // Concurrency is enforced by the scheduler
+        sessionConfig.HTTPMaximumConnectionsPerHost = UARequestSchedulerDefaultMaxConcurrentRequestsPerHost;
+
+        NSURLSession *session = [NSURLSession sessionWithConfiguration:sessionConfig delegate:nil delegateQueue:nil];
+        shared = [self schedulerWithSession:session dispatcher:[UADispatcher backgroundDispatcher]];
+    });
+
+    return shared;
+}
+
++ (instancetype)schedulerWithSession:(NSURLSession *)session dispatcher:(UADispatcher *)dispatcher {
+    return [[self alloc] initWithSession:session dispatcher:dispatcher];
+}
+
+- (UADisposable *)scheduleRequest:(NSURLRequest *)request
+                     requestClass:(NSString *)requestClass
+                         priority:(UARequestPriority)priority
+                       retryWhere:(UARequestRetryBlock)retryBlock
+                completionHandler:(UARequestCompletionHandler)completionHandler {
+
+    UARequestSchedulerTask *task = [[UARequestSchedulerTask alloc] init];
+    task.request = request;
+    task.requestClass = requestClass;
+    task.host = request.URL.host ?: @"";
+    task.priority = MIN(MAX(priority, UARequestPriorityLow), UARequestPriorityHigh);
+    task.retryBlock = retryBlock;
+    task.completionHandler = completionHandler;
+    task.retryDelay = UARequestSchedulerInitialRetryDelay;
+    task.enqueueDate = [NSDate date];
+
+    @synchronized (self) {
+        [self.pending[task.priority] addObject:task];
+    }
+
+    [self startReadyTasks];
+
+    UA_WEAKIFY(self)
+    return [UADisposable disposableWithBlock:^{
+        UA_STRONGIFY(self)
+        @synchronized (self) {
+            [self cancelTask:task];
+        }
+    }];
+}
+
+- (void)cancelRequestsWithClass:(NSString *)requestClass {
+    @synchronized (self) {
+        for (NSMutableArray<UARequestSchedulerTask *> *queue in self.pending) {
+            for (UARequestSchedulerTask *task in [queue copy]) {
+                if ([task.requestClass isEqualToString:requestClass]) {
+                    [self cancelTask:task];
+                }
+            }
+        }
+
+        for (UARequestSchedulerTask *task in [self.active copy]) {
+            if ([task.requestClass isEqualToString:requestClass]) {
+                [self cancelTask:task];
+            }
+        }
+    }
+}
+
+- (UARequestSchedulerMetrics *)metricsForRequestClass:(NSString *)requestClass {
+    @synchronized (self) {
+        return [[self metricsEntryForRequestClass:requestClass] copy];
+    }
+}
+
+#pragma mark -
+#pragma mark Scheduling
+
+// Must be called while synchronized on self
+- (void)cancelTask:(UARequestSchedulerTask *)task {
+    if (task.cancelled) {
+        return;
+    }
+
+    task.cancelled = YES;
+    task.completionHandler = nil;
+    task.retryBlock = nil;
+    [self.pending[task.priority] removeObject:task];
+
+    // Active tasks are cleaned up by the data task's completion
+    [task.dataTask cancel];
+
+    [self metricsEntryForRequestClass:task.requestClass].cancelledCount++;
+}
+
+// Must be called while synchronized on self
+- (UARequestSchedulerClassState *)stateForRequestClass:(NSString *)requestClass {
+    UARequestSchedulerClassState *state = self.classes[requestClass];
+    if (!state) {
+        state = [[UARequestSchedulerClassState alloc] init];
+        self.classes[requestClass] = state;
+    }
+    return state;
+}
+
+// Must be called while synchronized on self
+- (UARequestSchedulerMetrics *)metricsEntryForRequestClass:(NSString *)requestClass {
+    UARequestSchedulerMetrics *metrics = self.metrics[requestClass];
+    if (!metrics) {
+        metrics = [[UARequestSchedulerMetrics alloc] init];
+        self.metrics[requestClass] = metrics;
+    }
+    return metrics;
+}
+
+- (void)startReadyTasks {
+    NSMutableArray<UARequestSchedulerTask *> *ready = [NSMutableArray array];
+
+    @synchronized (self) {
+        NSDate *now = [NSDate date];
+        NSDate *nextBackoffExpiry = nil;
+
+        // Highest priority first
+        for (NSInteger priority = UARequestPriorityHigh; priority >= UARequestPriorityLow; priority--) {
+            for (UARequestSchedulerTask *task in [self.pending[priority] copy]) {
+                if (self.active.count >= self.maxConcurrentRequests) {
+                    break;
+                }
+
+                // One request per class at a time, in order, so a client's requests never overlap
+                UARequestSchedulerClassState *state = [self stateForRequestClass:task.requestClass];
+                if (state.isActive) {
+                    continue;
+                }
+
+                if (state.backoffUntil && [state.backoffUntil compare:now] == NSOrderedDescending) {
+                    if (!nextBackoffExpiry || [state.backoffUntil compare:nextBackoffExpiry] == NSOrderedAscending) {
+                        nextBackoffExpiry = state.backoffUntil;
+                    }
+                    continue;
+                }
+
+                if ([self.activeHosts countForObject:task.host] >= self.maxConcurrentRequestsPerHost) {
+                    continue;
+                }
+
+                [self.pending[priority] removeObject:task];
+                [self.active addObject:task];
+                [self.activeHosts addObject:task.host];
+                state.active = YES;
+
+                NSTimeInterval queueWait = [now timeIntervalSinceDate:task.enqueueDate];
+                UARequestSchedulerMetrics *metrics = [self metricsEntryForRequestClass:task.requestClass];
+                metrics.totalQueueWaitTime += queueWait;
+                metrics.maxQueueWaitTime = MAX(metrics.maxQueueWaitTime, queueWait);
+                UAMetricsRecordDuration(UAMetricsHistogramHTTPQueueWait, queueWait);
+
+                task.startDate = now;
+                task.dataTask = [self dataTaskForTask:task];
+                [ready addObject:task];
+            }
+        }
+
+        if (nextBackoffExpiry) {
+            [self scheduleWakeup:nextBackoffExpiry];
+        }
+    }
+
+    for (UARequestSchedulerTask *task in ready) {
+        [task.dataTask resume];
+    }
+}
+
+// Must be called while synchronized on self
+- (void)scheduleWakeup:(NSDate *)date {
+    if (self.wakeupDate && [self.wakeupDate compare:date] != NSOrderedDescending) {
+        return;
+    }
+
+    [self.wakeup dispose];
+    self.wakeupDate = date;
+
+    UA_WEAKIFY(self)
+    self.wakeup = [self.dispatcher dispatchAfter:[date timeIntervalSinceNow] block:^{
+        UA_STRONGIFY(self)
+        @synchronized (self) {
+            self.wakeup = nil;
+            self.wakeupDate = nil;
+        }
+        [self startReadyTasks];
+    }];
+}
+
+// Must be called while synchronized on self
+- (NSURLSessionTask *)dataTaskForTask:(UARequestSchedulerTask *)task {
+    UA_WEAKIFY(self)
+    return [self.session dataTaskWithRequest:task.request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
+        UA_STRONGIFY(self)
+        [self task:task didCompleteWithData:data response:response error:error];
+    }];
+}
+
+- (void)task:(UARequestSchedulerTask *)task didCompleteWithData:(NSData *)data response:(NSURLResponse *)response error:(NSError *)error {
+    UARequestCompletionHandler completionHandler = nil;
+    UARequestRetryBlock retryBlock = nil;
+
+    @synchronized (self) {
+        NSDate *now = [NSDate date];
+        [self stateForRequestClass:task.requestClass].active = NO;
+        [self.activeHosts removeObject:task.host];
+        [self.active removeObject:task];
+        task.dataTask = nil;
+
+        NSTimeInterval inFlight = [now timeIntervalSinceDate:task.startDate];
+        UARequestSchedulerMetrics *metrics = [self metricsEntryForRequestClass:task.requestClass];
+        metrics.totalInFlightTime += inFlight;
+        metrics.maxInFlightTime = MAX(metrics.maxInFlightTime, inFlight);
+        UAMetricsRecordDuration(UAMetricsHistogramHTTPRequest, inFlight);
+        UAMetricsIncrement(UAMetricsCounterHTTPRequests, 1);
+        if (error && !task.cancelled) {
+            UAMetricsIncrement(UAMetricsCounterHTTPRequestFailures, 1);
+        }
+
+        if (!task.cancelled) {
+            completionHandler = task.completionHandler;
+            retryBlock = task.retryBlock;
+        }
+    }
+
+    // Called outside the lock since clients may schedule more requests from these blocks
+    BOOL retry = !error && retryBlock && retryBlock(data, response);
+
+    @synchronized (self) {
+        if (task.cancelled) {
+            completionHandler = nil;
+        } else if (retry) {
+            UARequestSchedulerClassState *state = [self stateForRequestClass:task.requestClass];
+            NSDate *backoffUntil = [NSDate dateWithTimeIntervalSinceNow:task.retryDelay];
+            if (!state.backoffUntil || [state.backoffUntil compare:backoffUntil] == NSOrderedAscending) {
+                state.backoffUntil = backoffUntil;
+            }
+
+            UA_LTRACE(@"Backing off %@ requests for %f seconds", task.requestClass, task.retryDelay);
+
+            task.retryDelay = MIN(task.retryDelay * 2, UARequestSchedulerMaxRetryDelay);
+            task.enqueueDate = [NSDate date];
+            [self metricsEntryForRequestClass:task.requestClass].retryCount++;
+            UAMetricsIncrement(UAMetricsCounterHTTPRequestRetries, 1);
+
+            // Retries keep their place ahead of newer requests
+            [self.pending[task.priority] insertObject:task atIndex:0];
+            completionHandler = nil;
+        } else {
+            if (response) {
+                [self stateForRequestClass:task.requestClass].backoffUntil = nil;
+            }
+            [self metricsEntryForRequestClass:task.requestClass].completedCount++;
+            task.completionHandler = nil;
+            task.retryBlock = nil;
+        }
+    }
+
+    if (completionHandler) {
+        completionHandler(data, response, error);
+    }
+
+    [self startReadyTasks];
+}
+
+@end
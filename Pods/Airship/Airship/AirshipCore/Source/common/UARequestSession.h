@@ -4,8 +4,31 @@
 #import "UARequest.h"
 #import "UARuntimeConfig.h"
 
+@class UARequestScheduler;
+
 NS_ASSUME_NONNULL_BEGIN
 
+/**
+ * Request priorities. Higher priority requests are sent before lower priority requests
+ * when the request scheduler is at its concurrency limit.
+ */
+typedef NS_ENUM(NSInteger, UARequestPriority) {
+    /**
+     * Low priority, for requests that can wait such as prefetching.
+     */
+    UARequestPriorityLow = 0,
+
+    /**
+     * Normal priority.
+     */
+    UARequestPriorityNormal = 1,
+
+    /**
+     * High priority, for requests that other requests depend on such as channel registration.
+     */
+    UARequestPriorityHigh = 2
+};
+
 typedef void (^UARequestCompletionHandler)(NSData * _Nullable data, NSURLResponse * _Nullable response, NSError * _Nullable error);
 typedef BOOL (^UARequestRetryBlock)(NSData * _Nullable data, NSURLResponse * _Nullable response);
 
@@ -22,6 +45,17 @@ typedef BOOL (^UARequestRetryBlock)(NSData * _Nullable data, NSURLResponse * _Nu
  */
 + (instancetype)sessionWithConfig:(UARuntimeConfig *)config;
 
+/**
+ * UARequestSession factory method.
+ * @param config The UARuntimeConfig instance.
+ * @param requestClass The request class. Requests are cancelled and measured by class.
+ * @param priority The priority of the session's requests.
+ * @return A UARequestSession instance.
+ */
++ (instancetype)sessionWithConfig:(UARuntimeConfig *)config
+                     requestClass:(NSString *)requestClass
+                         priority:(UARequestPriority)priority;
+
 /**
  * UARequestSession factory method.
  * @param config The UARuntimeConfig instance.
@@ -33,11 +67,25 @@ typedef BOOL (^UARequestRetryBlock)(NSData * _Nullable data, NSURLResponse * _Nu
 /**
  * UARequestSession factory method.
  * @param config The UARuntimeConfig instance.
- * @param session A NSURLSession instance.
- * @param queue A NSOperation to perform retries on.
+ * @param scheduler The request scheduler.
+ * @param requestClass The request class. Requests are cancelled and measured by class.
+ * @param priority The priority of the session's requests.
  * @return A UARequestSession instance.
  */
-+ (instancetype)sessionWithConfig:(UARuntimeConfig *)config NSURLSession:(NSURLSession *)session queue:(NSOperationQueue *)queue;
++ (instancetype)sessionWithConfig:(UARuntimeConfig *)config
+                        scheduler:(UARequestScheduler *)scheduler
+                     requestClass:(NSString *)requestClass
+                         priority:(UARequestPriority)priority;
+
+/**
+ * The request class.
+ */
+@property (nonatomic, readonly) NSString *requestClass;
+
+/**
+ * The priority of the session's requests.
+ */
+@property (nonatomic, readonly) UARequestPriority priority;
 
 /**
  * Sets a http request header for all requests.
@@ -69,7 +117,7 @@ typedef BOOL (^UARequestRetryBlock)(NSData * _Nullable data, NSURLResponse * _Nu
           completionHandler:(UARequestCompletionHandler)completionHandler;
 
 /**
- * Cancels all in-flight requests.
+ * Cancels all queued and in-flight requests of the session's request class.
  */
 - (void)cancelAllRequests;
 
@@ -2,29 +2,31 @@
 
 
 #import "UARequestSession.h"
-#import "UAURLRequestOperation+Internal.h"
-#import "UADelayOperation+Internal.h"
+#import "UARequestScheduler+Internal.h"
+#import "UADispatcher.h"
 #import "UARuntimeConfig.h"
 #import "UAirship.h"
 
 @interface UARequestSession()
-@property(nonatomic, strong) NSURLSession *session;
-@property(nonatomic, strong) NSOperationQueue *queue;
+@property(nonatomic, strong) UARequestScheduler *scheduler;
+@property(nonatomic, copy) NSString *requestClass;
+@property(nonatomic, assign) UARequestPriority priority;
 @property(nonatomic, strong) NSMutableDictionary *headers;
 @end
 
-const NSTimeInterval InitialDelay = 30;
-const NSTimeInterval MaxBackOff = 3000;
-
 @implementation UARequestSession
 
-- (instancetype)initWithConfig:(UARuntimeConfig *)config session:(NSURLSession *)session queue:(NSOperationQueue *)queue {
+- (instancetype)initWithConfig:(UARuntimeConfig *)config
+                     scheduler:(UARequestScheduler *)scheduler
+                  requestClass:(NSString *)requestClass
+                      priority:(UARequestPriority)priority {
     self = [super init];
 
     if (self) {
         self.headers = [NSMutableDictionary dictionary];
-        self.session = session;
-        self.queue = queue;
+        self.scheduler = scheduler;
+        self.requestClass = requestClass;
+        self.priority = priority;
 
         [self setValue:@"gzip;q=1.0, compress;q=0.5" forHeader:@"Accept-Encoding"];
         [self setValue:[UARequestSession userAgentWithAppKey:config.appKey] forHeader:@"User-Agent"];
@@ -34,38 +36,39 @@ const NSTimeInterval MaxBackOff = 3000;
 }
 
 + (instancetype)sessionWithConfig:(UARuntimeConfig *)config {
+    // Without a class, cancellation is scoped to this session alone
+    return [self sessionWithConfig:config
+                      requestClass:[NSUUID UUID].UUIDString
+                          priority:UARequestPriorityNormal];
+}
 
-    static dispatch_once_t onceToken;
-    static NSURLSession *_session;
-    dispatch_once(&onceToken, ^{
-        NSURLSessionConfiguration *sessionConfig = [NSURLSessionConfiguration defaultSessionConfiguration];
-
-        // Disable the default HTTP cache so that 304 responses can be received. API clients using
-        // UARequestSession are expected to provide their own caching.
-        sessionConfig.URLCache = nil;
-        sessionConfig.requestCachePolicy = NSURLRequestReloadIgnoringLocalCacheData;
-
-        // Force min 1.2 even though our backend will always negotiate 1.2+
-        sessionConfig.TLSMinimumSupportedProtocol = kTLSProtocol12;
-
-        _session = [NSURLSession sessionWithConfiguration:sessionConfig delegate:nil delegateQueue:nil];
-    });
-
-    NSOperationQueue *queue = [[NSOperationQueue alloc] init];
-    queue.maxConcurrentOperationCount = 1;
-
-    return [[UARequestSession alloc] initWithConfig:config session:_session queue:queue];
++ (instancetype)sessionWithConfig:(UARuntimeConfig *)config
+                     requestClass:(NSString *)requestClass
+                         priority:(UARequestPriority)priority {
+    return [[UARequestSession alloc] initWithConfig:config
+                                          scheduler:[UARequestScheduler shared]
+                                       requestClass:requestClass
+                                           priority:priority];
 }
 
 + (instancetype)sessionWithConfig:(UARuntimeConfig *)config NSURLSession:(NSURLSession *)session {
-    NSOperationQueue *queue = [[NSOperationQueue alloc] init];
-    queue.maxConcurrentOperationCount = 1;
+    UARequestScheduler *scheduler = [UARequestScheduler schedulerWithSession:session
+                                                                  dispatcher:[UADispatcher backgroundDispatcher]];
 
-    return [[UARequestSession alloc] initWithConfig:config session:session queue:queue];
+    return [[UARequestSession alloc] initWithConfig:config
+                                          scheduler:scheduler
+                                       requestClass:[NSUUID UUID].UUIDString
+                                           priority:UARequestPriorityNormal];
 }
 
-+ (instancetype)sessionWithConfig:(UARuntimeConfig *)config NSURLSession:(NSURLSession *)session queue:(NSOperationQueue *)queue {
-    return [[UARequestSession alloc] initWithConfig:config session:session queue:queue];
++ (instancetype)sessionWithConfig:(UARuntimeConfig *)config
+                        scheduler:(UARequestScheduler *)scheduler
+                     requestClass:(NSString *)requestClass
+                         priority:(UARequestPriority)priority {
+    return [[UARequestSession alloc] initWithConfig:config
+                                          scheduler:scheduler
+                                       requestClass:requestClass
+                                           priority:priority];
 }
 
 - (void)setValue:(id)value forHeader:(NSString *)field {
@@ -98,51 +101,17 @@ const NSTimeInterval MaxBackOff = 3000;
         [urlRequest setValue:request.headers[key] forHTTPHeaderField:key];
     }
 
-    NSOperation *operation = [self operationWithRequest:urlRequest
-                                             retryDelay:InitialDelay
-                                             retryWhere:retryBlock
-                                      completionHandler:completionHandler];
-
-    [self.queue addOperation:operation];
+    [self.scheduler scheduleRequest:urlRequest
+                       requestClass:self.requestClass
+                           priority:self.priority
+                         retryWhere:retryBlock
+                  completionHandler:completionHandler];
 }
 
 - (void)cancelAllRequests {
-    [self.queue cancelAllOperations];
-}
-
-- (NSOperation *)operationWithRequest:(NSURLRequest *)request
-                           retryDelay:(NSTimeInterval)retryDelay
-                           retryWhere:(BOOL (^)(NSData *data, NSURLResponse *response))retryBlock
-                    completionHandler:(void (^)(NSData *data, NSURLResponse *response, NSError *error))completionHandler {
-
-
-    UAURLRequestOperation *operation = [UAURLRequestOperation operationWithRequest:request
-                                                                           session:self.session
-                                                                 completionHandler:^(NSData * _Nullable data, NSURLResponse * _Nullable response, NSError * _Nullable error) {
-
-        if (!error && retryBlock && retryBlock(data, response)) {
-            UADelayOperation *delayOperation = [UADelayOperation operationWithDelayInSeconds:retryDelay];
-            NSOperation *retryOperation = [self operationWithRequest:request
-                                                          retryDelay:MIN(retryDelay * 2, MaxBackOff)
-                                                          retryWhere:retryBlock
-                                                   completionHandler:completionHandler];
-
-            [retryOperation addDependency:delayOperation];
-
-            [self.queue addOperation:delayOperation];
-            [self.queue addOperation:retryOperation];
-
-            return;
-        } else {
-            completionHandler(data, response, error);
-        }
-
-    }];
-    
-    return operation;
+    [self.scheduler cancelRequestsWithClass:self.requestClass];
 }
 
-
 + (NSString *)userAgentWithAppKey:(NSString *)appKey {
     /*
      * [LIB-101] User agent string should be:
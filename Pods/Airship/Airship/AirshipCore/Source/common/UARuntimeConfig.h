@@ -44,6 +44,19 @@ NS_ASSUME_NONNULL_BEGIN
  */
 @property (readonly, getter=isAnalyticsEnabled) BOOL analyticsEnabled;
 
+/**
+ * If set to `YES`, analytics events are stored in an append-only log instead of Core Data.
+ * Events already stored are migrated to the log. Defaults to `NO`.
+ */
+@property (readonly, getter=isAnalyticsEventLogEnabled) BOOL analyticsEventLogEnabled;
+
+/**
+ * Custom event names that are aggregated into one event per minute instead of being stored
+ * individually. Include `screen_tracking` to aggregate screen tracking events by screen.
+ * Defaults to an empty array.
+ */
+@property (readonly) NSArray<NSString *> *aggregatedEventNames;
+
 /**
  * The Airship device API url.
  *
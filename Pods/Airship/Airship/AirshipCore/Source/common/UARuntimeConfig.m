@@ -12,6 +12,8 @@
 @property (nonatomic, copy) NSArray<NSString *> *whitelist;
 @property (nonatomic, copy) NSString *itunesID;
 @property (nonatomic, assign, getter=isAnalyticsEnabled) BOOL analyticsEnabled;
+@property (nonatomic, assign, getter=isAnalyticsEventLogEnabled) BOOL analyticsEventLogEnabled;
+@property (nonatomic, copy) NSArray<NSString *> *aggregatedEventNames;
 @property (nonatomic, assign) BOOL detectProvisioningMode;
 @property (nonatomic, copy) NSString *messageCenterStyleConfig;
 @property (nonatomic, assign) BOOL clearUserOnAppRestore;
@@ -67,6 +69,8 @@ NSString *const UARuntimeConfigEURemoteDataAPIURL = @"https://remote-data.asnapi
         self.requestAuthorizationToUseNotifications = config.requestAuthorizationToUseNotifications;
         self.automaticSetupEnabled = config.automaticSetupEnabled;
         self.analyticsEnabled = config.analyticsEnabled;
+        self.analyticsEventLogEnabled = config.analyticsEventLogEnabled;
+        self.aggregatedEventNames = config.aggregatedEventNames ?: @[];
         self.clearUserOnAppRestore = config.clearUserOnAppRestore;
         self.whitelist = config.whitelist;
         self.clearNamedUserOnAppRestore = config.clearNamedUserOnAppRestore;
@@ -58,6 +58,9 @@
 #import "UALocationProvider.h"
 #import "UAMediaEventTemplate.h"
 #import "UAMessageCenterModuleLoaderFactory.h"
+#import "UAMetrics.h"
+#import "UAMetricsExporter.h"
+#import "UAMetricsSnapshot.h"
 #import "UAModifyTagsAction.h"
 #import "UAModuleLoader.h"
 #import "UANSDictionaryValueTransformer.h"
@@ -3,7 +3,7 @@
 #import "UAMessageCenterMessageViewController.h"
 #import "UAMessageCenterNativeBridgeExtension.h"
 #import "UAMessageCenter.h"
-#import "UAInboxMessageList.h"
+#import "UAInboxMessageList+Internal.h"
 #import "UAInboxMessage.h"
 #import "UAInboxUtils.h"
 #import "UAMessageCenterLocalization.h"
@@ -336,7 +336,16 @@ static NSString *urlForBlankPage = @"about:blank";
 
 - (void)loadMessageIntoWebView {
     self.title = self.message.title;
-    
+
+    // Serve the prefetched body right away and refresh the cached copy for next time
+    UAInboxMessageBodyCache *bodyCache = [UAMessageCenter shared].messageList.bodyCache;
+    NSString *cachedBody = [bodyCache cachedBodyForMessage:self.message];
+    if (cachedBody) {
+        [self.webView loadHTMLString:cachedBody baseURL:self.message.messageBodyURL];
+        [bodyCache revalidateMessage:self.message];
+        return;
+    }
+
     NSMutableURLRequest *requestObj = [NSMutableURLRequest requestWithURL:self.message.messageBodyURL];
     requestObj.timeoutInterval = 60;
 
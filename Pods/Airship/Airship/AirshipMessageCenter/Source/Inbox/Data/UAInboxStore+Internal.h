@@ -55,11 +55,35 @@ NS_ASSUME_NONNULL_BEGIN
  * Updates the inbox store with the array of messages.
  *
  * @param messages An array of messages.
- * @param completionHandler The completion handler with the sync result.
- *
+ * @param completionHandler The completion handler with the sync result, the IDs of the messages
+ * that were inserted or whose payload changed, and the IDs of the messages that were removed.
  */
 - (void)syncMessagesWithResponse:(NSArray *)messages
-               completionHandler:(void(^)(BOOL))completionHandler;
+               completionHandler:(void(^)(BOOL success, NSSet<NSString *> *changedMessageIDs, NSSet<NSString *> *deletedMessageIDs))completionHandler;
+
+/**
+ * Marks messages read on the client in a single batch update.
+ *
+ * @param messageIDs The message IDs.
+ * @param completionHandler The completion handler with the update result.
+ */
+- (void)markMessagesReadLocallyWithIDs:(NSArray<NSString *> *)messageIDs completionHandler:(void(^)(BOOL success))completionHandler;
+
+/**
+ * Marks messages deleted on the client in a single batch update.
+ *
+ * @param messageIDs The message IDs.
+ * @param completionHandler The completion handler with the update result.
+ */
+- (void)markMessagesDeletedLocallyWithIDs:(NSArray<NSString *> *)messageIDs completionHandler:(void(^)(BOOL success))completionHandler;
+
+/**
+ * Marks messages read on the server in a single batch update, once the read state is synced.
+ *
+ * @param messageIDs The message IDs.
+ * @param completionHandler The completion handler with the update result.
+ */
+- (void)markMessagesReadWithIDs:(NSArray<NSString *> *)messageIDs completionHandler:(void(^)(BOOL success))completionHandler;
 
 
 /**
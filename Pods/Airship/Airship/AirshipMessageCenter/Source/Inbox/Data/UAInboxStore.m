@@ -109,16 +109,36 @@
     }];
 }
 
-- (void)syncMessagesWithResponse:(NSArray *)messages completionHandler:(void(^)(BOOL))completionHandler {
+- (void)syncMessagesWithResponse:(NSArray *)messages
+               completionHandler:(void(^)(BOOL, NSSet<NSString *> *, NSSet<NSString *> *))completionHandler {
     [self safePerformBlock:^(BOOL isSafe) {
         if (!isSafe) {
-            completionHandler(NO);
+            completionHandler(NO, [NSSet set], [NSSet set]);
+            return;
+        }
+
+        NSError *error;
+
+        // Fetch the existing messages up front instead of once per response message
+        NSFetchRequest *existingRequest = [NSFetchRequest fetchRequestWithEntityName:kUAInboxDBEntityName];
+        NSArray<UAInboxMessageData *> *existingData = [self.managedContext executeFetchRequest:existingRequest error:&error];
+        if (error) {
+            UA_LERR(@"Fetch request %@ failed with with error: %@", existingRequest, error);
+            completionHandler(NO, [NSSet set], [NSSet set]);
             return;
         }
 
+        NSMutableDictionary<NSString *, UAInboxMessageData *> *existingMessages = [NSMutableDictionary dictionary];
+        for (UAInboxMessageData *data in existingData) {
+            if (data.messageID) {
+                existingMessages[data.messageID] = data;
+            }
+        }
+
         // Track the response messageIDs so we can remove any messages that are
         // no longer in the response.
         NSMutableSet *newMessageIDs = [NSMutableSet set];
+        NSMutableSet *changedMessageIDs = [NSMutableSet set];
 
         for (NSDictionary *messagePayload in messages) {
             NSString *messageID = messagePayload[@"message_id"];
@@ -128,96 +148,160 @@
                 continue;
             }
 
-            if (![self updateMessageWithDictionary:messagePayload]) {
-                [self addMessageFromDictionary:messagePayload];
+            UAInboxMessageData *data = existingMessages[messageID];
+            if (!data) {
+                // Recorded so a message listed twice in the response is only inserted once
+                existingMessages[messageID] = [self addMessageFromDictionary:messagePayload];
+                [changedMessageIDs addObject:messageID];
+            } else if ([self updateMessageData:data withDictionary:messagePayload]) {
+                [changedMessageIDs addObject:messageID];
             }
 
             [newMessageIDs addObject:messageID];
         }
 
+        NSMutableSet *deletedMessageIDs = [NSMutableSet setWithArray:existingMessages.allKeys];
+        [deletedMessageIDs minusSet:newMessageIDs];
+
         // Delete any messages that are no longer in the array
-        NSFetchRequest *request = [NSFetchRequest fetchRequestWithEntityName:kUAInboxDBEntityName];
-        request.predicate = [NSPredicate predicateWithFormat:@"NOT (messageID IN %@)", newMessageIDs];
+        if (deletedMessageIDs.count) {
+            NSFetchRequest *request = [NSFetchRequest fetchRequestWithEntityName:kUAInboxDBEntityName];
+            request.predicate = [NSPredicate predicateWithFormat:@"NOT (messageID IN %@)", newMessageIDs];
+
+            if (self.inMemory) {
+                for (NSString *messageID in deletedMessageIDs) {
+                    [self.managedContext deleteObject:existingMessages[messageID]];
+                }
+            } else {
+                NSBatchDeleteRequest *deleteRequest = [[NSBatchDeleteRequest alloc] initWithFetchRequest:request];
+                [self.managedContext executeRequest:deleteRequest error:&error];
+            }
+        }
+
+        completionHandler([self.managedContext safeSave], changedMessageIDs, deletedMessageIDs);
+    }];
+}
+
+- (void)markMessagesReadLocallyWithIDs:(NSArray<NSString *> *)messageIDs completionHandler:(void(^)(BOOL success))completionHandler {
+    [self updateMessagesWithIDs:messageIDs propertiesToUpdate:@{ @"unreadClient" : @NO } completionHandler:completionHandler];
+}
+
+- (void)markMessagesDeletedLocallyWithIDs:(NSArray<NSString *> *)messageIDs completionHandler:(void(^)(BOOL success))completionHandler {
+    [self updateMessagesWithIDs:messageIDs propertiesToUpdate:@{ @"deletedClient" : @YES } completionHandler:completionHandler];
+}
+
+- (void)markMessagesReadWithIDs:(NSArray<NSString *> *)messageIDs completionHandler:(void(^)(BOOL success))completionHandler {
+    [self updateMessagesWithIDs:messageIDs propertiesToUpdate:@{ @"unread" : @NO } completionHandler:completionHandler];
+}
+
+/**
+ * Updates the properties of the messages in a single batch update.
+ *
+ * @param messageIDs The message IDs.
+ * @param properties The property values to set.
+ * @param completionHandler The completion handler with the update result.
+ */
+- (void)updateMessagesWithIDs:(NSArray<NSString *> *)messageIDs
+           propertiesToUpdate:(NSDictionary<NSString *, id> *)properties
+            completionHandler:(void(^)(BOOL success))completionHandler {
+    [self safePerformBlock:^(BOOL isSafe) {
+        if (!isSafe) {
+            completionHandler(NO);
+            return;
+        }
 
         NSError *error;
+        NSPredicate *predicate = [NSPredicate predicateWithFormat:@"messageID IN %@", messageIDs];
+
         if (self.inMemory) {
-            request.includesPropertyValues = NO;
-            NSArray *events = [self.managedContext executeFetchRequest:request error:&error];
-            for (NSManagedObject *event in events) {
-                [self.managedContext deleteObject:event];
+            // Batch updates are only supported by SQLite stores
+            NSFetchRequest *request = [NSFetchRequest fetchRequestWithEntityName:kUAInboxDBEntityName];
+            request.predicate = predicate;
+
+            NSArray<UAInboxMessageData *> *result = [self.managedContext executeFetchRequest:request error:&error];
+            if (error) {
+                UA_LERR(@"Fetch request %@ failed with with error: %@", request, error);
+                completionHandler(NO);
+                return;
             }
-        } else {
-            NSBatchDeleteRequest *deleteRequest = [[NSBatchDeleteRequest alloc] initWithFetchRequest:request];
-            [self.managedContext executeRequest:deleteRequest error:&error];
+
+            for (UAInboxMessageData *data in result) {
+                [data setValuesForKeysWithDictionary:properties];
+            }
+
+            completionHandler([self.managedContext safeSave]);
+            return;
+        }
+
+        NSBatchUpdateRequest *updateRequest = [[NSBatchUpdateRequest alloc] initWithEntityName:kUAInboxDBEntityName];
+        updateRequest.predicate = predicate;
+        updateRequest.propertiesToUpdate = properties;
+        updateRequest.resultType = NSUpdatedObjectIDsResultType;
+
+        NSBatchUpdateResult *result = (NSBatchUpdateResult *)[self.managedContext executeRequest:updateRequest error:&error];
+        if (error) {
+            UA_LERR(@"Batch update request %@ failed with with error: %@", updateRequest, error);
+            completionHandler(NO);
+            return;
         }
 
-        completionHandler([self.managedContext safeSave]);
+        // Batch updates bypass the context, merge the changes so fetched objects are not stale
+        [NSManagedObjectContext mergeChangesFromRemoteContextSave:@{ NSUpdatedObjectsKey : result.result ?: @[] }
+                                                     intoContexts:@[self.managedContext]];
+
+        completionHandler(YES);
     }];
 }
 
-- (void)updateMessageData:(UAInboxMessageData *)data withDictionary:(NSDictionary *)dict {
+/**
+ * Updates the message data with the message payload.
+ *
+ * @param data The message data.
+ * @param dict The message payload.
+ * @return `YES` if the payload differs from the stored payload, otherwise `NO`.
+ */
+- (BOOL)updateMessageData:(UAInboxMessageData *)data withDictionary:(NSDictionary *)dict {
 
     dict = [dict dictionaryWithValuesForKeys:[[dict keysOfEntriesPassingTest:^BOOL(id key, id obj, BOOL *stop) {
         return ![obj isEqual:[NSNull null]];
     }] allObjects]];
 
-    if (!data.isGone) {
-        data.messageID = dict[@"message_id"];
-        data.contentType = dict[@"content_type"];
-        data.title = dict[@"title"];
-        data.extra = dict[@"extra"];
-        data.messageBodyURL = [NSURL URLWithString:dict[@"message_body_url"]];
-        data.messageURL = [NSURL URLWithString:dict[@"message_url"]];
-        data.unread = [dict[@"unread"] boolValue];
-        data.messageSent = [UAUtils parseISO8601DateFromString:dict[@"message_sent"]];
-        data.rawMessageObject = dict;
-
-        NSString *messageExpiration = dict[@"message_expiry"];
-        if (messageExpiration) {
-            data.messageExpiration = [UAUtils parseISO8601DateFromString:messageExpiration];
-        } else {
-            data.messageExpiration = nil;
-        }
+    if (data.isGone) {
+        return NO;
     }
-}
 
-
-- (void)addMessageFromDictionary:(NSDictionary *)dictionary {
-    UAInboxMessageData *data = (UAInboxMessageData *)[NSEntityDescription insertNewObjectForEntityForName:kUAInboxDBEntityName
-                                                                                   inManagedObjectContext:self.managedContext];
-
-    [self updateMessageData:data withDictionary:dictionary];
-}
-
-- (BOOL)updateMessageWithDictionary:(NSDictionary *)dictionary {
-    NSString *messageID = dictionary[@"message_id"];
-    NSError *error = nil;
-
-    if (!messageID) {
-        UA_LDEBUG(@"Missing message ID: %@", dictionary);
+    // Unchanged messages are left alone so they are not reported or saved again
+    if ([data.rawMessageObject isEqualToDictionary:dict]) {
         return NO;
     }
 
-    NSFetchRequest *request = [[NSFetchRequest alloc] init];
-    request.entity = [NSEntityDescription entityForName:kUAInboxDBEntityName
-                                 inManagedObjectContext:self.managedContext];
-    request.predicate = [NSPredicate predicateWithFormat:@"messageID == %@", messageID];
-    request.fetchLimit = 1;
+    data.messageID = dict[@"message_id"];
+    data.contentType = dict[@"content_type"];
+    data.title = dict[@"title"];
+    data.extra = dict[@"extra"];
+    data.messageBodyURL = [NSURL URLWithString:dict[@"message_body_url"]];
+    data.messageURL = [NSURL URLWithString:dict[@"message_url"]];
+    data.unread = [dict[@"unread"] boolValue];
+    data.messageSent = [UAUtils parseISO8601DateFromString:dict[@"message_sent"]];
+    data.rawMessageObject = dict;
+
+    NSString *messageExpiration = dict[@"message_expiry"];
+    if (messageExpiration) {
+        data.messageExpiration = [UAUtils parseISO8601DateFromString:messageExpiration];
+    } else {
+        data.messageExpiration = nil;
+    }
 
-    NSArray *resultData = [self.managedContext executeFetchRequest:request error:&error];
+    return YES;
+}
 
-    if (error) {
-        UA_LERR(@"Fetch request %@ failed with with error: %@", request, error);
-    }
 
-    UAInboxMessageData *data;
-    if (resultData.count) {
-        data = [resultData lastObject];
-        [self updateMessageData:data withDictionary:dictionary];
-        return YES;
-    }
-    
-    return NO;
+- (UAInboxMessageData *)addMessageFromDictionary:(NSDictionary *)dictionary {
+    UAInboxMessageData *data = (UAInboxMessageData *)[NSEntityDescription insertNewObjectForEntityForName:kUAInboxDBEntityName
+                                                                                   inManagedObjectContext:self.managedContext];
+
+    [self updateMessageData:data withDictionary:dictionary];
+    return data;
 }
 
 - (void)moveDatabase {
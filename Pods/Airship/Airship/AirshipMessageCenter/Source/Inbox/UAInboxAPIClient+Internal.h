@@ -30,6 +30,13 @@ typedef void (^UAInboxClientSuccessBlock)(void);
  */
 typedef void (^UAInboxClientFailureBlock)(void);
 
+/**
+ * A block called when a batch update failed.
+ *
+ * @param status The HTTP status code, or 0 if no response was received.
+ */
+typedef void (^UAInboxClientBatchFailureBlock)(NSUInteger status);
+
 /**
  * A high level abstraction for performing Rich Push API requests.
  */
@@ -72,7 +79,7 @@ typedef void (^UAInboxClientFailureBlock)(void);
 
 - (void)performBatchDeleteForMessageURLs:(NSArray<NSURL *> *)messageURLs
                             onSuccess:(UAInboxClientSuccessBlock)successBlock
-                            onFailure:(UAInboxClientFailureBlock)failureBlock;
+                            onFailure:(UAInboxClientBatchFailureBlock)failureBlock;
 
 /**
  * Performs a batch mark-as-read request on the server.
@@ -84,7 +91,7 @@ typedef void (^UAInboxClientFailureBlock)(void);
 
 - (void)performBatchMarkAsReadForMessageURLs:(NSArray<NSURL *> *)messageURLs
                                    onSuccess:(UAInboxClientSuccessBlock)successBlock
-                                   onFailure:(UAInboxClientFailureBlock)failureBlock;
+                                   onFailure:(UAInboxClientBatchFailureBlock)failureBlock;
 
 /**
  * Clears the last modified time for message list requests.
@@ -127,7 +127,7 @@ NSString *const UALastMessageListModifiedTime = @"UALastMessageListModifiedTime.
 
 - (void)performBatchDeleteForMessageURLs:(NSArray<NSURL *> *)messageURLs
                             onSuccess:(UAInboxClientSuccessBlock)successBlock
-                            onFailure:(UAInboxClientFailureBlock)failureBlock {
+                            onFailure:(UAInboxClientBatchFailureBlock)failureBlock {
 
     if (!self.enabled) {
         successBlock();
@@ -182,7 +182,7 @@ NSString *const UALastMessageListModifiedTime = @"UALastMessageListModifiedTime.
                             if (httpResponse.statusCode != 200) {
                                 [UAUtils logFailedRequest:request withMessage:@"Batch delete failed" withError:error withResponse:httpResponse];
 
-                                failureBlock();
+                                failureBlock(httpResponse.statusCode);
 
                                 return;
                             }
@@ -195,7 +195,7 @@ NSString *const UALastMessageListModifiedTime = @"UALastMessageListModifiedTime.
 
 - (void)performBatchMarkAsReadForMessageURLs:(NSArray *)messageURLs
                                    onSuccess:(UAInboxClientSuccessBlock)successBlock
-                                   onFailure:(UAInboxClientFailureBlock)failureBlock {
+                                   onFailure:(UAInboxClientBatchFailureBlock)failureBlock {
 
     if (!self.enabled) {
         successBlock();
@@ -245,9 +245,9 @@ NSString *const UALastMessageListModifiedTime = @"UALastMessageListModifiedTime.
 
                                    // Failure
                                    if (httpResponse.statusCode != 200) {
-                                       [UAUtils logFailedRequest:request withMessage:@"Batch delete failed" withError:error withResponse:httpResponse];
+                                       [UAUtils logFailedRequest:request withMessage:@"Batch mark as read failed" withError:error withResponse:httpResponse];
 
-                                       failureBlock();
+                                       failureBlock(httpResponse.statusCode);
 
                                        return;
                                    }
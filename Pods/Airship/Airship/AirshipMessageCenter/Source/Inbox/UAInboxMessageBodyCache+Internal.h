@@ -0,0 +1,109 @@
+/* Copyright Airship and Contributors */
+
+#import <Foundation/Foundation.h>
+
+#import "UAAirshipMessageCenterCoreImport.h"
+
+@class UAUser;
+@class UAInboxMessage;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * The default maximum size in bytes of the cached message bodies.
+ */
+extern const NSUInteger UAInboxMessageBodyCacheDefaultMaxSize;
+
+/**
+ * The default maximum number of cached message bodies.
+ */
+extern const NSUInteger UAInboxMessageBodyCacheDefaultMaxMessages;
+
+/**
+ * Offline cache for Message Center message bodies.
+ *
+ * Unread message bodies are prefetched after the message list syncs, with their images inlined
+ * so the message renders without a connection. Bodies are evicted least recently used first once
+ * the cache exceeds its maximum size or message count.
+ */
+@interface UAInboxMessageBodyCache : NSObject
+
+///---------------------------------------------------------------------------------------
+/// @name Message Body Cache Internal Properties
+///---------------------------------------------------------------------------------------
+
+/**
+ * Whether prefetching is enabled. Defaults to `YES`.
+ */
+@property (atomic, assign) BOOL enabled;
+
+///---------------------------------------------------------------------------------------
+/// @name Message Body Cache Internal Methods
+///---------------------------------------------------------------------------------------
+
+/**
+ * Factory method.
+ *
+ * @param user The user.
+ * @param config The config.
+ * @return A message body cache instance.
+ */
++ (instancetype)cacheWithUser:(UAUser *)user config:(UARuntimeConfig *)config;
+
+/**
+ * Factory method. Used for testing.
+ *
+ * @param user The user.
+ * @param session The request session.
+ * @param directoryURL The directory in which to store message bodies.
+ * @param maxSize The maximum size in bytes of the cached message bodies.
+ * @param maxMessages The maximum number of cached message bodies.
+ * @param dispatcher The dispatcher used to write the manifest.
+ * @return A message body cache instance.
+ */
++ (instancetype)cacheWithUser:(UAUser *)user
+                      session:(UARequestSession *)session
+                 directoryURL:(NSURL *)directoryURL
+                      maxSize:(NSUInteger)maxSize
+                  maxMessages:(NSUInteger)maxMessages
+                   dispatcher:(UADispatcher *)dispatcher;
+
+/**
+ * Prefetches the bodies of the unread messages that are not cached yet, most recent first,
+ * up to the maximum message count.
+ *
+ * @param messages The messages.
+ */
+- (void)prefetchMessages:(NSArray<UAInboxMessage *> *)messages;
+
+/**
+ * Returns the cached body of a message.
+ *
+ * @param message The message.
+ * @return The HTML body, or `nil` if the body is not cached.
+ */
+- (nullable NSString *)cachedBodyForMessage:(UAInboxMessage *)message;
+
+/**
+ * Revalidates the cached body of a message in the background. A changed body replaces the
+ * cached body and a body that is no longer available is removed.
+ *
+ * @param message The message.
+ */
+- (void)revalidateMessage:(UAInboxMessage *)message;
+
+/**
+ * Removes the cached bodies of messages.
+ *
+ * @param messageIDs The message IDs.
+ */
+- (void)removeBodiesForMessageIDs:(NSArray<NSString *> *)messageIDs;
+
+/**
+ * Removes all cached bodies. Bodies still being fetched are discarded.
+ */
+- (void)removeAllBodies;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,537 @@
+/* Copyright Airship and Contributors */
+
+#import "UAInboxMessageBodyCache+Internal.h"
+#import "UAInboxMessage.h"
+#import "UAInboxUtils.h"
+#import "UAUser+Internal.h"
+
+#import "UAAirshipMessageCenterCoreImport.h"
+
+const NSUInteger UAInboxMessageBodyCacheDefaultMaxSize = 10 * 1024 * 1024;
+const NSUInteger UAInboxMessageBodyCacheDefaultMaxMessages = 25;
+
+// Images larger than this are left to load from the network
+static const NSUInteger UAInboxMessageBodyCacheMaxImageSize = 1024 * 1024;
+
+static NSString * const UAInboxMessageBodyCacheDirectoryName = @"com.urbanairship.message_center.bodies";
+static NSString * const UAInboxMessageBodyCacheManifestFileName = @"manifest.plist";
+
+// Delay before a changed manifest is written, so repeated reads share one write
+static const NSTimeInterval UAInboxMessageBodyCacheManifestWriteDelay = 1;
+
+static NSString * const UAInboxMessageBodyCacheSizeKey = @"size";
+static NSString * const UAInboxMessageBodyCacheLastAccessKey = @"last_access";
+static NSString * const UAInboxMessageBodyCacheETagKey = @"etag";
+static NSString * const UAInboxMessageBodyCacheLastModifiedKey = @"last_modified";
+
+/**
+ * Bookkeeping for a cached message body.
+ */
+@interface UAInboxMessageBodyCacheEntry : NSObject
+@property (nonatomic, assign) unsigned long long size;
+@property (nonatomic, strong) NSDate *lastAccess;
+@property (nonatomic, copy, nullable) NSString *etag;
+@property (nonatomic, copy, nullable) NSString *lastModified;
+@end
+
+@implementation UAInboxMessageBodyCacheEntry
+
++ (instancetype)entryWithDictionary:(NSDictionary *)dictionary {
+    UAInboxMessageBodyCacheEntry *entry = [[self alloc] init];
+    entry.size = [dictionary[UAInboxMessageBodyCacheSizeKey] unsignedLongLongValue];
+    entry.lastAccess = dictionary[UAInboxMessageBodyCacheLastAccessKey] ?: [NSDate date];
+    entry.etag = dictionary[UAInboxMessageBodyCacheETagKey];
+    entry.lastModified = dictionary[UAInboxMessageBodyCacheLastModifiedKey];
+    return entry;
+}
+
+- (NSDictionary *)dictionaryValue {
+    NSMutableDictionary *dictionary = [NSMutableDictionary dictionary];
+    dictionary[UAInboxMessageBodyCacheSizeKey] = @(self.size);
+    dictionary[UAInboxMessageBodyCacheLastAccessKey] = self.lastAccess;
+    dictionary[UAInboxMessageBodyCacheETagKey] = self.etag;
+    dictionary[UAInboxMessageBodyCacheLastModifiedKey] = self.lastModified;
+    return dictionary;
+}
+
+@end
+
+@interface UAInboxMessageBodyCache ()
+@property (nonatomic, strong) UAUser *user;
+@property (nonatomic, strong) UARequestSession *session;
+@property (nonatomic, strong) NSURL *directoryURL;
+@property (nonatomic, assign) NSUInteger maxSize;
+@property (nonatomic, assign) NSUInteger maxMessages;
+@property (nonatomic, strong) NSFileManager *fileManager;
+@property (nonatomic, strong) UADispatcher *dispatcher;
+@property (nonatomic, strong, nullable) UADisposable *scheduledManifestWrite;
+
+// Incremented when all bodies are removed, so fetches started before then are not stored
+@property (nonatomic, assign) NSUInteger generation;
+
+// Entries keyed by message ID
+@property (nonatomic, strong) NSMutableDictionary<NSString *, UAInboxMessageBodyCacheEntry *> *entries;
+
+// Messages waiting to be prefetched, one at a time
+@property (nonatomic, strong) NSMutableArray<UAInboxMessage *> *prefetchQueue;
+@property (nonatomic, assign) BOOL prefetching;
+@end
+
+@implementation UAInboxMessageBodyCache
+
+- (instancetype)initWithUser:(UAUser *)user
+                     session:(UARequestSession *)session
+                directoryURL:(NSURL *)directoryURL
+                     maxSize:(NSUInteger)maxSize
+                 maxMessages:(NSUInteger)maxMessages
+                  dispatcher:(UADispatcher *)dispatcher {
+    self = [super init];
+
+    if (self) {
+        self.user = user;
+        self.session = session;
+        self.directoryURL = directoryURL;
+        self.maxSize = maxSize;
+        self.maxMessages = maxMessages;
+        self.dispatcher = dispatcher;
+        self.fileManager = [NSFileManager defaultManager];
+        self.entries = [NSMutableDictionary dictionary];
+        self.prefetchQueue = [NSMutableArray array];
+        self.enabled = YES;
+
+        [self loadManifest];
+    }
+
+    return self;
+}
+
++ (instancetype)cacheWithUser:(UAUser *)user config:(UARuntimeConfig *)config {
+    NSURL *cachesURL = [[[NSFileManager defaultManager] URLsForDirectory:NSCachesDirectory inDomains:NSUserDomainMask] lastObject];
+    NSURL *directoryURL = [[cachesURL URLByAppendingPathComponent:UAInboxMessageBodyCacheDirectoryName] URLByAppendingPathComponent:config.appKey];
+
+    return [self cacheWithUser:user
+                       session:[UARequestSession sessionWithConfig:config requestClass:@"inbox_body" priority:UARequestPriorityLow]
+                  directoryURL:directoryURL
+                       maxSize:UAInboxMessageBodyCacheDefaultMaxSize
+                   maxMessages:UAInboxMessageBodyCacheDefaultMaxMessages
+                    dispatcher:[UADispatcher backgroundDispatcher]];
+}
+
++ (instancetype)cacheWithUser:(UAUser *)user
+                      session:(UARequestSession *)session
+                 directoryURL:(NSURL *)directoryURL
+                      maxSize:(NSUInteger)maxSize
+                  maxMessages:(NSUInteger)maxMessages
+                   dispatcher:(UADispatcher *)dispatcher {
+    return [[self alloc] initWithUser:user
+                              session:session
+                         directoryURL:directoryURL
+                              maxSize:maxSize
+                          maxMessages:maxMessages
+                           dispatcher:dispatcher];
+}
+
+- (void)dealloc {
+    [self.session cancelAllRequests];
+}
+
+- (void)prefetchMessages:(NSArray<UAInboxMessage *> *)messages {
+    if (!self.enabled) {
+        return;
+    }
+
+    @synchronized (self) {
+        [self.prefetchQueue removeAllObjects];
+
+        NSUInteger count = 0;
+        for (UAInboxMessage *message in messages) {
+            if (!message.unread || !message.messageID || !message.messageBodyURL) {
+                continue;
+            }
+
+            if (count++ >= self.maxMessages) {
+                break;
+            }
+
+            if (!self.entries[message.messageID]) {
+                [self.prefetchQueue addObject:message];
+            }
+        }
+    }
+
+    [self prefetchNext];
+}
+
+- (NSString *)cachedBodyForMessage:(UAInboxMessage *)message {
+    if (!message.messageID) {
+        return nil;
+    }
+
+    @synchronized (self) {
+        UAInboxMessageBodyCacheEntry *entry = self.entries[message.messageID];
+        if (!entry) {
+            return nil;
+        }
+
+        NSString *body = [NSString stringWithContentsOfURL:[self fileURLForMessageID:message.messageID]
+                                                  encoding:NSUTF8StringEncoding
+                                                     error:nil];
+
+        // The file may have been removed behind the cache's back, e.g. by the OS purging caches
+        if (!body) {
+            [self.entries removeObjectForKey:message.messageID];
+            [self setNeedsSaveManifest];
+            return nil;
+        }
+
+        entry.lastAccess = [NSDate date];
+        [self setNeedsSaveManifest];
+        return body;
+    }
+}
+
+- (void)revalidateMessage:(UAInboxMessage *)message {
+    @synchronized (self) {
+        if (!message.messageID || !self.entries[message.messageID]) {
+            return;
+        }
+    }
+
+    [self fetchBodyForMessage:message completionHandler:^{}];
+}
+
+- (void)removeBodiesForMessageIDs:(NSArray<NSString *> *)messageIDs {
+    @synchronized (self) {
+        BOOL changed = NO;
+        for (NSString *messageID in messageIDs) {
+            if (self.entries[messageID]) {
+                [self removeEntryForMessageID:messageID];
+                changed = YES;
+            }
+        }
+
+        if (changed) {
+            [self setNeedsSaveManifest];
+        }
+    }
+}
+
+- (void)removeAllBodies {
+    @synchronized (self) {
+        self.generation++;
+        [self.prefetchQueue removeAllObjects];
+        [self.entries removeAllObjects];
+        [self.scheduledManifestWrite dispose];
+        self.scheduledManifestWrite = nil;
+
+        NSArray *fileNames = [self.fileManager contentsOfDirectoryAtPath:self.directoryURL.path error:nil];
+        for (NSString *fileName in fileNames) {
+            [self.fileManager removeItemAtURL:[self.directoryURL URLByAppendingPathComponent:fileName] error:nil];
+        }
+    }
+}
+
+#pragma mark -
+#pragma mark Fetching
+
+- (void)prefetchNext {
+    UAInboxMessage *message;
+
+    @synchronized (self) {
+        if (self.prefetching || !self.prefetchQueue.count || !self.enabled) {
+            return;
+        }
+
+        message = self.prefetchQueue.firstObject;
+        [self.prefetchQueue removeObjectAtIndex:0];
+        self.prefetching = YES;
+    }
+
+    UA_LTRACE(@"Prefetching body of message %@", message.messageID);
+
+    // Prefetch one message at a time to stay in the background of other traffic
+    UA_WEAKIFY(self)
+    [self fetchBodyForMessage:message completionHandler:^{
+        UA_STRONGIFY(self)
+        @synchronized (self) {
+            self.prefetching = NO;
+        }
+
+        [self prefetchNext];
+    }];
+}
+
+- (void)fetchBodyForMessage:(UAInboxMessage *)message completionHandler:(void (^)(void))completionHandler {
+    NSString *messageID = message.messageID;
+    NSURL *bodyURL = message.messageBodyURL;
+
+    NSString *etag;
+    NSString *lastModified;
+    NSUInteger generation;
+    @synchronized (self) {
+        etag = self.entries[messageID].etag;
+        lastModified = self.entries[messageID].lastModified;
+        generation = self.generation;
+    }
+
+    UA_WEAKIFY(self)
+    [self.user getUserData:^(UAUserData *userData) {
+        UA_STRONGIFY(self)
+        if (!userData) {
+            completionHandler();
+            return;
+        }
+
+        UARequest *request = [UARequest requestWithBuilderBlock:^(UARequestBuilder *builder) {
+            builder.method = @"GET";
+            builder.URL = bodyURL;
+            [builder setValue:[UAInboxUtils userAuthHeaderString:userData] forHeader:@"Authorization"];
+            [builder setValue:etag forHeader:@"If-None-Match"];
+            [builder setValue:lastModified forHeader:@"If-Modified-Since"];
+        }];
+
+        [self.session dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
+            UA_STRONGIFY(self)
+            if (error || ![response isKindOfClass:[NSHTTPURLResponse class]]) {
+                UA_LTRACE(@"Failed to fetch body of message %@: %@", messageID, error);
+                completionHandler();
+                return;
+            }
+
+            NSHTTPURLResponse *httpResponse = (NSHTTPURLResponse *)response;
+            NSInteger status = httpResponse.statusCode;
+
+            if (status == 200) {
+                NSString *body = [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding] ?:
+                                 [[NSString alloc] initWithData:data encoding:NSISOLatin1StringEncoding];
+
+                [self inlineImagesInBody:body baseURL:bodyURL completionHandler:^(NSString *inlinedBody) {
+                    UA_STRONGIFY(self)
+                    [self storeBody:inlinedBody messageID:messageID response:httpResponse generation:generation];
+                    completionHandler();
+                }];
+                return;
+            }
+
+            if (status == 304) {
+                UA_LTRACE(@"Body of message %@ is up to date", messageID);
+            } else if (status == 404 || status == 410) {
+                [self removeBodiesForMessageIDs:@[messageID]];
+            }
+
+            completionHandler();
+        }];
+    } dispatcher:nil];
+}
+
+/**
+ * Inlines the images of a message body as data URIs so the body renders offline.
+ *
+ * @param body The message body.
+ * @param baseURL The URL that relative image sources resolve against.
+ * @param completionHandler The completion handler with the inlined body.
+ */
+- (void)inlineImagesInBody:(NSString *)body baseURL:(NSURL *)baseURL completionHandler:(void (^)(NSString *))completionHandler {
+    NSRegularExpression *regex = [NSRegularExpression regularExpressionWithPattern:@"<img\\b[^>]*?\\bsrc\\s*=\\s*[\"']([^\"']+)[\"']"
+                                                                           options:NSRegularExpressionCaseInsensitive
+                                                                             error:nil];
+
+    NSArray<NSTextCheckingResult *> *matches = [regex matchesInString:body options:0 range:NSMakeRange(0, body.length)];
+
+    NSMutableSet<NSString *> *sources = [NSMutableSet set];
+    for (NSTextCheckingResult *match in matches) {
+        NSString *source = [body substringWithRange:[match rangeAtIndex:1]];
+        if (![source hasPrefix:@"data:"]) {
+            [sources addObject:source];
+        }
+    }
+
+    NSMutableDictionary<NSString *, NSString *> *dataURIs = [NSMutableDictionary dictionary];
+    dispatch_group_t group = dispatch_group_create();
+
+    for (NSString *source in sources) {
+        NSString *unescaped = [source stringByReplacingOccurrencesOfString:@"&amp;" withString:@"&"];
+        NSURL *imageURL = [NSURL URLWithString:unescaped relativeToURL:baseURL].absoluteURL;
+        if (![imageURL.scheme isEqualToString:@"https"] && ![imageURL.scheme isEqualToString:@"http"]) {
+            continue;
+        }
+
+        UARequest *request = [UARequest requestWithBuilderBlock:^(UARequestBuilder *builder) {
+            builder.method = @"GET";
+            builder.URL = imageURL;
+        }];
+
+        dispatch_group_enter(group);
+        [self.session dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
+            NSInteger status = [response isKindOfClass:[NSHTTPURLResponse class]] ? ((NSHTTPURLResponse *)response).statusCode : 0;
+            if (!error && status == 200 && data.length <= UAInboxMessageBodyCacheMaxImageSize && [response.MIMEType hasPrefix:@"image/"]) {
+                NSString *dataURI = [NSString stringWithFormat:@"data:%@;base64,%@", response.MIMEType, [data base64EncodedStringWithOptions:0]];
+                @synchronized (dataURIs) {
+                    dataURIs[source] = dataURI;
+                }
+            }
+
+            dispatch_group_leave(group);
+        }];
+    }
+
+    dispatch_group_notify(group, dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+        NSMutableString *inlinedBody = [body mutableCopy];
+
+        // Replace from the end so the earlier match ranges stay valid
+        for (NSTextCheckingResult *match in matches.reverseObjectEnumerator) {
+            NSRange range = [match rangeAtIndex:1];
+            NSString *dataURI = dataURIs[[body substringWithRange:range]];
+            if (dataURI) {
+                [inlinedBody replaceCharactersInRange:range withString:dataURI];
+            }
+        }
+
+        completionHandler(inlinedBody);
+    });
+}
+
+#pragma mark -
+#pragma mark Storage
+
+- (NSURL *)fileURLForMessageID:(NSString *)messageID {
+    return [self.directoryURL URLByAppendingPathComponent:[[UAUtils sha256HashWithString:messageID] stringByAppendingPathExtension:@"html"]];
+}
+
+- (void)storeBody:(NSString *)body messageID:(NSString *)messageID response:(NSHTTPURLResponse *)response generation:(NSUInteger)generation {
+    NSData *data = [body dataUsingEncoding:NSUTF8StringEncoding];
+    if (data.length > self.maxSize) {
+        UA_LTRACE(@"Body of message %@ is too large to cache", messageID);
+        return;
+    }
+
+    @synchronized (self) {
+        // The bodies were removed while this one was fetched, e.g. for a new user
+        if (generation != self.generation) {
+            return;
+        }
+
+        if (![self createDirectory]) {
+            return;
+        }
+
+        NSURL *fileURL = [self fileURLForMessageID:messageID];
+        if (![data writeToURL:fileURL atomically:YES]) {
+            UA_LERR(@"Unable to write body of message %@ to %@", messageID, fileURL);
+            return;
+        }
+
+        UAInboxMessageBodyCacheEntry *entry = self.entries[messageID] ?: [[UAInboxMessageBodyCacheEntry alloc] init];
+        entry.size = data.length;
+        entry.lastAccess = entry.lastAccess ?: [NSDate date];
+        entry.etag = response.allHeaderFields[@"ETag"];
+        entry.lastModified = response.allHeaderFields[@"Last-Modified"];
+        self.entries[messageID] = entry;
+
+        [self evictIfNeeded];
+        [self setNeedsSaveManifest];
+    }
+}
+
+// Must be called while synchronized on self
+- (void)removeEntryForMessageID:(NSString *)messageID {
+    [self.entries removeObjectForKey:messageID];
+    [self.fileManager removeItemAtURL:[self fileURLForMessageID:messageID] error:nil];
+}
+
+// Must be called while synchronized on self
+- (void)evictIfNeeded {
+    unsigned long long totalSize = 0;
+    for (UAInboxMessageBodyCacheEntry *entry in self.entries.allValues) {
+        totalSize += entry.size;
+    }
+
+    if (totalSize <= self.maxSize && self.entries.count <= self.maxMessages) {
+        return;
+    }
+
+    // Least recently used first
+    NSArray<NSString *> *messageIDs = [self.entries keysSortedByValueUsingComparator:^NSComparisonResult(UAInboxMessageBodyCacheEntry *a, UAInboxMessageBodyCacheEntry *b) {
+        return [a.lastAccess compare:b.lastAccess];
+    }];
+
+    for (NSString *messageID in messageIDs) {
+        if (totalSize <= self.maxSize && self.entries.count <= self.maxMessages) {
+            break;
+        }
+
+        totalSize -= self.entries[messageID].size;
+        [self removeEntryForMessageID:messageID];
+    }
+}
+
+#pragma mark -
+#pragma mark Manifest
+
+- (NSURL *)manifestURL {
+    return [self.directoryURL URLByAppendingPathComponent:UAInboxMessageBodyCacheManifestFileName];
+}
+
+- (void)loadManifest {
+    NSDictionary *manifest = [NSDictionary dictionaryWithContentsOfURL:[self manifestURL]];
+
+    for (NSString *messageID in manifest) {
+        NSDictionary *dictionary = manifest[messageID];
+        if (![dictionary isKindOfClass:[NSDictionary class]]) {
+            continue;
+        }
+
+        if ([self.fileManager fileExistsAtPath:[self fileURLForMessageID:messageID].path]) {
+            self.entries[messageID] = [UAInboxMessageBodyCacheEntry entryWithDictionary:dictionary];
+        }
+    }
+}
+
+// Must be called while synchronized on self
+- (void)setNeedsSaveManifest {
+    if (self.scheduledManifestWrite) {
+        return;
+    }
+
+    UA_WEAKIFY(self)
+    self.scheduledManifestWrite = [self.dispatcher dispatchAfter:UAInboxMessageBodyCacheManifestWriteDelay block:^{
+        UA_STRONGIFY(self)
+        @synchronized (self) {
+            self.scheduledManifestWrite = nil;
+            [self saveManifest];
+        }
+    }];
+}
+
+// Must be called while synchronized on self
+- (void)saveManifest {
+    if (![self createDirectory]) {
+        return;
+    }
+
+    NSMutableDictionary *manifest = [NSMutableDictionary dictionary];
+    for (NSString *messageID in self.entries) {
+        manifest[messageID] = [self.entries[messageID] dictionaryValue];
+    }
+
+    if (![manifest writeToURL:[self manifestURL] atomically:YES]) {
+        UA_LERR(@"Unable to write message body manifest at %@", [self manifestURL]);
+    }
+}
+
+- (BOOL)createDirectory {
+    if ([self.fileManager fileExistsAtPath:self.directoryURL.path]) {
+        return YES;
+    }
+
+    NSError *error;
+    [self.fileManager createDirectoryAtURL:self.directoryURL withIntermediateDirectories:YES attributes:nil error:&error];
+    if (error) {
+        UA_LERR(@"Unable to create message body directory at %@", self.directoryURL);
+        return NO;
+    }
+
+    return YES;
+}
+
+@end
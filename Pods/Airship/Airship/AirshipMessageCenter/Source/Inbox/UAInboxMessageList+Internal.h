@@ -3,6 +3,8 @@
 #import "UAInboxMessageList.h"
 #import "UAInboxAPIClient+Internal.h"
 #import "UAInboxStore+Internal.h"
+#import "UAInboxMessageBodyCache+Internal.h"
+#import "UAInboxOutbox+Internal.h"
 
 #import "UAAirshipMessageCenterCoreImport.h"
 
@@ -48,14 +50,26 @@ NS_ASSUME_NONNULL_BEGIN
 @property (nonatomic, strong) NSArray<UAInboxMessage *> *messages;
 
 /**
- * A dictionary of messages mapped to their IDs
+ * A dictionary of messages mapped to their IDs. Updated incrementally on the main dispatcher
+ * while synchronized on the message list, and must only be read while synchronized on it.
  */
-@property (nonatomic, strong) NSDictionary *messageIDMap;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, UAInboxMessage *> *messageIDMap;
 
 /**
- * A dictionary of messages mapped to their URLs
+ * A dictionary of messages mapped to their URLs. Updated incrementally on the main dispatcher
+ * while synchronized on the message list, and must only be read while synchronized on it.
  */
-@property (nonatomic, strong) NSDictionary *messageURLMap;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, UAInboxMessage *> *messageURLMap;
+
+/**
+ * The offline message body cache, prefetched after the message list syncs.
+ */
+@property (nonatomic, strong, nullable) UAInboxMessageBodyCache *bodyCache;
+
+/**
+ * The outbox of read and delete operations waiting to be sent to the server.
+ */
+@property (nonatomic, strong, nullable) UAInboxOutbox *outbox;
 
 /**
  * Flag indicating whether the mesage list is enabled. Clear to disable. Set to enable.
@@ -24,10 +24,26 @@ extern NSString * const UAInboxMessageListWillUpdateNotification;
  * NSNotification posted when the message list is finished updating.
  *
  * Note: this notification is posted regardless of the type of update (retrieval, batch)
- * and regardless of the success/failure of the underlying operation.
+ * and regardless of the success/failure of the underlying operation. The user info contains
+ * the IDs of the inserted, updated and deleted messages.
  */
 extern NSString * const UAInboxMessageListUpdatedNotification;
 
+/**
+ * Key for the IDs of the messages added to the list in the `UAInboxMessageListUpdatedNotification` user info.
+ */
+extern NSString * const UAInboxMessageListInsertedMessageIDsKey;
+
+/**
+ * Key for the IDs of the messages that changed in the `UAInboxMessageListUpdatedNotification` user info.
+ */
+extern NSString * const UAInboxMessageListUpdatedMessageIDsKey;
+
+/**
+ * Key for the IDs of the messages removed from the list in the `UAInboxMessageListUpdatedNotification` user info.
+ */
+extern NSString * const UAInboxMessageListDeletedMessageIDsKey;
+
 @class UAInboxMessage;
 
 /**
@@ -12,14 +12,23 @@
 
 NSString * const UAInboxMessageListWillUpdateNotification = @"com.urbanairship.notification.message_list_will_update";
 NSString * const UAInboxMessageListUpdatedNotification = @"com.urbanairship.notification.message_list_updated";
+NSString * const UAInboxMessageListInsertedMessageIDsKey = @"inserted_message_ids";
+NSString * const UAInboxMessageListUpdatedMessageIDsKey = @"updated_message_ids";
+NSString * const UAInboxMessageListDeletedMessageIDsKey = @"deleted_message_ids";
 
 typedef void (^UAInboxMessageFetchCompletionHandler)(NSArray *);
+typedef void (^UAInboxMessageListChangesHandler)(NSDictionary *);
 
 @interface UAInboxMessageList()
 @property (nonatomic, strong) NSNotificationCenter *notificationCenter;
 @property (nonatomic, strong) UADispatcher *dispatcher;
 @property (nonatomic, strong) UADate *date;
 
+// IDs of the unread messages in the snapshot, only accessed on the main dispatcher
+@property (nonatomic, strong) NSMutableSet<NSString *> *unreadMessageIDs;
+
+// Set once a full refresh has been queued, incremental refreshes are applied on top of it
+@property (atomic, assign) BOOL snapshotRequested;
 @end
 
 @implementation UAInboxMessageList
@@ -46,6 +55,7 @@ typedef void (^UAInboxMessageFetchCompletionHandler)(NSArray *);
         self.retrieveOperationCount = 0;
         self.unreadCount = -1;
         self.messages = @[];
+        self.snapshotRequested = NO;
         self.notificationCenter = notificationCenter;
         self.dispatcher = dispatcher;
         self.date = date;
@@ -59,19 +69,24 @@ typedef void (^UAInboxMessageFetchCompletionHandler)(NSArray *);
                           dataStore:(UAPreferenceDataStore *)dataStore {
 
     UAInboxAPIClient *client = [UAInboxAPIClient clientWithConfig:config
-                                                          session:[UARequestSession sessionWithConfig:config]
+                                                          session:[UARequestSession sessionWithConfig:config requestClass:@"inbox" priority:UARequestPriorityNormal]
                                                              user:user
                                                         dataStore:dataStore];
 
     UAInboxStore *inboxStore = [UAInboxStore storeWithName:[NSString stringWithFormat:kUACoreDataStoreName, config.appKey]];
 
-    return [UAInboxMessageList messageListWithUser:user
-                                             client:client
-                                             config:config
-                                         inboxStore:inboxStore
-                                 notificationCenter:[NSNotificationCenter defaultCenter]
-                                         dispatcher:[UADispatcher mainDispatcher]
-                                               date:[[UADate alloc] init]];
+    UAInboxMessageList *messageList = [UAInboxMessageList messageListWithUser:user
+                                                                       client:client
+                                                                       config:config
+                                                                   inboxStore:inboxStore
+                                                           notificationCenter:[NSNotificationCenter defaultCenter]
+                                                                   dispatcher:[UADispatcher mainDispatcher]
+                                                                         date:[[UADate alloc] init]];
+
+    messageList.bodyCache = [UAInboxMessageBodyCache cacheWithUser:user config:config];
+    messageList.outbox = [UAInboxOutbox outboxWithClient:client inboxStore:inboxStore dataStore:dataStore];
+
+    return messageList;
 }
 
 + (instancetype)messageListWithUser:(UAUser *)user
@@ -95,22 +110,17 @@ typedef void (^UAInboxMessageFetchCompletionHandler)(NSArray *);
 #pragma mark Accessors
 
 - (void)setMessages:(NSArray *)messages {
-    _messages = [messages copy];
+    @synchronized(self) {
+        _messages = [messages copy];
 
-    NSMutableDictionary *messageIDMap = [NSMutableDictionary dictionary];
-    NSMutableDictionary *messageURLMap = [NSMutableDictionary dictionary];
+        self.messageIDMap = [NSMutableDictionary dictionary];
+        self.messageURLMap = [NSMutableDictionary dictionary];
+        self.unreadMessageIDs = [NSMutableSet set];
 
-    for (UAInboxMessage *message in _messages) {
-        if (message.messageBodyURL.absoluteString) {
-            [messageURLMap setObject:message forKey:message.messageBodyURL.absoluteString];
-        }
-        if (message.messageID) {
-            [messageIDMap setObject:message forKey:message.messageID];
+        for (UAInboxMessage *message in messages) {
+            [self indexMessage:message];
         }
     }
-
-    self.messageIDMap = [messageIDMap copy];
-    self.messageURLMap = [messageURLMap copy];
 }
 
 - (NSArray *)messages {
@@ -129,8 +139,8 @@ typedef void (^UAInboxMessageFetchCompletionHandler)(NSArray *);
     [self.notificationCenter postNotificationName:UAInboxMessageListWillUpdateNotification object:nil];
 }
 
-- (void)sendMessageListUpdatedNotification {
-    [self.notificationCenter postNotificationName:UAInboxMessageListUpdatedNotification object:nil];
+- (void)sendMessageListUpdatedNotificationWithChanges:(NSDictionary *)changes {
+    [self.notificationCenter postNotificationName:UAInboxMessageListUpdatedNotification object:nil userInfo:changes];
 }
 
 #pragma mark Update/Delete/Mark Messages
@@ -156,24 +166,32 @@ typedef void (^UAInboxMessageFetchCompletionHandler)(NSArray *);
         retrieveMessageListFailureBlock = nil;
     }];
 
-    void (^completionBlock)(BOOL) = ^(BOOL success){
+    UAInboxMessageListChangesHandler changesHandler = ^(NSDictionary *changes) {
+        UA_STRONGIFY(self)
+        if (self.retrieveOperationCount > 0) {
+            self.retrieveOperationCount--;
+        }
+        if (retrieveMessageListSuccessBlock) {
+            retrieveMessageListSuccessBlock();
+        }
+        [self sendMessageListUpdatedNotificationWithChanges:changes];
+
+        // Make unread messages available offline
+        [self.bodyCache prefetchMessages:self.messages];
+    };
+
+    void (^failureBlock)(void) = ^{
         UA_STRONGIFY(self)
 
         // Always refresh the listing even if it's a failure
-        [self refreshInboxWithCompletionHandler:^ {
+        [self refreshInboxWithCompletionHandler:^(NSDictionary *changes) {
             if (self.retrieveOperationCount > 0) {
                 self.retrieveOperationCount--;
             }
-            if (success) {
-                if (retrieveMessageListSuccessBlock) {
-                    retrieveMessageListSuccessBlock();
-                }
-            } else {
-                if (retrieveMessageListFailureBlock) {
-                    retrieveMessageListFailureBlock();
-                }
+            if (retrieveMessageListFailureBlock) {
+                retrieveMessageListFailureBlock();
             }
-            [self sendMessageListUpdatedNotification];
+            [self sendMessageListUpdatedNotificationWithChanges:changes];
         }];
     };
 
@@ -181,28 +199,30 @@ typedef void (^UAInboxMessageFetchCompletionHandler)(NSArray *);
     [self.client retrieveMessageListOnSuccess:^(NSUInteger status, NSArray *messages) {
         UA_STRONGIFY(self)
 
-        // Sync client state
-        [self syncLocalMessageState];
-
         UA_LDEBUG(@"Retrieve message list succeeded with status: %lu", (unsigned long)status);
 
         if (status == 200) {
-            [self.inboxStore syncMessagesWithResponse:messages completionHandler:^(BOOL success) {
+            [self.inboxStore syncMessagesWithResponse:messages completionHandler:^(BOOL success, NSSet *changedMessageIDs, NSSet *deletedMessageIDs) {
                 UA_STRONGIFY(self)
                 if (!success) {
                     [self.client clearLastModifiedTime];
-                    completionBlock(NO);
+                    failureBlock();
                 } else {
-                    completionBlock(YES);
+                    // Operations on messages that are gone from the server no longer need to be sent
+                    [self.outbox removeOperationsForMessageIDs:deletedMessageIDs];
+
+                    [self refreshMessagesWithIDs:changedMessageIDs
+                               deletedMessageIDs:deletedMessageIDs
+                               completionHandler:changesHandler];
                 }
             }];
         } else {
-            // 304
-            completionBlock(YES);
+            // 304, only expired messages need to be removed
+            [self refreshMessagesWithIDs:[NSSet set] deletedMessageIDs:[NSSet set] completionHandler:changesHandler];
         }
     } onFailure:^(){
         UA_LDEBUG(@"Retrieve message list failed");
-        completionBlock(NO);
+        failureBlock();
     }];
 
     return disposable;
@@ -231,16 +251,17 @@ typedef void (^UAInboxMessageFetchCompletionHandler)(NSArray *);
         inboxMessageListCompletionBlock = nil;
     }];
 
-    [self.inboxStore fetchMessagesWithPredicate:[NSPredicate predicateWithFormat:@"messageID IN %@", messageIDs]
-                              completionHandler:^(NSArray<UAInboxMessageData *> *data) {
+    UA_LDEBUG(@"Marking messages as read: %@.", messageIDs);
+    [self.outbox enqueueReadForMessages:messages];
+
+    [self.inboxStore markMessagesReadLocallyWithIDs:messageIDs
+                                  completionHandler:^(BOOL success) {
                                   UA_STRONGIFY(self)
-                                  UA_LDEBUG(@"Marking messages as read: %@.", messageIDs);
-                                  for (UAInboxMessageData *messageData in data) {
-                                      messageData.unreadClient = NO;
-                                  }
 
                                   // Refresh the messages
-                                  [self refreshInboxWithCompletionHandler:^{
+                                  [self refreshMessagesWithIDs:[NSSet setWithArray:messageIDs]
+                                             deletedMessageIDs:[NSSet set]
+                                             completionHandler:^(NSDictionary *changes) {
                                       UA_STRONGIFY(self)
                                       if (self.batchOperationCount > 0) {
                                           self.batchOperationCount--;
@@ -250,10 +271,8 @@ typedef void (^UAInboxMessageFetchCompletionHandler)(NSArray *);
                                           inboxMessageListCompletionBlock();
                                       }
 
-                                      [self sendMessageListUpdatedNotification];
+                                      [self sendMessageListUpdatedNotificationWithChanges:changes];
                                   }];
-
-                                  [self syncLocalMessageState];
                               }];
 
     return disposable;
@@ -282,18 +301,17 @@ typedef void (^UAInboxMessageFetchCompletionHandler)(NSArray *);
         inboxMessageListCompletionBlock = nil;
     }];
 
-    [self.inboxStore fetchMessagesWithPredicate:[NSPredicate predicateWithFormat:@"messageID IN %@", messageIDs]
-                              completionHandler:^(NSArray<UAInboxMessageData *> *data) {
+    UA_LTRACE(@"Marking messages as deleted %@.", messageIDs);
+    [self.outbox enqueueDeleteForMessages:messages];
 
+    [self.inboxStore markMessagesDeletedLocallyWithIDs:messageIDs
+                                     completionHandler:^(BOOL success) {
                                   UA_STRONGIFY(self)
 
-                                  UA_LTRACE(@"Marking messages as deleted %@.", messageIDs);
-                                  for (UAInboxMessageData *messageData in data) {
-                                      messageData.deletedClient = YES;
-                                  }
-
-                                  // Refresh the messages
-                                  [self refreshInboxWithCompletionHandler:^{
+                                  // Refresh the messages, deleted messages are no longer visible and will be removed
+                                  [self refreshMessagesWithIDs:[NSSet setWithArray:messageIDs]
+                                             deletedMessageIDs:[NSSet set]
+                                             completionHandler:^(NSDictionary *changes) {
                                       if (self.batchOperationCount > 0) {
                                           self.batchOperationCount--;
                                       }
@@ -302,10 +320,8 @@ typedef void (^UAInboxMessageFetchCompletionHandler)(NSArray *);
                                           inboxMessageListCompletionBlock();
                                       }
 
-                                      [self sendMessageListUpdatedNotification];
+                                      [self sendMessageListUpdatedNotificationWithChanges:changes];
                                   }];
-
-                                  [self syncLocalMessageState];
                               }];
 
 
@@ -315,8 +331,8 @@ typedef void (^UAInboxMessageFetchCompletionHandler)(NSArray *);
 - (void)loadSavedMessages {
     // First load
     [self sendMessageListWillUpdateNotification];
-    [self refreshInboxWithCompletionHandler:^ {
-        [self sendMessageListUpdatedNotification];
+    [self refreshInboxWithCompletionHandler:^(NSDictionary *changes) {
+        [self sendMessageListUpdatedNotificationWithChanges:changes];
     }];
 }
 
@@ -325,116 +341,236 @@ typedef void (^UAInboxMessageFetchCompletionHandler)(NSArray *);
 
 
 /**
- * Refreshes the publicly exposed inbox messages on the private context.
- * The completion handler is executed on the main context.
+ * Predicate matching the messages visible in the inbox.
+ */
+- (NSPredicate *)visibleMessagesPredicate {
+    NSString *predicateFormat = @"(messageExpiration == nil || messageExpiration >= %@) && (deletedClient == NO || deletedClient == nil)";
+    return [NSPredicate predicateWithFormat:predicateFormat, [self.date now]];
+}
+
+/**
+ * Reloads every publicly exposed inbox message on the private context.
+ * The completion handler is executed on the main context with the changes.
  *
  * @param completionHandler Optional completion handler.
  */
-- (void)refreshInboxWithCompletionHandler:(void (^)(void))completionHandler {
-    NSString *predicateFormat = @"(messageExpiration == nil || messageExpiration >= %@) && (deletedClient == NO || deletedClient == nil)";
-    NSPredicate *predicate = [NSPredicate predicateWithFormat:predicateFormat, [self.date now]];
+- (void)refreshInboxWithCompletionHandler:(nullable UAInboxMessageListChangesHandler)completionHandler {
+    self.snapshotRequested = YES;
 
     UA_WEAKIFY(self)
-    [self.inboxStore fetchMessagesWithPredicate:predicate
+    [self.inboxStore fetchMessagesWithPredicate:[self visibleMessagesPredicate]
                               completionHandler:^(NSArray<UAInboxMessageData *> *data) {
                                   UA_STRONGIFY(self)
-                                  NSInteger unreadCount = 0;
                                   NSMutableArray *messages = [NSMutableArray arrayWithCapacity:data.count];
 
                                   for (UAInboxMessageData *messageData in data) {
-                                      UAInboxMessage *message = [self messageFromMessageData:messageData];
-                                      if (message.unread) {
-                                          unreadCount ++;
-                                      }
-
-                                      [messages addObject:message];
+                                      [messages addObject:[self messageFromMessageData:messageData]];
                                   }
 
                                   [self.dispatcher dispatchAsync:^{
                                       UA_LDEBUG(@"Inbox messages updated.");
                                       UA_LTRACE(@"Loaded saved messages: %@.", messages);
-                                      self.unreadCount = unreadCount;
-                                      self.messages = messages;
+                                      NSDictionary *changes = [self replaceMessages:messages];
 
                                       if (completionHandler) {
-                                          completionHandler();
+                                          completionHandler(changes);
                                       }
                                   }];
                               }];
 }
 
 /**
- * Synchronizes local read messages state with the server, on the private context.
+ * Reloads only the given messages on the private context and applies them to the publicly
+ * exposed inbox messages. Messages that are no longer visible are removed. Falls back to a full
+ * reload if the inbox has not been loaded yet. The completion handler is executed on the main
+ * context with the changes.
+ *
+ * @param messageIDs The IDs of the messages that were inserted or changed in the store.
+ * @param deletedMessageIDs The IDs of the messages that were removed from the store.
+ * @param completionHandler Optional completion handler.
  */
-- (void)syncReadMessageState {
+- (void)refreshMessagesWithIDs:(NSSet<NSString *> *)messageIDs
+             deletedMessageIDs:(NSSet<NSString *> *)deletedMessageIDs
+             completionHandler:(nullable UAInboxMessageListChangesHandler)completionHandler {
+    if (!self.snapshotRequested) {
+        [self refreshInboxWithCompletionHandler:completionHandler];
+        return;
+    }
+
+    void (^apply)(NSArray *, NSSet *) = ^(NSArray<UAInboxMessage *> *messages, NSSet<NSString *> *removedMessageIDs) {
+        [self.dispatcher dispatchAsync:^{
+            UA_LDEBUG(@"Inbox messages updated.");
+            NSDictionary *changes = [self applyMessages:messages removedMessageIDs:removedMessageIDs];
+
+            if (completionHandler) {
+                completionHandler(changes);
+            }
+        }];
+    };
+
+    if (!messageIDs.count) {
+        apply(@[], deletedMessageIDs);
+        return;
+    }
+
+    NSPredicate *predicate = [NSCompoundPredicate andPredicateWithSubpredicates:@[[NSPredicate predicateWithFormat:@"messageID IN %@", messageIDs],
+                                                                                   [self visibleMessagesPredicate]]];
+
     UA_WEAKIFY(self)
-    [self.inboxStore fetchMessagesWithPredicate:[NSPredicate predicateWithFormat:@"unreadClient == NO && unread == YES"]
+    [self.inboxStore fetchMessagesWithPredicate:predicate
                               completionHandler:^(NSArray<UAInboxMessageData *> *data) {
                                   UA_STRONGIFY(self)
+                                  NSMutableArray *messages = [NSMutableArray arrayWithCapacity:data.count];
+                                  NSMutableSet *removedMessageIDs = [NSMutableSet setWithSet:messageIDs];
+                                  [removedMessageIDs unionSet:deletedMessageIDs];
 
-                                  if (!data.count) {
-                                      // Nothing to do
-                                      return;
+                                  for (UAInboxMessageData *messageData in data) {
+                                      [messages addObject:[self messageFromMessageData:messageData]];
+                                      [removedMessageIDs removeObject:messageData.messageID];
                                   }
 
-                                  NSArray *messageURLs = [data valueForKeyPath:@"messageURL"];
-                                  NSArray *messageIDs = [data valueForKeyPath:@"messageID"];
+                                  apply(messages, removedMessageIDs);
+                              }];
+}
 
-                                  UA_LTRACE(@"Synchronizing locally read messages %@ on server.", messageIDs);
+/**
+ * Replaces the snapshot with a full list of messages. Must be called on the main dispatcher.
+ *
+ * @param messages The messages.
+ * @return The changes between the previous and the new snapshot.
+ */
+- (NSDictionary *)replaceMessages:(NSArray<UAInboxMessage *> *)messages {
+    NSMutableArray *inserted = [NSMutableArray array];
+    NSMutableArray *updated = [NSMutableArray array];
+    NSMutableSet *deleted = [NSMutableSet setWithArray:self.messageIDMap.allKeys];
+
+    for (UAInboxMessage *message in messages) {
+        if (!message.messageID) {
+            continue;
+        }
 
-                                  [self.client performBatchMarkAsReadForMessageURLs:messageURLs onSuccess:^{
+        UAInboxMessage *existing = self.messageIDMap[message.messageID];
+        if (!existing) {
+            [inserted addObject:message.messageID];
+        } else if ([self message:message differsFromMessage:existing]) {
+            [updated addObject:message.messageID];
+        }
 
-                                      // Mark the messages as read
-                                      [self.inboxStore fetchMessagesWithPredicate:[NSPredicate predicateWithFormat:@"messageID IN %@", messageIDs]
-                                                                completionHandler:^(NSArray<UAInboxMessageData *> *data) {
-                                                                    for (UAInboxMessageData *messageData in data) {
-                                                                        messageData.unread = NO;
-                                                                    }
+        [deleted removeObject:message.messageID];
+    }
 
-                                                                    UA_LTRACE(@"Successfully synchronized locally read messages on server.");
-                                                                }];
-                                  } onFailure:^() {
-                                      UA_LTRACE(@"Failed to synchronize locally read messages on server.");
-                                  }];
+    self.messages = messages;
+    self.unreadCount = self.unreadMessageIDs.count;
+    [self.bodyCache removeBodiesForMessageIDs:deleted.allObjects];
 
-                              }];
+    return [self changesWithInserted:inserted updated:updated deleted:deleted.allObjects];
 }
 
 /**
- * Synchronizes local deleted message state with the server, on the private context.
+ * Applies changed and removed messages to the snapshot, and removes any expired messages.
+ * Must be called on the main dispatcher.
+ *
+ * @param messages The inserted or changed messages.
+ * @param removedMessageIDs The IDs of the messages to remove.
+ * @return The changes applied to the snapshot.
  */
-- (void)syncDeletedMessageState {
+- (NSDictionary *)applyMessages:(NSArray<UAInboxMessage *> *)messages removedMessageIDs:(NSSet<NSString *> *)removedMessageIDs {
+    NSMutableArray *inserted = [NSMutableArray array];
+    NSMutableArray *updated = [NSMutableArray array];
+    NSMutableArray *deleted = [NSMutableArray array];
+    NSMutableArray<UAInboxMessage *> *snapshot = [self.messages mutableCopy];
+    NSDate *now = [self.date now];
+
+    // The maps are updated in place, so lookups from other threads must not see them mid-change
+    @synchronized(self) {
+        for (UAInboxMessage *message in [snapshot copy]) {
+            BOOL expired = message.messageExpiration && [message.messageExpiration compare:now] == NSOrderedAscending;
+            if (expired || [removedMessageIDs containsObject:message.messageID]) {
+                [self removeMessage:message fromSnapshot:snapshot];
+                if (message.messageID) {
+                    [deleted addObject:message.messageID];
+                }
+            }
+        }
 
-    UA_WEAKIFY(self)
-    [self.inboxStore fetchMessagesWithPredicate:[NSPredicate predicateWithFormat:@"deletedClient == YES"]
-                              completionHandler:^(NSArray<UAInboxMessageData *> *data) {
-                                  UA_STRONGIFY(self)
+        for (UAInboxMessage *message in messages) {
+            if (!message.messageID) {
+                continue;
+            }
 
-                                  if (!data.count) {
-                                      // Nothing to do
-                                      return;
-                                  }
+            UAInboxMessage *existing = self.messageIDMap[message.messageID];
+            if (existing) {
+                if (![self message:message differsFromMessage:existing]) {
+                    continue;
+                }
+
+                [self removeMessage:existing fromSnapshot:snapshot];
+                [updated addObject:message.messageID];
+            } else {
+                [inserted addObject:message.messageID];
+            }
+
+            [self insertMessage:message intoSnapshot:snapshot];
+        }
 
+        _messages = [snapshot copy];
+    }
 
-                                  NSArray *messageURLs = [data valueForKeyPath:@"messageURL"];
-                                  NSArray *messageIDs = [data valueForKeyPath:@"messageID"];
+    self.unreadCount = self.unreadMessageIDs.count;
+    [self.bodyCache removeBodiesForMessageIDs:deleted];
 
-                                  UA_LTRACE(@"Synchronizing locally deleted messages %@ on server.", messageIDs);
+    return [self changesWithInserted:inserted updated:updated deleted:deleted];
+}
 
-                                  [self.client performBatchDeleteForMessageURLs:messageURLs onSuccess:^{
-                                      UA_LTRACE(@"Successfully synchronized locally deleted messages on server.");
-                                  } onFailure:^() {
-                                      UA_LTRACE(@"Failed to synchronize locally deleted messages on server.");
-                                  }];
-                              }];
+- (NSDictionary *)changesWithInserted:(NSArray *)inserted updated:(NSArray *)updated deleted:(NSArray *)deleted {
+    return @{ UAInboxMessageListInsertedMessageIDsKey : [inserted copy],
+              UAInboxMessageListUpdatedMessageIDsKey : [updated copy],
+              UAInboxMessageListDeletedMessageIDsKey : [deleted copy] };
 }
 
-/**
- * Synchronizes any local read or deleted message state with the server, on the private context.
- */
-- (void)syncLocalMessageState {
-    [self syncReadMessageState];
-    [self syncDeletedMessageState];
+- (BOOL)message:(UAInboxMessage *)message differsFromMessage:(UAInboxMessage *)existing {
+    // The existing message may have been marked read in place, so the read state is checked against the snapshot
+    BOOL wasUnread = [self.unreadMessageIDs containsObject:existing.messageID];
+    return message.unread != wasUnread || ![message.rawMessageObject isEqualToDictionary:existing.rawMessageObject];
+}
+
+- (void)indexMessage:(UAInboxMessage *)message {
+    if (message.messageBodyURL.absoluteString) {
+        [self.messageURLMap setObject:message forKey:message.messageBodyURL.absoluteString];
+    }
+    if (message.messageID) {
+        [self.messageIDMap setObject:message forKey:message.messageID];
+    }
+    if (message.unread && message.messageID) {
+        [self.unreadMessageIDs addObject:message.messageID];
+    }
+}
+
+- (void)insertMessage:(UAInboxMessage *)message intoSnapshot:(NSMutableArray<UAInboxMessage *> *)snapshot {
+    // Keep the store order, most recently sent first
+    NSUInteger index = [snapshot indexOfObject:message
+                                 inSortedRange:NSMakeRange(0, snapshot.count)
+                                       options:NSBinarySearchingInsertionIndex
+                               usingComparator:^NSComparisonResult(UAInboxMessage *a, UAInboxMessage *b) {
+        NSDate *aSent = a.messageSent ?: [NSDate distantPast];
+        NSDate *bSent = b.messageSent ?: [NSDate distantPast];
+        return [bSent compare:aSent];
+    }];
+
+    [snapshot insertObject:message atIndex:index];
+    [self indexMessage:message];
+}
+
+- (void)removeMessage:(UAInboxMessage *)message fromSnapshot:(NSMutableArray<UAInboxMessage *> *)snapshot {
+    [snapshot removeObjectIdenticalTo:message];
+
+    if (message.messageBodyURL.absoluteString && self.messageURLMap[message.messageBodyURL.absoluteString] == message) {
+        [self.messageURLMap removeObjectForKey:message.messageBodyURL.absoluteString];
+    }
+    if (message.messageID) {
+        [self.messageIDMap removeObjectForKey:message.messageID];
+        [self.unreadMessageIDs removeObject:message.messageID];
+    }
 }
 
 - (NSUInteger)messageCount {
@@ -442,11 +578,15 @@ typedef void (^UAInboxMessageFetchCompletionHandler)(NSArray *);
 }
 
 - (UAInboxMessage *)messageForBodyURL:(NSURL *)url {
-    return [self.messageURLMap objectForKey:url.absoluteString];
+    @synchronized(self) {
+        return [self.messageURLMap objectForKey:url.absoluteString];
+    }
 }
 
 - (UAInboxMessage *)messageForID:(NSString *)messageID {
-    return [self.messageIDMap objectForKey:messageID];
+    @synchronized(self) {
+        return [self.messageIDMap objectForKey:messageID];
+    }
 }
 
 - (BOOL)isRetrieving {
@@ -499,6 +639,11 @@ typedef void (^UAInboxMessageFetchCompletionHandler)(NSArray *);
 - (void)setEnabled:(BOOL)enabled {
     _enabled = enabled;
     self.client.enabled = enabled;
+    self.bodyCache.enabled = enabled;
+
+    if (enabled) {
+        [self.outbox flush];
+    }
 }
 
 @end
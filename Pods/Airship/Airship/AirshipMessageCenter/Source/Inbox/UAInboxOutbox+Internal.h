@@ -0,0 +1,97 @@
+/* Copyright Airship and Contributors */
+
+#import <Foundation/Foundation.h>
+
+#import "UAAirshipMessageCenterCoreImport.h"
+
+@class UAInboxAPIClient;
+@class UAInboxStore;
+@class UAInboxMessage;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * The initial delay in seconds before retrying a failed flush.
+ */
+extern const NSTimeInterval UAInboxOutboxInitialBackoff;
+
+/**
+ * The maximum delay in seconds before retrying a failed flush.
+ */
+extern const NSTimeInterval UAInboxOutboxMaxBackoff;
+
+/**
+ * Durable queue of the read and delete operations that still need to be sent to the server.
+ *
+ * Operations are persisted as they are enqueued and coalesced per message, with a delete
+ * superseding a read. Each flush sends every pending delete and every pending read in one batch
+ * request each, independently of each other. Batches that fail with a server or network error are
+ * retried with exponential backoff, and batches rejected with a client error other than 429 are
+ * dropped.
+ */
+@interface UAInboxOutbox : NSObject
+
+///---------------------------------------------------------------------------------------
+/// @name Inbox Outbox Internal Methods
+///---------------------------------------------------------------------------------------
+
+/**
+ * Factory method.
+ *
+ * @param client The inbox API client.
+ * @param inboxStore The inbox store.
+ * @param dataStore The data store the outbox is persisted in.
+ * @return An outbox instance.
+ */
++ (instancetype)outboxWithClient:(UAInboxAPIClient *)client
+                      inboxStore:(UAInboxStore *)inboxStore
+                       dataStore:(UAPreferenceDataStore *)dataStore;
+
+/**
+ * Factory method. Used for testing.
+ *
+ * @param client The inbox API client.
+ * @param inboxStore The inbox store.
+ * @param dataStore The data store the outbox is persisted in.
+ * @param dispatcher The dispatcher used to schedule retries.
+ * @return An outbox instance.
+ */
++ (instancetype)outboxWithClient:(UAInboxAPIClient *)client
+                      inboxStore:(UAInboxStore *)inboxStore
+                       dataStore:(UAPreferenceDataStore *)dataStore
+                      dispatcher:(UADispatcher *)dispatcher;
+
+/**
+ * Enqueues marking messages read on the server and flushes the outbox.
+ *
+ * @param messages The messages.
+ */
+- (void)enqueueReadForMessages:(NSArray<UAInboxMessage *> *)messages;
+
+/**
+ * Enqueues deleting messages on the server and flushes the outbox.
+ *
+ * @param messages The messages.
+ */
+- (void)enqueueDeleteForMessages:(NSArray<UAInboxMessage *> *)messages;
+
+/**
+ * Drops the pending operations of messages that no longer exist on the server.
+ *
+ * @param messageIDs The message IDs.
+ */
+- (void)removeOperationsForMessageIDs:(NSSet<NSString *> *)messageIDs;
+
+/**
+ * Sends the pending operations, unless a flush is in flight or waiting to be retried.
+ */
+- (void)flush;
+
+/**
+ * Removes every pending operation, e.g. when they belong to a previous user.
+ */
+- (void)removeAllOperations;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,374 @@
+/* Copyright Airship and Contributors */
+
+#import "UAInboxOutbox+Internal.h"
+#import "UAInboxAPIClient+Internal.h"
+#import "UAInboxStore+Internal.h"
+#import "UAInboxMessage.h"
+
+const NSTimeInterval UAInboxOutboxInitialBackoff = 30;
+const NSTimeInterval UAInboxOutboxMaxBackoff = 3000;
+
+// Data store keys
+static NSString * const UAInboxOutboxReadKey = @"UAInboxOutboxRead";
+static NSString * const UAInboxOutboxDeleteKey = @"UAInboxOutboxDelete";
+static NSString * const UAInboxOutboxMigratedKey = @"UAInboxOutboxMigrated";
+
+@interface UAInboxOutbox ()
+@property (nonatomic, strong) UAInboxAPIClient *client;
+@property (nonatomic, strong) UAInboxStore *inboxStore;
+@property (nonatomic, strong) UAPreferenceDataStore *dataStore;
+@property (nonatomic, strong) UADispatcher *dispatcher;
+
+// Pending operations, message ID to message URL
+@property (nonatomic, strong) NSMutableDictionary<NSString *, NSString *> *pendingReads;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, NSString *> *pendingDeletes;
+
+@property (nonatomic, assign) BOOL flushing;
+@property (nonatomic, assign) NSTimeInterval backoff;
+@property (nonatomic, strong, nullable) UADisposable *retryDisposable;
+@end
+
+@implementation UAInboxOutbox
+
+- (instancetype)initWithClient:(UAInboxAPIClient *)client
+                    inboxStore:(UAInboxStore *)inboxStore
+                     dataStore:(UAPreferenceDataStore *)dataStore
+                    dispatcher:(UADispatcher *)dispatcher {
+    self = [super init];
+
+    if (self) {
+        self.client = client;
+        self.inboxStore = inboxStore;
+        self.dataStore = dataStore;
+        self.dispatcher = dispatcher;
+        self.pendingReads = [NSMutableDictionary dictionaryWithDictionary:[dataStore dictionaryForKey:UAInboxOutboxReadKey] ?: @{}];
+        self.pendingDeletes = [NSMutableDictionary dictionaryWithDictionary:[dataStore dictionaryForKey:UAInboxOutboxDeleteKey] ?: @{}];
+        self.backoff = UAInboxOutboxInitialBackoff;
+
+        [self migrateLocalMessageState];
+    }
+
+    return self;
+}
+
++ (instancetype)outboxWithClient:(UAInboxAPIClient *)client
+                      inboxStore:(UAInboxStore *)inboxStore
+                       dataStore:(UAPreferenceDataStore *)dataStore {
+    return [[self alloc] initWithClient:client
+                             inboxStore:inboxStore
+                              dataStore:dataStore
+                             dispatcher:[UADispatcher mainDispatcher]];
+}
+
++ (instancetype)outboxWithClient:(UAInboxAPIClient *)client
+                      inboxStore:(UAInboxStore *)inboxStore
+                       dataStore:(UAPreferenceDataStore *)dataStore
+                      dispatcher:(UADispatcher *)dispatcher {
+    return [[self alloc] initWithClient:client
+                             inboxStore:inboxStore
+                              dataStore:dataStore
+                             dispatcher:dispatcher];
+}
+
+- (void)dealloc {
+    [_retryDisposable dispose];
+}
+
+/**
+ * Enqueues the read and delete state that was left in the store before the outbox existed, then flushes.
+ */
+- (void)migrateLocalMessageState {
+    if ([self.dataStore boolForKey:UAInboxOutboxMigratedKey]) {
+        [self flush];
+        return;
+    }
+
+    UA_WEAKIFY(self)
+    [self.inboxStore fetchMessagesWithPredicate:[NSPredicate predicateWithFormat:@"(unreadClient == NO && unread == YES) || deletedClient == YES"]
+                              completionHandler:^(NSArray<UAInboxMessageData *> *data) {
+        UA_STRONGIFY(self)
+        @synchronized (self) {
+            for (UAInboxMessageData *messageData in data) {
+                if (!messageData.messageID || !messageData.messageURL) {
+                    continue;
+                }
+
+                if (messageData.deletedClient) {
+                    [self.pendingReads removeObjectForKey:messageData.messageID];
+                    self.pendingDeletes[messageData.messageID] = messageData.messageURL.absoluteString;
+                } else if (!self.pendingDeletes[messageData.messageID]) {
+                    self.pendingReads[messageData.messageID] = messageData.messageURL.absoluteString;
+                }
+            }
+
+            [self persist];
+            [self.dataStore setBool:YES forKey:UAInboxOutboxMigratedKey];
+        }
+
+        [self.dispatcher dispatchAsync:^{
+            [self flush];
+        }];
+    }];
+}
+
+- (void)enqueueReadForMessages:(NSArray<UAInboxMessage *> *)messages {
+    @synchronized (self) {
+        for (UAInboxMessage *message in messages) {
+            // Deleting a message already takes it off the server, reading it too would be redundant
+            if (!self.pendingDeletes[message.messageID]) {
+                self.pendingReads[message.messageID] = message.messageURL.absoluteString;
+            }
+        }
+
+        [self persist];
+    }
+
+    [self flush];
+}
+
+- (void)enqueueDeleteForMessages:(NSArray<UAInboxMessage *> *)messages {
+    @synchronized (self) {
+        for (UAInboxMessage *message in messages) {
+            [self.pendingReads removeObjectForKey:message.messageID];
+            self.pendingDeletes[message.messageID] = message.messageURL.absoluteString;
+        }
+
+        [self persist];
+    }
+
+    [self flush];
+}
+
+- (void)removeOperationsForMessageIDs:(NSSet<NSString *> *)messageIDs {
+    if (!messageIDs.count) {
+        return;
+    }
+
+    @synchronized (self) {
+        [self.pendingReads removeObjectsForKeys:messageIDs.allObjects];
+        [self.pendingDeletes removeObjectsForKeys:messageIDs.allObjects];
+        [self persist];
+    }
+}
+
+- (void)flush {
+    NSDictionary<NSString *, NSString *> *reads;
+    NSDictionary<NSString *, NSString *> *deletes;
+
+    @synchronized (self) {
+        // Operations enqueued while in flight or backing off go out with the next flush
+        if (self.flushing || self.retryDisposable) {
+            return;
+        }
+
+        // The client reports success without sending anything while disabled
+        if (!self.client.enabled) {
+            return;
+        }
+
+        if (!self.pendingReads.count && !self.pendingDeletes.count) {
+            return;
+        }
+
+        self.flushing = YES;
+        reads = [self.pendingReads copy];
+        deletes = [self.pendingDeletes copy];
+    }
+
+    // Reads are sent whether or not the deletes go through, so one batch can never hold up the other
+    UA_WEAKIFY(self)
+    [self sendDeletes:deletes completionHandler:^(BOOL retryDeletes) {
+        UA_STRONGIFY(self)
+        [self sendReads:reads completionHandler:^(BOOL retryReads) {
+            UA_STRONGIFY(self)
+            if (retryDeletes || retryReads) {
+                [self flushFailed];
+            } else {
+                [self flushSucceeded];
+            }
+        }];
+    }];
+}
+
+- (void)removeAllOperations {
+    @synchronized (self) {
+        [self.pendingReads removeAllObjects];
+        [self.pendingDeletes removeAllObjects];
+        [self persist];
+
+        [self.retryDisposable dispose];
+        self.retryDisposable = nil;
+        self.backoff = UAInboxOutboxInitialBackoff;
+    }
+}
+
+#pragma mark -
+#pragma mark Flushing
+
+/**
+ * Checks if a failed batch should be retried. Client errors other than 429 will fail again, so
+ * their operations are dropped instead.
+ *
+ * @param status The HTTP status code, or 0 if no response was received.
+ * @return `YES` if the batch should be retried, otherwise `NO`.
+ */
+- (BOOL)shouldRetryStatus:(NSUInteger)status {
+    return !(status >= 400 && status <= 499 && status != 429);
+}
+
+/**
+ * Deletes messages on the server in a single request.
+ *
+ * @param deletes The pending deletes, message ID to message URL.
+ * @param completionHandler The completion handler, called with `YES` if the deletes should be retried.
+ */
+- (void)sendDeletes:(NSDictionary<NSString *, NSString *> *)deletes completionHandler:(void(^)(BOOL retry))completionHandler {
+    if (!deletes.count) {
+        completionHandler(NO);
+        return;
+    }
+
+    UA_LTRACE(@"Synchronizing locally deleted messages %@ on server.", deletes.allKeys);
+
+    UA_WEAKIFY(self)
+    [self.client performBatchDeleteForMessageURLs:[self URLsForOperations:deletes] onSuccess:^{
+        UA_STRONGIFY(self)
+        UA_LTRACE(@"Successfully synchronized locally deleted messages on server.");
+        [self removeSentOperations:deletes fromPending:self.pendingDeletes];
+        completionHandler(NO);
+    } onFailure:^(NSUInteger status) {
+        UA_STRONGIFY(self)
+        if ([self shouldRetryStatus:status]) {
+            UA_LTRACE(@"Failed to synchronize locally deleted messages on server.");
+            completionHandler(YES);
+            return;
+        }
+
+        UA_LERR(@"Dropping locally deleted messages %@, server responded with %lu", deletes.allKeys, (unsigned long)status);
+        [self removeSentOperations:deletes fromPending:self.pendingDeletes];
+        completionHandler(NO);
+    }];
+}
+
+/**
+ * Marks messages read on the server in a single request, then marks them read in the store in a single batch update.
+ *
+ * @param reads The pending reads, message ID to message URL.
+ * @param completionHandler The completion handler, called with `YES` if the reads should be retried.
+ */
+- (void)sendReads:(NSDictionary<NSString *, NSString *> *)reads completionHandler:(void(^)(BOOL retry))completionHandler {
+    if (!reads.count) {
+        completionHandler(NO);
+        return;
+    }
+
+    UA_LTRACE(@"Synchronizing locally read messages %@ on server.", reads.allKeys);
+
+    UA_WEAKIFY(self)
+    [self.client performBatchMarkAsReadForMessageURLs:[self URLsForOperations:reads] onSuccess:^{
+        UA_STRONGIFY(self)
+        UA_LTRACE(@"Successfully synchronized locally read messages on server.");
+        [self removeSentOperations:reads fromPending:self.pendingReads];
+
+        [self.inboxStore markMessagesReadWithIDs:reads.allKeys completionHandler:^(BOOL success) {
+            if (!success) {
+                UA_LERR(@"Failed to mark synchronized messages as read: %@", reads.allKeys);
+            }
+        }];
+
+        completionHandler(NO);
+    } onFailure:^(NSUInteger status) {
+        UA_STRONGIFY(self)
+        if ([self shouldRetryStatus:status]) {
+            UA_LTRACE(@"Failed to synchronize locally read messages on server.");
+            completionHandler(YES);
+            return;
+        }
+
+        UA_LERR(@"Dropping locally read messages %@, server responded with %lu", reads.allKeys, (unsigned long)status);
+        [self removeSentOperations:reads fromPending:self.pendingReads];
+        completionHandler(NO);
+    }];
+}
+
+- (void)flushSucceeded {
+    BOOL hasPending;
+
+    @synchronized (self) {
+        self.flushing = NO;
+        self.backoff = UAInboxOutboxInitialBackoff;
+        hasPending = self.pendingReads.count || self.pendingDeletes.count;
+    }
+
+    // Send anything that was enqueued while in flight
+    if (hasPending) {
+        [self flush];
+    }
+}
+
+- (void)flushFailed {
+    NSTimeInterval delay;
+
+    @synchronized (self) {
+        self.flushing = NO;
+        delay = self.backoff;
+        self.backoff = MIN(self.backoff * 2, UAInboxOutboxMaxBackoff);
+    }
+
+    UA_LDEBUG(@"Inbox outbox flush failed, retrying in %.0f seconds", delay);
+
+    UA_WEAKIFY(self)
+    UADisposable *disposable = [self.dispatcher dispatchAfter:delay block:^{
+        UA_STRONGIFY(self)
+        @synchronized (self) {
+            self.retryDisposable = nil;
+        }
+
+        [self flush];
+    }];
+
+    @synchronized (self) {
+        self.retryDisposable = disposable;
+    }
+}
+
+/**
+ * Removes sent operations that were not replaced while the request was in flight.
+ *
+ * @param sent The sent operations.
+ * @param pending The pending operations.
+ */
+- (void)removeSentOperations:(NSDictionary<NSString *, NSString *> *)sent
+                 fromPending:(NSMutableDictionary<NSString *, NSString *> *)pending {
+    @synchronized (self) {
+        for (NSString *messageID in sent) {
+            if ([pending[messageID] isEqualToString:sent[messageID]]) {
+                [pending removeObjectForKey:messageID];
+            }
+        }
+
+        [self persist];
+    }
+}
+
+- (NSArray<NSURL *> *)URLsForOperations:(NSDictionary<NSString *, NSString *> *)operations {
+    NSMutableArray<NSURL *> *URLs = [NSMutableArray arrayWithCapacity:operations.count];
+    for (NSString *URLString in operations.allValues) {
+        NSURL *URL = [NSURL URLWithString:URLString];
+        if (URL) {
+            [URLs addObject:URL];
+        }
+    }
+
+    return URLs;
+}
+
+/**
+ * Writes the pending operations to the data store. Must be called while synchronized on self.
+ */
+- (void)persist {
+    [self.dataStore setObject:[self.pendingReads copy] forKey:UAInboxOutboxReadKey];
+    [self.dataStore setObject:[self.pendingDeletes copy] forKey:UAInboxOutboxDeleteKey];
+}
+
+@end
@@ -120,12 +120,19 @@ NSString *const UAMessageDataScheme = @"message";
 }
 
 - (void)userCreated {
+    // Cached bodies and pending operations belong to the previous user
+    [self.messageList.bodyCache removeAllBodies];
+    [self.messageList.outbox removeAllOperations];
     [self.messageList retrieveMessageListWithSuccessBlock:nil withFailureBlock:nil];
 }
 
 - (void)onComponentEnableChange {
     self.user.enabled = self.componentEnabled;
     self.messageList.enabled = self.componentEnabled;
+
+    if (!self.componentEnabled) {
+        [self.messageList.bodyCache removeAllBodies];
+    }
 }
 
 #pragma mark -
@@ -151,6 +158,15 @@ NSString *const UAMessageDataScheme = @"message";
     }];
 }
 
+-(UAPushableComponentPriority)pushProcessingPriority {
+    return UAPushableComponentPriorityNormal;
+}
+
+-(NSTimeInterval)expectedPushProcessingTime {
+    // Message list refresh request
+    return 5;
+}
+
 #pragma mark -
 
 @end
@@ -12,7 +12,7 @@
 }
 
 + (instancetype)clientWithConfig:(UARuntimeConfig *)config {
-    return [UAUserAPIClient clientWithConfig:config session:[UARequestSession sessionWithConfig:config]];
+    return [UAUserAPIClient clientWithConfig:config session:[UARequestSession sessionWithConfig:config requestClass:@"user" priority:UARequestPriorityHigh]];
 }
 
 - (void)createUserWithChannelID:(NSString *)channelID
@@ -20,6 +20,7 @@
 #import "UAActiveTimer+Internal.h"
 #import "UAAirshipAutomationCoreImport.h"
 #import "UAAutomationEngine+Internal.h"
+#import "UAAutomationEngineMetrics+Internal.h"
 #import "UAAutomationModuleLoader.h"
 #import "UAAutomationResources.h"
 #import "UAAutomationStore+Internal.h"
@@ -27,11 +28,13 @@
 #import "UAInAppMessage+Internal.h"
 #import "UAInAppMessage.h"
 #import "UAInAppMessageAdapterProtocol.h"
+#import "UAInAppMessageAnimatedImageView+Internal.h"
 #import "UAInAppMessageAssetCache+Internal.h"
 #import "UAInAppMessageAssetManager+Internal.h"
 #import "UAInAppMessageAssetManager.h"
 #import "UAInAppMessageAssets+Internal.h"
 #import "UAInAppMessageAssets.h"
+#import "UAInAppMessageAssetStore+Internal.h"
 #import "UAInAppMessageAudience+Internal.h"
 #import "UAInAppMessageAudience.h"
 #import "UAInAppMessageAudienceChecks+Internal.h"
@@ -67,6 +70,7 @@
 #import "UAInAppMessageHTMLDisplayContent.h"
 #import "UAInAppMessageHTMLStyle.h"
 #import "UAInAppMessageHTMLViewController+Internal.h"
+#import "UAInAppMessageImage+Internal.h"
 #import "UAInAppMessageImmediateDisplayCoordinator.h"
 #import "UAInAppMessageManager+Internal.h"
 #import "UAInAppMessageManager.h"
@@ -79,6 +83,7 @@
 #import "UAInAppMessageModalDisplayContent.h"
 #import "UAInAppMessageModalStyle.h"
 #import "UAInAppMessageModalViewController+Internal.h"
+#import "UAInAppMessagePrefetcher+Internal.h"
 #import "UAInAppMessageResizableViewController+Internal.h"
 #import "UAInAppMessageResolution+Internal.h"
 #import "UAInAppMessageResolution.h"
@@ -90,8 +95,10 @@
 #import "UAInAppMessageScheduleInfo+Internal.h"
 #import "UAInAppMessageScheduleInfo.h"
 #import "UAInAppMessageStyleProtocol.h"
+#import "UAInAppMessageTagIndex+Internal.h"
 #import "UAInAppMessageTagSelector+Internal.h"
 #import "UAInAppMessageTagSelector.h"
+#import "UAInAppMessageTagSelectorProgram+Internal.h"
 #import "UAInAppMessageTextInfo+Internal.h"
 #import "UAInAppMessageTextInfo.h"
 #import "UAInAppMessageTextStyle.h"
@@ -107,6 +114,7 @@
 #import "UALegacyInAppMessaging+Internal.h"
 #import "UALegacyInAppMessaging.h"
 #import "UARetriable+Internal.h"
+#import "UARetriableGraph+Internal.h"
 #import "UARetriablePipeline+Internal.h"
 #import "UASchedule+Internal.h"
 #import "UASchedule.h"
@@ -119,6 +127,7 @@
 #import "UAScheduleEdits.h"
 #import "UAScheduleInfo+Internal.h"
 #import "UAScheduleInfo.h"
+#import "UAScheduleStateLog+Internal.h"
 #import "UAScheduleTrigger+Internal.h"
 #import "UAScheduleTrigger.h"
 #import "UAScheduleTriggerData+Internal.h"
@@ -204,6 +213,9 @@
 #import "UALocationProvider.h"
 #import "UAMediaEventTemplate.h"
 #import "UAMessageCenterModuleLoaderFactory.h"
+#import "UAMetrics.h"
+#import "UAMetricsExporter.h"
+#import "UAMetricsSnapshot.h"
 #import "UAModifyTagsAction.h"
 #import "UAModuleLoader.h"
 #import "UANamedUser.h"